@@ -0,0 +1,211 @@
+#include "AffineTransform.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define STLREPAIR_AFFINETRANSFORM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @since 2026 Oct 19
+ */
+AffineTransform::AffineTransform() :
+    m_isMirroring(false)
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+            m_matrix[row][col] = (row == col) ? 1.0f : 0.0f;
+    }
+
+    updateDerivedState();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AffineTransform AffineTransform::scale(float factor)
+{
+    return scale(Vec3{ factor, factor, factor });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AffineTransform AffineTransform::scale(const Vec3& factors)
+{
+    AffineTransform transform;
+    transform.m_matrix[0][0] = factors.x;
+    transform.m_matrix[1][1] = factors.y;
+    transform.m_matrix[2][2] = factors.z;
+    transform.updateDerivedState();
+    return transform;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AffineTransform AffineTransform::translation(const Vec3& offset)
+{
+    AffineTransform transform;
+    transform.m_matrix[0][3] = offset.x;
+    transform.m_matrix[1][3] = offset.y;
+    transform.m_matrix[2][3] = offset.z;
+    transform.updateDerivedState();
+    return transform;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AffineTransform AffineTransform::then(const AffineTransform& next) const
+{
+    // result = next * this, treating both as 4x4 with an implicit [0 0 0 1] row.
+    AffineTransform result;
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            float value = (col == 3) ? next.m_matrix[row][3] : 0.0f;
+            for (int k = 0; k < 3; ++k)
+                value += next.m_matrix[row][k] * m_matrix[k][col];
+            result.m_matrix[row][col] = value;
+        }
+    }
+
+    result.updateDerivedState();
+    return result;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool AffineTransform::isIdentity() const
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            if (m_matrix[row][col] != ((row == col) ? 1.0f : 0.0f))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+Vec3 AffineTransform::transformPoint(const Vec3& point) const
+{
+    return { m_matrix[0][0] * point.x + m_matrix[0][1] * point.y + m_matrix[0][2] * point.z + m_matrix[0][3],
+             m_matrix[1][0] * point.x + m_matrix[1][1] * point.y + m_matrix[1][2] * point.z + m_matrix[1][3],
+             m_matrix[2][0] * point.x + m_matrix[2][1] * point.y + m_matrix[2][2] * point.z + m_matrix[2][3] };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void AffineTransform::apply(STLBinaryTriangleData& triangleData) const
+{
+    STLFacet facet = decodeFacet(triangleData);
+
+#if defined(STLREPAIR_AFFINETRANSFORM_USE_SSE2)
+    const __m128 col0 = _mm_load_ps(m_columns[0]);
+    const __m128 col1 = _mm_load_ps(m_columns[1]);
+    const __m128 col2 = _mm_load_ps(m_columns[2]);
+    const __m128 col3 = _mm_load_ps(m_columns[3]);
+    alignas(16) float result[4];
+
+    for (int v = 0; v < 3; ++v)
+    {
+        const Vec3& vertex = facet.vertices[v];
+        __m128 sum = _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(vertex.x)), col3);
+        sum = _mm_add_ps(sum, _mm_mul_ps(col1, _mm_set1_ps(vertex.y)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(col2, _mm_set1_ps(vertex.z)));
+        _mm_store_ps(result, sum);
+        facet.vertices[v] = { result[0], result[1], result[2] };
+    }
+
+    __m128 normal = _mm_mul_ps(_mm_load_ps(m_normalColumns[0]), _mm_set1_ps(facet.normal.x));
+    normal = _mm_add_ps(normal, _mm_mul_ps(_mm_load_ps(m_normalColumns[1]), _mm_set1_ps(facet.normal.y)));
+    normal = _mm_add_ps(normal, _mm_mul_ps(_mm_load_ps(m_normalColumns[2]), _mm_set1_ps(facet.normal.z)));
+
+    // Horizontal add of the squares. The fourth lane is always zero.
+    __m128 squares = _mm_mul_ps(normal, normal);
+    __m128 shuffled = _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(squares, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    const __m128 lengthSquared = _mm_add_ss(sums, shuffled);
+
+    if (_mm_cvtss_f32(lengthSquared) > 0.0f)
+        normal = _mm_div_ps(normal, _mm_sqrt_ps(_mm_shuffle_ps(lengthSquared, lengthSquared, 0)));
+
+    _mm_store_ps(result, normal);
+    facet.normal = { result[0], result[1], result[2] };
+#else
+    for (int v = 0; v < 3; ++v)
+        facet.vertices[v] = transformPoint(facet.vertices[v]);
+
+    const Vec3 n = facet.normal;
+    Vec3 normal = { m_normalColumns[0][0] * n.x + m_normalColumns[1][0] * n.y + m_normalColumns[2][0] * n.z,
+                    m_normalColumns[0][1] * n.x + m_normalColumns[1][1] * n.y + m_normalColumns[2][1] * n.z,
+                    m_normalColumns[0][2] * n.x + m_normalColumns[1][2] * n.y + m_normalColumns[2][2] * n.z };
+
+    const float lengthSquared = normal.x * normal.x + normal.y * normal.y + normal.z * normal.z;
+    if (lengthSquared > 0.0f)
+    {
+        const float length = std::sqrt(lengthSquared);
+        normal = { normal.x / length, normal.y / length, normal.z / length };
+    }
+    facet.normal = normal;
+#endif
+
+    if (m_isMirroring)
+        std::swap(facet.vertices[1], facet.vertices[2]);
+
+    encodeFacet(facet, triangleData);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void AffineTransform::updateDerivedState()
+{
+    memset(m_columns, 0, sizeof(m_columns));
+    memset(m_normalColumns, 0, sizeof(m_normalColumns));
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+            m_columns[col][row] = m_matrix[row][col];
+    }
+
+    // The inverse-transpose is the cofactor matrix divided by the
+    // determinant. The magnitude doesn't matter since normals get
+    // renormalized, but the sign does.
+    const auto& m = m_matrix;
+    float cofactors[3][3];
+    cofactors[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    cofactors[0][1] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    cofactors[0][2] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    cofactors[1][0] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+    cofactors[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+    cofactors[1][2] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+    cofactors[2][0] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+    cofactors[2][1] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+    cofactors[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+    const float determinant = m[0][0] * cofactors[0][0] + m[0][1] * cofactors[0][1] + m[0][2] * cofactors[0][2];
+    m_isMirroring = (determinant < 0.0f);
+    const float sign = m_isMirroring ? -1.0f : 1.0f;
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 3; ++col)
+            m_normalColumns[col][row] = cofactors[row][col] * sign;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef STLREPAIR_AFFINETRANSFORM__H_
+#define STLREPAIR_AFFINETRANSFORM__H_
+
+#include "STLFileTypes.h"
+#include "STLGeometry.h"
+
+/**
+ * A 3x4 affine transform (3x3 linear part plus a translation) that can be
+ * applied to raw triangle data as it streams by.
+ *
+ * Vertices get the full transform. Normals get the inverse-transpose of the
+ * linear part and are renormalized, so they stay perpendicular to their
+ * facets even under non-uniform scaling. Transforms that mirror the model
+ * also swap two vertices, which keeps the winding consistent with the
+ * normal.
+ */
+class AffineTransform
+{
+public:
+
+    //! Constructor. Creates the identity transform.
+    AffineTransform();
+
+    //! Returns a transform that scales uniformly about the origin.
+    static AffineTransform scale(float factor);
+
+    //! Returns a transform that scales each axis independently about the origin.
+    static AffineTransform scale(const Vec3& factors);
+
+    //! Returns a transform that translates by the given offset.
+    static AffineTransform translation(const Vec3& offset);
+
+    /**
+     * Returns the transform equivalent to applying this one followed by
+     * the given one.
+     */
+    AffineTransform then(const AffineTransform& next) const;
+
+    //! Returns true if applying this transform would change nothing.
+    bool isIdentity() const;
+
+    //! Transforms a single point.
+    Vec3 transformPoint(const Vec3& point) const;
+
+    //! Transforms the normal and vertices of the given triangle in place.
+    void apply(STLBinaryTriangleData& triangleData) const;
+
+private:
+
+    void updateDerivedState();
+
+    // Row-major 3x4 matrix. Everything below is derived from it.
+    float m_matrix[3][4];
+
+    // Column-major copies, padded to 4 floats, for SIMD.
+    alignas(16) float m_columns[4][4];
+    alignas(16) float m_normalColumns[3][4];
+    bool m_isMirroring;
+};
+
+#endif
@@ -0,0 +1,831 @@
+#include "AsyncFileIO.h"
+#include "Contracts.h"
+#include "CallGuard.h"
+#include "TraceRecorder.h"
+#include "PositionalFile.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define STLREPAIR_ASYNCFILEIO_HAS_IO_URING
+#endif
+#endif
+
+namespace
+{
+    // Positional I/O is I/O-bound, so there's no point in having more
+    // threads than this even when the queue is deep.
+    constexpr const size_t MAXIMUM_IO_THREAD_COUNT = 8;
+
+    struct Completion
+    {
+        size_t m_slot;
+        int64_t m_result; // Bytes transferred, or -errno.
+    };
+
+    /**
+     * Something that carries out reads and writes in the background. Each
+     * request is tagged with a slot, which comes back with its completion.
+     * A slot only ever has one request outstanding.
+     */
+    class IOEngine
+    {
+    public:
+
+        virtual ~IOEngine() {}
+
+        virtual void submitRead(size_t slot, uint8_t* pBuffer, size_t size, uint64_t offset) = 0;
+        virtual void submitWrite(size_t slot, const uint8_t* pData, size_t size, uint64_t offset) = 0;
+
+        // Makes sure everything submitted so far has actually been started.
+        virtual void flush() {}
+
+        // Blocks until some request completes. There must be one outstanding.
+        virtual Completion waitForCompletion() = 0;
+    };
+
+    /**
+     * Plain pread()/pwrite() on a pool of threads. Works everywhere.
+     */
+    class ThreadPoolEngine : public IOEngine
+    {
+    public:
+
+        ThreadPoolEngine(PositionalFile& file, size_t threadCount) :
+            m_file(file),
+            m_isStopping(false)
+        {
+            for (size_t i = 0; i < threadCount; ++i)
+                m_threads.emplace_back([this]() { serviceRequests(); });
+        }
+
+        ~ThreadPoolEngine()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_isStopping = true;
+            }
+            m_requestAvailable.notify_all();
+
+            for (auto& thread : m_threads)
+                thread.join();
+        }
+
+        void submitRead(size_t slot, uint8_t* pBuffer, size_t size, uint64_t offset) override
+        {
+            submit({ slot, false, pBuffer, size, offset });
+        }
+
+        void submitWrite(size_t slot, const uint8_t* pData, size_t size, uint64_t offset) override
+        {
+            submit({ slot, true, const_cast<uint8_t*>(pData), size, offset });
+        }
+
+        Completion waitForCompletion() override
+        {
+            STLREPAIR_TRACE_SCOPE("wait for completion", "async io");
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_completionAvailable.wait(lock, [this]() { return !m_completions.empty(); });
+
+            Completion completion = m_completions.front();
+            m_completions.pop_front();
+            return completion;
+        }
+
+    private:
+
+        struct Request
+        {
+            size_t m_slot;
+            bool m_isWrite;
+            uint8_t* m_pBuffer;
+            size_t m_size;
+            uint64_t m_offset;
+        };
+
+        void submit(const Request& request)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_requests.push_back(request);
+            }
+            m_requestAvailable.notify_one();
+        }
+
+        void serviceRequests()
+        {
+            STLREPAIR_TRACE_THREAD_NAME("async io");
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_requestAvailable.wait(lock, [this]() { return m_isStopping || !m_requests.empty(); });
+                if (m_isStopping)
+                    return;
+
+                Request request = m_requests.front();
+                m_requests.pop_front();
+                lock.unlock();
+
+                int64_t result;
+                {
+                    STLREPAIR_TRACE_SCOPE(request.m_isWrite ? "pwrite" : "pread", "async io");
+                    result = request.m_isWrite ?
+                        m_file.tryWriteAt(request.m_pBuffer, request.m_size, request.m_offset) :
+                        m_file.tryReadAt(request.m_pBuffer, request.m_size, request.m_offset);
+                }
+
+                lock.lock();
+                m_completions.push_back({ request.m_slot, result });
+                m_completionAvailable.notify_one();
+            }
+        }
+
+        PositionalFile& m_file;
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_requestAvailable;
+        std::condition_variable m_completionAvailable;
+        std::deque<Request> m_requests;
+        std::deque<Completion> m_completions;
+        bool m_isStopping;
+    };
+
+#if defined(STLREPAIR_ASYNCFILEIO_HAS_IO_URING)
+
+    std::string describeError(int errorCode)
+    {
+        return std::strerror(errorCode);
+    }
+
+    // There's no liburing to lean on, so these are the raw system calls.
+    int ioUringSetup(unsigned entries, io_uring_params* pParams)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, pParams));
+    }
+
+    int ioUringEnter(int ringDescriptor, unsigned submitCount, unsigned minimumCompletions, unsigned flags)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ringDescriptor, submitCount,
+            minimumCompletions, flags, nullptr, 0));
+    }
+
+    int ioUringRegister(int ringDescriptor, unsigned opcode, void* pArguments, unsigned argumentCount)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_register, ringDescriptor, opcode,
+            pArguments, argumentCount));
+    }
+
+    /**
+     * io_uring with one registered buffer per slot, so the kernel doesn't
+     * have to map and unmap pages for every request.
+     */
+    class IOUringEngine : public IOEngine
+    {
+    public:
+
+        /**
+         * The buffers must outlive the engine. Slot n's buffer is the
+         * blockSize bytes at pBuffers + n * blockSize.
+         *
+         * @throws std::runtime_error if io_uring can't be set up.
+         */
+        IOUringEngine(int fileDescriptor, uint8_t* pBuffers, size_t slotCount, size_t blockSize) :
+            m_ringDescriptor(-1),
+            m_fileDescriptor(fileDescriptor),
+            m_pSubmissionRing(MAP_FAILED),
+            m_submissionRingSize(0),
+            m_pCompletionRing(MAP_FAILED),
+            m_completionRingSize(0),
+            m_pSubmissionEntries(static_cast<io_uring_sqe*>(MAP_FAILED)),
+            m_submissionEntriesSize(0),
+            m_pendingCount(0)
+        {
+            auto cleanupGuard = makeCallGuard([this]() { release(); });
+
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            m_ringDescriptor = ioUringSetup(static_cast<unsigned>(slotCount), &params);
+            if (m_ringDescriptor < 0)
+                throw std::runtime_error("io_uring isn't available - " + describeError(errno));
+
+            m_submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool isSingleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (isSingleMapping)
+                m_submissionRingSize = m_completionRingSize = std::max(m_submissionRingSize, m_completionRingSize);
+
+            m_pSubmissionRing = mmap(nullptr, m_submissionRingSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, m_ringDescriptor, IORING_OFF_SQ_RING);
+            if (m_pSubmissionRing == MAP_FAILED)
+                throw std::runtime_error("Couldn't map the io_uring submission queue.");
+
+            if (isSingleMapping)
+            {
+                m_pCompletionRing = m_pSubmissionRing;
+            }
+            else
+            {
+                m_pCompletionRing = mmap(nullptr, m_completionRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_ringDescriptor, IORING_OFF_CQ_RING);
+                if (m_pCompletionRing == MAP_FAILED)
+                    throw std::runtime_error("Couldn't map the io_uring completion queue.");
+            }
+
+            m_submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+            m_pSubmissionEntries = static_cast<io_uring_sqe*>(mmap(nullptr, m_submissionEntriesSize,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringDescriptor, IORING_OFF_SQES));
+            if (m_pSubmissionEntries == MAP_FAILED)
+                throw std::runtime_error("Couldn't map the io_uring submission entries.");
+
+            uint8_t* pSubmissionRing = static_cast<uint8_t*>(m_pSubmissionRing);
+            m_pSubmissionHead = reinterpret_cast<unsigned*>(pSubmissionRing + params.sq_off.head);
+            m_pSubmissionTail = reinterpret_cast<unsigned*>(pSubmissionRing + params.sq_off.tail);
+            m_submissionMask = *reinterpret_cast<unsigned*>(pSubmissionRing + params.sq_off.ring_mask);
+            m_submissionEntryCount = params.sq_entries;
+            m_pSubmissionArray = reinterpret_cast<unsigned*>(pSubmissionRing + params.sq_off.array);
+
+            uint8_t* pCompletionRing = static_cast<uint8_t*>(m_pCompletionRing);
+            m_pCompletionHead = reinterpret_cast<unsigned*>(pCompletionRing + params.cq_off.head);
+            m_pCompletionTail = reinterpret_cast<unsigned*>(pCompletionRing + params.cq_off.tail);
+            m_completionMask = *reinterpret_cast<unsigned*>(pCompletionRing + params.cq_off.ring_mask);
+            m_pCompletionEntries = reinterpret_cast<io_uring_cqe*>(pCompletionRing + params.cq_off.cqes);
+
+            // Registration can fail if the buffers exceed the locked memory
+            // limit. We don't bother with unregistered requests in that case.
+            // The thread pool is a perfectly good fallback.
+            std::vector<iovec> buffers(slotCount);
+            for (size_t i = 0; i < slotCount; ++i)
+            {
+                buffers[i].iov_base = pBuffers + i * blockSize;
+                buffers[i].iov_len = blockSize;
+            }
+            if (ioUringRegister(m_ringDescriptor, IORING_REGISTER_BUFFERS, buffers.data(),
+                static_cast<unsigned>(slotCount)) != 0)
+                throw std::runtime_error("Couldn't register io_uring buffers - " + describeError(errno));
+
+            cleanupGuard.dismiss();
+        }
+
+        ~IOUringEngine()
+        {
+            release();
+        }
+
+        void submitRead(size_t slot, uint8_t* pBuffer, size_t size, uint64_t offset) override
+        {
+            queue(IORING_OP_READ_FIXED, slot, pBuffer, size, offset);
+        }
+
+        void submitWrite(size_t slot, const uint8_t* pData, size_t size, uint64_t offset) override
+        {
+            queue(IORING_OP_WRITE_FIXED, slot, const_cast<uint8_t*>(pData), size, offset);
+        }
+
+        void flush() override
+        {
+            while (m_pendingCount > 0)
+            {
+                int submittedCount = ioUringEnter(m_ringDescriptor, m_pendingCount, 0, 0);
+                if (submittedCount < 0)
+                {
+                    if ((errno == EINTR) || (errno == EAGAIN))
+                        continue;
+                    throw std::runtime_error("io_uring submission failed - " + describeError(errno));
+                }
+                m_pendingCount -= static_cast<unsigned>(submittedCount);
+            }
+        }
+
+        Completion waitForCompletion() override
+        {
+            STLREPAIR_TRACE_SCOPE("wait for completion", "async io");
+
+            for (;;)
+            {
+                const unsigned head = *m_pCompletionHead;
+                if (head != __atomic_load_n(m_pCompletionTail, __ATOMIC_ACQUIRE))
+                {
+                    const io_uring_cqe& entry = m_pCompletionEntries[head & m_completionMask];
+                    Completion completion = { static_cast<size_t>(entry.user_data), entry.res };
+                    __atomic_store_n(m_pCompletionHead, head + 1, __ATOMIC_RELEASE);
+                    return completion;
+                }
+
+                int submittedCount = ioUringEnter(m_ringDescriptor, m_pendingCount, 1, IORING_ENTER_GETEVENTS);
+                if (submittedCount < 0)
+                {
+                    if ((errno == EINTR) || (errno == EAGAIN))
+                        continue;
+                    throw std::runtime_error("io_uring wait failed - " + describeError(errno));
+                }
+                m_pendingCount -= static_cast<unsigned>(submittedCount);
+            }
+        }
+
+    private:
+
+        void release()
+        {
+            if (m_pSubmissionEntries != MAP_FAILED)
+                munmap(m_pSubmissionEntries, m_submissionEntriesSize);
+            if ((m_pCompletionRing != MAP_FAILED) && (m_pCompletionRing != m_pSubmissionRing))
+                munmap(m_pCompletionRing, m_completionRingSize);
+            if (m_pSubmissionRing != MAP_FAILED)
+                munmap(m_pSubmissionRing, m_submissionRingSize);
+            if (m_ringDescriptor >= 0)
+                ::close(m_ringDescriptor);
+
+            m_pSubmissionEntries = static_cast<io_uring_sqe*>(MAP_FAILED);
+            m_pCompletionRing = m_pSubmissionRing = MAP_FAILED;
+            m_ringDescriptor = -1;
+        }
+
+        void queue(uint8_t opcode, size_t slot, uint8_t* pBuffer, size_t size, uint64_t offset)
+        {
+            const unsigned tail = *m_pSubmissionTail;
+            invariant_throw(tail - __atomic_load_n(m_pSubmissionHead, __ATOMIC_ACQUIRE) < m_submissionEntryCount,
+                std::runtime_error("io_uring submission queue overflowed."));
+
+            const unsigned index = tail & m_submissionMask;
+            io_uring_sqe& entry = m_pSubmissionEntries[index];
+            memset(&entry, 0, sizeof(entry));
+            entry.opcode = opcode;
+            entry.fd = m_fileDescriptor;
+            entry.addr = reinterpret_cast<uint64_t>(pBuffer);
+            entry.len = static_cast<uint32_t>(size);
+            entry.off = offset;
+            entry.buf_index = static_cast<uint16_t>(slot);
+            entry.user_data = slot;
+
+            m_pSubmissionArray[index] = index;
+            __atomic_store_n(m_pSubmissionTail, tail + 1, __ATOMIC_RELEASE);
+            ++m_pendingCount;
+        }
+
+        int m_ringDescriptor;
+        int m_fileDescriptor;
+
+        void* m_pSubmissionRing;
+        size_t m_submissionRingSize;
+        void* m_pCompletionRing;
+        size_t m_completionRingSize;
+        io_uring_sqe* m_pSubmissionEntries;
+        size_t m_submissionEntriesSize;
+
+        unsigned* m_pSubmissionHead;
+        unsigned* m_pSubmissionTail;
+        unsigned* m_pSubmissionArray;
+        unsigned m_submissionMask;
+        unsigned m_submissionEntryCount;
+
+        unsigned* m_pCompletionHead;
+        unsigned* m_pCompletionTail;
+        io_uring_cqe* m_pCompletionEntries;
+        unsigned m_completionMask;
+
+        // Requests queued but not yet handed to the kernel.
+        unsigned m_pendingCount;
+    };
+
+#endif
+
+    std::unique_ptr<IOEngine> createEngine(PositionalFile& file, std::vector<uint8_t>& buffers,
+        size_t slotCount, size_t blockSize, AsyncIOBackend backend)
+    {
+#if defined(STLREPAIR_ASYNCFILEIO_HAS_IO_URING)
+        if (backend != AsyncIOBackend::THREAD_POOL)
+        {
+            try
+            {
+                return std::make_unique<IOUringEngine>(file.getHandle(), buffers.data(), slotCount, blockSize);
+            }
+            catch (const std::runtime_error&)
+            {
+                if (backend == AsyncIOBackend::IO_URING)
+                    throw;
+            }
+        }
+#else
+        if (backend == AsyncIOBackend::IO_URING)
+            throw std::runtime_error("io_uring isn't available on this platform.");
+#endif
+
+        return std::make_unique<ThreadPoolEngine>(file, std::min(slotCount, MAXIMUM_IO_THREAD_COUNT));
+    }
+
+    size_t clampQueueDepth(size_t queueDepth)
+    {
+        return std::min(std::max<size_t>(queueDepth, 1), MAXIMUM_ASYNC_IO_QUEUE_DEPTH);
+    }
+
+    /**
+     * Reads ahead sequentially with up to queueDepth block-sized reads in
+     * flight. Block n of the read-ahead always lives in slot n % queueDepth.
+     */
+    class AsyncFileByteSource : public ByteSource
+    {
+    public:
+
+        AsyncFileByteSource(const std::string& filepath, const AsyncIOOptions& options) :
+            m_file(filepath, PositionalFileMode::READ),
+            m_blockSize(std::max<size_t>(options.m_blockSize, 1)),
+            m_slots(clampQueueDepth(options.m_queueDepth)),
+            m_buffers(m_slots.size() * m_blockSize),
+            m_inFlightCount(0)
+        {
+            m_spEngine = createEngine(m_file, m_buffers, m_slots.size(), m_blockSize, options.m_backend);
+            reset(0);
+        }
+
+        ~AsyncFileByteSource()
+        {
+            try
+            {
+                drain();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        size_t read(uint8_t* pBuffer, size_t size) override
+        {
+            size_t bytesRead = 0;
+
+            while (bytesRead < size)
+            {
+                if (m_hasCurrentBlock)
+                {
+                    const Slot& slot = getSlot(m_currentBlock);
+                    if (m_currentBlockOffset < slot.m_size)
+                    {
+                        const size_t bytesToCopy = std::min(size - bytesRead, slot.m_size - m_currentBlockOffset);
+                        memcpy(pBuffer + bytesRead, getBuffer(m_currentBlock) + m_currentBlockOffset, bytesToCopy);
+                        m_currentBlockOffset += bytesToCopy;
+                        bytesRead += bytesToCopy;
+                        continue;
+                    }
+
+                    // A short block can only be the last one.
+                    m_isEndOfData = (slot.m_size < m_blockSize);
+                    m_hasCurrentBlock = false;
+                    ++m_currentBlock;
+                }
+
+                if (m_isEndOfData)
+                    break;
+
+                submitReads();
+                while (getSlot(m_currentBlock).m_isInFlight)
+                    handleCompletion(m_spEngine->waitForCompletion());
+
+                const Slot& slot = getSlot(m_currentBlock);
+                if (slot.m_error != 0)
+                {
+                    m_isEndOfData = true;
+                    throw std::runtime_error("Error reading from file - " + describeError(slot.m_error));
+                }
+
+                m_hasCurrentBlock = true;
+                m_currentBlockOffset = 0;
+            }
+
+            return bytesRead;
+        }
+
+        bool seek(uint64_t offset) override
+        {
+            drain();
+            reset(offset);
+            return true;
+        }
+
+    private:
+
+        struct Slot
+        {
+            size_t m_size = 0;
+            int m_error = 0;
+            bool m_isInFlight = false;
+        };
+
+        Slot& getSlot(uint64_t block) { return m_slots[block % m_slots.size()]; }
+        uint8_t* getBuffer(uint64_t block) { return m_buffers.data() + (block % m_slots.size()) * m_blockSize; }
+
+        void reset(uint64_t offset)
+        {
+            m_startOffset = offset;
+            m_currentBlock = 0;
+            m_nextBlockToSubmit = 0;
+            m_currentBlockOffset = 0;
+            m_hasCurrentBlock = false;
+            m_isEndOfData = false;
+            m_hasFoundEnd = false;
+        }
+
+        // Keeps every slot not being consumed busy with a read further ahead.
+        void submitReads()
+        {
+            while (!m_hasFoundEnd && (m_nextBlockToSubmit < m_currentBlock + m_slots.size()))
+            {
+                Slot& slot = getSlot(m_nextBlockToSubmit);
+                slot = Slot();
+                slot.m_isInFlight = true;
+                submitRemainder(m_nextBlockToSubmit);
+                ++m_nextBlockToSubmit;
+            }
+
+            m_spEngine->flush();
+        }
+
+        void submitRemainder(uint64_t block)
+        {
+            const Slot& slot = getSlot(block);
+            m_spEngine->submitRead(block % m_slots.size(), getBuffer(block) + slot.m_size,
+                m_blockSize - slot.m_size, m_startOffset + block * m_blockSize + slot.m_size);
+            ++m_inFlightCount;
+        }
+
+        void handleCompletion(const Completion& completion)
+        {
+            --m_inFlightCount;
+
+            // Work out which block the slot holds. It's the only one in the
+            // window [m_currentBlock, m_nextBlockToSubmit) that maps to it.
+            const uint64_t block = m_currentBlock +
+                (completion.m_slot + m_slots.size() - m_currentBlock % m_slots.size()) % m_slots.size();
+            Slot& slot = getSlot(block);
+
+            if (completion.m_result < 0)
+            {
+                slot.m_error = static_cast<int>(-completion.m_result);
+                slot.m_isInFlight = false;
+                m_hasFoundEnd = true;
+                return;
+            }
+
+            slot.m_size += static_cast<size_t>(completion.m_result);
+            if (completion.m_result == 0)
+            {
+                slot.m_isInFlight = false;
+                m_hasFoundEnd = true;
+            }
+            else if (slot.m_size < m_blockSize)
+            {
+                // Short read. Either we've hit the end, in which case the
+                // next attempt comes back empty, or the kernel just felt
+                // like it.
+                submitRemainder(block);
+                m_spEngine->flush();
+            }
+            else
+            {
+                slot.m_isInFlight = false;
+            }
+        }
+
+        void drain()
+        {
+            while (m_inFlightCount > 0)
+            {
+                // Anything still in flight is unwanted, so don't chase short
+                // reads. Just wait them out.
+                Completion completion = m_spEngine->waitForCompletion();
+                --m_inFlightCount;
+                m_slots[completion.m_slot].m_isInFlight = false;
+            }
+        }
+
+        PositionalFile m_file;
+        const size_t m_blockSize;
+        std::vector<Slot> m_slots;
+        std::vector<uint8_t> m_buffers;
+        std::unique_ptr<IOEngine> m_spEngine;
+        size_t m_inFlightCount;
+
+        uint64_t m_startOffset;
+        uint64_t m_currentBlock;
+        uint64_t m_nextBlockToSubmit;
+        size_t m_currentBlockOffset;
+        bool m_hasCurrentBlock;
+        bool m_isEndOfData;
+        bool m_hasFoundEnd;
+    };
+
+    /**
+     * Gathers writes into block-sized chunks and keeps up to queueDepth of
+     * them in flight. Block n always lives in slot n % queueDepth.
+     */
+    class AsyncFileByteSink : public ByteSink
+    {
+    public:
+
+        AsyncFileByteSink(const std::string& filepath, const AsyncIOOptions& options) :
+            m_file(filepath, PositionalFileMode::WRITE),
+            m_blockSize(std::max<size_t>(options.m_blockSize, 1)),
+            m_slots(clampQueueDepth(options.m_queueDepth)),
+            m_buffers(m_slots.size() * m_blockSize),
+            m_inFlightCount(0),
+            m_currentBlock(0),
+            m_currentBlockSize(0),
+            m_error(0),
+            m_isClosed(false)
+        {
+            m_spEngine = createEngine(m_file, m_buffers, m_slots.size(), m_blockSize, options.m_backend);
+        }
+
+        ~AsyncFileByteSink()
+        {
+            try
+            {
+                close();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        void write(const uint8_t* pData, size_t size) override
+        {
+            invariant_throw(!m_isClosed, std::runtime_error("Sink already closed!"));
+            throwIfFailed();
+
+            while (size > 0)
+            {
+                if (m_currentBlockSize == m_blockSize)
+                    submitCurrentBlock();
+
+                const size_t bytesToCopy = std::min(size, m_blockSize - m_currentBlockSize);
+                memcpy(getBuffer(m_currentBlock) + m_currentBlockSize, pData, bytesToCopy);
+                m_currentBlockSize += bytesToCopy;
+                pData += bytesToCopy;
+                size -= bytesToCopy;
+            }
+        }
+
+        void close() override
+        {
+            if (m_isClosed)
+                return;
+            m_isClosed = true;
+
+            if ((m_currentBlockSize > 0) && (m_error == 0))
+                submitCurrentBlock();
+
+            while (m_inFlightCount > 0)
+                handleCompletion(m_spEngine->waitForCompletion());
+
+            throwIfFailed();
+            m_file.close();
+        }
+
+    private:
+
+        struct Slot
+        {
+            uint64_t m_offset = 0;
+            size_t m_size = 0;
+            size_t m_bytesWritten = 0;
+            bool m_isInFlight = false;
+        };
+
+        uint8_t* getBuffer(uint64_t block) { return m_buffers.data() + (block % m_slots.size()) * m_blockSize; }
+
+        void submitCurrentBlock()
+        {
+            const size_t slotIndex = m_currentBlock % m_slots.size();
+            Slot& slot = m_slots[slotIndex];
+            slot.m_offset = m_currentBlock * m_blockSize;
+            slot.m_size = m_currentBlockSize;
+            slot.m_bytesWritten = 0;
+            slot.m_isInFlight = true;
+            submitRemainder(slotIndex);
+            m_spEngine->flush();
+
+            ++m_currentBlock;
+            m_currentBlockSize = 0;
+
+            // The next block's slot may still be busy with an earlier write.
+            while (m_slots[m_currentBlock % m_slots.size()].m_isInFlight)
+                handleCompletion(m_spEngine->waitForCompletion());
+            throwIfFailed();
+        }
+
+        void submitRemainder(size_t slotIndex)
+        {
+            const Slot& slot = m_slots[slotIndex];
+            m_spEngine->submitWrite(slotIndex, m_buffers.data() + slotIndex * m_blockSize + slot.m_bytesWritten,
+                slot.m_size - slot.m_bytesWritten, slot.m_offset + slot.m_bytesWritten);
+            ++m_inFlightCount;
+        }
+
+        void handleCompletion(const Completion& completion)
+        {
+            --m_inFlightCount;
+            Slot& slot = m_slots[completion.m_slot];
+
+            if (completion.m_result <= 0)
+            {
+                // A write that makes no progress at all isn't going to
+                // start making progress if we ask again.
+                if (m_error == 0)
+                    m_error = (completion.m_result < 0) ? static_cast<int>(-completion.m_result) : EIO;
+                slot.m_isInFlight = false;
+                return;
+            }
+
+            slot.m_bytesWritten += static_cast<size_t>(completion.m_result);
+            if ((slot.m_bytesWritten < slot.m_size) && (m_error == 0))
+            {
+                submitRemainder(completion.m_slot);
+                m_spEngine->flush();
+            }
+            else
+            {
+                slot.m_isInFlight = false;
+            }
+        }
+
+        void throwIfFailed()
+        {
+            if (m_error != 0)
+                throw std::runtime_error("Error writing to file - " + describeError(m_error));
+        }
+
+        PositionalFile m_file;
+        const size_t m_blockSize;
+        std::vector<Slot> m_slots;
+        std::vector<uint8_t> m_buffers;
+        std::unique_ptr<IOEngine> m_spEngine;
+        size_t m_inFlightCount;
+
+        uint64_t m_currentBlock;
+        size_t m_currentBlockSize;
+        int m_error;
+        bool m_isClosed;
+    };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AsyncIOOptions::AsyncIOOptions() :
+    m_isEnabled(false),
+    m_backend(AsyncIOBackend::AUTOMATIC),
+    m_queueDepth(DEFAULT_ASYNC_IO_QUEUE_DEPTH),
+    m_blockSize(DEFAULT_ASYNC_IO_BLOCK_SIZE)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool isIOUringSupported()
+{
+#if defined(STLREPAIR_ASYNCFILEIO_HAS_IO_URING)
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ringDescriptor = ioUringSetup(1, &params);
+    if (ringDescriptor < 0)
+        return false;
+
+    ::close(ringDescriptor);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSource> openAsyncFileByteSource(const std::string& filepath,
+    const AsyncIOOptions& options)
+{
+    return std::make_unique<AsyncFileByteSource>(filepath, options);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSink> createAsyncFileByteSink(const std::string& filepath,
+    const AsyncIOOptions& options)
+{
+    return std::make_unique<AsyncFileByteSink>(filepath, options);
+}
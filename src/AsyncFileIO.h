@@ -0,0 +1,82 @@
+#ifndef STLREPAIR_ASYNCFILEIO__H_
+#define STLREPAIR_ASYNCFILEIO__H_
+
+#include "ByteStream.h"
+
+#include <memory>
+#include <string>
+#include <cstddef>
+
+/**
+ * Default number of reads or writes kept in flight at once.
+ */
+constexpr const size_t DEFAULT_ASYNC_IO_QUEUE_DEPTH = 16;
+
+/**
+ * Default size of each read or write.
+ */
+constexpr const size_t DEFAULT_ASYNC_IO_BLOCK_SIZE = 256 * 1024;
+
+/**
+ * Largest queue depth we'll honour. Anything bigger is clamped.
+ */
+constexpr const size_t MAXIMUM_ASYNC_IO_QUEUE_DEPTH = 1024;
+
+/**
+ * How asynchronous file I/O actually gets done.
+ */
+enum class AsyncIOBackend
+{
+    AUTOMATIC,   //!< io_uring if the kernel supports it, the thread pool otherwise.
+    IO_URING,    //!< io_uring or nothing. Linux only.
+    THREAD_POOL  //!< Positional reads and writes on a small pool of threads.
+};
+
+/**
+ * Settings for asynchronous file I/O.
+ */
+struct AsyncIOOptions
+{
+    //! Constructor. Sets everything to its default.
+    AsyncIOOptions();
+
+    //! Whether the reader and writer should use asynchronous I/O at all.
+    bool m_isEnabled;
+
+    AsyncIOBackend m_backend;
+
+    //! Number of reads or writes in flight at once.
+    size_t m_queueDepth;
+
+    //! Size of each read or write, in bytes.
+    size_t m_blockSize;
+};
+
+/**
+ * Returns true if the running kernel lets us set up an io_uring. Always
+ * false on anything other than Linux.
+ */
+bool isIOUringSupported();
+
+/**
+ * Opens a file for reading with multiple reads kept in flight, so the device
+ * queue never runs dry. Data is read ahead sequentially from the current
+ * position, so this suits streaming through a file from start to end.
+ *
+ * @throws std::runtime_error if the file can't be opened, or if io_uring
+ *         was asked for explicitly and isn't available.
+ */
+std::unique_ptr<ByteSource> openAsyncFileByteSource(const std::string& filepath,
+    const AsyncIOOptions& options);
+
+/**
+ * Creates (or truncates) a file for writing with multiple writes kept in
+ * flight. Write errors are reported from a later write() or from close().
+ *
+ * @throws std::runtime_error if the file can't be created, or if io_uring
+ *         was asked for explicitly and isn't available.
+ */
+std::unique_ptr<ByteSink> createAsyncFileByteSink(const std::string& filepath,
+    const AsyncIOOptions& options);
+
+#endif
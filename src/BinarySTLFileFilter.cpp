@@ -1,113 +1,190 @@
 #include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "PipelinedByteStream.h"
 #include "Contracts.h"
 
+#include <algorithm>
 #include <stdexcept>
-#include <iterator>
-#include <cstring>
+
+namespace
+{
+    /**
+     * ByteSink that throws away everything but the start of the file, and
+     * keeps that up to date as it's patched.
+     */
+    class FileStartByteSink : public ByteSink
+    {
+    public:
+
+        FileStartByteSink(STLBinaryHeader& header, uint32_t& triangleCount) :
+            m_header(header),
+            m_triangleCount(triangleCount),
+            m_size(0)
+        {
+        }
+
+        void write(const uint8_t* pData, size_t size) override
+        {
+            copyIntoStart(m_size, pData, size);
+            m_size += size;
+        }
+
+        bool patch(uint64_t offset, const uint8_t* pData, size_t size) override
+        {
+            copyIntoStart(offset, pData, size);
+            return true;
+        }
+
+        void close() override {}
+
+    private:
+
+        void copyIntoStart(uint64_t offset, const uint8_t* pData, size_t size)
+        {
+            const uint64_t headerEnd = BINARY_STL_HEADER_SIZE_IN_BYTES;
+            const uint64_t countEnd = headerEnd + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+            for (uint64_t position = offset; (position < offset + size) && (position < countEnd); ++position)
+            {
+                const uint8_t byte = pData[position - offset];
+                if (position < headerEnd)
+                    m_header[static_cast<size_t>(position)] = byte;
+                else
+                    reinterpret_cast<uint8_t*>(&m_triangleCount)[position - headerEnd] = byte;
+            }
+        }
+
+        STLBinaryHeader& m_header;
+        uint32_t& m_triangleCount;
+        uint64_t m_size;
+    };
+}
 
 /**
  * @since 2024 Feb 04
  */
 BinarySTLFileFilter::BinarySTLFileFilter(const std::string& outputFilePath) :
+    FilterChain(outputFilePath),
     m_zeroOutHeader(false),
     m_updateTriangleCount(false),
     m_zeroAttributeByteCounts(false),
     m_clearExtraFileData(false),
 	m_triangleLimit(0),
-    m_outputFilePath(outputFilePath),
-    m_readTriangleCount(0),
-    m_actualTriangleCount(0)
+    m_sortByMortonCode(false),
+    m_stampPayloadDigest(false),
+    m_writeOnBackgroundThread(false),
+    m_bypassPageCache(false),
+    m_outputCompression(CompressionFormat::NONE),
+    m_hasBuiltInStages(false)
 {
-    precondition_throw(!outputFilePath.empty(), std::runtime_error("Output filename cannot be empty."));
-
-    // Zero out the header. If m_zeroOutHeader == true, we'll
-    // just write this out as is.
-    memset(m_header.data(), 0, m_header.size());
 }
 
 /**
  * @since 2024 Feb 04
  */
-void BinarySTLFileFilter::onReadEnd()
+bool BinarySTLFileFilter::onReadFileHeader(const STLBinaryHeader& header)
 {
-    precondition_throw(m_spWriter != nullptr,
-        std::runtime_error("No output file opened for writing."));
-
-    if (!m_xtraData.empty())
-        m_spWriter->finalize(m_xtraData.data(), m_xtraData.size());
-    else
-        m_spWriter->finalize();
-
-    if (m_updateTriangleCount)
+    if (!m_hasBuiltInStages)
     {
-        FILE* pFile = fopen(m_outputFilePath.c_str(), "rb+");
-        if (!pFile)
-            throw std::runtime_error("Could not update output file triangle count.");
-
-        fseek(pFile, BINARY_STL_HEADER_SIZE_IN_BYTES, SEEK_SET);
-        fwrite(&m_actualTriangleCount, 1, sizeof(m_actualTriangleCount), pFile);
-        fclose(pFile);
+        insertBuiltInStages();
+        m_hasBuiltInStages = true;
     }
+
+    return FilterChain::onReadFileHeader(header);
 }
 
 /**
- * @since 2024 Feb 04
+ * @since 2026 Oct 19
  */
-bool BinarySTLFileFilter::onReadFileHeader(const STLBinaryHeader& header)
+RepairOptions BinarySTLFileFilter::getRepairOptions() const
 {
-    if (!m_zeroOutHeader)
-        m_header = header;
-
-    return true;
+    RepairOptions options;
+    options.m_zeroOutHeader = m_zeroOutHeader;
+    options.m_updateTriangleCount = m_updateTriangleCount;
+    options.m_zeroAttributeByteCounts = m_zeroAttributeByteCounts;
+    options.m_clearExtraFileData = m_clearExtraFileData;
+    options.m_triangleLimit = m_triangleLimit;
+    options.m_sortByMortonCode = m_sortByMortonCode;
+    options.m_transform = m_transform;
+    options.m_stampPayloadDigest = m_stampPayloadDigest;
+    return options;
 }
 
 /**
- * @since 2024 Feb 04
+ * @since 2026 Oct 19
  */
-bool BinarySTLFileFilter::onReadTriangleCount(const uint32_t triangleCount)
+void BinarySTLFileFilter::setFileStart(const STLBinaryHeader& header, uint32_t triangleCount)
 {
-    m_spWriter = std::make_unique<BinarySTLFileWriter>(
-        m_outputFilePath, m_header, triangleCount);
+    precondition_throw(!m_hasBuiltInStages, std::runtime_error("The file start must be set before reading starts."));
 
-    m_readTriangleCount = triangleCount;
-
-    return true;
+    m_spFileStartStage = std::make_unique<FileStartStage>(header, triangleCount);
 }
 
 /**
- * @since 2024 Feb 04
+ * @since 2026 Oct 19
  */
-bool BinarySTLFileFilter::onReadTriangle(const STLBinaryTriangleData& triangleData,
-    uint16_t attributeByteCount)
+std::unique_ptr<ByteSink> BinarySTLFileFilter::createSink(const std::string& outputFilePath)
 {
-    precondition_throw(m_spWriter != nullptr,
-        std::runtime_error("No output file opened for writing."));
+    std::unique_ptr<ByteSink> spSink;
+    if (m_asyncIO.m_isEnabled)
+        spSink = createAsyncFileByteSink(outputFilePath, m_asyncIO);
+    else if (m_bypassPageCache)
+        spSink = createDirectFileByteSink(outputFilePath);
+    else
+        spSink = FilterChain::createSink(outputFilePath);
 
-    if ((m_triangleLimit > 0) && (m_actualTriangleCount >= m_triangleLimit))
-        return true;
+    if (m_outputCompression != CompressionFormat::NONE)
+        spSink = createCompressingByteSink(std::move(spSink), m_outputCompression);
 
-    if (m_zeroAttributeByteCounts)
-        m_spWriter->writeTriangleData(triangleData, 0);
-    else
-        m_spWriter->writeTriangleData(triangleData, attributeByteCount);
+    // Compressing on the filter's thread would hold it up far more than
+    // the writes ever do.
+    if (m_writeOnBackgroundThread || (m_outputCompression != CompressionFormat::NONE))
+        spSink = std::make_unique<AsyncByteSink>(std::move(spSink));
 
-    ++m_actualTriangleCount;
+    return spSink;
+}
 
-    return true;
+/**
+ * @since 2026 Oct 19
+ */
+bool BinarySTLFileFilter::canReopenOutputFile() const
+{
+    return m_outputCompression == CompressionFormat::NONE;
 }
 
 /**
- * @since 2024 Feb 04
+ * @since 2026 Oct 19
  */
-bool BinarySTLFileFilter::onReadUnknownData(const uint8_t* const pData, const size_t dataSize)
+void BinarySTLFileFilter::insertBuiltInStages()
 {
-    precondition_throw(m_spWriter != nullptr,
-        std::runtime_error("No output file opened for writing."));
+    RepairOptions options = getRepairOptions();
+    options.m_stampPayloadDigest = false;
+
+    std::vector<std::unique_ptr<FilterStage>> stages = createBuiltInStages(options);
+    for (size_t i = 0; i < stages.size(); ++i)
+        insertStage(i, std::move(stages[i]));
 
-    if (m_clearExtraFileData)
-        return true;
+    // The digest has to see what's actually written, so it goes after any
+    // stages added with addStage(). Only the file start, which leaves the
+    // triangles alone, comes after it.
+    if (m_stampPayloadDigest)
+        insertStage(getStageCount(), std::make_unique<PayloadDigestStage>());
+
+    if (m_spFileStartStage)
+        insertStage(getStageCount(), std::move(m_spFileStartStage));
+}
 
-    std::copy(pData, pData + dataSize, std::back_inserter(m_xtraData));
+/**
+ * @since 2026 Oct 19
+ */
+void predictFileStart(const std::string& inputFile, const RepairOptions& options,
+    STLBinaryHeader& header, uint32_t& triangleCount)
+{
+    FilterChain chain(std::make_unique<FileStartByteSink>(header, triangleCount));
+    for (auto& spStage : createBuiltInStages(options))
+        chain.addStage(std::move(spStage));
 
-    return true;
+    BinarySTLFileReader reader(inputFile);
+    reader.setResynchronizationEnabled(options.m_resynchronize);
+    reader.readFile(chain);
 }
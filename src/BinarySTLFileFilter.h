@@ -1,8 +1,12 @@
 #ifndef STLREPAIR_BINARYSTLFILEFILTER__H_
 #define STLREPAIR_BINARYSTLFILEFILTER__H_
 
-#include "BinarySTLFileReader.h"
-#include "BinarySTLFileWriter.h"
+#include "FilterChain.h"
+#include "FilterStages.h"
+#include "AffineTransform.h"
+#include "AsyncFileIO.h"
+#include "DirectFileIO.h"
+#include "CompressedByteStream.h"
 
 #include <string>
 #include <memory>
@@ -13,45 +17,36 @@
  * This class serves to filter/modify STL data produced from a
  * BinarySTLFileReader and write it back out to disk.
  *
- * At this moment, this works as a monolithic filter class. But
- * in the future, as needs get more sophisticated, I could
- * envision breaking it up into a more traditional pipe-filter
- * oriented design.
+ * It's a FilterChain whose built-in stages are switched on by the public
+ * flags below, so the flags have to be set before reading starts. The
+ * built-in stages come first, ahead of any added with addStage(), apart
+ * from the payload digest, which goes after them so it hashes exactly what's
+ * written.
  */
-class BinarySTLFileFilter : public BinarySTLFileReaderListener
+class BinarySTLFileFilter : public FilterChain
 {
 public:
 
     //! Constructor.
     BinarySTLFileFilter(const std::string& outputFilePath);
 
-    //! Called whenever parsing ends. Guaranteed to be called even in the event of errors.
-    void onReadEnd() override;
-
-    //! Called whenever the file header is parsed.
-    bool onReadFileHeader(const STLBinaryHeader &header) override;
-
-    //! Called whenever the total triangle count has been parsed.
-    bool onReadTriangleCount(const uint32_t triangleCount) override;
-
     /**
-     * Called whenever a triangle has been read.
-     * Note that we don't currently need to tease apart the triangle data for
-     * this app. We only need to treat it as a binary blob. This may change
-     * in the future.
+     * Called whenever the file header is parsed. This is where the built-in
+     * stages get added.
      */
-    bool onReadTriangle(const STLBinaryTriangleData& triangleData,
-        const uint16_t attributeByteCount) override;
+    bool onReadFileHeader(const STLBinaryHeader &header) override;
+
+    //! Returns the repairs the public flags below ask for.
+    RepairOptions getRepairOptions() const;
 
     /**
-     * Called whenever a blob of unknown data is encountered. This usually
-     * happens near the end of a file which has truncated triangle data or
-     * an exporter has tacked something else on to the end.
-     *
-     * Regardless of why, it basically indicates the data isn't the same size as
-     * triangle data.
+     * Makes the header and triangle count at the start of the output the
+     * given ones from the outset, so the file never has to be patched
+     * afterwards. They have to be what the repair would have come to
+     * anyway (see predictFileStart()), or the read ends with an error.
+     * Must be called before reading starts.
      */
-    bool onReadUnknownData(const uint8_t* const pData, const size_t dataSize) override;
+    void setFileStart(const STLBinaryHeader& header, uint32_t triangleCount);
 
     bool m_zeroOutHeader;
     bool m_updateTriangleCount;
@@ -59,15 +54,79 @@ public:
     bool m_clearExtraFileData;
     uint32_t m_triangleLimit;
 
+    /**
+     * If true, triangles are held back until the end of the read and then
+     * written in Morton order of their centroids. Spatially close triangles
+     * end up close together in the file, which is much kinder to the caches
+     * of whatever loads it next.
+     */
+    bool m_sortByMortonCode;
+
+    /**
+     * Applied to every triangle on its way through. Defaults to the
+     * identity, in which case triangles are passed through untouched.
+     */
+    AffineTransform m_transform;
+
+    /**
+     * If true, a digest of the facet records is worked out as they're
+     * written and stamped into the header, replacing whatever was there.
+     * See verifyPayloadDigest().
+     */
+    bool m_stampPayloadDigest;
+
+    /**
+     * If true, the actual disk writes happen on a background thread (see
+     * AsyncByteSink), so filtering doesn't stall on them. The output is the
+     * same either way.
+     */
+    bool m_writeOnBackgroundThread;
+
+    /**
+     * If m_asyncIO.m_isEnabled is true, the output file is written with
+     * several writes in flight at once (io_uring where available). Combines
+     * with m_writeOnBackgroundThread.
+     */
+    AsyncIOOptions m_asyncIO;
+
+    /**
+     * If true, the output file is written with direct I/O, so it doesn't
+     * push everything else out of the page cache. Ignored if
+     * m_asyncIO.m_isEnabled is true.
+     */
+    bool m_bypassPageCache;
+
+    /**
+     * If not NONE, the output is compressed as it's written, on a background
+     * thread. A compressed file can't be patched, so if the repair changes
+     * the header or triangle count at the end, setFileStart() has to be
+     * called first.
+     */
+    CompressionFormat m_outputCompression;
+
+protected:
+
+    std::unique_ptr<ByteSink> createSink(const std::string& outputFilePath) override;
+    bool canReopenOutputFile() const override;
+
 private:
 
-    std::string m_outputFilePath;
-    STLBinaryHeader m_header;
-    std::unique_ptr<BinarySTLFileWriter> m_spWriter;
-    uint32_t m_readTriangleCount;
-    uint32_t m_actualTriangleCount;
+    void insertBuiltInStages();
 
-    std::vector<char> m_xtraData;
+    bool m_hasBuiltInStages;
+    std::unique_ptr<FileStartStage> m_spFileStartStage;
 };
 
+/**
+ * Works out the header and triangle count a repair with the given options
+ * would leave at the start of its output, by running it over the input
+ * without keeping anything else. That's another read of the input, so it's
+ * only worth it for outputs that can't be patched afterwards, like
+ * compressed ones. See BinarySTLFileFilter::setFileStart().
+ *
+ * @throws std::runtime_error if the input can't be read.
+ */
+void predictFileStart(const std::string& inputFile, const RepairOptions& options,
+    STLBinaryHeader& header, uint32_t& triangleCount);
+
 #endif
@@ -1,18 +1,59 @@
 #include "BinarySTLFileReader.h"
+#include "RecordPlausibility.h"
+#include "FacetReader.h"
+#include "CompressedByteStream.h"
 #include "FileUtils.h"
 #include "Contracts.h"
 #include "CallGuard.h"
+#include "Stats.h"
+#include "TraceRecorder.h"
 
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 #include <cstring>
 
+namespace
+{
+    const size_t TRIANGLE_RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+
+    // Size of the reader's internal buffer. Large enough that reads are
+    // cheap, small enough not to matter.
+    const size_t READ_BUFFER_SIZE = 1024 * 1024;
+
+    // Number of records after a candidate boundary that must also look like
+    // real triangles before we believe it.
+    const size_t RESYNC_LOOKAHEAD_RECORDS = 8;
+
+    // How much data to look at per pass when scanning for a record boundary.
+    const size_t RESYNC_SCAN_WINDOW_SIZE = 64 * 1024;
+
+    const size_t NO_RECORD_BOUNDARY = static_cast<size_t>(-1);
+
+    bool seekTo(FILE* pFile, std::uintmax_t offset)
+    {
+#if defined(_WIN32)
+        return _fseeki64(pFile, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+        return fseeko(pFile, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+}
+
 /**
  * @since 2024 Jan 21
  */
 BinarySTLFileReader::BinarySTLFileReader(const std::string& filepath) :
-    m_pFile(nullptr),
     m_totalTriangleCount(0),
-    m_currTriangleIndex(0)
+    m_currTriangleIndex(0),
+    m_buffer(READ_BUFFER_SIZE),
+    m_bufferBegin(0),
+    m_bufferEnd(0),
+    m_bufferFileOffset(0),
+    m_isEndOfFile(false),
+    m_isResynchronizationEnabled(false),
+    m_isResynchronizing(false),
+    m_verifiedRecordCount(0)
 {
     if (filepath.empty())
         throw std::runtime_error("STL path cannot be empty.");
@@ -20,12 +61,36 @@ BinarySTLFileReader::BinarySTLFileReader(const std::string& filepath) :
     if (!FileUtils::fileExists(filepath))
         throw std::runtime_error("Specified STL file does not exist - " + filepath);
 
+    // How much a compressed file holds isn't known until it's been read.
+    if (detectCompressionFormat(filepath) != CompressionFormat::NONE)
+    {
+        m_spSource = openCompressedFileByteSource(filepath);
+        return;
+    }
+
     if (FileUtils::getFileSize(filepath) < MINIMUM_BINARY_STL_SIZE_IN_BYTES)
         throw std::runtime_error("Specified file too small to be a binary STL - " + filepath);
 
-    m_pFile = fopen(filepath.c_str(), "rb");
-    if (!m_pFile)
-        throw std::runtime_error("Unknown error when opening " + filepath);
+    m_spSource = std::make_unique<FileByteSource>(filepath);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+BinarySTLFileReader::BinarySTLFileReader(std::unique_ptr<ByteSource> spSource) :
+    m_spSource(std::move(spSource)),
+    m_totalTriangleCount(0),
+    m_currTriangleIndex(0),
+    m_buffer(READ_BUFFER_SIZE),
+    m_bufferBegin(0),
+    m_bufferEnd(0),
+    m_bufferFileOffset(0),
+    m_isEndOfFile(false),
+    m_isResynchronizationEnabled(false),
+    m_isResynchronizing(false),
+    m_verifiedRecordCount(0)
+{
+    precondition_throw(m_spSource != nullptr, std::runtime_error("STL source cannot be null."));
 }
 
 /**
@@ -33,8 +98,6 @@ BinarySTLFileReader::BinarySTLFileReader(const std::string& filepath) :
  */
 BinarySTLFileReader::~BinarySTLFileReader()
 {
-    if (m_pFile)
-        fclose(m_pFile);
 }
 
 /**
@@ -42,22 +105,102 @@ BinarySTLFileReader::~BinarySTLFileReader()
  */
 void BinarySTLFileReader::readFile(BinarySTLFileReaderListener& listener)
 {
-    invariant_throw(m_pFile != nullptr, "File not opened for reading!");
+    readFrom(listener, nullptr);
+}
 
-    fseek(m_pFile, 0, SEEK_SET);
+/**
+ * @since 2026 Oct 19
+ */
+void BinarySTLFileReader::resumeFile(BinarySTLFileReaderListener& listener,
+    const BinarySTLFileReaderCheckpoint& checkpoint)
+{
+    readFrom(listener, &checkpoint);
+}
 
+/**
+ * @since 2026 Oct 19
+ */
+BinarySTLFileReaderCheckpoint BinarySTLFileReader::getCheckpoint() const
+{
+    BinarySTLFileReaderCheckpoint checkpoint;
+    checkpoint.m_fileOffset = m_bufferFileOffset + m_bufferBegin;
+    checkpoint.m_triangleIndex = m_currTriangleIndex;
+    checkpoint.m_isResynchronizing = m_isResynchronizing;
+    checkpoint.m_verifiedRecordCount = m_verifiedRecordCount;
+    checkpoint.m_seenBounds = m_seenBounds;
+    return checkpoint;
+}
+
+/**
+ * Reads the file from the start, or from the checkpoint if there is one.
+ *
+ * @since 2026 Oct 19
+ */
+void BinarySTLFileReader::readFrom(BinarySTLFileReaderListener& listener,
+    const BinarySTLFileReaderCheckpoint* pCheckpoint)
+{
+    invariant_throw(m_spSource != nullptr, "File not opened for reading!");
+    STLREPAIR_TRACE_SCOPE("read file", "reader");
+
+    if (!m_spSource->seek(0))
+        throw std::runtime_error("Could not seek to start of STL data.");
+    m_bufferBegin = 0;
+    m_bufferEnd = 0;
+    m_bufferFileOffset = 0;
+    m_isEndOfFile = false;
+    m_currTriangleIndex = 0;
+    m_isResynchronizing = m_isResynchronizationEnabled;
+    m_verifiedRecordCount = 0;
+    m_seenBounds = BoundingBox();
+
+    // If parsing fails, the listener still hears about the end. But it's
+    // too late for anything it throws then to go anywhere.
     bool cont = listener.onReadBegin();
-    auto parseEndGuard = makeCallGuard([&]() { listener.onReadEnd(); });
-    if (!cont)
-        return;
+    auto parseEndGuard = makeCallGuard([&]()
+    {
+        try
+        {
+            listener.onReadEnd();
+        }
+        catch (const std::exception&)
+        {
+        }
+    });
 
-    if (!readFileHeader(listener))
-        return;
+    if (cont && readFileHeader(listener) && readTriangleCount(listener))
+    {
+        if (pCheckpoint)
+        {
+            if ((pCheckpoint->m_triangleIndex > m_totalTriangleCount) ||
+                (pCheckpoint->m_fileOffset < BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES) ||
+                !m_spSource->seek(pCheckpoint->m_fileOffset))
+            {
+                throw std::runtime_error("Checkpoint doesn't match the STL data.");
+            }
 
-    if (!readTriangleCount(listener))
-        return;
+            m_bufferBegin = 0;
+            m_bufferEnd = 0;
+            m_bufferFileOffset = pCheckpoint->m_fileOffset;
+            m_isEndOfFile = false;
+            m_currTriangleIndex = pCheckpoint->m_triangleIndex;
+            m_isResynchronizing = pCheckpoint->m_isResynchronizing;
+            m_verifiedRecordCount = static_cast<size_t>(pCheckpoint->m_verifiedRecordCount);
+            m_seenBounds = pCheckpoint->m_seenBounds;
+        }
+
+        while (readTriangle(listener));
+    }
 
-    while (readTriangle(listener));
+    parseEndGuard.dismiss();
+    listener.onReadEnd();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void BinarySTLFileReader::setResynchronizationEnabled(bool enabled)
+{
+    m_isResynchronizationEnabled = enabled;
 }
 
 /**
@@ -68,10 +211,11 @@ bool BinarySTLFileReader::readFileHeader(BinarySTLFileReaderListener& listener)
     std::array<uint8_t, BINARY_STL_HEADER_SIZE_IN_BYTES> headerData;
     memset(headerData.data(), 0, headerData.size());
 
-    auto bytesRead = fread(headerData.data(), 1, headerData.size(), m_pFile);
-    if (bytesRead != headerData.size())
+    if (fillBuffer(headerData.size()) < headerData.size())
         throw std::runtime_error("Could not read file header.");
 
+    memcpy(headerData.data(), m_buffer.data() + m_bufferBegin, headerData.size());
+    consumeBuffer(headerData.size());
     return listener.onReadFileHeader(headerData);
 }
 
@@ -80,10 +224,11 @@ bool BinarySTLFileReader::readFileHeader(BinarySTLFileReaderListener& listener)
  */
 bool BinarySTLFileReader::readTriangleCount(BinarySTLFileReaderListener& listener)
 {
-    auto bytesRead = fread(&m_totalTriangleCount, 1, sizeof(m_totalTriangleCount), m_pFile);
-    if (bytesRead != sizeof(m_totalTriangleCount))
+    if (fillBuffer(sizeof(m_totalTriangleCount)) < sizeof(m_totalTriangleCount))
         throw std::runtime_error("Could not read triangle count.");
 
+    memcpy(&m_totalTriangleCount, m_buffer.data() + m_bufferBegin, sizeof(m_totalTriangleCount));
+    consumeBuffer(sizeof(m_totalTriangleCount));
     return listener.onReadTriangleCount(m_totalTriangleCount);
 }
 
@@ -95,43 +240,301 @@ bool BinarySTLFileReader::readTriangle(BinarySTLFileReaderListener& listener)
     STLBinaryTriangleData triangle;
     uint16_t attributeCount = 0;
 
-    unsigned char buffer[BINARY_STL_TRIANGLE_SIZE_IN_BYTES +
-        BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES];
-
-    auto bytesRead = fread(&buffer[0], 1, sizeof(buffer), m_pFile);
-    if (bytesRead <= 0)
+    auto bytesAvailable = fillBuffer(TRIANGLE_RECORD_SIZE);
+    if (bytesAvailable == 0)
         return false; // End of file.
 
-    if (bytesRead != sizeof(buffer))
-        return listener.onReadUnknownData(&buffer[0], bytesRead);
+    const uint8_t* pRecord = m_buffer.data() + m_bufferBegin;
+    if (bytesAvailable < TRIANGLE_RECORD_SIZE)
+    {
+        consumeBuffer(bytesAvailable);
+        return listener.onReadUnknownData(pRecord, bytesAvailable);
+    }
 
     if (m_currTriangleIndex >= m_totalTriangleCount)
-        return listener.onReadUnknownData(&buffer[0], bytesRead);
+    {
+        consumeBuffer(TRIANGLE_RECORD_SIZE);
+        return listener.onReadUnknownData(pRecord, TRIANGLE_RECORD_SIZE);
+    }
 
-    std::copy(&buffer[0], &buffer[0] + BINARY_STL_TRIANGLE_SIZE_IN_BYTES, triangle.data());
-    attributeCount = *(reinterpret_cast<uint16_t*>(&buffer[0] + BINARY_STL_TRIANGLE_SIZE_IN_BYTES));
+    if (m_isResynchronizing)
+    {
+        bool isAligned = true;
+        bool cont = checkAlignment(listener, isAligned);
+        if (!cont || !isAligned)
+            return cont;
+
+        // Checking may have moved things around in the buffer.
+        pRecord = m_buffer.data() + m_bufferBegin;
+    }
+
+    memcpy(triangle.data(), pRecord, triangle.size());
+    memcpy(&attributeCount, pRecord + BINARY_STL_TRIANGLE_SIZE_IN_BYTES, sizeof(attributeCount));
+    consumeBuffer(TRIANGLE_RECORD_SIZE);
     ++m_currTriangleIndex;
     return listener.onReadTriangle(triangle, attributeCount);
 }
 
 /**
- * @since 2024 Feb 11
+ * Decides whether the record at the front of the buffer is in step with the
+ * real records. If it's not, junk is skipped and isAligned is set to false,
+ * in which case the caller should start over with whatever comes next.
+ *
+ * Records are checked a few at a time and remembered, so most calls are
+ * nearly free. The interesting cases are:
+ *
+ *  - The record doesn't look like a triangle but the ones after it do. It's
+ *    just an odd triangle, and it's kept unless its vertices are garbage.
+ *  - The record doesn't look like a triangle and neither do the ones after
+ *    it. Alignment has been lost. Skip to the next record boundary.
+ *  - The record looks fine but the next one doesn't. Either the junk starts
+ *    right after this record, or the junk started just before it and this
+ *    "record" is a mix of junk and the start of a real one. In the second
+ *    case there's a boundary within the next 50 bytes, so we look for one.
+ *
+ * @since 2026 Oct 19
  */
-uint32_t readTriangleCount(const std::string& pathToFile)
+bool BinarySTLFileReader::checkAlignment(BinarySTLFileReaderListener& listener, bool& isAligned)
 {
-    // Helper class
-    class TriangleCountListener : public BinarySTLFileReaderListener
+    isAligned = true;
+
+    // m_verifiedRecordCount is the number of plausible records in a row,
+    // counting from the previous record. Once that's down to this record and
+    // the next, it's time to look further ahead again.
+    if (m_verifiedRecordCount > 2)
+    {
+        --m_verifiedRecordCount;
+    }
+    else
     {
-    public:
-        TriangleCountListener() : m_triangleCount(0) {}
-        bool onReadTriangleCount(const uint32_t triangleCount) { m_triangleCount = triangleCount; return false; }
-        uint32_t m_triangleCount;
-    };
+        const size_t remainingTriangles = m_totalTriangleCount - m_currTriangleIndex;
+        const size_t bytesAvailable = fillBuffer(TRIANGLE_RECORD_SIZE * (RESYNC_LOOKAHEAD_RECORDS + 2));
+        const size_t recordsToCheck = std::min({ RESYNC_LOOKAHEAD_RECORDS, remainingTriangles,
+            bytesAvailable / TRIANGLE_RECORD_SIZE });
+        const uint8_t* pRecord = m_buffer.data() + m_bufferBegin;
+
+        m_verifiedRecordCount = countPlausibleTriangleRecords(pRecord, recordsToCheck);
+
+        if (m_verifiedRecordCount == 0)
+        {
+            // With nothing after it to go by, a final odd record falls through
+            // to the scan, which puts things back as they were if it finds
+            // nothing better.
+            const size_t followingRecords = recordsToCheck - 1;
+            if (followingRecords > 0 &&
+                countPlausibleTriangleRecords(pRecord + TRIANGLE_RECORD_SIZE, followingRecords) == followingRecords)
+            {
+                // Still in step. Junk that happens to be a whole number of
+                // records long ends up here too.
+                if (hasUsableVertices(pRecord, m_seenBounds))
+                    return true;
 
-    TriangleCountListener listener;
-    BinarySTLFileReader reader(pathToFile);
-    reader.readFile(listener);
-    return listener.m_triangleCount;
+                const uint64_t skipBeginOffset = m_bufferFileOffset + m_bufferBegin;
+                consumeBuffer(TRIANGLE_RECORD_SIZE);
+                isAligned = false;
+                return listener.onReadSkippedData(skipBeginOffset, TRIANGLE_RECORD_SIZE);
+            }
+
+            isAligned = false;
+            return skipToRecordBoundary(listener);
+        }
+
+        if (m_verifiedRecordCount == 1 && recordsToCheck > 1)
+        {
+            // Sometimes both interpretations hold up. Go with whichever
+            // record looks more like a real triangle.
+            const size_t offset = findRecordBoundary(1, TRIANGLE_RECORD_SIZE, bytesAvailable);
+            if (offset != NO_RECORD_BOUNDARY &&
+                scoreTriangleRecord(pRecord + offset) > scoreTriangleRecord(pRecord))
+            {
+                const uint64_t skipBeginOffset = m_bufferFileOffset + m_bufferBegin;
+                consumeBuffer(offset);
+                m_verifiedRecordCount = 0;
+                isAligned = false;
+                return listener.onReadSkippedData(skipBeginOffset, offset);
+            }
+        }
+    }
+
+    STLBinaryTriangleData triangle;
+    memcpy(triangle.data(), m_buffer.data() + m_bufferBegin, triangle.size());
+    for (const auto& vertex : decodeFacet(triangle).vertices)
+        m_seenBounds.extend(vertex);
+
+    return true;
+}
+
+/**
+ * Looks for the start of a run of real triangle records at offsets in
+ * [firstOffset, lastOffset) from the front of the buffer. Returns the offset
+ * found, or NO_RECORD_BOUNDARY.
+ *
+ * Misaligned data can occasionally pass for a run of triangles too, usually
+ * a few bytes to either side of the real boundary. So once a candidate is
+ * found, the rest of that record's worth of offsets are checked as well, and
+ * the best of them wins. Candidates near the geometry seen so far beat those
+ * that aren't, after which the better looking first record wins.
+ *
+ * @since 2026 Oct 19
+ */
+size_t BinarySTLFileReader::findRecordBoundary(size_t firstOffset, size_t lastOffset,
+    size_t bytesAvailable) const
+{
+    const size_t remainingTriangles = m_totalTriangleCount - m_currTriangleIndex;
+    const size_t lookaheadRecords = std::min(RESYNC_LOOKAHEAD_RECORDS, remainingTriangles);
+    size_t firstCandidateOffset = NO_RECORD_BOUNDARY;
+    size_t bestOffset = NO_RECORD_BOUNDARY;
+    bool isBestNearBounds = false;
+    double bestScore = 0.0;
+
+    for (size_t offset = firstOffset; offset < lastOffset; ++offset)
+    {
+        if (offset + TRIANGLE_RECORD_SIZE > bytesAvailable)
+            break;
+
+        if (firstCandidateOffset != NO_RECORD_BOUNDARY && offset >= firstCandidateOffset + TRIANGLE_RECORD_SIZE)
+            break;
+
+        // Nearly every offset is ruled out by its first record, most of them
+        // by the floats alone, so that's all that's looked at until one
+        // passes.
+        const uint8_t* pCandidate = m_buffer.data() + m_bufferBegin + offset;
+        if (!isPlausibleTriangleRecord(pCandidate))
+            continue;
+
+        const size_t recordsToCheck = std::min(lookaheadRecords, (bytesAvailable - offset) / TRIANGLE_RECORD_SIZE);
+        if ((recordsToCheck > 1) &&
+            (countPlausibleTriangleRecords(pCandidate + TRIANGLE_RECORD_SIZE, recordsToCheck - 1) != recordsToCheck - 1))
+        {
+            continue;
+        }
+
+        const bool isNearBounds = isRecordNearBounds(pCandidate, m_seenBounds);
+        const double score = scoreTriangleRecord(pCandidate);
+        if (firstCandidateOffset == NO_RECORD_BOUNDARY)
+            firstCandidateOffset = offset;
+
+        if (bestOffset == NO_RECORD_BOUNDARY || (isNearBounds && !isBestNearBounds) ||
+            (isNearBounds == isBestNearBounds && score > bestScore))
+        {
+            bestOffset = offset;
+            isBestNearBounds = isNearBounds;
+            bestScore = score;
+        }
+    }
+
+    return bestOffset;
+}
+
+/**
+ * Skips bytes until the front of the buffer is at a record boundary. The
+ * front of the buffer has already been ruled out. If the file runs out
+ * first, nothing is skipped and resynchronization is switched off.
+ *
+ * @since 2026 Oct 19
+ */
+bool BinarySTLFileReader::skipToRecordBoundary(BinarySTLFileReaderListener& listener)
+{
+    const size_t remainingTriangles = m_totalTriangleCount - m_currTriangleIndex;
+    const size_t bytesNeeded = TRIANGLE_RECORD_SIZE * (std::min(RESYNC_LOOKAHEAD_RECORDS, remainingTriangles) + 1);
+    const uint64_t skipBeginOffset = m_bufferFileOffset + m_bufferBegin;
+    uint64_t skippedBytes = 0;
+    size_t firstOffset = 1;
+
+    m_verifiedRecordCount = 0;
+
+    for (;;)
+    {
+        // Near the end of the file, we judge offsets by however many records
+        // are left. Otherwise, only offsets with enough data after them to be
+        // judged properly are looked at, and the rest wait for the next pass.
+        const size_t bytesAvailable = fillBuffer(RESYNC_SCAN_WINDOW_SIZE);
+        const size_t lastOffset = m_isEndOfFile ? bytesAvailable : bytesAvailable - bytesNeeded;
+
+        const size_t offset = findRecordBoundary(firstOffset, lastOffset, bytesAvailable);
+        if (offset != NO_RECORD_BOUNDARY)
+        {
+            consumeBuffer(offset);
+            skippedBytes += offset;
+            return listener.onReadSkippedData(skipBeginOffset, skippedBytes);
+        }
+
+        if (m_isEndOfFile)
+        {
+            // Nothing left that looks like triangle data. Go back to where we
+            // started and read the rest as is.
+            if (!m_spSource->seek(skipBeginOffset))
+                throw std::runtime_error("Could not seek within STL file.");
+
+            m_bufferBegin = 0;
+            m_bufferEnd = 0;
+            m_bufferFileOffset = skipBeginOffset;
+            m_isEndOfFile = false;
+            m_isResynchronizing = false;
+            return true;
+        }
+
+        consumeBuffer(lastOffset);
+        skippedBytes += lastOffset;
+        firstOffset = 0;
+    }
+}
+
+/**
+ * Makes sure at least minimumBytes unconsumed bytes are in the buffer, unless
+ * the end of the file gets in the way. Returns the number of unconsumed
+ * bytes.
+ *
+ * @since 2026 Oct 19
+ */
+size_t BinarySTLFileReader::fillBuffer(size_t minimumBytes)
+{
+    size_t bytesAvailable = m_bufferEnd - m_bufferBegin;
+    if (bytesAvailable >= minimumBytes || m_isEndOfFile)
+        return bytesAvailable;
+
+    STLREPAIR_STATS_PHASE(READ);
+
+    if (m_bufferBegin > 0)
+    {
+        memmove(m_buffer.data(), m_buffer.data() + m_bufferBegin, bytesAvailable);
+        m_bufferFileOffset += m_bufferBegin;
+        m_bufferBegin = 0;
+        m_bufferEnd = bytesAvailable;
+    }
+
+    if (m_buffer.size() < minimumBytes)
+        m_buffer.resize(minimumBytes);
+
+    while (m_bufferEnd < minimumBytes)
+    {
+        auto bytesRead = m_spSource->read(m_buffer.data() + m_bufferEnd, m_buffer.size() - m_bufferEnd);
+        if (bytesRead == 0)
+        {
+            m_isEndOfFile = true;
+            break;
+        }
+        m_bufferEnd += bytesRead;
+        STLREPAIR_STATS_COUNT_BYTES(READ, bytesRead);
+    }
+
+    return m_bufferEnd - m_bufferBegin;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void BinarySTLFileReader::consumeBuffer(size_t byteCount)
+{
+    m_bufferBegin += std::min(byteCount, m_bufferEnd - m_bufferBegin);
+}
+
+/**
+ * @since 2024 Feb 11
+ */
+uint32_t readTriangleCount(const std::string& pathToFile)
+{
+    return FacetReader(pathToFile).getTriangleCount();
 }
 
 /**
@@ -139,11 +542,18 @@ uint32_t readTriangleCount(const std::string& pathToFile)
  */
 uint32_t calculateTriangleCount(const std::string& pathToFile)
 {
-    auto fileSize = FileUtils::getFileSize(pathToFile);
-    fileSize -= BINARY_STL_HEADER_SIZE_IN_BYTES;
-    fileSize -= BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+    return calculateTriangleCountFromSize(getUncompressedSize(pathToFile));
+}
 
-    return static_cast<uint32_t>(fileSize / (BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES));
+/**
+ * @since 2026 Oct 19
+ */
+uint32_t calculateTriangleCountFromSize(std::uintmax_t dataSize)
+{
+    dataSize -= BINARY_STL_HEADER_SIZE_IN_BYTES;
+    dataSize -= BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    return static_cast<uint32_t>(dataSize / (BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES));
 }
 
 /**
@@ -151,9 +561,78 @@ uint32_t calculateTriangleCount(const std::string& pathToFile)
  */
 uint32_t hasExtraData(const std::string& pathToFile)
 {
-    const uint32_t TRIANGLE_BLOB_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
-    uint32_t triangleCount = readTriangleCount(pathToFile);
-    uint32_t expectedFileSize = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES + (triangleCount * TRIANGLE_BLOB_SIZE);
-    return FileUtils::getFileSize(pathToFile) > expectedFileSize;
+    return getUncompressedSize(pathToFile) > calculateDataSize(readTriangleCount(pathToFile));
 }
 
+/**
+ * @since 2026 Oct 19
+ */
+std::uintmax_t calculateDataSize(uint32_t triangleCount)
+{
+    const std::uintmax_t TRIANGLE_BLOB_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    return BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES + triangleCount * TRIANGLE_BLOB_SIZE;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+BoundingBox scanBoundingBox(const std::string& pathToFile, std::uintmax_t maxBytesToScan)
+{
+    const std::uintmax_t TRIANGLE_BLOB_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    const std::uintmax_t TRIANGLES_PER_BLOCK = 16384;
+    const std::uintmax_t FIRST_TRIANGLE_OFFSET = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    // Sampling a compressed file would mean decompressing it all anyway, so
+    // every triangle is looked at.
+    if (detectCompressionFormat(pathToFile) != CompressionFormat::NONE)
+    {
+        BoundingBox bounds;
+        FacetReader reader(pathToFile);
+        for (const FacetBatch& batch : reader)
+        {
+            for (FacetView facet : batch)
+            {
+                for (size_t vertex = 0; vertex < 3; ++vertex)
+                    bounds.extend(facet.getVertex(vertex));
+            }
+        }
+        return bounds;
+    }
+
+    const std::uintmax_t triangleCount = std::min(readTriangleCount(pathToFile), calculateTriangleCount(pathToFile));
+    const std::uintmax_t blockCount = (triangleCount + TRIANGLES_PER_BLOCK - 1) / TRIANGLES_PER_BLOCK;
+    const std::uintmax_t blocksToScan = std::max<std::uintmax_t>(1, maxBytesToScan / (TRIANGLES_PER_BLOCK * TRIANGLE_BLOB_SIZE));
+    const std::uintmax_t blockStep = std::max<std::uintmax_t>(1, blockCount / blocksToScan);
+
+    FILE* pFile = fopen(pathToFile.c_str(), "rb");
+    if (!pFile)
+        throw std::runtime_error("Unknown error when opening " + pathToFile);
+    auto closeGuard = makeCallGuard([&]() { fclose(pFile); });
+
+    BoundingBox bounds;
+    std::vector<uint8_t> buffer(static_cast<size_t>(TRIANGLES_PER_BLOCK * TRIANGLE_BLOB_SIZE));
+
+    for (std::uintmax_t block = 0; block < blockCount; block += blockStep)
+    {
+        const std::uintmax_t firstTriangle = block * TRIANGLES_PER_BLOCK;
+        const std::uintmax_t trianglesInBlock = std::min(TRIANGLES_PER_BLOCK, triangleCount - firstTriangle);
+
+        if (!seekTo(pFile, FIRST_TRIANGLE_OFFSET + firstTriangle * TRIANGLE_BLOB_SIZE))
+            throw std::runtime_error("Could not seek within " + pathToFile);
+
+        const size_t bytesToRead = static_cast<size_t>(trianglesInBlock * TRIANGLE_BLOB_SIZE);
+        if (fread(buffer.data(), 1, bytesToRead, pFile) != bytesToRead)
+            throw std::runtime_error("Could not read triangle data from " + pathToFile);
+
+        for (size_t i = 0; i < trianglesInBlock; ++i)
+        {
+            STLBinaryTriangleData triangle;
+            memcpy(triangle.data(), buffer.data() + i * TRIANGLE_BLOB_SIZE, triangle.size());
+            STLFacet facet = decodeFacet(triangle);
+            for (const auto& vertex : facet.vertices)
+                bounds.extend(vertex);
+        }
+    }
+
+    return bounds;
+}
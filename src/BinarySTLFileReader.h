@@ -2,10 +2,14 @@
 #define STLREPAIR_BINARYSTLFILEREADER__H_
 
 #include "STLFileTypes.h"
+#include "STLGeometry.h"
+#include "ByteStream.h"
 
 #include <string>
 #include <cstdio>
 #include <array>
+#include <memory>
+#include <vector>
 
 /**
  * Callback interface for anything wishing to consume parsed data from the
@@ -53,6 +57,32 @@ public:
      * triangle data.
      */
     virtual bool onReadUnknownData(const uint8_t* const pData, const size_t dataSize) { return true; }
+
+    /**
+     * Called whenever resynchronization skips over bytes that didn't look
+     * like triangle data in order to get back in step with the records that
+     * follow. Only happens when resynchronization is enabled on the reader.
+     *
+     * @param fileOffset The offset of the first skipped byte.
+     * @param dataSize The number of bytes skipped.
+     */
+    virtual bool onReadSkippedData(const uint64_t /*fileOffset*/, const uint64_t /*dataSize*/) { return true; }
+};
+
+/**
+ * Where a BinarySTLFileReader has got to, between triangles. Enough to
+ * carry on reading from there in another process (see
+ * BinarySTLFileReader::resumeFile()).
+ */
+struct BinarySTLFileReaderCheckpoint
+{
+    uint64_t m_fileOffset = 0;              //!< Offset of the next byte to read.
+    uint32_t m_triangleIndex = 0;           //!< Triangles read so far.
+
+    // Resynchronization state.
+    bool m_isResynchronizing = false;
+    uint64_t m_verifiedRecordCount = 0;
+    BoundingBox m_seenBounds;
 };
 
 /**
@@ -63,12 +93,21 @@ class BinarySTLFileReader
 public:
 
     /**
-     * Constructor.
+     * Constructor. A gzip or zstd compressed file is decompressed as it's
+     * read, on a background thread (see openCompressedFileByteSource()).
      *
      * @throws std::runtime_error
      */
     BinarySTLFileReader(const std::string &filepath);
 
+    /**
+     * Constructor. Reads from the given source instead of opening a file,
+     * e.g., a PrefetchingByteSource to do the disk reads on another thread.
+     *
+     * @throws std::runtime_error
+     */
+    explicit BinarySTLFileReader(std::unique_ptr<ByteSource> spSource);
+
     /**
      * Destructor.
      */
@@ -82,15 +121,71 @@ public:
      */
     void readFile(BinarySTLFileReaderListener &listener);
 
+    /**
+     * Like readFile(), except that after the header and triangle count,
+     * reading carries on from the checkpoint rather than the first triangle.
+     * The listener has to be ready to pick up from there too.
+     *
+     * @throws std::runtime_error if the checkpoint doesn't fit the file.
+     */
+    void resumeFile(BinarySTLFileReaderListener& listener, const BinarySTLFileReaderCheckpoint& checkpoint);
+
+    /**
+     * Returns where reading has got to. Only meaningful from within
+     * BinarySTLFileReaderListener::onReadTriangle(), once the triangle's
+     * been read.
+     */
+    BinarySTLFileReaderCheckpoint getCheckpoint() const;
+
+    /**
+     * Enables or disables resynchronization. Disabled by default.
+     *
+     * Normally, records are assumed to be packed back to back from the end of
+     * the triangle count onwards. A single stray insert in the middle of the
+     * file (something we've seen from broken transfer tools) turns every
+     * triangle after it into garbage.
+     *
+     * With resynchronization enabled, the reader checks each record for
+     * plausibility. When it looks like alignment has been lost, the reader
+     * scans ahead for the next offset at which several consecutive records
+     * look like real triangles near the geometry seen so far, reports the
+     * bytes in between via onReadSkippedData(), and carries on from there.
+     *
+     * If nothing in the rest of the file looks like triangle data, the
+     * heuristics evidently don't suit this file. Nothing is skipped, and the
+     * rest of the file is read as though resynchronization were disabled.
+     */
+    void setResynchronizationEnabled(bool enabled);
+
 private:
 
+    void readFrom(BinarySTLFileReaderListener& listener, const BinarySTLFileReaderCheckpoint* pCheckpoint);
     bool readFileHeader(BinarySTLFileReaderListener &listener);
     bool readTriangleCount(BinarySTLFileReaderListener &listener);
     bool readTriangle(BinarySTLFileReaderListener& listener);
+    bool checkAlignment(BinarySTLFileReaderListener& listener, bool& isAligned);
+    size_t findRecordBoundary(size_t firstOffset, size_t lastOffset, size_t bytesAvailable) const;
+    bool skipToRecordBoundary(BinarySTLFileReaderListener& listener);
+    size_t fillBuffer(size_t minimumBytes);
+    void consumeBuffer(size_t byteCount);
 
-    FILE *m_pFile;
+    std::unique_ptr<ByteSource> m_spSource;
     uint32_t m_totalTriangleCount;
     uint32_t m_currTriangleIndex;
+
+    // Everything is read through this buffer. Bytes [m_bufferBegin,
+    // m_bufferEnd) are unconsumed. m_bufferFileOffset is the file offset of
+    // the first byte in the buffer.
+    std::vector<uint8_t> m_buffer;
+    size_t m_bufferBegin;
+    size_t m_bufferEnd;
+    uint64_t m_bufferFileOffset;
+    bool m_isEndOfFile;
+
+    bool m_isResynchronizationEnabled;
+    bool m_isResynchronizing;
+    size_t m_verifiedRecordCount;
+    BoundingBox m_seenBounds;
 };
 
 /**
@@ -101,13 +196,42 @@ uint32_t readTriangleCount(const std::string& pathToFile);
 
 /**
  * Utility function for calculating the number of expected triangles based entirely
- * on the size of the file.
+ * on the size of the file. For a compressed file, that's the size of what it
+ * holds, which means decompressing all of it.
  */
 uint32_t calculateTriangleCount(const std::string& pathToFile);
 
+/**
+ * Like calculateTriangleCount(), for STL data of the given size. Saves
+ * decompressing a compressed file again once its size is known (see
+ * getUncompressedSize()).
+ */
+uint32_t calculateTriangleCountFromSize(std::uintmax_t dataSize);
+
 /**
  * Utility function for determining if the specified file has junk data.
  */
 uint32_t hasExtraData(const std::string& pathToFile);
 
+/**
+ * Returns the size of binary STL data holding the given number of
+ * triangles and nothing else.
+ */
+std::uintmax_t calculateDataSize(uint32_t triangleCount);
+
+/**
+ * Utility function for finding the bounding box of the triangles in the
+ * specified file without running them through a reader. Only vertex data
+ * is looked at, in large blocks.
+ *
+ * Files whose triangle data is larger than maxBytesToScan are sampled, one
+ * block at a time at even intervals, rather than read in full. The result
+ * is then an approximation that may miss the extremes of unsampled
+ * triangles, which is fine for things like centering.
+ *
+ * @throws std::runtime_error
+ */
+BoundingBox scanBoundingBox(const std::string& pathToFile,
+    std::uintmax_t maxBytesToScan = 64 * 1024 * 1024);
+
 #endif
@@ -1,37 +1,44 @@
 #include "BinarySTLFileWriter.h"
-#include "CallGuard.h"
 #include "Contracts.h"
+#include "TraceRecorder.h"
 
 #include <stdexcept>
+#include <cstring>
 
 /**
  * @since 2024 Feb 01
  */
 BinarySTLFileWriter::BinarySTLFileWriter(const std::string& filepath,
-    const STLBinaryHeader &header, uint32_t triangleCount) :
-    m_pFile(nullptr)
+    const STLBinaryHeader &header, uint32_t triangleCount)
 {
     if (filepath.empty())
         throw std::runtime_error("STL output path cannot be empty.");
 
-    m_pFile = fopen(filepath.c_str(), "wb");
-    if (!m_pFile)
-        throw std::runtime_error("Unknown error when opening " + filepath);
-
-    // Destructors aren't called when exceptions are thrown from
-    // constructors, which is why we're setting up a guard here.
-    // We'll dismiss it later if all is well.
-    auto exceptionGuard = makeCallGuard([&]() { fclose(m_pFile); });
+    m_spSink = std::make_unique<FileByteSink>(filepath);
+    writeFileStart(header, triangleCount);
+}
 
-    size_t bytesWritten = fwrite(header.data(), 1, header.size(), m_pFile);
-    if (bytesWritten != header.size())
-        throw std::runtime_error("Could not write header to STL file.");
+/**
+ * @since 2026 Oct 19
+ */
+BinarySTLFileWriter::BinarySTLFileWriter(std::unique_ptr<ByteSink> spSink,
+    const STLBinaryHeader &header, uint32_t triangleCount) :
+    m_spSink(std::move(spSink))
+{
+    if (!m_spSink)
+        throw std::runtime_error("STL output sink cannot be null.");
 
-    bytesWritten = fwrite(&triangleCount, 1, sizeof(triangleCount), m_pFile);
-    if (bytesWritten != sizeof(triangleCount))
-        throw std::runtime_error("Could not write triangle count to STL file.");
+    writeFileStart(header, triangleCount);
+}
 
-    exceptionGuard.dismiss();
+/**
+ * @since 2026 Oct 19
+ */
+BinarySTLFileWriter::BinarySTLFileWriter(std::unique_ptr<ByteSink> spSink) :
+    m_spSink(std::move(spSink))
+{
+    if (!m_spSink)
+        throw std::runtime_error("STL output sink cannot be null.");
 }
 
 /**
@@ -39,7 +46,15 @@ BinarySTLFileWriter::BinarySTLFileWriter(const std::string& filepath,
  */
 BinarySTLFileWriter::~BinarySTLFileWriter()
 {
-    finalize();
+    // Errors here have nowhere to go. Callers who care should call
+    // finalize() themselves.
+    try
+    {
+        finalize();
+    }
+    catch (const std::exception&)
+    {
+    }
 }
 
 /**
@@ -47,15 +62,10 @@ BinarySTLFileWriter::~BinarySTLFileWriter()
  */
 void BinarySTLFileWriter::writeTriangleData(const STLBinaryTriangleData& triangle, uint16_t attributeByteCount)
 {
-    invariant_throw(m_pFile != nullptr, std::runtime_error("File not opened for writing! (1)"));
+    invariant_throw(m_spSink != nullptr, std::runtime_error("File not opened for writing! (1)"));
 
-    auto bytesWritten = fwrite(&triangle, 1, triangle.size(), m_pFile);
-    if (bytesWritten != triangle.size())
-        throw std::runtime_error("Error writing triangle data to STL file.");
-
-    bytesWritten = fwrite(&attributeByteCount, 1, sizeof(attributeByteCount), m_pFile);
-    if (bytesWritten != sizeof(attributeByteCount))
-        throw std::runtime_error("Error writing attribute byte count to STL file.");
+    m_spSink->write(triangle.data(), triangle.size());
+    m_spSink->write(reinterpret_cast<const uint8_t*>(&attributeByteCount), sizeof(attributeByteCount));
 }
 
 /**
@@ -63,10 +73,13 @@ void BinarySTLFileWriter::writeTriangleData(const STLBinaryTriangleData& triangl
  */
 void BinarySTLFileWriter::finalize()
 {
-    if (m_pFile)
+    STLREPAIR_TRACE_SCOPE("close", "writer");
+
+    if (m_spSink)
     {
-        fclose(m_pFile);
-        m_pFile = nullptr;
+        // Reset first, so a failed close isn't retried by the destructor.
+        std::unique_ptr<ByteSink> spSink = std::move(m_spSink);
+        spSink->close();
     }
 }
 
@@ -75,10 +88,43 @@ void BinarySTLFileWriter::finalize()
  */
 void BinarySTLFileWriter::finalize(const char* pBuffer, size_t bufferSize)
 {
-    invariant_throw(m_pFile != nullptr, std::runtime_error("File not opened for writing! (2)"));
+    invariant_throw(m_spSink != nullptr, std::runtime_error("File not opened for writing! (2)"));
 
     if ((pBuffer != nullptr) && (bufferSize > 0))
-        fwrite(pBuffer, 1, bufferSize, m_pFile);
+        m_spSink->write(reinterpret_cast<const uint8_t*>(pBuffer), bufferSize);
 
     finalize();
 }
+
+/**
+ * @since 2026 Oct 19
+ */
+void BinarySTLFileWriter::writeFileStart(const STLBinaryHeader& header, const uint32_t triangleCount)
+{
+    m_spSink->write(header.data(), header.size());
+    m_spSink->write(reinterpret_cast<const uint8_t*>(&triangleCount), sizeof(triangleCount));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool BinarySTLFileWriter::rewriteFileStart(const STLBinaryHeader& header, uint32_t triangleCount)
+{
+    invariant_throw(m_spSink != nullptr, std::runtime_error("File not opened for writing! (3)"));
+
+    uint8_t fileStart[BINARY_STL_HEADER_SIZE_IN_BYTES + sizeof(triangleCount)];
+    memcpy(fileStart, header.data(), header.size());
+    memcpy(fileStart + header.size(), &triangleCount, sizeof(triangleCount));
+
+    return m_spSink->patch(0, fileStart, sizeof(fileStart));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool BinarySTLFileWriter::sync()
+{
+    invariant_throw(m_spSink != nullptr, std::runtime_error("File not opened for writing! (4)"));
+
+    return m_spSink->sync();
+}
@@ -2,9 +2,11 @@
 #define STLREPAIR_BINARYSTLFILEWRITER__H_
 
 #include "STLFileTypes.h"
+#include "ByteStream.h"
 
 #include <string>
 #include <array>
+#include <memory>
 #include <cstdint>
 
 /**
@@ -30,6 +32,28 @@ public:
     BinarySTLFileWriter(const std::string& filepath,
         const STLBinaryHeader &header, const uint32_t triangleCount);
 
+    /**
+     * Constructor. Writes to the given sink instead of creating a file,
+     * e.g., an AsyncByteSink to do the disk writes on another thread.
+     *
+     * @param spSink Where the STL data goes.
+     * @param header File header data.
+     * @param triangleCount The number of triangles to be written to the STL file.
+     *
+     * @throws std::runtime_error
+     */
+    BinarySTLFileWriter(std::unique_ptr<ByteSink> spSink,
+        const STLBinaryHeader &header, const uint32_t triangleCount);
+
+    /**
+     * Constructor. Carries on with output that already has its header and
+     * triangle count, and maybe some triangles, e.g. a FileByteSink opened
+     * to resume a file. Nothing is written until it's asked for.
+     *
+     * @throws std::runtime_error
+     */
+    explicit BinarySTLFileWriter(std::unique_ptr<ByteSink> spSink);
+
     /**
      * Destructor.
      */
@@ -59,9 +83,28 @@ public:
      */
     void finalize(const char* pBuffer, size_t bufferSize);
 
+    /**
+     * Overwrites the header and triangle count written at the start of the
+     * file. Must be called before finalize(). Returns false if the sink
+     * can't go back and change them, in which case nothing is written.
+     *
+     * @throws std::runtime_error
+     */
+    bool rewriteFileStart(const STLBinaryHeader& header, uint32_t triangleCount);
+
+    /**
+     * Makes sure everything written so far is on disk. Must be called
+     * before finalize(). Returns false if the sink can't do that.
+     *
+     * @throws std::runtime_error
+     */
+    bool sync();
+
 private:
 
-    FILE* m_pFile;
+    void writeFileStart(const STLBinaryHeader& header, const uint32_t triangleCount);
+
+    std::unique_ptr<ByteSink> m_spSink;
 };
 
 #endif
@@ -0,0 +1,290 @@
+#include "ByteStream.h"
+#include "Contracts.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    bool seekTo(FILE* pFile, uint64_t offset)
+    {
+#if defined(_WIN32)
+        return _fseeki64(pFile, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+        return fseeko(pFile, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+
+    int64_t tell(FILE* pFile)
+    {
+#if defined(_WIN32)
+        return _ftelli64(pFile);
+#else
+        return ftello(pFile);
+#endif
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FileByteSource::FileByteSource(const std::string& filepath) :
+    m_pFile(nullptr)
+{
+    m_pFile = fopen(filepath.c_str(), "rb");
+    if (!m_pFile)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FileByteSource::~FileByteSource()
+{
+    fclose(m_pFile);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+size_t FileByteSource::read(uint8_t* pBuffer, size_t size)
+{
+    size_t bytesRead = fread(pBuffer, 1, size, m_pFile);
+    if ((bytesRead < size) && ferror(m_pFile))
+        throw std::runtime_error("Error reading from file.");
+
+    return bytesRead;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FileByteSource::seek(uint64_t offset)
+{
+    return seekTo(m_pFile, offset);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FileByteSink::FileByteSink(const std::string& filepath) :
+    m_pFile(nullptr)
+{
+    m_pFile = fopen(filepath.c_str(), "wb");
+    if (!m_pFile)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FileByteSink::FileByteSink(const std::string& filepath, uint64_t resumeOffset) :
+    m_pFile(nullptr)
+{
+    m_pFile = fopen(filepath.c_str(), "rb+");
+    if (!m_pFile)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+
+    int64_t size = -1;
+    if (fseek(m_pFile, 0, SEEK_END) == 0)
+        size = tell(m_pFile);
+
+#if defined(_WIN32)
+    const bool isTruncated = (_chsize_s(_fileno(m_pFile), static_cast<__int64>(resumeOffset)) == 0);
+#else
+    const bool isTruncated = (ftruncate(fileno(m_pFile), static_cast<off_t>(resumeOffset)) == 0);
+#endif
+
+    if ((size < 0) || (static_cast<uint64_t>(size) < resumeOffset) || !isTruncated || !seekTo(m_pFile, resumeOffset))
+    {
+        fclose(m_pFile);
+        m_pFile = nullptr;
+        throw std::runtime_error("Could not carry on writing " + filepath);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FileByteSink::~FileByteSink()
+{
+    if (m_pFile)
+        fclose(m_pFile);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FileByteSink::write(const uint8_t* pData, size_t size)
+{
+    invariant_throw(m_pFile != nullptr, std::runtime_error("File not opened for writing!"));
+
+    if (fwrite(pData, 1, size, m_pFile) != size)
+        throw std::runtime_error("Error writing to file.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FileByteSink::patch(uint64_t offset, const uint8_t* pData, size_t size)
+{
+    invariant_throw(m_pFile != nullptr, std::runtime_error("File not opened for writing!"));
+
+    const int64_t position = tell(m_pFile);
+    precondition_throw((position >= 0) && (offset + size <= static_cast<uint64_t>(position)),
+        std::runtime_error("Can only patch data that's already been written."));
+
+    if (!seekTo(m_pFile, offset))
+        return false;
+
+    const bool isWritten = (fwrite(pData, 1, size, m_pFile) == size);
+    if (!seekTo(m_pFile, static_cast<uint64_t>(position)) || !isWritten)
+        throw std::runtime_error("Error writing to file.");
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FileByteSink::sync()
+{
+    invariant_throw(m_pFile != nullptr, std::runtime_error("File not opened for writing!"));
+
+    if (fflush(m_pFile) != 0)
+        throw std::runtime_error("Error writing to file.");
+
+#if defined(_WIN32)
+    const bool isSynced = (_commit(_fileno(m_pFile)) == 0);
+#elif defined(__linux__)
+    const bool isSynced = (fdatasync(fileno(m_pFile)) == 0);
+#else
+    const bool isSynced = (fsync(fileno(m_pFile)) == 0);
+#endif
+    if (!isSynced)
+        throw std::runtime_error("Error flushing file to disk.");
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FileByteSink::close()
+{
+    if (!m_pFile)
+        return;
+
+    FILE* pFile = m_pFile;
+    m_pFile = nullptr;
+    if (fclose(pFile) != 0)
+        throw std::runtime_error("Error closing file.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+MemoryByteSource::MemoryByteSource(const uint8_t* pData, size_t size) :
+    m_pData(pData),
+    m_size(size),
+    m_position(0)
+{
+    precondition_throw((pData != nullptr) || (size == 0), std::runtime_error("Memory source cannot be null."));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+size_t MemoryByteSource::read(uint8_t* pBuffer, size_t size)
+{
+    const size_t bytesToCopy = std::min(size, m_size - m_position);
+    if (bytesToCopy > 0)
+        memcpy(pBuffer, m_pData + m_position, bytesToCopy);
+
+    m_position += bytesToCopy;
+    return bytesToCopy;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool MemoryByteSource::seek(uint64_t offset)
+{
+    if (offset > m_size)
+        return false;
+
+    m_position = static_cast<size_t>(offset);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+VectorByteSink::VectorByteSink(std::vector<uint8_t>& data) :
+    m_data(data),
+    m_startSize(data.size())
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void VectorByteSink::write(const uint8_t* pData, size_t size)
+{
+    m_data.insert(m_data.end(), pData, pData + size);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool VectorByteSink::patch(uint64_t offset, const uint8_t* pData, size_t size)
+{
+    precondition_throw(offset + size <= m_data.size() - m_startSize,
+        std::runtime_error("Can only patch data that's already been written."));
+
+    memcpy(m_data.data() + m_startSize + offset, pData, size);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+BufferByteSink::BufferByteSink(uint8_t* pBuffer, size_t capacity) :
+    m_pBuffer(pBuffer),
+    m_capacity(capacity),
+    m_size(0)
+{
+    precondition_throw((pBuffer != nullptr) || (capacity == 0), std::runtime_error("Output buffer cannot be null."));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void BufferByteSink::write(const uint8_t* pData, size_t size)
+{
+    if (size > m_capacity - m_size)
+        throw std::runtime_error("Output buffer too small.");
+
+    if (size > 0)
+        memcpy(m_pBuffer + m_size, pData, size);
+    m_size += size;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool BufferByteSink::patch(uint64_t offset, const uint8_t* pData, size_t size)
+{
+    precondition_throw(offset + size <= m_size,
+        std::runtime_error("Can only patch data that's already been written."));
+
+    memcpy(m_pBuffer + offset, pData, size);
+    return true;
+}
@@ -0,0 +1,210 @@
+#ifndef STLREPAIR_BYTESTREAM__H_
+#define STLREPAIR_BYTESTREAM__H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstddef>
+
+/**
+ * Somewhere bytes are read from. The reader doesn't care whether that's a
+ * file, a background thread or something else entirely.
+ */
+class ByteSource
+{
+public:
+
+    //! Destructor.
+    virtual ~ByteSource() {}
+
+    /**
+     * Reads up to size bytes into pBuffer. Returns the number of bytes read,
+     * which is only ever zero at the end of the data.
+     *
+     * @throws std::runtime_error
+     */
+    virtual size_t read(uint8_t* pBuffer, size_t size) = 0;
+
+    /**
+     * Moves the read position to the given offset from the start of the
+     * data. Returns false if that isn't possible.
+     */
+    virtual bool seek(uint64_t offset) = 0;
+};
+
+/**
+ * Somewhere bytes are written to.
+ */
+class ByteSink
+{
+public:
+
+    //! Destructor.
+    virtual ~ByteSink() {}
+
+    /**
+     * Writes size bytes from pData.
+     *
+     * @throws std::runtime_error
+     */
+    virtual void write(const uint8_t* pData, size_t size) = 0;
+
+    /**
+     * Overwrites size bytes that were already written, starting at offset
+     * from the start of the data. Only valid before close(). Returns false,
+     * writing nothing, if the sink can't go back like that.
+     *
+     * @throws std::runtime_error
+     */
+    virtual bool patch(uint64_t /*offset*/, const uint8_t* /*pData*/, size_t /*size*/) { return false; }
+
+    /**
+     * Makes sure everything written so far is on disk. Only valid before
+     * close(). Returns false if the sink can't do that.
+     *
+     * @throws std::runtime_error
+     */
+    virtual bool sync() { return false; }
+
+    /**
+     * Flushes everything written so far and closes the sink. No more data
+     * can be written afterwards. Calling this more than once is harmless.
+     *
+     * @throws std::runtime_error
+     */
+    virtual void close() = 0;
+};
+
+/**
+ * ByteSource that reads from a file with plain stdio.
+ */
+class FileByteSource : public ByteSource
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @throws std::runtime_error if the file can't be opened.
+     */
+    explicit FileByteSource(const std::string& filepath);
+
+    //! Destructor.
+    ~FileByteSource();
+
+    size_t read(uint8_t* pBuffer, size_t size) override;
+    bool seek(uint64_t offset) override;
+
+private:
+
+    FILE* m_pFile;
+};
+
+/**
+ * ByteSink that writes to a file with plain stdio. The file is created, or
+ * truncated if it already exists.
+ */
+class FileByteSink : public ByteSink
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @throws std::runtime_error if the file can't be opened.
+     */
+    explicit FileByteSink(const std::string& filepath);
+
+    /**
+     * Constructor. Opens an existing file to carry on writing it from the
+     * given offset. Anything after the offset is thrown away.
+     *
+     * @throws std::runtime_error if the file can't be opened or is shorter
+     *         than the offset.
+     */
+    FileByteSink(const std::string& filepath, uint64_t resumeOffset);
+
+    //! Destructor. Closes the file if that hasn't happened already.
+    ~FileByteSink();
+
+    void write(const uint8_t* pData, size_t size) override;
+    bool patch(uint64_t offset, const uint8_t* pData, size_t size) override;
+    bool sync() override;
+    void close() override;
+
+private:
+
+    FILE* m_pFile;
+};
+
+/**
+ * ByteSource over a block of memory owned by someone else, who has to keep
+ * it alive for as long as the source is in use.
+ */
+class MemoryByteSource : public ByteSource
+{
+public:
+
+    //! Constructor.
+    MemoryByteSource(const uint8_t* pData, size_t size);
+
+    size_t read(uint8_t* pBuffer, size_t size) override;
+    bool seek(uint64_t offset) override;
+
+private:
+
+    const uint8_t* m_pData;
+    size_t m_size;
+    size_t m_position;
+};
+
+/**
+ * ByteSink that appends to a vector owned by someone else.
+ */
+class VectorByteSink : public ByteSink
+{
+public:
+
+    //! Constructor. Whatever's already in the vector stays at the front.
+    explicit VectorByteSink(std::vector<uint8_t>& data);
+
+    void write(const uint8_t* pData, size_t size) override;
+    bool patch(uint64_t offset, const uint8_t* pData, size_t size) override;
+    void close() override {}
+
+private:
+
+    std::vector<uint8_t>& m_data;
+    const size_t m_startSize;
+};
+
+/**
+ * ByteSink that writes into a fixed-size buffer owned by someone else.
+ */
+class BufferByteSink : public ByteSink
+{
+public:
+
+    //! Constructor.
+    BufferByteSink(uint8_t* pBuffer, size_t capacity);
+
+    /**
+     * @throws std::runtime_error if the data won't fit. Nothing is written
+     *         in that case.
+     */
+    void write(const uint8_t* pData, size_t size) override;
+    bool patch(uint64_t offset, const uint8_t* pData, size_t size) override;
+    void close() override {}
+
+    //! Returns the number of bytes written so far.
+    size_t getSize() const { return m_size; }
+
+private:
+
+    uint8_t* m_pBuffer;
+    size_t m_capacity;
+    size_t m_size;
+};
+
+#endif
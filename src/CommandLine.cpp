@@ -0,0 +1,524 @@
+#include "CommandLine.h"
+#include "RepairCache.h"
+#include "RepairCheckpoint.h"
+
+#include <stdexcept>
+
+namespace
+{
+    std::string getOptionValue(int argc, const char** argv, int& index)
+    {
+        const std::string option = argv[index];
+        if (index + 1 >= argc)
+            throw std::runtime_error("Missing value for " + option);
+
+        return argv[++index];
+    }
+
+    float parseFloat(const std::string& text, const std::string& option)
+    {
+        size_t parsedLength = 0;
+        float value = 0.0f;
+        try
+        {
+            value = std::stof(text, &parsedLength);
+        }
+        catch (const std::exception&)
+        {
+            parsedLength = 0;
+        }
+
+        if ((parsedLength == 0) || (parsedLength != text.size()))
+            throw std::runtime_error("Invalid number for " + option + " - " + text);
+
+        return value;
+    }
+
+    size_t parseCount(const std::string& text, const std::string& option)
+    {
+        size_t parsedLength = 0;
+        unsigned long long value = 0;
+        try
+        {
+            value = std::stoull(text, &parsedLength);
+        }
+        catch (const std::exception&)
+        {
+            parsedLength = 0;
+        }
+
+        if ((parsedLength == 0) || (parsedLength != text.size()) || (value == 0) || (text[0] == '-'))
+            throw std::runtime_error("Invalid count for " + option + " - " + text);
+
+        return static_cast<size_t>(value);
+    }
+
+    AsyncIOBackend parseIOBackend(const std::string& name)
+    {
+        if (name == "auto")
+            return AsyncIOBackend::AUTOMATIC;
+        if (name == "io_uring")
+            return AsyncIOBackend::IO_URING;
+        if (name == "threads")
+            return AsyncIOBackend::THREAD_POOL;
+
+        throw std::runtime_error("Unknown I/O backend - " + name + " (expected auto, io_uring or threads)");
+    }
+
+    DurabilityPolicy parseDurabilityPolicy(const std::string& name)
+    {
+        if (name == "none")
+            return DurabilityPolicy::NONE;
+        if (name == "fdatasync")
+            return DurabilityPolicy::FDATASYNC;
+        if (name == "group")
+            return DurabilityPolicy::GROUP_COMMIT;
+
+        throw std::runtime_error("Unknown durability policy - " + name + " (expected none, fdatasync or group)");
+    }
+
+    float parseUnitScale(const std::string& units)
+    {
+        // Everything gets converted to millimetres, which is what slicers assume.
+        if (units == "mm")
+            return 1.0f;
+        if (units == "cm")
+            return 10.0f;
+        if (units == "m")
+            return 1000.0f;
+        if (units == "in")
+            return 25.4f;
+
+        throw std::runtime_error("Unknown units - " + units + " (expected mm, cm, m or in)");
+    }
+
+    Vec3 parseVector(const std::string& text, const std::string& option)
+    {
+        auto firstComma = text.find(',');
+        auto secondComma = (firstComma == std::string::npos) ? std::string::npos : text.find(',', firstComma + 1);
+        if (secondComma == std::string::npos)
+            throw std::runtime_error("Expected x,y,z for " + option + " - " + text);
+
+        return { parseFloat(text.substr(0, firstComma), option),
+                 parseFloat(text.substr(firstComma + 1, secondComma - firstComma - 1), option),
+                 parseFloat(text.substr(secondComma + 1), option) };
+    }
+
+    bool isTransformRequested(const CommandLineOptions& options)
+    {
+        return options.m_center || (options.m_scale != 1.0f) || (options.m_translation.x != 0.0f) ||
+            (options.m_translation.y != 0.0f) || (options.m_translation.z != 0.0f);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+CommandLineOptions::CommandLineOptions() :
+    m_splitComponents(false),
+    m_checkIntersections(false),
+    m_mortonOrder(false),
+    m_resynchronize(false),
+    m_pipelined(false),
+    m_directIO(false),
+    m_stampPayloadDigest(false),
+    m_verify(false),
+    m_durability(DurabilityPolicy::NONE),
+    m_checkpoint(false),
+    m_checkpointIntervalInBytes(DEFAULT_CHECKPOINT_INTERVAL_BYTES),
+    m_follow(false),
+    m_shard(false),
+    m_shardMode(ShardMode::FACET_RANGE),
+    m_shardCount(0),
+    m_maxShardBytes(0),
+    m_clearHeader(false),
+    m_clearAttributes(false),
+    m_workerCount(0),
+    m_metricsPort(0),
+    m_metricsInterval(15),
+    m_stats(false),
+    m_statsAsJson(false),
+    m_cacheSizeInBytes(DEFAULT_REPAIR_CACHE_SIZE_IN_BYTES),
+    m_center(false),
+    m_scale(1.0f),
+    m_translation{ 0.0f, 0.0f, 0.0f }
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+CommandLineOptions parseCommandLine(int argc, const char** argv)
+{
+    CommandLineOptions options;
+    std::vector<std::string> inputFiles;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (arg == "--split-components")
+        {
+            options.m_splitComponents = true;
+        }
+        else if (arg == "--check-intersections")
+        {
+            options.m_checkIntersections = true;
+        }
+        else if (arg == "--morton-order")
+        {
+            options.m_mortonOrder = true;
+        }
+        else if (arg == "--resync")
+        {
+            options.m_resynchronize = true;
+        }
+        else if (arg == "--pipelined")
+        {
+            options.m_pipelined = true;
+        }
+        else if (arg == "--direct-io")
+        {
+            options.m_directIO = true;
+        }
+        else if (arg == "--async-io")
+        {
+            options.m_asyncIO.m_isEnabled = true;
+        }
+        else if (arg == "--io-backend")
+        {
+            options.m_asyncIO.m_isEnabled = true;
+            options.m_asyncIO.m_backend = parseIOBackend(getOptionValue(argc, argv, i));
+        }
+        else if (arg == "--io-queue-depth")
+        {
+            options.m_asyncIO.m_isEnabled = true;
+            options.m_asyncIO.m_queueDepth = parseCount(getOptionValue(argc, argv, i), arg);
+        }
+        else if (arg == "--io-block-size")
+        {
+            // Given in KiB, which is the granularity anyone tuning this thinks in.
+            options.m_asyncIO.m_isEnabled = true;
+            options.m_asyncIO.m_blockSize = parseCount(getOptionValue(argc, argv, i), arg) * 1024;
+        }
+        else if (arg == "--stamp-digest")
+        {
+            options.m_stampPayloadDigest = true;
+        }
+        else if (arg == "--verify")
+        {
+            options.m_verify = true;
+        }
+        else if (arg == "--diff")
+        {
+            options.m_diffFile = getOptionValue(argc, argv, i);
+        }
+        else if (arg == "--durability")
+        {
+            options.m_durability = parseDurabilityPolicy(getOptionValue(argc, argv, i));
+        }
+        else if (arg == "--checkpoint")
+        {
+            options.m_checkpoint = true;
+        }
+        else if ((arg == "--shards") || (arg == "--shard-size") || (arg == "--shard-slabs") || (arg == "--shard-octants"))
+        {
+            if (options.m_shard)
+                throw std::runtime_error("Only one way of sharding may be specified.");
+            options.m_shard = true;
+
+            if (arg == "--shards")
+            {
+                options.m_shardMode = ShardMode::FACET_RANGE;
+                options.m_shardCount = static_cast<uint32_t>(parseCount(getOptionValue(argc, argv, i), arg));
+            }
+            else if (arg == "--shard-size")
+            {
+                options.m_shardMode = ShardMode::MAX_BYTES;
+                options.m_maxShardBytes = parseCount(getOptionValue(argc, argv, i), arg) * 1024ull * 1024;
+            }
+            else if (arg == "--shard-slabs")
+            {
+                options.m_shardMode = ShardMode::SLABS;
+                options.m_shardCount = static_cast<uint32_t>(parseCount(getOptionValue(argc, argv, i), arg));
+            }
+            else
+            {
+                options.m_shardMode = ShardMode::OCTANTS;
+            }
+        }
+        else if (arg == "--follow")
+        {
+            options.m_follow = true;
+        }
+        else if (arg == "--checkpoint-interval")
+        {
+            // Given in MiB.
+            options.m_checkpoint = true;
+            options.m_checkpointIntervalInBytes = parseCount(getOptionValue(argc, argv, i), arg) * 1024ull * 1024;
+        }
+        else if (arg == "--clear-header")
+        {
+            options.m_clearHeader = true;
+        }
+        else if (arg == "--clear-attributes")
+        {
+            options.m_clearAttributes = true;
+        }
+        else if (arg == "--watch")
+        {
+            options.m_watchDirectories.push_back(getOptionValue(argc, argv, i));
+        }
+        else if (arg == "--output-dir")
+        {
+            options.m_outputDirectory = getOptionValue(argc, argv, i);
+        }
+        else if (arg == "--serve")
+        {
+            options.m_serverSocketPath = getOptionValue(argc, argv, i);
+        }
+        else if (arg == "--workers")
+        {
+            options.m_workerCount = static_cast<unsigned>(parseCount(getOptionValue(argc, argv, i), arg));
+        }
+        else if (arg == "--metrics-port")
+        {
+            const size_t port = parseCount(getOptionValue(argc, argv, i), arg);
+            if (port > 65535)
+                throw std::runtime_error("Invalid port for " + arg + " - " + std::to_string(port));
+            options.m_metricsPort = static_cast<uint16_t>(port);
+        }
+        else if (arg == "--metrics-file")
+        {
+            options.m_metricsFile = getOptionValue(argc, argv, i);
+        }
+        else if (arg == "--metrics-interval")
+        {
+            options.m_metricsInterval = static_cast<unsigned>(parseCount(getOptionValue(argc, argv, i), arg));
+        }
+        else if ((arg == "--stats") || (arg == "--stats=text"))
+        {
+            options.m_stats = true;
+            options.m_statsAsJson = false;
+        }
+        else if (arg == "--stats=json")
+        {
+            options.m_stats = true;
+            options.m_statsAsJson = true;
+        }
+        else if (arg == "--trace")
+        {
+            options.m_traceFile = getOptionValue(argc, argv, i);
+        }
+        else if (arg == "--cache-dir")
+        {
+            options.m_cacheDirectory = getOptionValue(argc, argv, i);
+        }
+        else if (arg == "--cache-size")
+        {
+            // Given in MiB.
+            options.m_cacheSizeInBytes = parseCount(getOptionValue(argc, argv, i), arg) * 1024ull * 1024;
+        }
+        else if (arg == "--scale")
+        {
+            options.m_scale *= parseFloat(getOptionValue(argc, argv, i), arg);
+        }
+        else if (arg == "--units")
+        {
+            options.m_scale *= parseUnitScale(getOptionValue(argc, argv, i));
+        }
+        else if (arg == "--translate")
+        {
+            options.m_translation = parseVector(getOptionValue(argc, argv, i), arg);
+        }
+        else if (arg == "--center")
+        {
+            options.m_center = true;
+        }
+        else if (arg == "--merge")
+        {
+            options.m_mergeOutputFile = getOptionValue(argc, argv, i);
+        }
+        else if ((arg.size() > 1) && (arg[0] == '-'))
+        {
+            throw std::runtime_error("Unknown option - " + arg);
+        }
+        else
+        {
+            inputFiles.push_back(arg);
+        }
+    }
+
+    if (!options.m_mergeOutputFile.empty())
+        options.m_mergeInputFiles = inputFiles;
+    else if (inputFiles.size() > 1)
+        throw std::runtime_error("Only one input file may be specified.");
+    else if (!inputFiles.empty())
+        options.m_inputFile = inputFiles.front();
+
+    if (!options.m_mergeOutputFile.empty())
+    {
+        if (options.m_mergeInputFiles.empty())
+            throw std::runtime_error("--merge needs at least one input file.");
+        if (!options.m_serverSocketPath.empty() || !options.m_watchDirectories.empty() || options.m_shard ||
+            options.m_splitComponents || options.m_checkIntersections || options.m_verify || !options.m_diffFile.empty() ||
+            options.m_follow || options.m_checkpoint || !options.m_cacheDirectory.empty() || options.m_mortonOrder ||
+            options.m_resynchronize || options.m_pipelined || options.m_directIO || options.m_asyncIO.m_isEnabled ||
+            options.m_center)
+        {
+            throw std::runtime_error("--merge can only be combined with the header, attribute, durability "
+                "and transform options, other than --center.");
+        }
+    }
+    else if (!options.m_serverSocketPath.empty())
+    {
+        if (!options.m_inputFile.empty() || !options.m_watchDirectories.empty())
+            throw std::runtime_error("--serve can't be combined with an input file or --watch.");
+
+        // Each request says how it wants to be repaired.
+        if (isTransformRequested(options) || options.m_mortonOrder || !options.m_cacheDirectory.empty())
+        {
+            throw std::runtime_error("--serve can't be combined with the transform options, --morton-order "
+                "or --cache-dir. Clients choose their repairs with each request.");
+        }
+    }
+    else if (!options.m_watchDirectories.empty())
+    {
+        if (!options.m_inputFile.empty())
+            throw std::runtime_error("An input file can't be given with --watch.");
+        if (options.m_outputDirectory.empty())
+            throw std::runtime_error("--watch needs an --output-dir.");
+        if (options.m_center || !options.m_cacheDirectory.empty() || options.m_checkpoint)
+            throw std::runtime_error("--center, --cache-dir and --checkpoint can't be used with --watch.");
+    }
+    else if (options.m_inputFile.empty())
+    {
+        throw std::runtime_error("No input file specified.");
+    }
+
+    if (((options.m_metricsPort != 0) || !options.m_metricsFile.empty()) &&
+        options.m_watchDirectories.empty() && options.m_serverSocketPath.empty())
+    {
+        throw std::runtime_error("Metrics are only available with --watch or --serve.");
+    }
+
+    if (options.m_verify && !options.m_diffFile.empty())
+        throw std::runtime_error("--verify and --diff can't be used together.");
+
+    if (options.m_directIO && options.m_asyncIO.m_isEnabled)
+        throw std::runtime_error("--direct-io can't be combined with asynchronous I/O.");
+
+    if (options.m_checkpoint &&
+        (options.m_pipelined || options.m_directIO || options.m_asyncIO.m_isEnabled || options.m_mortonOrder))
+    {
+        throw std::runtime_error("--checkpoint can't be combined with --pipelined, --direct-io, "
+            "asynchronous I/O or --morton-order.");
+    }
+
+    if (options.m_shard)
+    {
+        if (options.m_inputFile.empty())
+            throw std::runtime_error("Sharding needs an input file.");
+        if (options.m_splitComponents || options.m_checkIntersections || options.m_verify || !options.m_diffFile.empty() ||
+            options.m_follow || options.m_checkpoint || !options.m_cacheDirectory.empty() || options.m_mortonOrder ||
+            options.m_resynchronize || options.m_pipelined || options.m_directIO || options.m_asyncIO.m_isEnabled)
+        {
+            throw std::runtime_error("Sharding can only be combined with the header, attribute and transform options.");
+        }
+    }
+
+    if (options.m_splitComponents)
+    {
+        if (options.m_checkIntersections || options.m_verify || !options.m_diffFile.empty() ||
+            options.m_mortonOrder || isTransformRequested(options) || options.m_stampPayloadDigest ||
+            !options.m_cacheDirectory.empty() || options.m_checkpoint)
+        {
+            throw std::runtime_error("--split-components can't be combined with --check-intersections, --verify, "
+                "--diff, --morton-order, the transform options, --stamp-digest, --cache-dir or --checkpoint.");
+        }
+    }
+
+    if (options.m_checkIntersections)
+    {
+        // Only a report comes out, so anything about the output is moot.
+        if (options.m_verify || !options.m_diffFile.empty() || options.m_mortonOrder ||
+            isTransformRequested(options) || options.m_stampPayloadDigest || !options.m_cacheDirectory.empty() ||
+            options.m_checkpoint || options.m_clearHeader || options.m_clearAttributes ||
+            (options.m_durability != DurabilityPolicy::NONE) || options.m_resynchronize || options.m_pipelined ||
+            options.m_directIO || options.m_asyncIO.m_isEnabled)
+        {
+            throw std::runtime_error("--check-intersections only reads the input, so it can't be combined with "
+                "--verify, --diff, or any output, transform or I/O option.");
+        }
+    }
+
+    if (options.m_follow)
+    {
+        if (options.m_inputFile.empty())
+            throw std::runtime_error("--follow needs an input file.");
+        if (options.m_splitComponents || options.m_checkIntersections || options.m_verify || !options.m_diffFile.empty())
+            throw std::runtime_error("--follow only works when repairing.");
+        if (options.m_center || options.m_mortonOrder || options.m_checkpoint || !options.m_cacheDirectory.empty() ||
+            options.m_directIO || options.m_asyncIO.m_isEnabled)
+        {
+            throw std::runtime_error("--follow can't be combined with --center, --morton-order, --checkpoint, "
+                "--cache-dir, --direct-io or asynchronous I/O.");
+        }
+    }
+
+    return options;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string getUsageString()
+{
+    return
+        "usage: stlrepair [options] <file.stl>\n"
+        "       stlrepair [options] --merge <out.stl> <file.stl>...\n"
+        "       stlrepair [options] --watch <dir> [--watch <dir>...] --output-dir <dir>\n"
+        "       stlrepair [--workers <n>] --serve <socket>\n"
+        "\n"
+        "options:\n"
+        "  --split-components     Write each disconnected part to its own file.\n"
+        "  --shards <n>           Split into n files of consecutive facets.\n"
+        "  --shard-size <MiB>     Split into as few files of at most this size as will do.\n"
+        "  --shard-slabs <n>      Split into n slabs along the longest axis.\n"
+        "  --shard-octants        Split into the eight octants about the center.\n"
+        "  --merge <out.stl>      Merge the input files into one.\n"
+        "  --check-intersections  Report self-intersecting facets and exit.\n"
+        "  --morton-order         Write facets in spatially coherent (Z-curve) order.\n"
+        "  --resync               Skip over junk inserted in the middle of the facets.\n"
+        "  --pipelined            Read, repair and write on separate threads.\n"
+        "  --direct-io            Bypass the page cache when reading and writing.\n"
+        "  --async-io             Keep several reads and writes in flight at once.\n"
+        "  --io-backend <name>    auto, io_uring or threads (implies --async-io).\n"
+        "  --io-queue-depth <n>   Reads or writes in flight (implies --async-io).\n"
+        "  --io-block-size <KiB>  Size of each read or write (implies --async-io).\n"
+        "  --stamp-digest         Stamp a digest of the facets into the header.\n"
+        "  --verify               Check the facets against the stamped digest and exit.\n"
+        "  --diff <other.stl>     Report facet differences from another STL and exit.\n"
+        "  --durability <policy>  none, fdatasync or group (default none).\n"
+        "  --checkpoint           Record progress now and then, and resume from it if rerun.\n"
+        "  --checkpoint-interval <MiB>\n"
+        "                         Input read between checkpoints (default 256).\n"
+        "  --follow               Repair the input while it's still being written.\n"
+        "  --clear-header         Clear the header without asking.\n"
+        "  --clear-attributes     Clear the attribute counts without asking.\n"
+        "  --watch <dir>          Repair STLs as they're written to the directory.\n"
+        "  --output-dir <dir>     Where --watch puts repaired files.\n"
+        "  --serve <socket>       Serve repairs to RepairClients over a Unix socket.\n"
+        "  --workers <n>          Repairs --watch or --serve makes at once (default one per core).\n"
+        "  --metrics-port <port>  Serve Prometheus metrics on 127.0.0.1 (--watch or --serve).\n"
+        "  --metrics-file <file>  Keep Prometheus metrics in a file (--watch or --serve).\n"
+        "  --metrics-interval <s> How often the metrics file is rewritten (default 15).\n"
+        "  --cache-dir <dir>      Reuse earlier repairs of identical files.\n"
+        "  --cache-size <MiB>     Limit on the size of the cache (default 1024).\n"
+        "  --stats[=json]         Print time, bytes and facets per phase at exit.\n"
+        "  --trace <file.json>    Record a timeline for chrome://tracing or Perfetto.\n"
+        "  --units <mm|cm|m|in>   Convert from the given units to millimetres.\n"
+        "  --scale <factor>       Scale the model about the origin.\n"
+        "  --translate <x,y,z>    Move the model by the given offset.\n"
+        "  --center               Center the model's bounding box on the origin.\n";
+}
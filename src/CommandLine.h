@@ -0,0 +1,105 @@
+#ifndef STLREPAIR_COMMANDLINE__H_
+#define STLREPAIR_COMMANDLINE__H_
+
+#include "STLGeometry.h"
+#include "AsyncFileIO.h"
+#include "OutputCommitter.h"
+#include "ShardWriter.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Everything the user told us on the command line.
+ */
+struct CommandLineOptions
+{
+    //! Constructor. Sets every option to its default.
+    CommandLineOptions();
+
+    std::string m_inputFile;
+    bool m_splitComponents;
+    bool m_checkIntersections;
+    bool m_mortonOrder;
+    bool m_resynchronize;
+    bool m_pipelined;
+    AsyncIOOptions m_asyncIO;
+    bool m_directIO;
+    bool m_stampPayloadDigest;
+    bool m_verify;
+    std::string m_diffFile;
+    DurabilityPolicy m_durability;
+
+    // Checkpointing. If enabled, a sidecar next to the input records
+    // progress every m_checkpointIntervalInBytes of input, and a rerun of
+    // the same repair picks up from there.
+    bool m_checkpoint;
+    uint64_t m_checkpointIntervalInBytes;
+
+    // Follow mode. The input is repaired as it's written, and finished
+    // once nobody's writing it any more.
+    bool m_follow;
+
+    // Sharding. If enabled, the input is split into shards instead of
+    // being repaired. m_shardCount is for FACET_RANGE and SLABS, and
+    // m_maxShardBytes for MAX_BYTES.
+    bool m_shard;
+    ShardMode m_shardMode;
+    uint32_t m_shardCount;
+    uint64_t m_maxShardBytes;
+
+    // Merge mode. Enabled if an output file is given, in which case the
+    // input files are merged into it and m_inputFile is empty.
+    std::string m_mergeOutputFile;
+    std::vector<std::string> m_mergeInputFiles;
+
+    // Repairs made without asking.
+    bool m_clearHeader;
+    bool m_clearAttributes;
+
+    // Watch mode. Enabled if any directories are given, in which case
+    // there's no input file.
+    std::vector<std::string> m_watchDirectories;
+    std::string m_outputDirectory;
+    unsigned m_workerCount;
+
+    // Server mode. Enabled if a socket path is given, in which case
+    // there's no input file. Shares m_workerCount with watch mode.
+    std::string m_serverSocketPath;
+
+    // Metrics for watch and server mode. Served over HTTP if a port is
+    // given, and/or rewritten every m_metricsInterval seconds if a file is.
+    uint16_t m_metricsPort;
+    std::string m_metricsFile;
+    unsigned m_metricsInterval;
+
+    // Instrumentation. Printed at exit, as JSON if m_statsAsJson is set.
+    // The trace is written at exit too, if a file is given.
+    bool m_stats;
+    bool m_statsAsJson;
+    std::string m_traceFile;
+
+    // Repair cache. Disabled if the directory is empty.
+    std::string m_cacheDirectory;
+    uint64_t m_cacheSizeInBytes;
+
+    // Geometric transform. Applied as center, then scale, then translate.
+    bool m_center;
+    float m_scale;
+    Vec3 m_translation;
+};
+
+/**
+ * Parses the command line arguments.
+ *
+ * @throws std::runtime_error if the arguments are malformed.
+ */
+CommandLineOptions parseCommandLine(int argc, const char** argv);
+
+/**
+ * Returns the usage text, including the list of supported options.
+ */
+std::string getUsageString();
+
+#endif
@@ -0,0 +1,597 @@
+#include "CompressedByteStream.h"
+#include "PipelinedByteStream.h"
+#include "FileUtils.h"
+#include "Contracts.h"
+#include "CallGuard.h"
+
+#if defined(STLREPAIR_WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(STLREPAIR_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const uint8_t GZIP_MAGIC[] = { 0x1f, 0x8b };
+    const uint8_t ZSTD_MAGIC[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+    std::string getFormatName(CompressionFormat format)
+    {
+        switch (format)
+        {
+        case CompressionFormat::GZIP: return "gzip";
+        case CompressionFormat::ZSTD: return "zstd";
+        default: return "uncompressed";
+        }
+    }
+
+    std::runtime_error makeUnsupportedError(CompressionFormat format)
+    {
+        return std::runtime_error(getFormatName(format) + " compression isn't supported in this build.");
+    }
+
+    bool endsWith(const std::string& text, const std::string& suffix)
+    {
+        if (text.size() < suffix.size())
+            return false;
+
+        return std::equal(suffix.begin(), suffix.end(), text.end() - suffix.size(),
+            [](char a, char b) { return a == tolower(static_cast<unsigned char>(b)); });
+    }
+
+    /**
+     * Decompression, whatever the format. Decodes as much as it can of the
+     * input into the output and says how much of each it used.
+     */
+    class Decoder
+    {
+    public:
+
+        virtual ~Decoder() {}
+
+        //! Starts over, as though nothing had been decoded yet.
+        virtual void reset() = 0;
+
+        virtual void decode(const uint8_t* pInput, size_t inputSize, size_t& inputUsed,
+            uint8_t* pOutput, size_t outputSize, size_t& outputUsed) = 0;
+
+        //! Returns true if the last decode() stopped at the end of a whole member or frame.
+        virtual bool isAtStreamEnd() const = 0;
+    };
+
+    /**
+     * Compression, whatever the format. Encodes as much as it can of the
+     * input into the output and says how much of each it used. Once finish
+     * is passed, returns true when everything's been written out.
+     */
+    class Encoder
+    {
+    public:
+
+        virtual ~Encoder() {}
+
+        virtual bool encode(const uint8_t* pInput, size_t inputSize, size_t& inputUsed,
+            uint8_t* pOutput, size_t outputSize, size_t& outputUsed, bool finish) = 0;
+    };
+
+#if defined(STLREPAIR_WITH_ZLIB)
+
+    uInt clampToUInt(size_t size)
+    {
+        return static_cast<uInt>(std::min<size_t>(size, std::numeric_limits<uInt>::max()));
+    }
+
+    class GzipDecoder : public Decoder
+    {
+    public:
+
+        GzipDecoder() :
+            m_isAtStreamEnd(false)
+        {
+            memset(&m_stream, 0, sizeof(m_stream));
+            if (inflateInit2(&m_stream, 15 + 16) != Z_OK)
+                throw std::runtime_error("Could not start gzip decompression.");
+        }
+
+        ~GzipDecoder()
+        {
+            inflateEnd(&m_stream);
+        }
+
+        void reset() override
+        {
+            inflateReset(&m_stream);
+            m_isAtStreamEnd = false;
+        }
+
+        void decode(const uint8_t* pInput, size_t inputSize, size_t& inputUsed,
+            uint8_t* pOutput, size_t outputSize, size_t& outputUsed) override
+        {
+            inputUsed = 0;
+            outputUsed = 0;
+
+            // Another member may follow the one that just ended.
+            if (m_isAtStreamEnd)
+            {
+                if (inputSize == 0)
+                    return;
+                reset();
+            }
+
+            m_stream.next_in = const_cast<Bytef*>(pInput);
+            m_stream.avail_in = clampToUInt(inputSize);
+            m_stream.next_out = pOutput;
+            m_stream.avail_out = clampToUInt(outputSize);
+            const uInt availableIn = m_stream.avail_in;
+            const uInt availableOut = m_stream.avail_out;
+
+            const int result = inflate(&m_stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END)
+                m_isAtStreamEnd = true;
+            else if ((result != Z_OK) && (result != Z_BUF_ERROR))
+                throw std::runtime_error("Corrupt gzip data.");
+
+            inputUsed = availableIn - m_stream.avail_in;
+            outputUsed = availableOut - m_stream.avail_out;
+        }
+
+        bool isAtStreamEnd() const override { return m_isAtStreamEnd; }
+
+    private:
+
+        z_stream m_stream;
+        bool m_isAtStreamEnd;
+    };
+
+    class GzipEncoder : public Encoder
+    {
+    public:
+
+        GzipEncoder()
+        {
+            memset(&m_stream, 0, sizeof(m_stream));
+            if (deflateInit2(&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                throw std::runtime_error("Could not start gzip compression.");
+        }
+
+        ~GzipEncoder()
+        {
+            deflateEnd(&m_stream);
+        }
+
+        bool encode(const uint8_t* pInput, size_t inputSize, size_t& inputUsed,
+            uint8_t* pOutput, size_t outputSize, size_t& outputUsed, bool finish) override
+        {
+            m_stream.next_in = const_cast<Bytef*>(pInput);
+            m_stream.avail_in = clampToUInt(inputSize);
+            m_stream.next_out = pOutput;
+            m_stream.avail_out = clampToUInt(outputSize);
+            const uInt availableIn = m_stream.avail_in;
+            const uInt availableOut = m_stream.avail_out;
+
+            // Only finish once the last of the input is in.
+            const bool isLastInput = finish && (m_stream.avail_in == inputSize);
+            const int result = deflate(&m_stream, isLastInput ? Z_FINISH : Z_NO_FLUSH);
+            if ((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR))
+                throw std::runtime_error("gzip compression failed.");
+
+            inputUsed = availableIn - m_stream.avail_in;
+            outputUsed = availableOut - m_stream.avail_out;
+            return result == Z_STREAM_END;
+        }
+
+    private:
+
+        z_stream m_stream;
+    };
+
+#endif
+
+#if defined(STLREPAIR_WITH_ZSTD)
+
+    class ZstdDecoder : public Decoder
+    {
+    public:
+
+        ZstdDecoder() :
+            m_pContext(ZSTD_createDCtx()),
+            m_isAtStreamEnd(false)
+        {
+            if (!m_pContext)
+                throw std::runtime_error("Could not start zstd decompression.");
+        }
+
+        ~ZstdDecoder()
+        {
+            ZSTD_freeDCtx(m_pContext);
+        }
+
+        void reset() override
+        {
+            ZSTD_DCtx_reset(m_pContext, ZSTD_reset_session_only);
+            m_isAtStreamEnd = false;
+        }
+
+        void decode(const uint8_t* pInput, size_t inputSize, size_t& inputUsed,
+            uint8_t* pOutput, size_t outputSize, size_t& outputUsed) override
+        {
+            ZSTD_inBuffer input = { pInput, inputSize, 0 };
+            ZSTD_outBuffer output = { pOutput, outputSize, 0 };
+
+            // Frames follow one another without any help from us.
+            const size_t result = ZSTD_decompressStream(m_pContext, &output, &input);
+            if (ZSTD_isError(result))
+                throw std::runtime_error(std::string("Corrupt zstd data - ") + ZSTD_getErrorName(result));
+
+            if ((input.pos > 0) || (output.pos > 0))
+                m_isAtStreamEnd = (result == 0);
+
+            inputUsed = input.pos;
+            outputUsed = output.pos;
+        }
+
+        bool isAtStreamEnd() const override { return m_isAtStreamEnd; }
+
+    private:
+
+        ZSTD_DCtx* m_pContext;
+        bool m_isAtStreamEnd;
+    };
+
+    class ZstdEncoder : public Encoder
+    {
+    public:
+
+        ZstdEncoder() :
+            m_pContext(ZSTD_createCCtx())
+        {
+            if (!m_pContext)
+                throw std::runtime_error("Could not start zstd compression.");
+            ZSTD_CCtx_setParameter(m_pContext, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+        }
+
+        ~ZstdEncoder()
+        {
+            ZSTD_freeCCtx(m_pContext);
+        }
+
+        bool encode(const uint8_t* pInput, size_t inputSize, size_t& inputUsed,
+            uint8_t* pOutput, size_t outputSize, size_t& outputUsed, bool finish) override
+        {
+            ZSTD_inBuffer input = { pInput, inputSize, 0 };
+            ZSTD_outBuffer output = { pOutput, outputSize, 0 };
+
+            const size_t result = ZSTD_compressStream2(m_pContext, &output, &input, finish ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(result))
+                throw std::runtime_error(std::string("zstd compression failed - ") + ZSTD_getErrorName(result));
+
+            inputUsed = input.pos;
+            outputUsed = output.pos;
+            return finish && (result == 0);
+        }
+
+    private:
+
+        ZSTD_CCtx* m_pContext;
+    };
+
+#endif
+
+    std::unique_ptr<Decoder> createDecoder(CompressionFormat format)
+    {
+#if defined(STLREPAIR_WITH_ZLIB)
+        if (format == CompressionFormat::GZIP)
+            return std::make_unique<GzipDecoder>();
+#endif
+#if defined(STLREPAIR_WITH_ZSTD)
+        if (format == CompressionFormat::ZSTD)
+            return std::make_unique<ZstdDecoder>();
+#endif
+        throw makeUnsupportedError(format);
+    }
+
+    std::unique_ptr<Encoder> createEncoder(CompressionFormat format)
+    {
+#if defined(STLREPAIR_WITH_ZLIB)
+        if (format == CompressionFormat::GZIP)
+            return std::make_unique<GzipEncoder>();
+#endif
+#if defined(STLREPAIR_WITH_ZSTD)
+        if (format == CompressionFormat::ZSTD)
+            return std::make_unique<ZstdEncoder>();
+#endif
+        throw makeUnsupportedError(format);
+    }
+
+    /**
+     * See createDecompressingByteSource().
+     */
+    class DecompressingByteSource : public ByteSource
+    {
+    public:
+
+        DecompressingByteSource(std::unique_ptr<ByteSource> spSource, CompressionFormat format) :
+            m_spSource(std::move(spSource)),
+            m_spDecoder(createDecoder(format)),
+            m_format(format),
+            m_input(COMPRESSED_BUFFER_SIZE),
+            m_inputBegin(0),
+            m_inputEnd(0),
+            m_isEndOfInput(false),
+            m_position(0)
+        {
+            precondition_throw(m_spSource != nullptr, std::runtime_error("Decompression requires a source."));
+        }
+
+        size_t read(uint8_t* pBuffer, size_t size) override
+        {
+            size_t bytesRead = 0;
+
+            while ((bytesRead == 0) && (size > 0))
+            {
+                if ((m_inputBegin == m_inputEnd) && !m_isEndOfInput)
+                {
+                    m_inputBegin = 0;
+                    m_inputEnd = m_spSource->read(m_input.data(), m_input.size());
+                    m_isEndOfInput = (m_inputEnd == 0);
+                }
+
+                size_t inputUsed = 0;
+                size_t outputUsed = 0;
+                m_spDecoder->decode(m_input.data() + m_inputBegin, m_inputEnd - m_inputBegin, inputUsed,
+                    pBuffer, size, outputUsed);
+                m_inputBegin += inputUsed;
+                bytesRead += outputUsed;
+
+                if ((inputUsed == 0) && (outputUsed == 0))
+                {
+                    if (m_inputBegin < m_inputEnd)
+                        throw std::runtime_error("Corrupt " + getFormatName(m_format) + " data.");
+
+                    if (m_isEndOfInput)
+                    {
+                        if (!m_spDecoder->isAtStreamEnd())
+                            throw std::runtime_error("Compressed " + getFormatName(m_format) + " data ends part way through.");
+                        break;
+                    }
+                }
+            }
+
+            m_position += bytesRead;
+            return bytesRead;
+        }
+
+        bool seek(uint64_t offset) override
+        {
+            if (offset < m_position)
+            {
+                if (!m_spSource->seek(0))
+                    return false;
+
+                m_spDecoder->reset();
+                m_inputBegin = 0;
+                m_inputEnd = 0;
+                m_isEndOfInput = false;
+                m_position = 0;
+            }
+
+            std::vector<uint8_t> discarded(static_cast<size_t>(std::min<uint64_t>(offset - m_position, COMPRESSED_BUFFER_SIZE)));
+            while (m_position < offset)
+            {
+                const size_t bytesToSkip = static_cast<size_t>(std::min<uint64_t>(offset - m_position, discarded.size()));
+                if (read(discarded.data(), bytesToSkip) == 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+    private:
+
+        std::unique_ptr<ByteSource> m_spSource;
+        std::unique_ptr<Decoder> m_spDecoder;
+        const CompressionFormat m_format;
+
+        // Bytes [m_inputBegin, m_inputEnd) of m_input haven't been decoded yet.
+        std::vector<uint8_t> m_input;
+        size_t m_inputBegin;
+        size_t m_inputEnd;
+        bool m_isEndOfInput;
+
+        uint64_t m_position;
+    };
+
+    /**
+     * See createCompressingByteSink().
+     */
+    class CompressingByteSink : public ByteSink
+    {
+    public:
+
+        CompressingByteSink(std::unique_ptr<ByteSink> spSink, CompressionFormat format) :
+            m_spSink(std::move(spSink)),
+            m_spEncoder(createEncoder(format)),
+            m_output(COMPRESSED_BUFFER_SIZE),
+            m_outputSize(0),
+            m_isClosed(false)
+        {
+            precondition_throw(m_spSink != nullptr, std::runtime_error("Compression requires a sink."));
+        }
+
+        void write(const uint8_t* pData, size_t size) override
+        {
+            invariant_throw(!m_isClosed, std::runtime_error("Sink already closed!"));
+
+            while (size > 0)
+            {
+                size_t inputUsed = 0;
+                encode(pData, size, inputUsed, false);
+                pData += inputUsed;
+                size -= inputUsed;
+            }
+        }
+
+        //! Writes out the end of the compressed stream, then closes the sink underneath.
+        void close() override
+        {
+            if (m_isClosed)
+                return;
+            m_isClosed = true;
+
+            size_t inputUsed = 0;
+            while (!encode(nullptr, 0, inputUsed, true))
+            {
+            }
+
+            if (m_outputSize > 0)
+                flushOutput();
+            m_spSink->close();
+        }
+
+    private:
+
+        bool encode(const uint8_t* pData, size_t size, size_t& inputUsed, bool finish)
+        {
+            size_t outputUsed = 0;
+            const bool isFinished = m_spEncoder->encode(pData, size, inputUsed,
+                m_output.data() + m_outputSize, m_output.size() - m_outputSize, outputUsed, finish);
+            m_outputSize += outputUsed;
+
+            if (m_outputSize == m_output.size())
+                flushOutput();
+
+            return isFinished;
+        }
+
+        void flushOutput()
+        {
+            m_spSink->write(m_output.data(), m_outputSize);
+            m_outputSize = 0;
+        }
+
+        std::unique_ptr<ByteSink> m_spSink;
+        std::unique_ptr<Encoder> m_spEncoder;
+        std::vector<uint8_t> m_output;
+        size_t m_outputSize;
+        bool m_isClosed;
+    };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+CompressionFormat detectCompressionFormat(const std::string& filepath)
+{
+    FILE* pFile = fopen(filepath.c_str(), "rb");
+    if (!pFile)
+        return CompressionFormat::NONE;
+    auto closeGuard = makeCallGuard([&]() { fclose(pFile); });
+
+    uint8_t magic[sizeof(ZSTD_MAGIC)];
+    const size_t bytesRead = fread(magic, 1, sizeof(magic), pFile);
+
+    if ((bytesRead >= sizeof(GZIP_MAGIC)) && (memcmp(magic, GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0))
+        return CompressionFormat::GZIP;
+    if ((bytesRead >= sizeof(ZSTD_MAGIC)) && (memcmp(magic, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0))
+        return CompressionFormat::ZSTD;
+
+    return CompressionFormat::NONE;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+CompressionFormat getCompressionFormatFromPath(const std::string& filepath)
+{
+    if (endsWith(filepath, ".gz"))
+        return CompressionFormat::GZIP;
+    if (endsWith(filepath, ".zst"))
+        return CompressionFormat::ZSTD;
+
+    return CompressionFormat::NONE;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool isCompressionSupported(CompressionFormat format)
+{
+    switch (format)
+    {
+    case CompressionFormat::NONE:
+        return true;
+#if defined(STLREPAIR_WITH_ZLIB)
+    case CompressionFormat::GZIP:
+        return true;
+#endif
+#if defined(STLREPAIR_WITH_ZSTD)
+    case CompressionFormat::ZSTD:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSource> createDecompressingByteSource(std::unique_ptr<ByteSource> spSource,
+    CompressionFormat format)
+{
+    precondition_throw(format != CompressionFormat::NONE, std::runtime_error("No compression format given."));
+    return std::make_unique<DecompressingByteSource>(std::move(spSource), format);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSink> createCompressingByteSink(std::unique_ptr<ByteSink> spSink,
+    CompressionFormat format)
+{
+    precondition_throw(format != CompressionFormat::NONE, std::runtime_error("No compression format given."));
+    return std::make_unique<CompressingByteSink>(std::move(spSink), format);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSource> openCompressedFileByteSource(const std::string& filepath)
+{
+    const CompressionFormat format = detectCompressionFormat(filepath);
+    if (format == CompressionFormat::NONE)
+        throw std::runtime_error("Specified file isn't compressed - " + filepath);
+
+    return std::make_unique<PrefetchingByteSource>(
+        createDecompressingByteSource(std::make_unique<FileByteSource>(filepath), format));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::uintmax_t getUncompressedSize(const std::string& filepath)
+{
+    const CompressionFormat format = detectCompressionFormat(filepath);
+    if (format == CompressionFormat::NONE)
+        return FileUtils::getFileSize(filepath);
+
+    std::unique_ptr<ByteSource> spSource =
+        createDecompressingByteSource(std::make_unique<FileByteSource>(filepath), format);
+
+    std::vector<uint8_t> buffer(COMPRESSED_BUFFER_SIZE);
+    std::uintmax_t size = 0;
+    while (size_t bytesRead = spSource->read(buffer.data(), buffer.size()))
+        size += bytesRead;
+
+    return size;
+}
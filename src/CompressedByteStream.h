@@ -0,0 +1,90 @@
+#ifndef STLREPAIR_COMPRESSEDBYTESTREAM__H_
+#define STLREPAIR_COMPRESSEDBYTESTREAM__H_
+
+#include "ByteStream.h"
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+/**
+ * Size of the buffer compressed data is read into or written from. The
+ * decompressed side is bounded by whoever's reading (see
+ * openCompressedFileByteSource()).
+ */
+constexpr const size_t COMPRESSED_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * Ways an STL can be compressed.
+ */
+enum class CompressionFormat
+{
+    NONE,
+    GZIP,       //!< .gz. Needs a build with STLREPAIR_WITH_ZLIB defined.
+    ZSTD        //!< .zst. Needs a build with STLREPAIR_WITH_ZSTD defined.
+};
+
+/**
+ * Returns how the file is compressed, going by the magic bytes at its
+ * start. Anything that isn't gzip or zstd, or can't be read, is NONE.
+ */
+CompressionFormat detectCompressionFormat(const std::string& filepath);
+
+/**
+ * Returns how a file written to the given path ought to be compressed,
+ * going by its extension (.gz or .zst).
+ */
+CompressionFormat getCompressionFormatFromPath(const std::string& filepath);
+
+/**
+ * Returns true if this build can read and write the given format.
+ */
+bool isCompressionSupported(CompressionFormat format);
+
+/**
+ * Creates a source that decompresses what it reads from the given one.
+ * Only COMPRESSED_BUFFER_SIZE bytes of compressed data are held at a time.
+ * Several gzip members or zstd frames back to back are read as one.
+ *
+ * Seeking forwards decompresses and throws away everything in between.
+ * Seeking backwards starts over from the beginning, so the source underneath
+ * has to be able to seek back to 0.
+ *
+ * Reading throws if the compressed data is corrupt or ends part way through.
+ *
+ * @throws std::runtime_error if the format isn't supported in this build.
+ */
+std::unique_ptr<ByteSource> createDecompressingByteSource(std::unique_ptr<ByteSource> spSource,
+    CompressionFormat format);
+
+/**
+ * Creates a sink that compresses everything written to it on its way to the
+ * given one. A compressed stream can't be gone back over, so patch() always
+ * returns false.
+ *
+ * @throws std::runtime_error if the format isn't supported in this build.
+ */
+std::unique_ptr<ByteSink> createCompressingByteSink(std::unique_ptr<ByteSink> spSink,
+    CompressionFormat format);
+
+/**
+ * Opens a compressed file for reading as the data it holds. The format
+ * comes from detectCompressionFormat(). Decompression runs on a background
+ * thread (see PrefetchingByteSource), so it overlaps whatever's done with
+ * the data.
+ *
+ * @throws std::runtime_error if the file can't be opened, isn't compressed
+ *         or its format isn't supported in this build.
+ */
+std::unique_ptr<ByteSource> openCompressedFileByteSource(const std::string& filepath);
+
+/**
+ * Returns the size of the data a file holds. That's just the file size for
+ * a file that isn't compressed. A compressed one is decompressed in full to
+ * find out, as neither format records it reliably.
+ *
+ * @throws std::runtime_error
+ */
+std::uintmax_t getUncompressedSize(const std::string& filepath);
+
+#endif
@@ -0,0 +1,219 @@
+#include "ConnectedComponents.h"
+#include "BinarySTLFileWriter.h"
+#include "STLGeometry.h"
+#include "FileUtils.h"
+#include "Parallel.h"
+#include "Contracts.h"
+
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+
+namespace
+{
+    struct VertexRef
+    {
+        std::array<uint32_t, 3> key;
+        uint32_t triangle;
+    };
+
+    bool operator<(const VertexRef& lhs, const VertexRef& rhs)
+    {
+        return lhs.key < rhs.key;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+ConcurrentUnionFind::ConcurrentUnionFind(uint32_t size) :
+    m_spParents(new std::atomic<uint32_t>[size]),
+    m_size(size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+        m_spParents[i].store(i, std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint32_t ConcurrentUnionFind::find(uint32_t element)
+{
+    while (true)
+    {
+        uint32_t parent = m_spParents[element].load(std::memory_order_relaxed);
+        if (parent == element)
+            return element;
+
+        // Path halving. If another thread beats us to it, that's fine.
+        // The grandparent is still an ancestor.
+        uint32_t grandparent = m_spParents[parent].load(std::memory_order_relaxed);
+        if (parent != grandparent)
+            m_spParents[element].compare_exchange_weak(parent, grandparent,
+                std::memory_order_relaxed);
+
+        element = grandparent;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void ConcurrentUnionFind::unite(uint32_t element1, uint32_t element2)
+{
+    while (true)
+    {
+        element1 = find(element1);
+        element2 = find(element2);
+        if (element1 == element2)
+            return;
+
+        if (element1 < element2)
+            std::swap(element1, element2);
+
+        // Only a root may be re-parented. If element1 stopped being a root
+        // since we found it, go around again.
+        uint32_t expected = element1;
+        if (m_spParents[element1].compare_exchange_strong(expected, element2,
+                std::memory_order_acq_rel))
+            return;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+ComponentLabels findConnectedComponents(const STLMesh& mesh)
+{
+    precondition_throw(mesh.size() < std::numeric_limits<uint32_t>::max(),
+        std::runtime_error("Too many triangles to label."));
+
+    const uint32_t triangleCount = static_cast<uint32_t>(mesh.size());
+
+    ComponentLabels labels;
+    labels.m_componentCount = 0;
+    labels.m_triangleComponents.resize(triangleCount);
+
+    // Gather every vertex along with the triangle it came from, then sort
+    // so that welded vertices sit next to each other.
+    std::vector<VertexRef> refs(size_t(triangleCount) * 3);
+    parallelFor(triangleCount, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            STLFacet facet = decodeFacet(mesh.m_triangles[i]);
+            for (size_t v = 0; v < 3; ++v)
+                refs[i * 3 + v] = { computeVertexKey(facet.vertices[v]), static_cast<uint32_t>(i) };
+        }
+    });
+
+    parallelSort(refs, [](const VertexRef& lhs, const VertexRef& rhs) { return lhs < rhs; });
+
+    // Each run of identical keys is one welded vertex. Every triangle
+    // touching it gets joined to the first one in the run. A chunk only
+    // handles runs that start inside it.
+    ConcurrentUnionFind sets(triangleCount);
+    parallelFor(refs.size(), [&](size_t begin, size_t end)
+    {
+        size_t i = begin;
+        if (i > 0)
+        {
+            while ((i < end) && (refs[i].key == refs[begin - 1].key))
+                ++i;
+        }
+
+        while (i < end)
+        {
+            size_t j = i + 1;
+            while ((j < refs.size()) && (refs[j].key == refs[i].key))
+            {
+                sets.unite(refs[i].triangle, refs[j].triangle);
+                ++j;
+            }
+            i = j;
+        }
+    });
+
+    // Roots are always the smallest index in their set, so walking the
+    // triangles in order visits each root before any of its members.
+    std::vector<uint32_t> roots(triangleCount);
+    parallelFor(triangleCount, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            roots[i] = sets.find(static_cast<uint32_t>(i));
+    });
+
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        if (roots[i] == i)
+            labels.m_triangleComponents[i] = labels.m_componentCount++;
+        else
+            labels.m_triangleComponents[i] = labels.m_triangleComponents[roots[i]];
+    }
+
+    return labels;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::vector<std::string> writeConnectedComponents(const STLMesh& mesh,
+    const ComponentLabels& labels, const std::string& outputPathTemplate,
+    bool zeroOutHeader, bool zeroAttributeByteCounts)
+{
+    precondition_throw(!outputPathTemplate.empty(),
+        std::runtime_error("Output filename cannot be empty."));
+    precondition_throw(labels.m_triangleComponents.size() == mesh.size(),
+        std::runtime_error("Component labels don't match the mesh."));
+
+    // Bucket the triangle indices by component.
+    std::vector<size_t> offsets(size_t(labels.m_componentCount) + 1, 0);
+    for (uint32_t component : labels.m_triangleComponents)
+        ++offsets[component + 1];
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+
+    std::vector<uint32_t> order(mesh.size());
+    std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < mesh.size(); ++i)
+        order[cursors[labels.m_triangleComponents[i]]++] = static_cast<uint32_t>(i);
+
+    // Paths are picked up front, on one thread, so workers can't race
+    // each other for the same unused name.
+    std::string dir, base, ext;
+    FileUtils::splitPath(outputPathTemplate, dir, base, ext);
+
+    std::vector<std::string> outputPaths(labels.m_componentCount);
+    for (uint32_t component = 0; component < labels.m_componentCount; ++component)
+    {
+        outputPaths[component] = FileUtils::generateUniqueFilePath(
+            dir + base + "_part" + std::to_string(component + 1) + "." + ext);
+    }
+
+    STLBinaryHeader header = mesh.m_header;
+    if (zeroOutHeader)
+        memset(header.data(), 0, header.size());
+
+    parallelFor(labels.m_componentCount, [&](size_t begin, size_t end)
+    {
+        for (size_t component = begin; component < end; ++component)
+        {
+            const size_t first = offsets[component];
+            const size_t last = offsets[component + 1];
+
+            BinarySTLFileWriter writer(outputPaths[component], header,
+                static_cast<uint32_t>(last - first));
+
+            for (size_t i = first; i < last; ++i)
+            {
+                const uint32_t triangle = order[i];
+                writer.writeTriangleData(mesh.m_triangles[triangle],
+                    zeroAttributeByteCounts ? 0 : mesh.m_attributeByteCounts[triangle]);
+            }
+
+            writer.finalize();
+        }
+    }, 1);
+
+    return outputPaths;
+}
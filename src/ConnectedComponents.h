@@ -0,0 +1,80 @@
+#ifndef STLREPAIR_CONNECTEDCOMPONENTS__H_
+#define STLREPAIR_CONNECTEDCOMPONENTS__H_
+
+#include "STLMesh.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Lock-free disjoint set over the range [0, size). Any number of threads
+ * may call find() and unite() concurrently.
+ *
+ * Roots are always linked from the larger index to the smaller one, which
+ * keeps the forest acyclic without needing ranks or locks. Paths are
+ * halved during find().
+ */
+class ConcurrentUnionFind
+{
+public:
+
+    //! Constructor. Every element starts out in its own set.
+    explicit ConcurrentUnionFind(uint32_t size);
+
+    //! Returns the representative of the set containing the given element.
+    uint32_t find(uint32_t element);
+
+    //! Merges the sets containing the two given elements.
+    void unite(uint32_t element1, uint32_t element2);
+
+    //! Returns the number of elements.
+    uint32_t size() const { return m_size; }
+
+private:
+
+    std::unique_ptr<std::atomic<uint32_t>[]> m_spParents;
+    uint32_t m_size;
+};
+
+/**
+ * The result of labelling a mesh's connected components.
+ */
+struct ComponentLabels
+{
+    //! Number of distinct components found.
+    uint32_t m_componentCount;
+
+    //! Component index for each triangle, in mesh order. Components are
+    //! numbered in order of their first triangle.
+    std::vector<uint32_t> m_triangleComponents;
+};
+
+/**
+ * Finds the connected components of the given mesh. Two triangles are
+ * connected if they share a welded (bit-identical) vertex.
+ */
+ComponentLabels findConnectedComponents(const STLMesh& mesh);
+
+/**
+ * Writes each component to its own binary STL, in parallel. Output paths are
+ * derived from the given template by appending "_partN" to the base name.
+ *
+ * @param mesh The source mesh.
+ * @param labels The labels produced by findConnectedComponents().
+ * @param outputPathTemplate Path used to derive the output file names.
+ * @param zeroOutHeader If true, each part is given an empty header. Otherwise
+ *  the source header is copied.
+ * @param zeroAttributeByteCounts If true, attribute byte counts are cleared.
+ *
+ * @return The paths of the files written, in component order.
+ *
+ * @throws std::runtime_error
+ */
+std::vector<std::string> writeConnectedComponents(const STLMesh& mesh,
+    const ComponentLabels& labels, const std::string& outputPathTemplate,
+    bool zeroOutHeader, bool zeroAttributeByteCounts);
+
+#endif
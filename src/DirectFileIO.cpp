@@ -0,0 +1,447 @@
+#include "DirectFileIO.h"
+#include "Contracts.h"
+#include "PositionalFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    size_t roundUpToAlignment(size_t size)
+    {
+        size = std::max<size_t>(size, 1);
+        return ((size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT) * DIRECT_IO_ALIGNMENT;
+    }
+
+    /**
+     * Heap buffer whose start is aligned to DIRECT_IO_ALIGNMENT.
+     */
+    class AlignedBuffer
+    {
+    public:
+
+        explicit AlignedBuffer(size_t size) :
+            m_storage(size + DIRECT_IO_ALIGNMENT),
+            m_size(size)
+        {
+            const uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.data());
+            m_pData = m_storage.data() + (DIRECT_IO_ALIGNMENT - address % DIRECT_IO_ALIGNMENT) % DIRECT_IO_ALIGNMENT;
+        }
+
+        uint8_t* data() { return m_pData; }
+        size_t size() const { return m_size; }
+
+    private:
+
+        std::vector<uint8_t> m_storage;
+        uint8_t* m_pData;
+        size_t m_size;
+    };
+
+    /**
+     * Opens a file so that its data bypasses the page cache, if the file
+     * system allows it, or normally if not. Sets isDirect to say which.
+     */
+    NativeFileHandle openUncached(const std::string& filepath, bool isForWriting, bool& isDirect)
+    {
+#if defined(_WIN32)
+        const DWORD access = isForWriting ? GENERIC_WRITE : GENERIC_READ;
+        const DWORD sharing = isForWriting ? 0 : FILE_SHARE_READ;
+        const DWORD disposition = isForWriting ? CREATE_ALWAYS : OPEN_EXISTING;
+        const DWORD hints = isForWriting ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_SEQUENTIAL_SCAN;
+
+        HANDLE handle = CreateFileA(filepath.c_str(), access, sharing, nullptr, disposition,
+            hints | FILE_FLAG_NO_BUFFERING, nullptr);
+        isDirect = (handle != INVALID_HANDLE_VALUE);
+        if (!isDirect)
+            handle = CreateFileA(filepath.c_str(), access, sharing, nullptr, disposition, hints, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Unknown error when opening " + filepath);
+        return handle;
+#else
+        const int flags = isForWriting ? (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC);
+
+        int descriptor = -1;
+        isDirect = false;
+#if defined(O_DIRECT)
+        // EINVAL means the file system doesn't do direct I/O (tmpfs, some
+        // network file systems). Anything else is a real failure.
+        descriptor = open(filepath.c_str(), flags | O_DIRECT, 0644);
+        isDirect = (descriptor >= 0);
+        if (!isDirect && (errno == EINVAL))
+#endif
+            descriptor = open(filepath.c_str(), flags, 0644);
+        if (descriptor < 0)
+            throw std::runtime_error("Unknown error when opening " + filepath);
+
+#if defined(F_NOCACHE)
+        if (!isDirect)
+            fcntl(descriptor, F_NOCACHE, 1);
+#endif
+#if defined(POSIX_FADV_SEQUENTIAL)
+        if (!isDirect && !isForWriting)
+            posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        return descriptor;
+#endif
+    }
+
+    /**
+     * A file opened so that its data bypasses the page cache if at all
+     * possible. If the file system won't allow that, it's opened normally
+     * and dropFromCache() does the job after the fact instead.
+     *
+     * While isDirect() is true, every buffer, offset and size handed in must
+     * be aligned.
+     */
+    class UncachedFile
+    {
+    public:
+
+        UncachedFile(const std::string& filepath, bool isForWriting) :
+            m_isDirect(false),
+            m_file(openUncached(filepath, isForWriting, m_isDirect), filepath, true)
+        {
+        }
+
+        UncachedFile(const UncachedFile&) = delete;
+        UncachedFile& operator=(const UncachedFile&) = delete;
+
+        bool isDirect() const { return m_isDirect; }
+
+        /**
+         * Reads up to size bytes. Comes up short only at the end of the file.
+         */
+        size_t read(uint8_t* pBuffer, size_t size, uint64_t offset)
+        {
+            size_t totalBytesRead = 0;
+            while (totalBytesRead < size)
+            {
+                const size_t bytesRead = readOnce(pBuffer + totalBytesRead, size - totalBytesRead, offset + totalBytesRead);
+                if (bytesRead == 0)
+                    break;
+                totalBytesRead += bytesRead;
+
+                // An unaligned count from a direct read can only be the tail
+                // of the file, and we couldn't continue from there anyway.
+                if (m_isDirect && (totalBytesRead % DIRECT_IO_ALIGNMENT != 0))
+                    break;
+            }
+
+            return totalBytesRead;
+        }
+
+        void write(const uint8_t* pData, size_t size, uint64_t offset)
+        {
+            while (size > 0)
+            {
+                const size_t bytesWritten = writeOnce(pData, size, offset);
+                pData += bytesWritten;
+                offset += bytesWritten;
+                size -= bytesWritten;
+            }
+        }
+
+        /**
+         * Starts the kernel writing the given range back to disk without
+         * waiting for it to finish.
+         */
+        void startWriteback(uint64_t offset, size_t size)
+        {
+#if defined(__linux__)
+            if (!m_isDirect)
+                sync_file_range(m_file.getHandle(), static_cast<off_t>(offset), static_cast<off_t>(size), SYNC_FILE_RANGE_WRITE);
+#else
+            (void)offset;
+            (void)size;
+#endif
+        }
+
+        /**
+         * Evicts the given range from the page cache. A size of zero means
+         * through to the end of the file. Dirty pages can't be evicted, so
+         * for data we've written, isDirty makes us wait for it to reach the
+         * disk first.
+         */
+        void dropFromCache(uint64_t offset, size_t size, bool isDirty)
+        {
+#if !defined(_WIN32)
+            if (m_isDirect)
+                return;
+
+#if defined(__linux__)
+            if (isDirty)
+                sync_file_range(m_file.getHandle(), static_cast<off_t>(offset), static_cast<off_t>(size),
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+#else
+            (void)isDirty;
+#endif
+#if defined(POSIX_FADV_DONTNEED)
+            posix_fadvise(m_file.getHandle(), static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+#endif
+#else
+            (void)offset;
+            (void)size;
+            (void)isDirty;
+#endif
+        }
+
+        void truncate(uint64_t size)
+        {
+            m_file.setSize(size);
+        }
+
+        void close()
+        {
+            m_file.close();
+        }
+
+    private:
+
+        size_t readOnce(uint8_t* pBuffer, size_t size, uint64_t offset)
+        {
+            for (;;)
+            {
+                const int64_t bytesRead = m_file.tryReadAt(pBuffer, size, offset);
+                if (bytesRead >= 0)
+                    return static_cast<size_t>(bytesRead);
+
+                if ((bytesRead == -EINVAL) && m_isDirect)
+                {
+                    disableDirectIO();
+                    continue;
+                }
+                throw std::runtime_error("Error reading from file - " + std::string(strerror(static_cast<int>(-bytesRead))));
+            }
+        }
+
+        size_t writeOnce(const uint8_t* pData, size_t size, uint64_t offset)
+        {
+            for (;;)
+            {
+                const int64_t bytesWritten = m_file.tryWriteAt(pData, size, offset);
+                if (bytesWritten > 0)
+                    return static_cast<size_t>(bytesWritten);
+
+                if ((bytesWritten == -EINVAL) && m_isDirect)
+                {
+                    disableDirectIO();
+                    continue;
+                }
+                throw std::runtime_error("Error writing to file - " +
+                    std::string((bytesWritten < 0) ? strerror(static_cast<int>(-bytesWritten)) : "no progress"));
+            }
+        }
+
+        // Some devices want more alignment than we give them. They get
+        // cached I/O rather than nothing at all. Only POSIX reports that as
+        // EINVAL; Windows fails the open instead.
+        void disableDirectIO()
+        {
+#if defined(O_DIRECT)
+            fcntl(m_file.getHandle(), F_SETFL, fcntl(m_file.getHandle(), F_GETFL) & ~O_DIRECT);
+#endif
+            m_isDirect = false;
+        }
+
+        bool m_isDirect;
+        PositionalFile m_file;
+    };
+
+    class DirectFileByteSource : public ByteSource
+    {
+    public:
+
+        DirectFileByteSource(const std::string& filepath, size_t blockSize) :
+            m_file(filepath, false),
+            m_buffer(roundUpToAlignment(blockSize)),
+            m_bufferOffset(0),
+            m_bufferSize(0),
+            m_position(0),
+            m_endOffset(UINT64_MAX)
+        {
+        }
+
+        ~DirectFileByteSource()
+        {
+            if (m_bufferSize > 0)
+                m_file.dropFromCache(m_bufferOffset, m_bufferSize, false);
+        }
+
+        size_t read(uint8_t* pBuffer, size_t size) override
+        {
+            size_t bytesRead = 0;
+
+            while (bytesRead < size)
+            {
+                if ((m_position >= m_bufferOffset) && (m_position < m_bufferOffset + m_bufferSize))
+                {
+                    const size_t bufferIndex = static_cast<size_t>(m_position - m_bufferOffset);
+                    const size_t bytesToCopy = std::min(size - bytesRead, m_bufferSize - bufferIndex);
+                    memcpy(pBuffer + bytesRead, m_buffer.data() + bufferIndex, bytesToCopy);
+                    m_position += bytesToCopy;
+                    bytesRead += bytesToCopy;
+                    continue;
+                }
+
+                if (m_position >= m_endOffset)
+                    break;
+
+                // Direct reads have to start on an aligned offset, which is
+                // how the 84-byte header and every odd read size after it
+                // get handled. We read the aligned block around them.
+                fillBuffer(m_position - m_position % DIRECT_IO_ALIGNMENT);
+                if (m_position >= m_bufferOffset + m_bufferSize)
+                    break;
+            }
+
+            return bytesRead;
+        }
+
+        bool seek(uint64_t offset) override
+        {
+            m_position = offset;
+            return true;
+        }
+
+    private:
+
+        void fillBuffer(uint64_t offset)
+        {
+            if (m_bufferSize > 0)
+                m_file.dropFromCache(m_bufferOffset, m_bufferSize, false);
+
+            m_bufferOffset = offset;
+            m_bufferSize = 0;
+            m_bufferSize = m_file.read(m_buffer.data(), m_buffer.size(), offset);
+            if (m_bufferSize < m_buffer.size())
+                m_endOffset = offset + m_bufferSize;
+        }
+
+        UncachedFile m_file;
+        AlignedBuffer m_buffer;
+        uint64_t m_bufferOffset;
+        size_t m_bufferSize;
+        uint64_t m_position;
+        uint64_t m_endOffset;
+    };
+
+    class DirectFileByteSink : public ByteSink
+    {
+    public:
+
+        DirectFileByteSink(const std::string& filepath, size_t blockSize) :
+            m_file(filepath, true),
+            m_buffer(roundUpToAlignment(blockSize)),
+            m_bufferSize(0),
+            m_fileOffset(0),
+            m_isClosed(false)
+        {
+        }
+
+        ~DirectFileByteSink()
+        {
+            try
+            {
+                close();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        void write(const uint8_t* pData, size_t size) override
+        {
+            invariant_throw(!m_isClosed, std::runtime_error("Sink already closed!"));
+
+            while (size > 0)
+            {
+                const size_t bytesToCopy = std::min(size, m_buffer.size() - m_bufferSize);
+                memcpy(m_buffer.data() + m_bufferSize, pData, bytesToCopy);
+                m_bufferSize += bytesToCopy;
+                pData += bytesToCopy;
+                size -= bytesToCopy;
+
+                if (m_bufferSize == m_buffer.size())
+                    writeBuffer();
+            }
+        }
+
+        void close() override
+        {
+            if (m_isClosed)
+                return;
+            m_isClosed = true;
+
+            if (m_bufferSize > 0)
+            {
+                // Direct writes have to be whole aligned blocks, so the tail
+                // goes out padded and the padding is cut off afterwards.
+                const size_t dataSize = m_bufferSize;
+                const uint64_t fileSize = m_fileOffset + dataSize;
+                if (m_file.isDirect())
+                {
+                    m_bufferSize = roundUpToAlignment(dataSize);
+                    memset(m_buffer.data() + dataSize, 0, m_bufferSize - dataSize);
+                }
+
+                writeBuffer();
+                if (m_fileOffset != fileSize)
+                    m_file.truncate(fileSize);
+            }
+
+            m_file.dropFromCache(0, 0, true);
+            m_file.close();
+        }
+
+    private:
+
+        void writeBuffer()
+        {
+            m_file.write(m_buffer.data(), m_bufferSize, m_fileOffset);
+
+            // Get this block on its way to disk, and evict the one before it,
+            // which by now has most likely made it there.
+            m_file.startWriteback(m_fileOffset, m_bufferSize);
+            if (m_fileOffset >= m_buffer.size())
+                m_file.dropFromCache(m_fileOffset - m_buffer.size(), m_buffer.size(), true);
+
+            m_fileOffset += m_bufferSize;
+            m_bufferSize = 0;
+        }
+
+        UncachedFile m_file;
+        AlignedBuffer m_buffer;
+        size_t m_bufferSize;
+        uint64_t m_fileOffset;
+        bool m_isClosed;
+    };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSource> openDirectFileByteSource(const std::string& filepath, size_t blockSize)
+{
+    return std::make_unique<DirectFileByteSource>(filepath, blockSize);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSink> createDirectFileByteSink(const std::string& filepath, size_t blockSize)
+{
+    return std::make_unique<DirectFileByteSink>(filepath, blockSize);
+}
@@ -0,0 +1,49 @@
+#ifndef STLREPAIR_DIRECTFILEIO__H_
+#define STLREPAIR_DIRECTFILEIO__H_
+
+#include "ByteStream.h"
+
+#include <memory>
+#include <string>
+#include <cstddef>
+
+/**
+ * Alignment required of buffers, offsets and sizes for direct I/O. Covers
+ * both 512-byte and 4K sector devices.
+ */
+constexpr const size_t DIRECT_IO_ALIGNMENT = 4096;
+
+/**
+ * Default size of each direct read or write. Always rounded up to a multiple
+ * of DIRECT_IO_ALIGNMENT.
+ */
+constexpr const size_t DEFAULT_DIRECT_IO_BLOCK_SIZE = 1024 * 1024;
+
+/**
+ * Opens a file for reading without going through the page cache (O_DIRECT,
+ * or FILE_FLAG_NO_BUFFERING on Windows). Reads of any size at any offset are
+ * fine. They're served from aligned block-sized reads behind the scenes.
+ *
+ * Where the file system won't do direct I/O, the file is read normally and
+ * each block is dropped from the cache (posix_fadvise(DONTNEED)) once it's
+ * been consumed.
+ *
+ * @throws std::runtime_error if the file can't be opened.
+ */
+std::unique_ptr<ByteSource> openDirectFileByteSource(const std::string& filepath,
+    size_t blockSize = DEFAULT_DIRECT_IO_BLOCK_SIZE);
+
+/**
+ * Creates (or truncates) a file for writing without going through the page
+ * cache. The final partial block is padded out to the alignment on its way
+ * to disk, and the file is then truncated back to the size actually written.
+ *
+ * The fallback is the same as for reading. Written blocks are flushed and
+ * dropped from the cache as we go.
+ *
+ * @throws std::runtime_error if the file can't be created.
+ */
+std::unique_ptr<ByteSink> createDirectFileByteSink(const std::string& filepath,
+    size_t blockSize = DEFAULT_DIRECT_IO_BLOCK_SIZE);
+
+#endif
@@ -0,0 +1,186 @@
+#include "FacetBVH.h"
+#include "MortonCode.h"
+#include "Parallel.h"
+#include "Contracts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * Length of the common prefix of the keys of leaves i and j, where a
+     * key is the Morton code with the leaf index appended to break ties.
+     * Returns -1 when j is out of range.
+     */
+    int commonPrefix(const std::vector<uint64_t>& codes, int64_t i, int64_t j)
+    {
+        if ((j < 0) || (j >= static_cast<int64_t>(codes.size())))
+            return -1;
+
+        const uint64_t codeI = codes[static_cast<size_t>(i)];
+        const uint64_t codeJ = codes[static_cast<size_t>(j)];
+        if (codeI != codeJ)
+            return countLeadingZeros(codeI ^ codeJ);
+
+        return 64 + countLeadingZeros(static_cast<uint64_t>(i ^ j)) - 32;
+    }
+
+    FacetBVH::Box toBox(const STLFacet& facet)
+    {
+        FacetBVH::Box box;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float a = (&facet.vertices[0].x)[axis];
+            const float b = (&facet.vertices[1].x)[axis];
+            const float c = (&facet.vertices[2].x)[axis];
+            box.m_min[axis] = std::min(a, std::min(b, c));
+            box.m_max[axis] = std::max(a, std::max(b, c));
+        }
+        return box;
+    }
+
+    FacetBVH::Box merge(const FacetBVH::Box& box1, const FacetBVH::Box& box2)
+    {
+        FacetBVH::Box box;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            box.m_min[axis] = std::min(box1.m_min[axis], box2.m_min[axis]);
+            box.m_max[axis] = std::max(box1.m_max[axis], box2.m_max[axis]);
+        }
+        return box;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FacetBVH::FacetBVH(const STLMesh& mesh) :
+    m_root(LEAF_FLAG)
+{
+    precondition_throw(mesh.size() < LEAF_FLAG,
+        std::runtime_error("Too many triangles for a bounding volume hierarchy."));
+
+    const uint32_t count = static_cast<uint32_t>(mesh.size());
+    if (count == 0)
+        return;
+
+    // Sort the leaves along the Z-order curve.
+    std::vector<uint64_t> codes;
+    sortByMortonCode(mesh.m_triangles, codes, m_leafTriangles);
+
+    m_leafBoxes.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            m_leafBoxes[i] = toBox(decodeFacet(mesh.m_triangles[m_leafTriangles[i]]));
+    });
+
+    if (count == 1)
+        return;
+
+    // Internal node i always covers a range with one end at leaf i, which
+    // is what lets every node be built without looking at any other.
+    m_nodes.resize(count - 1);
+    std::vector<uint32_t> leafParents(count);
+    std::vector<uint32_t> nodeParents(count - 1, std::numeric_limits<uint32_t>::max());
+
+    parallelFor(count - 1, [&](size_t begin, size_t end)
+    {
+        for (size_t node = begin; node < end; ++node)
+        {
+            const int64_t i = static_cast<int64_t>(node);
+            const int direction = (commonPrefix(codes, i, i + 1) - commonPrefix(codes, i, i - 1)) >= 0 ? 1 : -1;
+            const int minPrefix = commonPrefix(codes, i, i - direction);
+
+            // Find the other end of the range.
+            int64_t maxLength = 2;
+            while (commonPrefix(codes, i, i + maxLength * direction) > minPrefix)
+                maxLength *= 2;
+
+            int64_t length = 0;
+            for (int64_t step = maxLength / 2; step >= 1; step /= 2)
+            {
+                if (commonPrefix(codes, i, i + (length + step) * direction) > minPrefix)
+                    length += step;
+            }
+            const int64_t j = i + length * direction;
+
+            // Find where the range splits.
+            const int nodePrefix = commonPrefix(codes, i, j);
+            int64_t split = 0;
+            int64_t divisor = 2;
+            int64_t step = 0;
+            do
+            {
+                step = (length + divisor - 1) / divisor;
+                if (commonPrefix(codes, i, i + (split + step) * direction) > nodePrefix)
+                    split += step;
+                divisor *= 2;
+            } while (step > 1);
+
+            const int64_t gamma = i + split * direction + std::min(direction, 0);
+            const uint32_t first = static_cast<uint32_t>(std::min(i, j));
+            const uint32_t last = static_cast<uint32_t>(std::max(i, j));
+
+            Node& current = m_nodes[node];
+            current.m_lastLeaf = last;
+
+            if (first == gamma)
+            {
+                current.m_left = static_cast<uint32_t>(gamma) | LEAF_FLAG;
+                leafParents[static_cast<size_t>(gamma)] = static_cast<uint32_t>(node);
+            }
+            else
+            {
+                current.m_left = static_cast<uint32_t>(gamma);
+                nodeParents[static_cast<size_t>(gamma)] = static_cast<uint32_t>(node);
+            }
+
+            if (last == gamma + 1)
+            {
+                current.m_right = static_cast<uint32_t>(gamma + 1) | LEAF_FLAG;
+                leafParents[static_cast<size_t>(gamma + 1)] = static_cast<uint32_t>(node);
+            }
+            else
+            {
+                current.m_right = static_cast<uint32_t>(gamma + 1);
+                nodeParents[static_cast<size_t>(gamma + 1)] = static_cast<uint32_t>(node);
+            }
+        }
+    });
+
+    // Fit the boxes bottom up. The second child to arrive at a node is the
+    // one that computes its box and carries on towards the root.
+    std::unique_ptr<std::atomic<uint32_t>[]> arrivals(new std::atomic<uint32_t>[count - 1]);
+    for (uint32_t i = 0; i < count - 1; ++i)
+        arrivals[i].store(0, std::memory_order_relaxed);
+
+    parallelFor(count, [&](size_t begin, size_t end)
+    {
+        for (size_t leaf = begin; leaf < end; ++leaf)
+        {
+            uint32_t node = leafParents[leaf];
+            while (node != std::numeric_limits<uint32_t>::max())
+            {
+                if (arrivals[node].fetch_add(1, std::memory_order_acq_rel) == 0)
+                    break;
+
+                Node& current = m_nodes[node];
+                const Box& left = (current.m_left & LEAF_FLAG) ?
+                    m_leafBoxes[current.m_left & ~LEAF_FLAG] : m_nodes[current.m_left].m_box;
+                const Box& right = (current.m_right & LEAF_FLAG) ?
+                    m_leafBoxes[current.m_right & ~LEAF_FLAG] : m_nodes[current.m_right].m_box;
+                current.m_box = merge(left, right);
+
+                node = nodeParents[node];
+            }
+        }
+    });
+
+    // Node 0 always covers the full range.
+    m_root = 0;
+}
@@ -0,0 +1,126 @@
+#ifndef STLREPAIR_FACETBVH__H_
+#define STLREPAIR_FACETBVH__H_
+
+#include "STLMesh.h"
+#include "STLGeometry.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Linear bounding volume hierarchy over the triangles of an STLMesh.
+ *
+ * Triangles are sorted by the Morton code of their centroids and the tree
+ * is built with Karras' "Maximizing Parallelism in the Construction of
+ * BVHs, Octrees, and k-d Trees" (2012). Every internal node can be built
+ * independently, so construction runs on all cores.
+ *
+ * Leaves are addressed by their position in Morton order, not by their
+ * index in the mesh. Use triangleIndex() to map back.
+ */
+class FacetBVH
+{
+public:
+
+    //! Bit set on child indices that refer to leaves rather than internal nodes.
+    static constexpr uint32_t LEAF_FLAG = 0x80000000u;
+
+    /**
+     * Compact box used by both nodes and leaves. Kept separate from
+     * BoundingBox so the node layout stays tightly packed.
+     */
+    struct Box
+    {
+        float m_min[3];
+        float m_max[3];
+    };
+
+    /**
+     * Internal node. Both children may be leaves (LEAF_FLAG set) or other
+     * internal nodes. Each node covers a contiguous range of leaves,
+     * ending at m_lastLeaf.
+     */
+    struct Node
+    {
+        Box m_box;
+        uint32_t m_left;
+        uint32_t m_right;
+        uint32_t m_lastLeaf;
+    };
+
+    //! Constructor. Builds the hierarchy for the given mesh.
+    explicit FacetBVH(const STLMesh& mesh);
+
+    //! Returns the number of leaves.
+    uint32_t leafCount() const { return static_cast<uint32_t>(m_leafBoxes.size()); }
+
+    //! Returns the mesh index of the triangle stored in the given leaf.
+    uint32_t triangleIndex(uint32_t leaf) const { return m_leafTriangles[leaf]; }
+
+    //! Returns the bounding box of the given leaf.
+    const Box& leafBox(uint32_t leaf) const { return m_leafBoxes[leaf]; }
+
+    /**
+     * Invokes fn(otherLeaf) for every leaf after the given one (in Morton
+     * order) whose bounding box overlaps the given leaf's box. Walking every
+     * leaf this way visits each overlapping pair exactly once.
+     */
+    template<typename Fn>
+    void forEachOverlappingLeaf(uint32_t leaf, Fn fn) const;
+
+private:
+
+    static bool overlaps(const Box& box1, const Box& box2);
+
+    std::vector<Node> m_nodes;
+    std::vector<Box> m_leafBoxes;
+    std::vector<uint32_t> m_leafTriangles;
+    uint32_t m_root;
+};
+
+/**
+ * @since 2026 Oct 19
+ */
+inline bool FacetBVH::overlaps(const Box& box1, const Box& box2)
+{
+    return (box1.m_min[0] <= box2.m_max[0]) && (box2.m_min[0] <= box1.m_max[0]) &&
+           (box1.m_min[1] <= box2.m_max[1]) && (box2.m_min[1] <= box1.m_max[1]) &&
+           (box1.m_min[2] <= box2.m_max[2]) && (box2.m_min[2] <= box1.m_max[2]);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+template<typename Fn>
+void FacetBVH::forEachOverlappingLeaf(uint32_t leaf, Fn fn) const
+{
+    // Each level of a Karras tree consumes at least one bit of a 96-bit
+    // key (63 Morton bits plus the leaf index), which bounds its depth.
+    uint32_t stack[128];
+    int stackSize = 0;
+
+    const Box& queryBox = m_leafBoxes[leaf];
+    stack[stackSize++] = m_root;
+
+    while (stackSize > 0)
+    {
+        const uint32_t node = stack[--stackSize];
+
+        if (node & LEAF_FLAG)
+        {
+            const uint32_t otherLeaf = node & ~LEAF_FLAG;
+            if ((otherLeaf > leaf) && overlaps(queryBox, m_leafBoxes[otherLeaf]))
+                fn(otherLeaf);
+            continue;
+        }
+
+        const Node& current = m_nodes[node];
+        if ((current.m_lastLeaf <= leaf) || !overlaps(queryBox, current.m_box))
+            continue;
+
+        stack[stackSize++] = current.m_right;
+        stack[stackSize++] = current.m_left;
+    }
+}
+
+#endif
@@ -0,0 +1,291 @@
+#include "FacetDiff.h"
+#include "MappedFile.h"
+#include "XXHash64.h"
+#include "RadixSort.h"
+#include "Parallel.h"
+#include "STLFileTypes.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <utility>
+#include <mutex>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define STLREPAIR_FACETDIFF_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const size_t FACET_RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+
+    //! Facets per task when comparing or hashing across cores.
+    const size_t FACETS_PER_TASK = 64 * 1024;
+
+    /**
+     * Returns the offset of the first byte that differs, or size if none do.
+     */
+    size_t findFirstDifference(const uint8_t* pLeft, const uint8_t* pRight, size_t size)
+    {
+        size_t offset = 0;
+
+#if defined(STLREPAIR_FACETDIFF_USE_SSE2)
+        for (; offset + 16 <= size; offset += 16)
+        {
+            const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pLeft + offset));
+            const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRight + offset));
+            const int equalMask = _mm_movemask_epi8(_mm_cmpeq_epi8(left, right));
+            if (equalMask != 0xFFFF)
+            {
+                int bit = 0;
+                while (equalMask & (1 << bit))
+                    ++bit;
+                return offset + static_cast<size_t>(bit);
+            }
+        }
+#endif
+
+        for (; offset < size; ++offset)
+        {
+            if (pLeft[offset] != pRight[offset])
+                return offset;
+        }
+
+        return size;
+    }
+
+    /**
+     * Returns the positions below facetCount where the records differ, in
+     * order.
+     */
+    std::vector<uint32_t> findMismatchedPositions(const uint8_t* pLeft, const uint8_t* pRight, uint32_t facetCount)
+    {
+        std::vector<std::pair<size_t, std::vector<uint32_t>>> taskResults;
+        std::mutex resultsMutex;
+
+        parallelFor(facetCount, [&](size_t begin, size_t end)
+        {
+            std::vector<uint32_t> mismatches;
+
+            size_t offset = begin * FACET_RECORD_SIZE;
+            const size_t endOffset = end * FACET_RECORD_SIZE;
+            while (offset < endOffset)
+            {
+                const size_t difference = findFirstDifference(pLeft + offset, pRight + offset, endOffset - offset);
+                if (difference == endOffset - offset)
+                    break;
+
+                // Skip the rest of the mismatched record.
+                const size_t position = (offset + difference) / FACET_RECORD_SIZE;
+                mismatches.push_back(static_cast<uint32_t>(position));
+                offset = (position + 1) * FACET_RECORD_SIZE;
+            }
+
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            taskResults.emplace_back(begin, std::move(mismatches));
+        }, FACETS_PER_TASK);
+
+        std::sort(taskResults.begin(), taskResults.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<uint32_t> mismatches;
+        for (auto& taskResult : taskResults)
+            mismatches.insert(mismatches.end(), taskResult.second.begin(), taskResult.second.end());
+
+        return mismatches;
+    }
+
+    /**
+     * Hashes the records at the given positions and sorts the positions by
+     * hash, so equal records end up next to each other.
+     */
+    void buildHashIndex(const uint8_t* pRecords, std::vector<uint32_t>& positions, std::vector<uint64_t>& hashes)
+    {
+        hashes.resize(positions.size());
+        parallelFor(positions.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                XXHash64 hash;
+                hash.update(pRecords + static_cast<size_t>(positions[i]) * FACET_RECORD_SIZE, FACET_RECORD_SIZE);
+                hashes[i] = hash.digest();
+            }
+        }, FACETS_PER_TASK);
+
+        radixSort(hashes, positions);
+    }
+
+    //! Positions that don't line up: the mismatches, plus whatever runs past the other file.
+    std::vector<uint32_t> getUnalignedPositions(const std::vector<uint32_t>& mismatches,
+        uint32_t commonFacetCount, uint32_t facetCount)
+    {
+        std::vector<uint32_t> positions(mismatches);
+        for (uint32_t position = commonFacetCount; position < facetCount; ++position)
+            positions.push_back(position);
+
+        return positions;
+    }
+
+    /**
+     * Sorts a run of positions by the bytes of their records, so equal
+     * records within a hash collision group end up next to each other.
+     */
+    void sortRunByRecord(const uint8_t* pRecords, std::vector<uint32_t>::iterator begin, std::vector<uint32_t>::iterator end)
+    {
+        if ((end - begin) < 2)
+            return;
+
+        std::sort(begin, end, [pRecords](uint32_t a, uint32_t b)
+        {
+            return memcmp(pRecords + static_cast<size_t>(a) * FACET_RECORD_SIZE,
+                pRecords + static_cast<size_t>(b) * FACET_RECORD_SIZE, FACET_RECORD_SIZE) < 0;
+        });
+    }
+
+    uint32_t readTriangleCountField(const MappedFile& file)
+    {
+        uint32_t triangleCount = 0;
+        memcpy(&triangleCount, file.data() + BINARY_STL_HEADER_SIZE_IN_BYTES, sizeof(triangleCount));
+        return triangleCount;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FacetDiff::isIdentical() const
+{
+    return !m_isHeaderDifferent &&
+        (m_leftTriangleCount == m_rightTriangleCount) &&
+        (m_leftFacetCount == m_rightFacetCount) &&
+        m_changedFacets.empty() && m_removedFacets.empty() && m_addedFacets.empty() &&
+        (m_movedFacetCount == 0);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FacetDiff diffFacets(const uint8_t* pLeftRecords, uint32_t leftFacetCount,
+    const uint8_t* pRightRecords, uint32_t rightFacetCount)
+{
+    FacetDiff diff;
+    diff.m_leftFacetCount = leftFacetCount;
+    diff.m_rightFacetCount = rightFacetCount;
+
+    const uint32_t commonFacetCount = std::min(leftFacetCount, rightFacetCount);
+    const std::vector<uint32_t> mismatches = findMismatchedPositions(pLeftRecords, pRightRecords, commonFacetCount);
+
+    std::vector<uint32_t> leftPositions = getUnalignedPositions(mismatches, commonFacetCount, leftFacetCount);
+    std::vector<uint32_t> rightPositions = getUnalignedPositions(mismatches, commonFacetCount, rightFacetCount);
+    if (leftPositions.empty() && rightPositions.empty())
+        return diff;
+
+    std::vector<uint64_t> leftHashes;
+    std::vector<uint64_t> rightHashes;
+    buildHashIndex(pLeftRecords, leftPositions, leftHashes);
+    buildHashIndex(pRightRecords, rightPositions, rightHashes);
+
+    // Walk both indexes together. Within a run of equal hashes, pair up
+    // records that really are equal. Anything left over has no match.
+    std::vector<uint32_t> leftUnmatched;
+    std::vector<uint32_t> rightUnmatched;
+    size_t left = 0;
+    size_t right = 0;
+    while ((left < leftHashes.size()) || (right < rightHashes.size()))
+    {
+        if ((right == rightHashes.size()) || ((left < leftHashes.size()) && (leftHashes[left] < rightHashes[right])))
+        {
+            leftUnmatched.push_back(leftPositions[left++]);
+            continue;
+        }
+
+        if ((left == leftHashes.size()) || (rightHashes[right] < leftHashes[left]))
+        {
+            rightUnmatched.push_back(rightPositions[right++]);
+            continue;
+        }
+
+        const uint64_t hash = leftHashes[left];
+        const size_t leftEnd = std::find_if(leftHashes.begin() + left, leftHashes.end(),
+            [hash](uint64_t other) { return other != hash; }) - leftHashes.begin();
+        const size_t rightEnd = std::find_if(rightHashes.begin() + right, rightHashes.end(),
+            [hash](uint64_t other) { return other != hash; }) - rightHashes.begin();
+
+        // Hash collisions aside, a run is usually one record repeated. Sort
+        // both sides by record bytes and merge them, so matching stays
+        // O(k log k) however long the run is.
+        sortRunByRecord(pLeftRecords, leftPositions.begin() + left, leftPositions.begin() + leftEnd);
+        sortRunByRecord(pRightRecords, rightPositions.begin() + right, rightPositions.begin() + rightEnd);
+
+        while ((left < leftEnd) && (right < rightEnd))
+        {
+            const int order = memcmp(pLeftRecords + static_cast<size_t>(leftPositions[left]) * FACET_RECORD_SIZE,
+                pRightRecords + static_cast<size_t>(rightPositions[right]) * FACET_RECORD_SIZE, FACET_RECORD_SIZE);
+            if (order < 0)
+            {
+                leftUnmatched.push_back(leftPositions[left++]);
+            }
+            else if (order > 0)
+            {
+                rightUnmatched.push_back(rightPositions[right++]);
+            }
+            else
+            {
+                ++diff.m_movedFacetCount;
+                ++left;
+                ++right;
+            }
+        }
+
+        for (; left < leftEnd; ++left)
+            leftUnmatched.push_back(leftPositions[left]);
+        for (; right < rightEnd; ++right)
+            rightUnmatched.push_back(rightPositions[right]);
+    }
+
+    std::sort(leftUnmatched.begin(), leftUnmatched.end());
+    std::sort(rightUnmatched.begin(), rightUnmatched.end());
+
+    // An unmatched facet on both sides at the same position is a change.
+    std::set_intersection(leftUnmatched.begin(), leftUnmatched.end(),
+        rightUnmatched.begin(), rightUnmatched.end(), std::back_inserter(diff.m_changedFacets));
+    std::set_difference(leftUnmatched.begin(), leftUnmatched.end(),
+        diff.m_changedFacets.begin(), diff.m_changedFacets.end(), std::back_inserter(diff.m_removedFacets));
+    std::set_difference(rightUnmatched.begin(), rightUnmatched.end(),
+        diff.m_changedFacets.begin(), diff.m_changedFacets.end(), std::back_inserter(diff.m_addedFacets));
+
+    return diff;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FacetDiff diffSTLFiles(const std::string& leftFile, const std::string& rightFile)
+{
+    const size_t payloadOffset = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    MappedFile left(leftFile);
+    MappedFile right(rightFile);
+    if (left.size() < payloadOffset)
+        throw std::runtime_error("Specified file too small to be a binary STL - " + leftFile);
+    if (right.size() < payloadOffset)
+        throw std::runtime_error("Specified file too small to be a binary STL - " + rightFile);
+
+    const uint32_t leftTriangleCount = readTriangleCountField(left);
+    const uint32_t rightTriangleCount = readTriangleCountField(right);
+    const uint32_t leftFacetCount = static_cast<uint32_t>(std::min<uint64_t>(leftTriangleCount,
+        (left.size() - payloadOffset) / FACET_RECORD_SIZE));
+    const uint32_t rightFacetCount = static_cast<uint32_t>(std::min<uint64_t>(rightTriangleCount,
+        (right.size() - payloadOffset) / FACET_RECORD_SIZE));
+
+    FacetDiff diff = diffFacets(left.data() + payloadOffset, leftFacetCount,
+        right.data() + payloadOffset, rightFacetCount);
+
+    diff.m_isHeaderDifferent = (memcmp(left.data(), right.data(), BINARY_STL_HEADER_SIZE_IN_BYTES) != 0);
+    diff.m_leftTriangleCount = leftTriangleCount;
+    diff.m_rightTriangleCount = rightTriangleCount;
+
+    return diff;
+}
@@ -0,0 +1,61 @@
+#ifndef STLREPAIR_FACETDIFF__H_
+#define STLREPAIR_FACETDIFF__H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Facet-by-facet differences between two binary STLs, the "left" and the
+ * "right". Facets are compared as whole 50-byte records, attribute byte
+ * count included.
+ */
+struct FacetDiff
+{
+    bool m_isHeaderDifferent = false;
+
+    //! Triangle counts as declared after the header.
+    uint32_t m_leftTriangleCount = 0;
+    uint32_t m_rightTriangleCount = 0;
+
+    //! Facets actually compared. Never more than the declared count.
+    uint32_t m_leftFacetCount = 0;
+    uint32_t m_rightFacetCount = 0;
+
+    //! Positions where both files have a facet, but not the same one.
+    std::vector<uint32_t> m_changedFacets;
+
+    //! Positions of left facets that aren't anywhere in the right.
+    std::vector<uint32_t> m_removedFacets;
+
+    //! Positions of right facets that aren't anywhere in the left.
+    std::vector<uint32_t> m_addedFacets;
+
+    //! Facets in both files, but at different positions.
+    uint32_t m_movedFacetCount = 0;
+
+    //! Returns true if there's no difference at all.
+    bool isIdentical() const;
+};
+
+/**
+ * Compares two runs of facet records.
+ *
+ * Records are first compared position by position (with SSE2 where
+ * available, across all cores). Facets that don't line up are then matched
+ * by content through a hash index, so reordering shows up as moves rather
+ * than as every facet changing.
+ */
+FacetDiff diffFacets(const uint8_t* pLeftRecords, uint32_t leftFacetCount,
+    const uint8_t* pRightRecords, uint32_t rightFacetCount);
+
+/**
+ * Compares the headers, triangle counts and facets of two binary STL files.
+ * Both are memory mapped. Trailing data after the facets is ignored.
+ *
+ * @throws std::runtime_error if either file can't be read or is too small
+ *         to be a binary STL.
+ */
+FacetDiff diffSTLFiles(const std::string& leftFile, const std::string& rightFile);
+
+#endif
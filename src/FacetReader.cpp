@@ -0,0 +1,152 @@
+#include "FacetReader.h"
+#include "MappedFile.h"
+#include "CompressedByteStream.h"
+#include "Contracts.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    constexpr const size_t FILE_START_SIZE = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FacetReader::FacetReader(const std::string& filepath, size_t batchSize) :
+    m_batchSize(std::max<size_t>(batchSize, 1)),
+    m_triangleCount(0),
+    m_nextIndex(0),
+    m_availableCount(0)
+{
+    // A compressed file is no use mapped.
+    if (detectCompressionFormat(filepath) != CompressionFormat::NONE)
+    {
+        m_spSource = openCompressedFileByteSource(filepath);
+    }
+    else
+    {
+        try
+        {
+            m_spMappedFile = std::make_unique<MappedFile>(filepath);
+        }
+        catch (const std::runtime_error&)
+        {
+            // Not everything can be mapped (empty files, some special files).
+            // The buffered path reports the real problem, if there is one.
+            m_spSource = std::make_unique<FileByteSource>(filepath);
+        }
+    }
+
+    if (m_spMappedFile)
+    {
+        if (m_spMappedFile->size() < FILE_START_SIZE)
+            throw std::runtime_error("Specified file too small to be a binary STL - " + filepath);
+
+        readStart(m_spMappedFile->data());
+        const uint64_t wholeRecordCount = (m_spMappedFile->size() - FILE_START_SIZE) / FacetBatch::RECORD_SIZE;
+        m_availableCount = std::min<uint64_t>(wholeRecordCount, m_triangleCount);
+    }
+    else
+    {
+        uint8_t start[FILE_START_SIZE];
+        if (readFromSource(start, sizeof(start)) < sizeof(start))
+            throw std::runtime_error("Specified file too small to be a binary STL - " + filepath);
+
+        readStart(start);
+        m_availableCount = m_triangleCount;
+        m_buffer.resize(m_batchSize * FacetBatch::RECORD_SIZE);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FacetReader::FacetReader(std::unique_ptr<ByteSource> spSource, size_t batchSize) :
+    m_batchSize(std::max<size_t>(batchSize, 1)),
+    m_triangleCount(0),
+    m_nextIndex(0),
+    m_availableCount(0),
+    m_spSource(std::move(spSource))
+{
+    precondition_throw(m_spSource != nullptr, std::runtime_error("FacetReader requires a source."));
+
+    uint8_t start[FILE_START_SIZE];
+    if (readFromSource(start, sizeof(start)) < sizeof(start))
+        throw std::runtime_error("Could not read file header and triangle count.");
+
+    readStart(start);
+    m_availableCount = m_triangleCount;
+    m_buffer.resize(m_batchSize * FacetBatch::RECORD_SIZE);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FacetReader::~FacetReader()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FacetReader::next(FacetBatch& batch)
+{
+    // In buffered mode, the available count is only an upper bound until
+    // the source runs dry.
+    const size_t wantedCount = static_cast<size_t>(std::min<uint64_t>(m_availableCount - m_nextIndex, m_batchSize));
+    size_t count = wantedCount;
+    const uint8_t* pRecords = nullptr;
+
+    if (m_spMappedFile)
+    {
+        pRecords = m_spMappedFile->data() + FILE_START_SIZE + m_nextIndex * FacetBatch::RECORD_SIZE;
+    }
+    else if (wantedCount > 0)
+    {
+        // A partial record at the end of the file doesn't count.
+        count = readFromSource(m_buffer.data(), wantedCount * FacetBatch::RECORD_SIZE) / FacetBatch::RECORD_SIZE;
+        pRecords = m_buffer.data();
+        if (count < wantedCount)
+            m_availableCount = m_nextIndex + count;
+    }
+
+    if (count == 0)
+    {
+        batch = FacetBatch();
+        return false;
+    }
+
+    batch = FacetBatch(pRecords, count, m_nextIndex);
+    m_nextIndex += count;
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FacetReader::readStart(const uint8_t* pStart)
+{
+    memcpy(m_header.data(), pStart, m_header.size());
+    memcpy(&m_triangleCount, pStart + BINARY_STL_HEADER_SIZE_IN_BYTES, sizeof(m_triangleCount));
+}
+
+/**
+ * Reads until the buffer is full or the source runs dry.
+ *
+ * @since 2026 Oct 19
+ */
+size_t FacetReader::readFromSource(uint8_t* pBuffer, size_t size)
+{
+    size_t totalBytesRead = 0;
+    while (totalBytesRead < size)
+    {
+        size_t bytesRead = m_spSource->read(pBuffer + totalBytesRead, size - totalBytesRead);
+        if (bytesRead == 0)
+            break;
+        totalBytesRead += bytesRead;
+    }
+
+    return totalBytesRead;
+}
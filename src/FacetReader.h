@@ -0,0 +1,249 @@
+#ifndef STLREPAIR_FACETREADER__H_
+#define STLREPAIR_FACETREADER__H_
+
+#include "STLFileTypes.h"
+#include "STLGeometry.h"
+#include "ByteStream.h"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class MappedFile;
+
+/**
+ * Default number of facets handed out per batch.
+ */
+constexpr const size_t DEFAULT_FACET_BATCH_SIZE = 4096;
+
+/**
+ * Read-only view of one binary STL triangle record, straight out of the
+ * reader's memory. Nothing's decoded until it's asked for.
+ */
+class FacetView
+{
+public:
+
+    //! Constructor. pRecord points at a full 50 byte record.
+    explicit FacetView(const uint8_t* pRecord) : m_pRecord(pRecord) {}
+
+    //! Returns the normal and vertices.
+    STLFacet getFacet() const
+    {
+        STLFacet facet;
+        memcpy(&facet, m_pRecord, sizeof(facet));
+        return facet;
+    }
+
+    //! Returns the facet normal as stored in the file.
+    Vec3 getNormal() const { return readVec3(0); }
+
+    //! Returns vertex 0, 1 or 2.
+    Vec3 getVertex(size_t index) const { return readVec3(sizeof(Vec3) * (index + 1)); }
+
+    uint16_t getAttributeByteCount() const
+    {
+        uint16_t attributeByteCount = 0;
+        memcpy(&attributeByteCount, m_pRecord + BINARY_STL_TRIANGLE_SIZE_IN_BYTES, sizeof(attributeByteCount));
+        return attributeByteCount;
+    }
+
+    //! Copies out the raw 48 bytes of triangle data.
+    void copyTriangleData(STLBinaryTriangleData& triangleData) const
+    {
+        memcpy(triangleData.data(), m_pRecord, triangleData.size());
+    }
+
+    //! Returns the raw 50 byte record.
+    const uint8_t* getRecord() const { return m_pRecord; }
+
+private:
+
+    Vec3 readVec3(size_t offset) const
+    {
+        Vec3 value;
+        memcpy(&value, m_pRecord + offset, sizeof(value));
+        return value;
+    }
+
+    const uint8_t* m_pRecord;
+};
+
+/**
+ * A run of consecutive facets. Only valid until the reader that produced it
+ * moves on to the next batch.
+ */
+class FacetBatch
+{
+public:
+
+    static constexpr size_t RECORD_SIZE =
+        BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FacetView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = FacetView;
+
+        explicit const_iterator(const uint8_t* pRecord = nullptr) : m_pRecord(pRecord) {}
+
+        FacetView operator*() const { return FacetView(m_pRecord); }
+        const_iterator& operator++() { m_pRecord += RECORD_SIZE; return *this; }
+        const_iterator operator++(int) { const_iterator previous = *this; ++*this; return previous; }
+        bool operator==(const const_iterator& other) const { return m_pRecord == other.m_pRecord; }
+        bool operator!=(const const_iterator& other) const { return m_pRecord != other.m_pRecord; }
+
+    private:
+
+        const uint8_t* m_pRecord;
+    };
+
+    //! Constructor. Creates an empty batch.
+    FacetBatch() : m_pRecords(nullptr), m_count(0), m_firstIndex(0) {}
+
+    //! Constructor. pRecords points at count consecutive 50 byte records.
+    FacetBatch(const uint8_t* pRecords, size_t count, uint64_t firstIndex) :
+        m_pRecords(pRecords), m_count(count), m_firstIndex(firstIndex) {}
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+    //! Returns the index within the file of the first facet in the batch.
+    uint64_t getFirstIndex() const { return m_firstIndex; }
+
+    FacetView operator[](size_t index) const { return FacetView(m_pRecords + index * RECORD_SIZE); }
+
+    const_iterator begin() const { return const_iterator(m_pRecords); }
+    const_iterator end() const { return const_iterator(m_pRecords + m_count * RECORD_SIZE); }
+
+private:
+
+    const uint8_t* m_pRecords;
+    size_t m_count;
+    uint64_t m_firstIndex;
+};
+
+/**
+ * Pull-based alternative to BinarySTLFileReader. Instead of receiving
+ * callbacks, callers ask for the next batch of facets when they're ready
+ * for it, which makes early exit and composition a matter of ordinary
+ * control flow:
+ *
+ *     FacetReader reader("model.stl");
+ *     for (const FacetBatch& batch : reader)
+ *         for (FacetView facet : batch)
+ *             bounds.extend(facet.getVertex(0));
+ *
+ * Files are memory mapped where possible, in which case batches point
+ * straight into the mapping. Otherwise they're read through one reusable
+ * buffer. Either way, nothing is allocated per facet.
+ *
+ * Only facets covered by the triangle count in the file are produced.
+ * Anything after them, and any partial record at the end, is left alone.
+ * There's no resynchronization. Use BinarySTLFileReader for that.
+ */
+class FacetReader
+{
+public:
+
+    /**
+     * Input iterator over the batches. Advancing it advances the reader.
+     */
+    class iterator
+    {
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = FacetBatch;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const FacetBatch*;
+        using reference = const FacetBatch&;
+
+        explicit iterator(FacetReader* pReader = nullptr) : m_pReader(pReader) { advance(); }
+
+        const FacetBatch& operator*() const { return m_batch; }
+        const FacetBatch* operator->() const { return &m_batch; }
+        iterator& operator++() { advance(); return *this; }
+        bool operator==(const iterator& other) const { return m_pReader == other.m_pReader; }
+        bool operator!=(const iterator& other) const { return m_pReader != other.m_pReader; }
+
+    private:
+
+        void advance()
+        {
+            if (m_pReader && !m_pReader->next(m_batch))
+                m_pReader = nullptr;
+        }
+
+        FacetReader* m_pReader;
+        FacetBatch m_batch;
+    };
+
+    /**
+     * Constructor. Memory maps the file, falling back to buffered reads if
+     * it can't be mapped. A gzip or zstd compressed file is decompressed as
+     * it's read (see openCompressedFileByteSource()).
+     *
+     * @throws std::runtime_error if the file can't be opened or is too
+     *         small to hold a header and triangle count.
+     */
+    explicit FacetReader(const std::string& filepath, size_t batchSize = DEFAULT_FACET_BATCH_SIZE);
+
+    /**
+     * Constructor. Reads through a buffer from the given source, starting
+     * at its current position.
+     *
+     * @throws std::runtime_error if there's no header and triangle count.
+     */
+    explicit FacetReader(std::unique_ptr<ByteSource> spSource, size_t batchSize = DEFAULT_FACET_BATCH_SIZE);
+
+    //! Destructor.
+    ~FacetReader();
+
+    FacetReader(const FacetReader&) = delete;
+    FacetReader& operator=(const FacetReader&) = delete;
+
+    const STLBinaryHeader& getHeader() const { return m_header; }
+
+    //! Returns the triangle count stored in the file.
+    uint32_t getTriangleCount() const { return m_triangleCount; }
+
+    /**
+     * Fetches the next batch of facets, invalidating the previous one.
+     * Returns false, leaving batch empty, once there are no more.
+     */
+    bool next(FacetBatch& batch);
+
+    //! Iteration starts wherever the reader currently is.
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+
+    void readStart(const uint8_t* pStart);
+    size_t readFromSource(uint8_t* pBuffer, size_t size);
+
+    const size_t m_batchSize;
+    STLBinaryHeader m_header;
+    uint32_t m_triangleCount;
+    uint64_t m_nextIndex;
+    uint64_t m_availableCount;
+
+    // Mapped mode.
+    std::unique_ptr<MappedFile> m_spMappedFile;
+
+    // Buffered mode.
+    std::unique_ptr<ByteSource> m_spSource;
+    std::vector<uint8_t> m_buffer;
+};
+
+#endif
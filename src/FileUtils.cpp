@@ -2,7 +2,11 @@
 #include "Contracts.h"
 #include "CallGuard.h"
 
+#include <atomic>
 #include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <cstdio>
 #include <cstring>
 
 namespace FileUtils
@@ -95,6 +99,20 @@ std::string generateUniqueFilePath(const std::string& filepathTemplate)
     return newFilePath;
 }
 
+/**
+ * @since 2026 Oct 19
+ */
+std::string generateRandomSuffix()
+{
+    static std::atomic<uint64_t> s_counter(0);
+    std::random_device random;
+
+    char suffix[17];
+    snprintf(suffix, sizeof(suffix), "%016llx",
+        static_cast<unsigned long long>((static_cast<uint64_t>(random()) << 32) ^ random() ^ s_counter++));
+    return suffix;
+}
+
 /**
  * @since 2024 Feb 08
  */
@@ -172,4 +190,28 @@ bool areFilesEqual(const std::string& filepath1, const std::string& filepath2)
     return areFilesEqual(filepath1, filepath2, 0, fileSize1);
 }
 
+/**
+ * @since 2026 Oct 19
+ */
+void readWholeFile(const std::string& filepath, std::vector<uint8_t>& data)
+{
+    FILE* pFile = fopen(filepath.c_str(), "rb");
+    if (!pFile)
+        throw std::runtime_error("Could not open " + filepath);
+    auto closeGuard = makeCallGuard([&]() { fclose(pFile); });
+
+    data.resize(static_cast<size_t>(getFileSize(filepath)));
+    data.resize(fread(data.data(), 1, data.size(), pFile));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::vector<uint8_t> readWholeFile(const std::string& filepath)
+{
+    std::vector<uint8_t> data;
+    readWholeFile(filepath, data);
+    return data;
+}
+
 }
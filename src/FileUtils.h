@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 /**
  * General purpose file utility functions.
@@ -43,6 +44,12 @@ void splitPath(const std::string& fullpath, std::string& dir,
  */
 std::string generateUniqueFilePath(const std::string& filepathTemplate);
 
+/**
+ * Returns 16 random hex digits, for naming temp files that must not collide
+ * with any other thread's or process's.
+ */
+std::string generateRandomSuffix();
+
 /**
  * Returns true if the specified byte range matches between filepath1 and filepath2.
  */
@@ -54,6 +61,20 @@ bool areFilesEqual(const std::string& filepath1, const std::string& filepath2,
  */
 bool areFilesEqual(const std::string& filepath1, const std::string& filepath2);
 
+/**
+ * Reads the whole of the specified file into data, reusing its storage.
+ *
+ * @throws std::runtime_error if the file can't be opened.
+ */
+void readWholeFile(const std::string& filepath, std::vector<uint8_t>& data);
+
+/**
+ * Returns the whole of the specified file.
+ *
+ * @throws std::runtime_error if the file can't be opened.
+ */
+std::vector<uint8_t> readWholeFile(const std::string& filepath);
+
 }
 
 #endif
@@ -0,0 +1,335 @@
+#include "FilterChain.h"
+#include "Contracts.h"
+#include "Stats.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <cstring>
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t FilterChainCheckpoint::getOutputSize() const
+{
+    return BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES +
+        static_cast<uint64_t>(m_writtenTriangleCount) *
+        (BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FilterChain::FilterChain(const std::string& outputFilePath, size_t batchSize) :
+    m_batchSize(std::max<size_t>(batchSize, 1)),
+    m_outputFilePath(outputFilePath),
+    m_triangleCount(0),
+    m_writtenTriangleCount(0),
+    m_skippedByteCount(0)
+{
+    precondition_throw(!outputFilePath.empty(), std::runtime_error("Output filename cannot be empty."));
+
+    memset(m_header.data(), 0, m_header.size());
+    m_batch.m_triangles.reserve(m_batchSize);
+    m_batch.m_attributeByteCounts.reserve(m_batchSize);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FilterChain::FilterChain(std::unique_ptr<ByteSink> spOutputSink, size_t batchSize) :
+    m_batchSize(std::max<size_t>(batchSize, 1)),
+    m_spOutputSink(std::move(spOutputSink)),
+    m_triangleCount(0),
+    m_writtenTriangleCount(0),
+    m_skippedByteCount(0)
+{
+    precondition_throw(m_spOutputSink != nullptr, std::runtime_error("Output sink cannot be null."));
+
+    memset(m_header.data(), 0, m_header.size());
+    m_batch.m_triangles.reserve(m_batchSize);
+    m_batch.m_attributeByteCounts.reserve(m_batchSize);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FilterChain::~FilterChain()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FilterChain& FilterChain::addStage(std::unique_ptr<FilterStage> spStage)
+{
+    insertStage(m_stages.size(), std::move(spStage));
+    return *this;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FilterChain::insertStage(size_t index, std::unique_ptr<FilterStage> spStage)
+{
+    precondition_throw(spStage != nullptr, std::runtime_error("Filter stage cannot be null."));
+    precondition_throw(m_spWriter == nullptr, std::runtime_error("Filter stages must be added before reading starts."));
+
+    m_stages.insert(m_stages.begin() + std::min(index, m_stages.size()), std::move(spStage));
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FilterChain::onReadEnd()
+{
+    precondition_throw(m_spWriter != nullptr,
+        std::runtime_error("No output file opened for writing."));
+
+    processTriangles(m_batch, 0);
+    m_batch.clear();
+
+    // Whatever a stage held back carries on through the stages after it,
+    // which may in turn be holding triangles back themselves.
+    for (size_t stage = 0; stage < m_stages.size(); ++stage)
+    {
+        TriangleBatch released;
+        {
+            STLREPAIR_TRACE_SCOPE(m_stages[stage]->getName(), "stage");
+            m_stages[stage]->finishTriangles(released);
+        }
+        processTriangles(released, stage + 1);
+    }
+
+    for (auto& spStage : m_stages)
+        spStage->processExtraData(m_extraData);
+
+    uint32_t finalTriangleCount = m_triangleCount;
+    for (auto& spStage : m_stages)
+        spStage->finishTriangleCount(finalTriangleCount, m_writtenTriangleCount);
+
+    STLBinaryHeader finalHeader = m_header;
+    for (auto& spStage : m_stages)
+        spStage->finishHeader(finalHeader);
+
+    // Patch the start of the file through the sink if it can do it.
+    // Otherwise reopen the file once it's been closed out.
+    bool isFileStartPatched = (finalTriangleCount == m_triangleCount) && (finalHeader == m_header);
+    if (!isFileStartPatched)
+    {
+        STLREPAIR_STATS_PHASE(PATCH);
+        isFileStartPatched = m_spWriter->rewriteFileStart(finalHeader, finalTriangleCount);
+    }
+
+    {
+        STLREPAIR_STATS_PHASE(WRITE);
+        STLREPAIR_STATS_COUNT_BYTES(WRITE, m_extraData.size());
+
+        if (!m_extraData.empty())
+            m_spWriter->finalize(m_extraData.data(), m_extraData.size());
+        else
+            m_spWriter->finalize();
+    }
+
+    if (!isFileStartPatched)
+    {
+        STLREPAIR_STATS_PHASE(PATCH);
+
+        if (m_outputFilePath.empty() || !canReopenOutputFile())
+            throw std::runtime_error("Output sink cannot update the start of the file.");
+
+        FILE* pFile = fopen(m_outputFilePath.c_str(), "rb+");
+        if (!pFile)
+            throw std::runtime_error("Could not update output file header and triangle count.");
+
+        const bool isWritten = (fwrite(finalHeader.data(), 1, finalHeader.size(), pFile) == finalHeader.size()) &&
+            (fwrite(&finalTriangleCount, 1, sizeof(finalTriangleCount), pFile) == sizeof(finalTriangleCount));
+        fclose(pFile);
+
+        if (!isWritten)
+            throw std::runtime_error("Could not update output file header and triangle count.");
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FilterChain::onReadFileHeader(const STLBinaryHeader& header)
+{
+    if (m_spResumeCheckpoint)
+    {
+        // The header went out with the first run, and the stages are all
+        // in place by now.
+        if (m_spResumeCheckpoint->m_stageStates.size() != m_stages.size())
+            throw std::runtime_error("Checkpoint doesn't match the filter stages.");
+        for (size_t stage = 0; stage < m_stages.size(); ++stage)
+            m_stages[stage]->restoreState(m_spResumeCheckpoint->m_stageStates[stage]);
+
+        m_header = m_spResumeCheckpoint->m_header;
+        return true;
+    }
+
+    m_header = header;
+    for (auto& spStage : m_stages)
+        spStage->processHeader(m_header);
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FilterChain::onReadTriangleCount(const uint32_t triangleCount)
+{
+    if (m_spResumeCheckpoint)
+    {
+        const FilterChainCheckpoint& checkpoint = *m_spResumeCheckpoint;
+        m_triangleCount = checkpoint.m_triangleCount;
+        m_writtenTriangleCount = checkpoint.m_writtenTriangleCount;
+        m_skippedByteCount = checkpoint.m_skippedByteCount;
+
+        // A run that failed rather than died may have patched the start of
+        // the file on its way out, so it's put back as it was.
+        STLREPAIR_STATS_PHASE(WRITE);
+        m_spWriter = std::make_unique<BinarySTLFileWriter>(
+            std::make_unique<FileByteSink>(m_outputFilePath, checkpoint.getOutputSize()));
+        m_spWriter->rewriteFileStart(m_header, m_triangleCount);
+        return true;
+    }
+
+    m_triangleCount = triangleCount;
+    for (auto& spStage : m_stages)
+        spStage->processTriangleCount(m_triangleCount);
+
+    STLREPAIR_STATS_PHASE(WRITE);
+    STLREPAIR_STATS_COUNT_BYTES(WRITE, BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES);
+    m_spWriter = std::make_unique<BinarySTLFileWriter>(createSink(m_outputFilePath), m_header, m_triangleCount);
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FilterChain::saveCheckpoint(FilterChainCheckpoint& checkpoint)
+{
+    if (!m_spWriter || !m_batch.empty() || !m_extraData.empty())
+        return false;
+
+    FilterChainCheckpoint saved;
+    saved.m_header = m_header;
+    saved.m_triangleCount = m_triangleCount;
+    saved.m_writtenTriangleCount = m_writtenTriangleCount;
+    saved.m_skippedByteCount = m_skippedByteCount;
+    saved.m_stageStates.resize(m_stages.size());
+    for (size_t stage = 0; stage < m_stages.size(); ++stage)
+    {
+        if (!m_stages[stage]->saveState(saved.m_stageStates[stage]))
+            return false;
+    }
+
+    if (!m_spWriter->sync())
+        return false;
+
+    checkpoint = std::move(saved);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FilterChain::resumeFrom(const FilterChainCheckpoint& checkpoint)
+{
+    precondition_throw(!m_outputFilePath.empty(), std::runtime_error("Only output files can be resumed."));
+    precondition_throw(m_spWriter == nullptr, std::runtime_error("Can't resume once reading has started."));
+
+    m_spResumeCheckpoint = std::make_unique<FilterChainCheckpoint>(checkpoint);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FilterChain::onReadTriangle(const STLBinaryTriangleData& triangleData,
+    uint16_t attributeByteCount)
+{
+    precondition_throw(m_spWriter != nullptr,
+        std::runtime_error("No output file opened for writing."));
+
+    m_batch.push_back(triangleData, attributeByteCount);
+    if (m_batch.size() >= m_batchSize)
+    {
+        processTriangles(m_batch, 0);
+        m_batch.clear();
+    }
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FilterChain::onReadUnknownData(const uint8_t* const pData, const size_t dataSize)
+{
+    precondition_throw(m_spWriter != nullptr,
+        std::runtime_error("No output file opened for writing."));
+
+    std::copy(pData, pData + dataSize, std::back_inserter(m_extraData));
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool FilterChain::onReadSkippedData(const uint64_t /*fileOffset*/, const uint64_t dataSize)
+{
+    m_skippedByteCount += dataSize;
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSink> FilterChain::createSink(const std::string& outputFilePath)
+{
+    if (m_spOutputSink)
+        return std::move(m_spOutputSink);
+
+    return std::make_unique<FileByteSink>(outputFilePath);
+}
+
+/**
+ * Sends the batch through the stages from firstStage onwards and writes
+ * whatever comes out the other end.
+ *
+ * @since 2026 Oct 19
+ */
+void FilterChain::processTriangles(TriangleBatch& batch, size_t firstStage)
+{
+    STLREPAIR_STATS_PHASE(FILTER);
+    STLREPAIR_STATS_COUNT_FACETS(FILTER, batch.size());
+
+    for (size_t stage = firstStage; (stage < m_stages.size()) && !batch.empty(); ++stage)
+    {
+        STLREPAIR_TRACE_SCOPE(m_stages[stage]->getName(), "stage");
+        m_stages[stage]->processTriangles(batch);
+    }
+
+    writeTriangles(batch);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FilterChain::writeTriangles(const TriangleBatch& batch)
+{
+    STLREPAIR_STATS_PHASE(WRITE);
+    STLREPAIR_STATS_COUNT_BYTES(WRITE, batch.size() * (BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES));
+    STLREPAIR_STATS_COUNT_FACETS(WRITE, batch.size());
+
+    for (size_t i = 0; i < batch.size(); ++i)
+        m_spWriter->writeTriangleData(batch.m_triangles[i], batch.m_attributeByteCounts[i]);
+
+    m_writtenTriangleCount += static_cast<uint32_t>(batch.size());
+}
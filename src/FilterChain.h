@@ -0,0 +1,159 @@
+#ifndef STLREPAIR_FILTERCHAIN__H_
+#define STLREPAIR_FILTERCHAIN__H_
+
+#include "BinarySTLFileReader.h"
+#include "BinarySTLFileWriter.h"
+#include "FilterStage.h"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Default number of triangles gathered before a batch is sent down the chain.
+ * Small enough that a batch stays in cache while every stage has its turn.
+ */
+constexpr const size_t DEFAULT_FILTER_BATCH_SIZE = 4096;
+
+/**
+ * What a FilterChain has done so far, taken between batches. Together with
+ * a BinarySTLFileReaderCheckpoint, enough to pick a repair back up in
+ * another process. Triangle records are a fixed size, so the output carries
+ * on from HEADER + COUNT + 50 bytes per written triangle.
+ */
+struct FilterChainCheckpoint
+{
+    STLBinaryHeader m_header = {};          //!< As written at the start of the output.
+    uint32_t m_triangleCount = 0;           //!< As written at the start of the output.
+    uint32_t m_writtenTriangleCount = 0;
+    uint64_t m_skippedByteCount = 0;
+    std::vector<std::vector<uint8_t>> m_stageStates;
+
+    //! Returns the size of the output so far.
+    uint64_t getOutputSize() const;
+};
+
+/**
+ * Pipe-and-filter processing of STL data produced by a BinarySTLFileReader.
+ *
+ * Triangles are gathered into batches, and each batch goes through every
+ * stage in turn before it's written. However many stages there are, the file
+ * is read once and written once.
+ */
+class FilterChain : public BinarySTLFileReaderListener
+{
+public:
+
+    //! Constructor.
+    explicit FilterChain(const std::string& outputFilePath,
+        size_t batchSize = DEFAULT_FILTER_BATCH_SIZE);
+
+    /**
+     * Constructor. The output goes to the given sink rather than a file. If
+     * the triangle count has to be corrected at the end, the sink must
+     * support ByteSink::patch().
+     */
+    explicit FilterChain(std::unique_ptr<ByteSink> spOutputSink,
+        size_t batchSize = DEFAULT_FILTER_BATCH_SIZE);
+
+    //! Destructor.
+    ~FilterChain();
+
+    /**
+     * Adds a stage to the end of the chain. Returns the chain, so calls can
+     * be strung together. Stages must be added before reading starts.
+     */
+    FilterChain& addStage(std::unique_ptr<FilterStage> spStage);
+
+    //! Returns the number of stages in the chain.
+    size_t getStageCount() const { return m_stages.size(); }
+
+    //! Called whenever parsing ends. Guaranteed to be called even in the event of errors.
+    void onReadEnd() override;
+
+    //! Called whenever the file header is parsed.
+    bool onReadFileHeader(const STLBinaryHeader& header) override;
+
+    //! Called whenever the total triangle count has been parsed.
+    bool onReadTriangleCount(const uint32_t triangleCount) override;
+
+    //! Called whenever a triangle has been read.
+    bool onReadTriangle(const STLBinaryTriangleData& triangleData,
+        const uint16_t attributeByteCount) override;
+
+    //! Called whenever a blob of unknown data is encountered.
+    bool onReadUnknownData(const uint8_t* const pData, const size_t dataSize) override;
+
+    /**
+     * Called whenever the reader skips over junk to get back in step with
+     * the triangle records. Skipped bytes are simply left out of the output.
+     */
+    bool onReadSkippedData(const uint64_t fileOffset, const uint64_t dataSize) override;
+
+    //! Returns the total number of bytes the reader has skipped so far.
+    uint64_t getSkippedByteCount() const { return m_skippedByteCount; }
+
+    //! Returns the number of triangles written so far.
+    uint32_t getWrittenTriangleCount() const { return m_writtenTriangleCount; }
+
+    /**
+     * Takes a checkpoint, once everything written so far is on disk. Only
+     * possible between batches, before any trailing data turns up, with an
+     * output sink that can sync and stages that can save their state.
+     * Returns false, doing nothing, otherwise.
+     *
+     * @throws std::runtime_error if the output can't be synced.
+     */
+    bool saveCheckpoint(FilterChainCheckpoint& checkpoint);
+
+    /**
+     * Makes the chain carry on from a checkpoint instead of starting afresh.
+     * Must be called before reading starts, with the same stages as when it
+     * was taken. The output file is opened at the checkpoint's output size
+     * and anything after that is thrown away. Only works for chains writing
+     * to a file.
+     *
+     * @throws std::runtime_error if the chain writes to a sink.
+     */
+    void resumeFrom(const FilterChainCheckpoint& checkpoint);
+
+protected:
+
+    /**
+     * Opens the sink the output is written to. This is the sink given to the
+     * constructor if there was one, or a plain file otherwise.
+     */
+    virtual std::unique_ptr<ByteSink> createSink(const std::string& outputFilePath);
+
+    /**
+     * Returns true if the start of the output file can be patched by
+     * reopening it once it's been written, for when the sink can't patch
+     * it. Not so if the sink transforms what's written, e.g. compresses it.
+     */
+    virtual bool canReopenOutputFile() const { return true; }
+
+    //! Inserts a stage at the given position in the chain.
+    void insertStage(size_t index, std::unique_ptr<FilterStage> spStage);
+
+private:
+
+    void processTriangles(TriangleBatch& batch, size_t firstStage);
+    void writeTriangles(const TriangleBatch& batch);
+
+    std::vector<std::unique_ptr<FilterStage>> m_stages;
+    const size_t m_batchSize;
+    TriangleBatch m_batch;
+
+    std::string m_outputFilePath;
+    std::unique_ptr<ByteSink> m_spOutputSink;
+    STLBinaryHeader m_header;
+    std::unique_ptr<BinarySTLFileWriter> m_spWriter;
+    uint32_t m_triangleCount;
+    uint32_t m_writtenTriangleCount;
+    uint64_t m_skippedByteCount;
+    std::vector<char> m_extraData;
+    std::unique_ptr<FilterChainCheckpoint> m_spResumeCheckpoint;
+};
+
+#endif
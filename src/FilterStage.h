@@ -0,0 +1,115 @@
+#ifndef STLREPAIR_FILTERSTAGE__H_
+#define STLREPAIR_FILTERSTAGE__H_
+
+#include "STLFileTypes.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A batch of triangle records on its way through a FilterChain. The two
+ * vectors are parallel. Stages that remove or add triangles must keep them
+ * the same length.
+ */
+struct TriangleBatch
+{
+    std::vector<STLBinaryTriangleData> m_triangles;
+    std::vector<uint16_t> m_attributeByteCounts;
+
+    size_t size() const { return m_triangles.size(); }
+    bool empty() const { return m_triangles.empty(); }
+
+    void push_back(const STLBinaryTriangleData& triangle, uint16_t attributeByteCount)
+    {
+        m_triangles.push_back(triangle);
+        m_attributeByteCounts.push_back(attributeByteCount);
+    }
+
+    void resize(size_t size)
+    {
+        m_triangles.resize(size);
+        m_attributeByteCounts.resize(size);
+    }
+
+    void clear()
+    {
+        m_triangles.clear();
+        m_attributeByteCounts.clear();
+    }
+};
+
+/**
+ * One step in a FilterChain. Each part of the file passes through every
+ * stage in the chain, in order, before it's written. The defaults pass
+ * everything through untouched, so a stage only overrides what it cares
+ * about.
+ */
+class FilterStage
+{
+public:
+
+    //! Destructor.
+    virtual ~FilterStage() {}
+
+    //! Returns a short name for the stage, as shown in traces.
+    virtual const char* getName() const { return "filter stage"; }
+
+    //! Given the header on its way out. Modify it in place.
+    virtual void processHeader(STLBinaryHeader& /*header*/) {}
+
+    /**
+     * Given the triangle count on its way out, before any triangles have
+     * been seen. Modify it in place.
+     */
+    virtual void processTriangleCount(uint32_t& /*triangleCount*/) {}
+
+    /**
+     * Given each batch of triangles. Triangles may be modified, removed or
+     * added. A stage may also hold triangles back by taking them out of the
+     * batch, as long as it gives them back from finishTriangles(). Never
+     * called with an empty batch.
+     */
+    virtual void processTriangles(TriangleBatch& /*batch*/) {}
+
+    /**
+     * Called once every triangle has been through processTriangles(). Any
+     * triangles added to the batch carry on through the rest of the chain.
+     */
+    virtual void finishTriangles(TriangleBatch& /*batch*/) {}
+
+    //! Given whatever trailed the triangle data. Modify it in place.
+    virtual void processExtraData(std::vector<char>& /*extraData*/) {}
+
+    /**
+     * Given the triangle count that went out at the start of the file along
+     * with the number of triangles that actually got written. If the count
+     * is changed here, the file is patched to match.
+     */
+    virtual void finishTriangleCount(uint32_t& /*triangleCount*/, uint32_t /*writtenTriangleCount*/) {}
+
+    /**
+     * Given the header that went out at the start of the file, once
+     * everything else has been written. If it's changed here, the file is
+     * patched to match.
+     */
+    virtual void finishHeader(STLBinaryHeader& /*header*/) {}
+
+    /**
+     * Saves whatever the stage needs to carry on from where it is, for a
+     * checkpoint (see FilterChain::saveCheckpoint()). Only called between
+     * batches. Returns false if the stage can't be checkpointed, e.g.
+     * because it's holding triangles back. Stages without state needn't
+     * bother.
+     */
+    virtual bool saveState(std::vector<uint8_t>& /*state*/) const { return true; }
+
+    /**
+     * Puts back what saveState() saved, before the stage sees any triangles.
+     *
+     * @throws std::runtime_error if the state doesn't make sense.
+     */
+    virtual void restoreState(const std::vector<uint8_t>& /*state*/) {}
+};
+
+#endif
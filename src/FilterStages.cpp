@@ -0,0 +1,294 @@
+#include "FilterStages.h"
+#include "MortonCode.h"
+#include "XXHash64.h"
+#include "Version.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+
+namespace
+{
+    template <typename T>
+    void saveRawState(const T& value, std::vector<uint8_t>& state)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "State must be trivially copyable.");
+        const uint8_t* pValue = reinterpret_cast<const uint8_t*>(&value);
+        state.assign(pValue, pValue + sizeof(value));
+    }
+
+    template <typename T>
+    void restoreRawState(T& value, const std::vector<uint8_t>& state)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "State must be trivially copyable.");
+        if (state.size() != sizeof(value))
+            throw std::runtime_error("Saved filter stage state is the wrong size.");
+        memcpy(&value, state.data(), sizeof(value));
+    }
+
+    void hashVec3(XXHash64& hash, const Vec3& vector)
+    {
+        hash.update(&vector.x, sizeof(vector.x));
+        hash.update(&vector.y, sizeof(vector.y));
+        hash.update(&vector.z, sizeof(vector.z));
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void ZeroHeaderStage::processHeader(STLBinaryHeader& header)
+{
+    memset(header.data(), 0, header.size());
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+TriangleLimitStage::TriangleLimitStage(uint32_t triangleLimit) :
+    m_triangleLimit(triangleLimit),
+    m_passedTriangleCount(0)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TriangleLimitStage::processTriangles(TriangleBatch& batch)
+{
+    const uint32_t remaining = m_triangleLimit - m_passedTriangleCount;
+    if (batch.size() > remaining)
+        batch.resize(remaining);
+
+    m_passedTriangleCount += static_cast<uint32_t>(batch.size());
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool TriangleLimitStage::saveState(std::vector<uint8_t>& state) const
+{
+    saveRawState(m_passedTriangleCount, state);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TriangleLimitStage::restoreState(const std::vector<uint8_t>& state)
+{
+    restoreRawState(m_passedTriangleCount, state);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+TransformStage::TransformStage(const AffineTransform& transform) :
+    m_transform(transform)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TransformStage::processTriangles(TriangleBatch& batch)
+{
+    if (m_transform.isIdentity())
+        return;
+
+    for (auto& triangle : batch.m_triangles)
+        m_transform.apply(triangle);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void ZeroAttributeByteCountsStage::processTriangles(TriangleBatch& batch)
+{
+    for (uint16_t& attributeByteCount : batch.m_attributeByteCounts)
+    {
+        if (attributeByteCount != 0)
+        {
+            ++m_zeroedCount;
+            attributeByteCount = 0;
+        }
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void MortonOrderStage::processTriangles(TriangleBatch& batch)
+{
+    m_pending.m_triangles.insert(m_pending.m_triangles.end(),
+        batch.m_triangles.begin(), batch.m_triangles.end());
+    m_pending.m_attributeByteCounts.insert(m_pending.m_attributeByteCounts.end(),
+        batch.m_attributeByteCounts.begin(), batch.m_attributeByteCounts.end());
+    batch.clear();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void MortonOrderStage::finishTriangles(TriangleBatch& batch)
+{
+    std::vector<uint64_t> codes;
+    std::vector<uint32_t> order;
+    sortByMortonCode(m_pending.m_triangles, codes, order);
+
+    batch.m_triangles.reserve(batch.size() + order.size());
+    batch.m_attributeByteCounts.reserve(batch.size() + order.size());
+    for (uint32_t triangle : order)
+        batch.push_back(m_pending.m_triangles[triangle], m_pending.m_attributeByteCounts[triangle]);
+
+    m_pending = TriangleBatch();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void ClearExtraDataStage::processExtraData(std::vector<char>& extraData)
+{
+    extraData.clear();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void UpdateTriangleCountStage::finishTriangleCount(uint32_t& triangleCount, uint32_t writtenTriangleCount)
+{
+    triangleCount = writtenTriangleCount;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PayloadDigestStage::processTriangles(TriangleBatch& batch)
+{
+    for (size_t i = 0; i < batch.size(); ++i)
+        m_digest.update(batch.m_triangles[i], batch.m_attributeByteCounts[i]);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PayloadDigestStage::finishHeader(STLBinaryHeader& header)
+{
+    stampPayloadDigest(header, m_digest.digest());
+}
+
+/**
+ * The digest's hashing state is saved as is, so the checkpoint only makes
+ * sense to the same build on the same platform.
+ *
+ * @since 2026 Oct 19
+ */
+bool PayloadDigestStage::saveState(std::vector<uint8_t>& state) const
+{
+    saveRawState(m_digest, state);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PayloadDigestStage::restoreState(const std::vector<uint8_t>& state)
+{
+    restoreRawState(m_digest, state);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+FileStartStage::FileStartStage(const STLBinaryHeader& header, uint32_t triangleCount) :
+    m_header(header),
+    m_triangleCount(triangleCount)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FileStartStage::processHeader(STLBinaryHeader& header)
+{
+    header = m_header;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FileStartStage::processTriangleCount(uint32_t& triangleCount)
+{
+    triangleCount = m_triangleCount;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FileStartStage::finishTriangleCount(uint32_t& triangleCount, uint32_t /*writtenTriangleCount*/)
+{
+    if (triangleCount != m_triangleCount)
+        throw std::runtime_error("Triangle count doesn't match the one written up front.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void FileStartStage::finishHeader(STLBinaryHeader& header)
+{
+    if (header != m_header)
+        throw std::runtime_error("Header doesn't match the one written up front.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::vector<std::unique_ptr<FilterStage>> createBuiltInStages(const RepairOptions& options)
+{
+    std::vector<std::unique_ptr<FilterStage>> stages;
+
+    if (options.m_zeroOutHeader)
+        stages.push_back(std::make_unique<ZeroHeaderStage>());
+    if (options.m_triangleLimit > 0)
+        stages.push_back(std::make_unique<TriangleLimitStage>(options.m_triangleLimit));
+    if (!options.m_transform.isIdentity())
+        stages.push_back(std::make_unique<TransformStage>(options.m_transform));
+    if (options.m_zeroAttributeByteCounts)
+        stages.push_back(std::make_unique<ZeroAttributeByteCountsStage>());
+    if (options.m_sortByMortonCode)
+        stages.push_back(std::make_unique<MortonOrderStage>());
+    if (options.m_clearExtraFileData)
+        stages.push_back(std::make_unique<ClearExtraDataStage>());
+    if (options.m_updateTriangleCount)
+        stages.push_back(std::make_unique<UpdateTriangleCountStage>());
+    if (options.m_stampPayloadDigest)
+        stages.push_back(std::make_unique<PayloadDigestStage>());
+
+    return stages;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t hashRepairOptions(const RepairOptions& options)
+{
+    XXHash64 optionsHash;
+
+    const std::string version = getVersionString();
+    optionsHash.update(version.data(), version.size());
+
+    const uint8_t flags[] = {
+        options.m_zeroOutHeader, options.m_updateTriangleCount, options.m_zeroAttributeByteCounts,
+        options.m_clearExtraFileData, options.m_sortByMortonCode, options.m_resynchronize,
+        options.m_stampPayloadDigest };
+    optionsHash.update(flags, sizeof(flags));
+    optionsHash.update(&options.m_triangleLimit, sizeof(options.m_triangleLimit));
+
+    // An affine transform is pinned down by where it puts the origin and
+    // the unit axes.
+    for (const Vec3& point : { Vec3{ 0, 0, 0 }, Vec3{ 1, 0, 0 }, Vec3{ 0, 1, 0 }, Vec3{ 0, 0, 1 } })
+        hashVec3(optionsHash, options.m_transform.transformPoint(point));
+
+    return optionsHash.digest();
+}
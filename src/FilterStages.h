@@ -0,0 +1,172 @@
+#ifndef STLREPAIR_FILTERSTAGES__H_
+#define STLREPAIR_FILTERSTAGES__H_
+
+#include "FilterStage.h"
+#include "AffineTransform.h"
+#include "PayloadDigest.h"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/**
+ * The filter stages stlrepair ships with.
+ */
+
+//! Replaces the header with zeros.
+class ZeroHeaderStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "zero header"; }
+    void processHeader(STLBinaryHeader& header) override;
+};
+
+//! Passes through no more than the given number of triangles.
+class TriangleLimitStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "triangle limit"; }
+    explicit TriangleLimitStage(uint32_t triangleLimit);
+    void processTriangles(TriangleBatch& batch) override;
+    bool saveState(std::vector<uint8_t>& state) const override;
+    void restoreState(const std::vector<uint8_t>& state) override;
+
+private:
+    const uint32_t m_triangleLimit;
+    uint32_t m_passedTriangleCount;
+};
+
+//! Applies a geometric transform to every triangle.
+class TransformStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "transform"; }
+    explicit TransformStage(const AffineTransform& transform);
+    void processTriangles(TriangleBatch& batch) override;
+
+private:
+    const AffineTransform m_transform;
+};
+
+//! Sets every triangle's attribute byte count to zero.
+class ZeroAttributeByteCountsStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "zero attribute byte counts"; }
+    void processTriangles(TriangleBatch& batch) override;
+
+    //! Returns the number of attribute byte counts that weren't zero already.
+    uint64_t getZeroedCount() const { return m_zeroedCount; }
+
+private:
+    uint64_t m_zeroedCount = 0;
+};
+
+/**
+ * Holds every triangle back until the end, then releases them in Morton
+ * order of their centroids. See sortByMortonCode().
+ */
+class MortonOrderStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "morton order"; }
+    void processTriangles(TriangleBatch& batch) override;
+    void finishTriangles(TriangleBatch& batch) override;
+    bool saveState(std::vector<uint8_t>& /*state*/) const override { return false; }
+
+private:
+    TriangleBatch m_pending;
+};
+
+//! Drops anything that trailed the triangle data.
+class ClearExtraDataStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "clear extra data"; }
+    void processExtraData(std::vector<char>& extraData) override;
+};
+
+//! Corrects the triangle count to match the number of triangles written.
+class UpdateTriangleCountStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "update triangle count"; }
+    void finishTriangleCount(uint32_t& triangleCount, uint32_t writtenTriangleCount) override;
+};
+
+/**
+ * Hashes every triangle on its way out and stamps the digest into the
+ * header at the end (see PayloadDigest). Has to come after every stage
+ * that changes triangles, so it sees exactly what's written. Only a
+ * FileStartStage may follow it.
+ */
+class PayloadDigestStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "payload digest"; }
+    void processTriangles(TriangleBatch& batch) override;
+    void finishHeader(STLBinaryHeader& header) override;
+    bool saveState(std::vector<uint8_t>& state) const override;
+    void restoreState(const std::vector<uint8_t>& state) override;
+
+private:
+    PayloadDigest m_digest;
+};
+
+/**
+ * Sends out a header and triangle count worked out beforehand (see
+ * predictFileStart()), in place of whatever the stages before it would
+ * have put at the start of the file, so it never has to be patched. Goes
+ * last. Throws at the end if the stages before it didn't come to the same.
+ */
+class FileStartStage : public FilterStage
+{
+public:
+    const char* getName() const override { return "file start"; }
+    FileStartStage(const STLBinaryHeader& header, uint32_t triangleCount);
+    void processHeader(STLBinaryHeader& header) override;
+    void processTriangleCount(uint32_t& triangleCount) override;
+    void finishTriangleCount(uint32_t& triangleCount, uint32_t writtenTriangleCount) override;
+    void finishHeader(STLBinaryHeader& header) override;
+
+private:
+    const STLBinaryHeader m_header;
+    const uint32_t m_triangleCount;
+};
+
+/**
+ * Which of the built-in repairs to make. Everything is off by default.
+ */
+struct RepairOptions
+{
+    bool m_zeroOutHeader = false;
+    bool m_updateTriangleCount = false;
+    bool m_zeroAttributeByteCounts = false;
+    bool m_clearExtraFileData = false;
+    uint32_t m_triangleLimit = 0;
+    bool m_sortByMortonCode = false;
+    AffineTransform m_transform;
+    bool m_stampPayloadDigest = false;
+
+    /**
+     * Whether the reader should skip misaligned junk. Not a stage, so it's
+     * up to whoever sets up the reader (repairSTL() does).
+     */
+    bool m_resynchronize = false;
+};
+
+/**
+ * Creates the stages for the given repairs, in the order they have to run.
+ * The limit applies to triangles as they were read, and sorting sees
+ * triangles after they've been transformed. A PayloadDigestStage, if
+ * there is one, is always last.
+ */
+std::vector<std::unique_ptr<FilterStage>> createBuiltInStages(const RepairOptions& options);
+
+/**
+ * Returns a hash of everything in the options that affects the output,
+ * including the version, since repairs may change between versions.
+ */
+uint64_t hashRepairOptions(const RepairOptions& options);
+
+#endif
@@ -0,0 +1,176 @@
+#include "FollowingFileIO.h"
+
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+
+namespace
+{
+    /**
+     * Reads a file as it grows. See openFollowingFileByteSource().
+     */
+    class FollowingFileByteSource : public ByteSource
+    {
+    public:
+
+        explicit FollowingFileByteSource(const std::string& filepath) :
+            m_filepath(filepath),
+            m_fd(-1),
+            m_inotifyFd(-1),
+            m_isWriterDone(false),
+            m_canCheckWriters(true)
+        {
+            // Watch first, so nothing written between here and the first
+            // read goes unnoticed.
+            m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (m_inotifyFd == -1)
+                throw std::runtime_error(std::string("Could not initialize inotify - ") + strerror(errno));
+
+            if (inotify_add_watch(m_inotifyFd, filepath.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB) == -1)
+            {
+                const std::string error = "Could not watch " + filepath + " - " + strerror(errno);
+                close(m_inotifyFd);
+                throw std::runtime_error(error);
+            }
+
+            m_fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (m_fd == -1)
+            {
+                close(m_inotifyFd);
+                throw std::runtime_error("Unknown error when opening " + filepath);
+            }
+        }
+
+        ~FollowingFileByteSource()
+        {
+            close(m_fd);
+            close(m_inotifyFd);
+        }
+
+        size_t read(uint8_t* pBuffer, size_t size) override
+        {
+            for (;;)
+            {
+                const ssize_t bytesRead = ::read(m_fd, pBuffer, size);
+                if (bytesRead > 0)
+                    return static_cast<size_t>(bytesRead);
+                if (bytesRead == -1)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error("Error reading from " + m_filepath);
+                }
+
+                if (m_isWriterDone)
+                    return 0;
+
+                // Anything written before the last writer closed the file
+                // is there to be read now, so one more read finishes up.
+                if (!isOpenForWriting())
+                {
+                    m_isWriterDone = true;
+                    continue;
+                }
+
+                waitForChange();
+            }
+        }
+
+        bool seek(uint64_t offset) override
+        {
+            return lseek(m_fd, static_cast<off_t>(offset), SEEK_SET) != -1;
+        }
+
+    private:
+
+        //! Returns true if anyone might still be writing the file.
+        bool isOpenForWriting()
+        {
+            if (!m_canCheckWriters)
+                return true;
+
+            // A read lease can only be had while nobody has the file open for
+            // writing. We give it straight back, so no writer is held up.
+            if (fcntl(m_fd, F_SETLEASE, F_RDLCK) == 0)
+            {
+                fcntl(m_fd, F_SETLEASE, F_UNLCK);
+                return false;
+            }
+
+            if (errno == EAGAIN)
+                return true;
+
+            // Not ours to lease. Writers closing the file will have to do.
+            m_canCheckWriters = false;
+            return true;
+        }
+
+        //! Returns true once the last link to the file's gone. We're holding it open, so it's still there.
+        bool isDeleted() const
+        {
+            struct stat status;
+            return (fstat(m_fd, &status) == 0) && (status.st_nlink == 0);
+        }
+
+        //! Blocks until the file's written to or closed by a writer.
+        void waitForChange()
+        {
+            pollfd fd = { m_inotifyFd, POLLIN, 0 };
+            if ((poll(&fd, 1, -1) == -1) && (errno != EINTR))
+                throw std::runtime_error(std::string("Could not wait for changes - ") + strerror(errno));
+
+            alignas(inotify_event) char events[4096];
+            ssize_t size = 0;
+            while ((size = ::read(m_inotifyFd, events, sizeof(events))) > 0)
+            {
+                for (const char* pNext = events; pNext < events + size; )
+                {
+                    const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(pNext);
+                    pNext += sizeof(inotify_event) + pEvent->len;
+
+                    if ((pEvent->mask & IN_ATTRIB) && isDeleted())
+                        throw std::runtime_error(m_filepath + " was deleted while it was being followed.");
+                    if ((pEvent->mask & IN_CLOSE_WRITE) && !m_canCheckWriters)
+                        m_isWriterDone = true;
+                }
+            }
+        }
+
+        const std::string m_filepath;
+        int m_fd;
+        int m_inotifyFd;
+        bool m_isWriterDone;
+        bool m_canCheckWriters;
+    };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSource> openFollowingFileByteSource(const std::string& filepath)
+{
+    return std::make_unique<FollowingFileByteSource>(filepath);
+}
+
+#else
+
+/**
+ * @since 2026 Oct 19
+ */
+std::unique_ptr<ByteSource> openFollowingFileByteSource(const std::string& filepath)
+{
+    (void)filepath;
+    throw std::runtime_error("Following a file as it's written isn't supported on this platform.");
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef STLREPAIR_FOLLOWINGFILEIO__H_
+#define STLREPAIR_FOLLOWINGFILEIO__H_
+
+#include "ByteStream.h"
+
+#include <memory>
+#include <string>
+
+/**
+ * Opens a file that's still being written, a download say, for reading as
+ * it grows, like tail -f. Reading at the end of what's there so far waits
+ * (on inotify, not by polling) for more to arrive, and only comes back
+ * empty once nobody has the file open for writing any more. Until then,
+ * every read blocks until there's something to return.
+ *
+ * Whether anyone's still writing is asked of the kernel with a read lease
+ * (F_SETLEASE), which only the file's owner (or root) can take. Otherwise,
+ * the end comes with the next time a writer closes the file, so a file
+ * that's already finished and owned by someone else is waited on forever.
+ *
+ * If the file is deleted while it's being followed, reading throws.
+ *
+ * Linux only.
+ *
+ * @throws std::runtime_error if the file can't be opened or watched.
+ */
+std::unique_ptr<ByteSource> openFollowingFileByteSource(const std::string& filepath);
+
+#endif
@@ -0,0 +1,139 @@
+#include "InMemoryRepair.h"
+#include "BinarySTLFileReader.h"
+#include "FilterChain.h"
+#include "Contracts.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+namespace
+{
+    /**
+     * ByteSink that counts the bytes going through to the one it wraps.
+     */
+    class CountingByteSink : public ByteSink
+    {
+    public:
+
+        CountingByteSink(std::unique_ptr<ByteSink> spSink, size_t& byteCount) :
+            m_spSink(std::move(spSink)),
+            m_byteCount(byteCount)
+        {
+        }
+
+        void write(const uint8_t* pData, size_t size) override
+        {
+            m_spSink->write(pData, size);
+            m_byteCount += size;
+        }
+
+        bool patch(uint64_t offset, const uint8_t* pData, size_t size) override
+        {
+            return m_spSink->patch(offset, pData, size);
+        }
+
+        void close() override { m_spSink->close(); }
+
+    private:
+
+        std::unique_ptr<ByteSink> m_spSink;
+        size_t& m_byteCount;
+    };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult repairSTL(const uint8_t* pInput, size_t inputSize,
+    std::vector<uint8_t>& output, const RepairOptions& options)
+{
+    return repairSTL(pInput, inputSize, std::make_unique<VectorByteSink>(output), options);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult repairSTL(const uint8_t* pInput, size_t inputSize,
+    uint8_t* pOutput, size_t outputCapacity, const RepairOptions& options)
+{
+    return repairSTL(pInput, inputSize, std::make_unique<BufferByteSink>(pOutput, outputCapacity), options);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult repairSTL(const uint8_t* pInput, size_t inputSize,
+    std::unique_ptr<ByteSink> spOutput, const RepairOptions& options)
+{
+    precondition_throw(spOutput != nullptr, std::runtime_error("Output sink cannot be null."));
+    precondition_throw(inputSize >= static_cast<size_t>(MINIMUM_BINARY_STL_SIZE_IN_BYTES),
+        std::runtime_error("Input is too small to be a binary STL."));
+
+    RepairResult result;
+
+    FilterChain chain(std::make_unique<CountingByteSink>(std::move(spOutput), result.m_outputSize));
+    const ZeroAttributeByteCountsStage* pZeroAttributesStage = nullptr;
+    for (auto& spStage : createBuiltInStages(options))
+    {
+        if (auto* pStage = dynamic_cast<const ZeroAttributeByteCountsStage*>(spStage.get()))
+            pZeroAttributesStage = pStage;
+        chain.addStage(std::move(spStage));
+    }
+
+    BinarySTLFileReader reader(std::make_unique<MemoryByteSource>(pInput, inputSize));
+    reader.setResynchronizationEnabled(options.m_resynchronize);
+    reader.readFile(chain);
+
+    result.m_triangleCount = chain.getWrittenTriangleCount();
+    result.m_skippedByteCount = chain.getSkippedByteCount();
+
+    // Work out which of the repairs asked for made a difference.
+    uint32_t triangleCountRead = 0;
+    memcpy(&triangleCountRead, pInput + BINARY_STL_HEADER_SIZE_IN_BYTES, sizeof(triangleCountRead));
+    result.m_isHeaderCleared = options.m_zeroOutHeader &&
+        std::any_of(pInput, pInput + BINARY_STL_HEADER_SIZE_IN_BYTES, [](uint8_t byte) { return byte != 0; });
+    result.m_isTriangleCountChanged = options.m_updateTriangleCount && (triangleCountRead != result.m_triangleCount);
+    result.m_zeroedAttributeCount = pZeroAttributesStage ? pZeroAttributesStage->getZeroedCount() : 0;
+
+    // Records are a fixed size, so whatever didn't come out, and wasn't
+    // skipped as junk, was dropped.
+    const uint64_t keptByteCount = result.m_outputSize + result.m_skippedByteCount;
+    result.m_droppedByteCount = (inputSize > keptByteCount) ? inputSize - keptByteCount : 0;
+
+    return result;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairOptions planRepairs(const uint8_t* pInput, size_t inputSize, const RepairOptions& baseOptions)
+{
+    const uint64_t TRIANGLE_BLOB_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    const uint64_t FIRST_TRIANGLE_OFFSET = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    RepairOptions options = baseOptions;
+    if (inputSize < FIRST_TRIANGLE_OFFSET)
+        return options;
+
+    uint32_t triangleCountRead = 0;
+    memcpy(&triangleCountRead, pInput + BINARY_STL_HEADER_SIZE_IN_BYTES, sizeof(triangleCountRead));
+    const uint64_t triangleCountCalc = (inputSize - FIRST_TRIANGLE_OFFSET) / TRIANGLE_BLOB_SIZE;
+
+    // Skipping junk can cost us triangles, so the count has to be
+    // rewritten to match what actually made it through.
+    if (options.m_resynchronize)
+        options.m_updateTriangleCount = true;
+
+    if (triangleCountRead > triangleCountCalc)
+    {
+        options.m_updateTriangleCount = true;
+        options.m_triangleLimit = static_cast<uint32_t>(triangleCountCalc);
+        options.m_clearExtraFileData = true;
+    }
+
+    if (inputSize > FIRST_TRIANGLE_OFFSET + triangleCountRead * TRIANGLE_BLOB_SIZE)
+        options.m_clearExtraFileData = true;
+
+    return options;
+}
@@ -0,0 +1,73 @@
+#ifndef STLREPAIR_INMEMORYREPAIR__H_
+#define STLREPAIR_INMEMORYREPAIR__H_
+
+#include "ByteStream.h"
+#include "FilterStages.h"
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Repairs binary STL data that's already in memory, for applications that
+ * embed stlrepair rather than running it. No files are touched and nothing
+ * is shared between calls, so any number of repairs can run at once on
+ * different threads.
+ */
+
+/**
+ * What a repair did.
+ */
+struct RepairResult
+{
+    uint32_t m_triangleCount = 0;       //!< Triangles written.
+    uint64_t m_skippedByteCount = 0;    //!< Misaligned bytes skipped by resynchronization.
+    size_t m_outputSize = 0;            //!< Bytes written.
+
+    // The repairs that actually changed something, as opposed to those asked for.
+    bool m_isHeaderCleared = false;         //!< The header wasn't blank, and was cleared.
+    bool m_isTriangleCountChanged = false;  //!< The count written isn't the one read.
+    uint64_t m_zeroedAttributeCount = 0;    //!< Non-zero attribute byte counts zeroed.
+    uint64_t m_droppedByteCount = 0;        //!< Extra data and triangles past the limit left out.
+};
+
+/**
+ * Repairs the STL data in the input buffer, appending the result to output.
+ *
+ * @throws std::runtime_error if the input can't be parsed.
+ */
+RepairResult repairSTL(const uint8_t* pInput, size_t inputSize,
+    std::vector<uint8_t>& output, const RepairOptions& options);
+
+/**
+ * Repairs the STL data in the input buffer, writing the result to the output
+ * buffer. m_outputSize of the result says how much of it was used.
+ *
+ * @throws std::runtime_error if the input can't be parsed or the result
+ *         won't fit in the output buffer.
+ */
+RepairResult repairSTL(const uint8_t* pInput, size_t inputSize,
+    uint8_t* pOutput, size_t outputCapacity, const RepairOptions& options);
+
+/**
+ * Repairs the STL data in the input buffer, writing the result to the given
+ * sink, which is closed before returning. If the triangle count has to be
+ * corrected, the sink must support ByteSink::patch().
+ *
+ * @throws std::runtime_error if the input can't be parsed or the sink fails.
+ */
+RepairResult repairSTL(const uint8_t* pInput, size_t inputSize,
+    std::unique_ptr<ByteSink> spOutput, const RepairOptions& options);
+
+/**
+ * Works out the structural repairs the input needs and adds them to the
+ * given options. That's what the interactive tool offers once it has
+ * compared the declared triangle count against the size of the data. A
+ * count larger than the data can hold is corrected and the triangles are
+ * limited to what's there, and anything trailing the triangles is dropped.
+ * Nothing else about the options is changed.
+ */
+RepairOptions planRepairs(const uint8_t* pInput, size_t inputSize, const RepairOptions& baseOptions);
+
+#endif
@@ -1,11 +1,348 @@
 #include "FileUtils.h"
 #include "Version.h"
+#include "CommandLine.h"
 #include "RepairOptionPrompts.h"
 #include "STLFileTypes.h"
 #include "BinarySTLFileReader.h"
 #include "BinarySTLFileFilter.h"
+#include "PipelinedByteStream.h"
+#include "CompressedByteStream.h"
+#include "AsyncFileIO.h"
+#include "DirectFileIO.h"
+#include "FollowingFileIO.h"
+#include "RepairCache.h"
+#include "OutputCommitter.h"
+#include "RepairCheckpoint.h"
+#include "PayloadDigest.h"
+#include "FacetDiff.h"
+#include "Stats.h"
+#include "TraceRecorder.h"
+#include "WatchDaemon.h"
+#include "RepairServer.h"
+#include "Metrics.h"
+#include "MetricsExporter.h"
+#include "CallGuard.h"
+#include "AffineTransform.h"
+#include "ConnectedComponents.h"
+#include "ShardWriter.h"
+#include "STLMerger.h"
+#include "SelfIntersection.h"
 
 #include <iostream>
+#include <memory>
+#include <csignal>
+
+namespace
+{
+    /**
+     * Splits the input into one file per connected component. Triangle
+     * counts are always exact and trailing data is always dropped, so the
+     * only questions worth asking are about the header and attributes, and
+     * not even those if the command line has already answered them.
+     */
+    void splitComponents(const CommandLineOptions& options, const std::string& inputFile)
+    {
+        bool zeroOutHeader = options.m_clearHeader || promptClearFileHeader();
+        bool zeroAttributeByteCounts = options.m_clearAttributes || promptClearFacetAttributeCounts();
+
+        STLMesh mesh = readMesh(inputFile);
+        ComponentLabels labels = findConnectedComponents(mesh);
+
+        std::cout << "Found " << labels.m_componentCount << " connected component(s).\n";
+
+        auto outputFiles = writeConnectedComponents(mesh, labels, inputFile,
+            zeroOutHeader, zeroAttributeByteCounts);
+
+        for (const auto& outputFile : outputFiles)
+            std::cout << "Generated new STL - " << outputFile << "\n";
+    }
+
+    /**
+     * Splits the input into shards as the command line describes, with
+     * the header and attributes cleared if asked for, and transformed.
+     */
+    void shardInput(const CommandLineOptions& options, const std::string& inputFile,
+        const AffineTransform& transform)
+    {
+        ShardOptions shardOptions;
+        shardOptions.m_mode = options.m_shardMode;
+        shardOptions.m_shardCount = options.m_shardCount;
+        shardOptions.m_maxShardBytes = options.m_maxShardBytes;
+        shardOptions.m_zeroOutHeader = options.m_clearHeader || promptClearFileHeader();
+        shardOptions.m_zeroAttributeByteCounts = options.m_clearAttributes || promptClearFacetAttributeCounts();
+        shardOptions.m_transform = transform;
+        shardOptions.m_durability = options.m_durability;
+
+        for (const auto& outputFile : shardFile(inputFile, shardOptions))
+            std::cout << "Generated new STL - " << outputFile << "\n";
+    }
+
+    /**
+     * Builds the transform described by the command line. Centering needs
+     * the bounding box up front, since we only get one pass at the triangles
+     * during the repair itself, so that comes from a quick pre-scan.
+     */
+    AffineTransform buildTransform(const CommandLineOptions& options, const std::string& inputFile)
+    {
+        AffineTransform transform;
+
+        if (options.m_center)
+        {
+            Vec3 center = scanBoundingBox(inputFile).center();
+            transform = AffineTransform::translation({ -center.x, -center.y, -center.z });
+        }
+
+        return transform.then(AffineTransform::scale(options.m_scale))
+                        .then(AffineTransform::translation(options.m_translation));
+    }
+
+    /**
+     * Merges the input files into the output file, repairing each as the
+     * command line says. Returns the exit code.
+     */
+    int mergeInputs(const CommandLineOptions& options)
+    {
+        MergeOptions mergeOptions;
+        mergeOptions.m_zeroOutHeader = options.m_clearHeader || promptClearFileHeader();
+        mergeOptions.m_zeroAttributeByteCounts = options.m_clearAttributes || promptClearFacetAttributeCounts();
+        mergeOptions.m_transform = buildTransform(options, std::string());
+
+        // Only renamed into place once it's complete, like any other output.
+        const std::string tempFile = makeTempOutputPath(options.m_mergeOutputFile);
+        auto tempFileGuard = makeCallGuard([&]() { remove(tempFile.c_str()); });
+
+        const uint32_t facetCount = mergeFiles(options.m_mergeInputFiles, tempFile, mergeOptions);
+        {
+            STLREPAIR_STATS_PHASE(COMMIT);
+            OutputCommitter(options.m_durability).commit(tempFile, options.m_mergeOutputFile);
+            tempFileGuard.dismiss();
+        }
+
+        std::cout << "Merged " << facetCount << " facet(s) from " << options.m_mergeInputFiles.size()
+            << " file(s) - " << options.m_mergeOutputFile << "\n";
+        std::cout << "Done.\n";
+        return 0;
+    }
+
+    /**
+     * Starts whichever metrics exporters the command line asks for. They
+     * stop when the returned objects are destroyed.
+     */
+    struct MetricsExporters
+    {
+        std::unique_ptr<MetricsHttpEndpoint> m_spHttpEndpoint;
+        std::unique_ptr<MetricsTextfileWriter> m_spTextfileWriter;
+    };
+
+    MetricsExporters startMetricsExporters(const CommandLineOptions& options)
+    {
+        MetricsExporters exporters;
+        if ((options.m_metricsPort == 0) && options.m_metricsFile.empty())
+            return exporters;
+
+        Metrics::setEnabled(true);
+        if (options.m_metricsPort != 0)
+            exporters.m_spHttpEndpoint.reset(new MetricsHttpEndpoint(options.m_metricsPort));
+        if (!options.m_metricsFile.empty())
+        {
+            exporters.m_spTextfileWriter.reset(new MetricsTextfileWriter(options.m_metricsFile,
+                std::chrono::seconds(options.m_metricsInterval)));
+        }
+        return exporters;
+    }
+
+    WatchDaemon* s_pWatchDaemon = nullptr;
+    RepairServer* s_pRepairServer = nullptr;
+
+    extern "C" void stopRunning(int /*signal*/)
+    {
+        if (s_pWatchDaemon)
+            s_pWatchDaemon->stop();
+        if (s_pRepairServer)
+            s_pRepairServer->stop();
+    }
+
+    /**
+     * Repairs files as they're written to the watched directories, until
+     * interrupted. Nobody's around to answer questions, so the structural
+     * repairs are always made, and the header and attribute counts are only
+     * cleared if the command line says so.
+     */
+    int watchDirectories(const CommandLineOptions& options)
+    {
+        WatchOptions watchOptions;
+        watchOptions.m_directories = options.m_watchDirectories;
+        watchOptions.m_outputDirectory = options.m_outputDirectory;
+        watchOptions.m_workerCount = options.m_workerCount;
+        watchOptions.m_durability = options.m_durability;
+
+        RepairOptions& repairOptions = watchOptions.m_repairOptions;
+        repairOptions.m_zeroOutHeader = options.m_clearHeader;
+        repairOptions.m_zeroAttributeByteCounts = options.m_clearAttributes;
+        repairOptions.m_sortByMortonCode = options.m_mortonOrder;
+        repairOptions.m_stampPayloadDigest = options.m_stampPayloadDigest;
+        repairOptions.m_resynchronize = options.m_resynchronize;
+        repairOptions.m_transform = buildTransform(options, std::string());
+
+        MetricsExporters exporters = startMetricsExporters(options);
+        WatchDaemon daemon(watchOptions);
+        s_pWatchDaemon = &daemon;
+        signal(SIGINT, stopRunning);
+        signal(SIGTERM, stopRunning);
+        auto signalGuard = makeCallGuard([]()
+        {
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            s_pWatchDaemon = nullptr;
+        });
+
+        std::cout << "Watching for STL files. Press Ctrl+C to stop." << std::endl;
+        daemon.run();
+
+        std::cout << "Repaired " << daemon.getRepairedFileCount() << " files ("
+                  << daemon.getFailedFileCount() << " failed).\n";
+        return 0;
+    }
+
+    /**
+     * Serves repairs over a Unix domain socket until interrupted. What to
+     * repair comes with each request.
+     */
+    int serveRepairs(const CommandLineOptions& options)
+    {
+        MetricsExporters exporters = startMetricsExporters(options);
+        RepairServer server(options.m_serverSocketPath, options.m_workerCount);
+        s_pRepairServer = &server;
+        signal(SIGINT, stopRunning);
+        signal(SIGTERM, stopRunning);
+        auto signalGuard = makeCallGuard([]()
+        {
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            s_pRepairServer = nullptr;
+        });
+
+        std::cout << "Serving repairs on " << options.m_serverSocketPath << ". Press Ctrl+C to stop." << std::endl;
+        server.run();
+
+        std::cout << "Served " << server.getRepairedRequestCount() << " repairs ("
+                  << server.getFailedRequestCount() << " failed).\n";
+        return 0;
+    }
+
+    void printStats(bool asJson)
+    {
+        const StatsReport report = Stats::getReport();
+        if (asJson)
+            std::cout << formatStatsJson(report) << std::endl;
+        else
+            std::cout << formatStatsText(report) << std::flush;
+    }
+
+    void writeTrace(const std::string& traceFile)
+    {
+        TraceRecorder::stop();
+        try
+        {
+            TraceRecorder::writeJson(traceFile);
+            std::cout << "Wrote trace - " << traceFile << std::endl;
+
+            const uint64_t droppedEventCount = TraceRecorder::getDroppedEventCount();
+            if (droppedEventCount > 0)
+                std::cout << droppedEventCount << " trace events didn't fit and were dropped." << std::endl;
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * Reports every pair of facets that pass through each other. This is a
+     * geometry check only. Nothing is written.
+     */
+    void checkIntersections(const std::string& inputFile)
+    {
+        STLMesh mesh = readMesh(inputFile);
+        auto intersections = findSelfIntersections(mesh);
+
+        std::cout << "Found " << intersections.size() << " intersecting facet pair(s).\n";
+
+        for (const auto& intersection : intersections)
+            std::cout << "  facet " << intersection.first << " intersects facet " << intersection.second << "\n";
+    }
+
+    /**
+     * Checks the facets against the digest stamped in the header. Returns
+     * the exit code.
+     */
+    int verifyFile(const std::string& inputFile)
+    {
+        STLREPAIR_STATS_PHASE(VERIFY);
+
+        switch (verifyPayloadDigest(inputFile))
+        {
+        case PayloadDigestCheck::MATCH:
+            std::cout << "Payload digest verified - " << inputFile << "\n";
+            return 0;
+        case PayloadDigestCheck::MISMATCH:
+            std::cout << "Payload digest MISMATCH - " << inputFile << "\n";
+            return 1;
+        case PayloadDigestCheck::NOT_STAMPED:
+        default:
+            std::cout << "No payload digest in header - " << inputFile << "\n";
+            return 2;
+        }
+    }
+
+    void printFacetPositions(const char* pLabel, const std::vector<uint32_t>& positions)
+    {
+        const size_t MAX_POSITIONS_SHOWN = 20;
+
+        if (positions.empty())
+            return;
+
+        std::cout << positions.size() << " facet(s) " << pLabel << ":";
+        for (size_t i = 0; i < std::min(positions.size(), MAX_POSITIONS_SHOWN); ++i)
+            std::cout << " " << positions[i];
+        if (positions.size() > MAX_POSITIONS_SHOWN)
+            std::cout << " ...";
+        std::cout << "\n";
+    }
+
+    /**
+     * Reports facet-level differences between the two files. Returns the
+     * exit code, which is 0 only if they're the same.
+     */
+    int diffFiles(const std::string& inputFile, const std::string& otherFile)
+    {
+        FacetDiff diff;
+        {
+            STLREPAIR_STATS_PHASE(DIFF);
+            diff = diffSTLFiles(inputFile, otherFile);
+        }
+
+        std::cout << "Comparing " << inputFile << " to " << otherFile << "\n";
+
+        if (diff.m_isHeaderDifferent)
+            std::cout << "Headers differ.\n";
+        if (diff.m_leftTriangleCount != diff.m_rightTriangleCount)
+            std::cout << "Triangle counts differ - " << diff.m_leftTriangleCount << " vs " << diff.m_rightTriangleCount << "\n";
+        if (diff.m_leftFacetCount != diff.m_rightFacetCount)
+            std::cout << "Facet counts differ - " << diff.m_leftFacetCount << " vs " << diff.m_rightFacetCount << "\n";
+
+        printFacetPositions("changed", diff.m_changedFacets);
+        printFacetPositions("removed", diff.m_removedFacets);
+        printFacetPositions("added", diff.m_addedFacets);
+        if (diff.m_movedFacetCount > 0)
+            std::cout << diff.m_movedFacetCount << " facet(s) moved.\n";
+
+        if (diff.isIdentical())
+            std::cout << "No differences.\n";
+
+        return diff.isIdentical() ? 0 : 1;
+    }
+}
 
 /**
  * main()
@@ -16,13 +353,64 @@ int main(int argc, const char** argv)
         "Copyright(C) 2024, Shane Kirk\n"
         "Visit http://www.shanekirk.com for more info.\n" << std::endl;
 
-    if (argc < 2)
+    CommandLineOptions options;
+    try
+    {
+        options = parseCommandLine(argc, argv);
+    }
+    catch (const std::runtime_error& e)
     {
-        std::cout << "usage: stlrepair <file.stl>" << std::endl;
+        std::cout << e.what() << "\n\n" << getUsageString() << std::endl;
         return 1;
     }
 
-    const std::string inputFile = argv[1];
+    const std::string inputFile = options.m_inputFile;
+
+    Stats::setEnabled(options.m_stats);
+    auto statsGuard = makeCallGuard([&]()
+    {
+        if (options.m_stats)
+            printStats(options.m_statsAsJson);
+    });
+
+    if (!options.m_traceFile.empty())
+    {
+        TraceRecorder::start();
+        TraceRecorder::setThreadName("main");
+    }
+    auto traceGuard = makeCallGuard([&]()
+    {
+        if (!options.m_traceFile.empty())
+            writeTrace(options.m_traceFile);
+    });
+
+    if (!options.m_mergeOutputFile.empty())
+    {
+        try
+        {
+            return mergeInputs(options);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!options.m_watchDirectories.empty() || !options.m_serverSocketPath.empty())
+    {
+        try
+        {
+            if (!options.m_serverSocketPath.empty())
+                return serveRepairs(options);
+            return watchDirectories(options);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
 
     if (!FileUtils::fileExists(inputFile))
     {
@@ -32,31 +420,141 @@ int main(int argc, const char** argv)
 
     try
     {
-        if (determineFileType(inputFile) == STLFileType::ASCII)
+        // A compressed input is only ever read front to back.
+        const CompressionFormat inputCompression = detectCompressionFormat(inputFile);
+        if (inputCompression != CompressionFormat::NONE)
         {
-            if (!promptShouldTreatASCIIModeAsBinary())
+            if (!isCompressionSupported(inputCompression))
+                throw std::runtime_error("This build can't read how " + inputFile + " is compressed.");
+            if (options.m_verify || !options.m_diffFile.empty() || options.m_shard || options.m_follow ||
+                options.m_checkpoint || options.m_directIO || options.m_asyncIO.m_isEnabled)
             {
-                std::cout << "Exiting\n";
-                return 0;
+                throw std::runtime_error("--verify, --diff, sharding, --follow, --checkpoint, --direct-io and "
+                    "asynchronous I/O can't be used with a compressed input.");
             }
         }
 
-        if (FileUtils::getFileSize(inputFile) < MINIMUM_BINARY_STL_SIZE_IN_BYTES)
-            throw std::runtime_error("Specified file too small to be a binary STL - " + inputFile);
+        if (options.m_verify)
+            return verifyFile(inputFile);
+
+        if (!options.m_diffFile.empty())
+            return diffFiles(inputFile, options.m_diffFile);
+
+        // A file that's still being written can't be judged by what's
+        // there so far.
+        std::uintmax_t inputSize = 0;
+        if (!options.m_follow)
+        {
+            STLFileType fileType = STLFileType::UNKNOWN;
+            {
+                STLREPAIR_STATS_PHASE(PROBE);
+                fileType = determineFileType(inputFile);
+                inputSize = getUncompressedSize(inputFile);
+            }
+
+            if (fileType == STLFileType::ASCII)
+            {
+                if (!promptShouldTreatASCIIModeAsBinary())
+                {
+                    std::cout << "Exiting\n";
+                    return 0;
+                }
+            }
 
+            if (inputSize < MINIMUM_BINARY_STL_SIZE_IN_BYTES)
+                throw std::runtime_error("Specified file too small to be a binary STL - " + inputFile);
+        }
 
+        if (options.m_checkIntersections)
+        {
+            checkIntersections(inputFile);
+            return 0;
+        }
+
+        if (options.m_splitComponents)
+        {
+            splitComponents(options, inputFile);
+            std::cout << "Done.\n";
+            return 0;
+        }
+
+        if (options.m_shard)
+        {
+            shardInput(options, inputFile, buildTransform(options, inputFile));
+            std::cout << "Done.\n";
+            return 0;
+        }
+
+        // Written to a temp file and only renamed once it's complete, so a
+        // crash never leaves a truncated file behind under the new name.
         std::string newFile = FileUtils::generateUniqueFilePath(inputFile);
-        BinarySTLFileFilter filter(newFile);
+        std::string tempFile = makeTempOutputPath(newFile);
+
+        // An earlier run that was checkpointed carries on where it left off,
+        // as long as it was the same repair of the same file.
+        const std::string checkpointPath = getCheckpointPath(inputFile);
+        RepairCheckpoint checkpoint;
+        bool isResuming = options.m_checkpoint && readRepairCheckpoint(checkpointPath, checkpoint) &&
+            FileUtils::fileExists(checkpoint.m_tempFile) && !FileUtils::fileExists(checkpoint.m_outputFile);
+        if (isResuming)
+        {
+            newFile = checkpoint.m_outputFile;
+            tempFile = checkpoint.m_tempFile;
+        }
 
-        if (promptClearFileHeader())
+        // Once there's a checkpoint, what's been written is kept for next time.
+        auto tempFileGuard = makeCallGuard([&]()
+        {
+            if (!options.m_checkpoint || !FileUtils::fileExists(checkpointPath))
+                remove(tempFile.c_str());
+        });
+
+        BinarySTLFileFilter filter(tempFile);
+        filter.m_sortByMortonCode = options.m_mortonOrder;
+        filter.m_writeOnBackgroundThread = options.m_pipelined;
+        filter.m_asyncIO = options.m_asyncIO;
+        filter.m_bypassPageCache = options.m_directIO;
+        filter.m_stampPayloadDigest = options.m_stampPayloadDigest;
+        filter.m_outputCompression = getCompressionFormatFromPath(newFile);
+        if (!isCompressionSupported(filter.m_outputCompression))
+            throw std::runtime_error("This build can't compress " + newFile + ".");
+        if (options.m_checkpoint && (filter.m_outputCompression != CompressionFormat::NONE))
+            throw std::runtime_error("--checkpoint can't be used with a compressed output.");
+
+        uint32_t triangleCountRead = 0;
+        uint32_t triangleCountCalc = 0;
+        bool hasExtraFileData = false;
+        {
+            STLREPAIR_STATS_PHASE(PROBE);
+            filter.m_transform = buildTransform(options, inputFile);
+            if (!options.m_follow)
+            {
+                triangleCountRead = readTriangleCount(inputFile);
+                triangleCountCalc = calculateTriangleCountFromSize(inputSize);
+                hasExtraFileData = (inputSize > calculateDataSize(triangleCountRead));
+            }
+        }
+
+        // Whether the count will be right or there'll be a partial facet on
+        // the end isn't known until the writer's done. So the count is
+        // always made to match what's there, and anything left over goes.
+        if (options.m_follow)
+        {
+            filter.m_updateTriangleCount = true;
+            filter.m_clearExtraFileData = true;
+        }
+
+        // Skipping junk can cost us triangles, so the count has to be
+        // rewritten to match what actually made it through.
+        if (options.m_resynchronize)
+            filter.m_updateTriangleCount = true;
+
+        if (options.m_clearHeader || promptClearFileHeader())
             filter.m_zeroOutHeader = true;
 
-        if (promptClearFacetAttributeCounts())
+        if (options.m_clearAttributes || promptClearFacetAttributeCounts())
             filter.m_zeroAttributeByteCounts = true;
 
-        uint32_t triangleCountRead = readTriangleCount(inputFile);
-        uint32_t triangleCountCalc = calculateTriangleCount(inputFile);
-
         if (triangleCountRead > triangleCountCalc)
         {
             if (promptTriangleCountTooBig())
@@ -67,15 +565,115 @@ int main(int argc, const char** argv)
             }
         }
 
-        if (hasExtraData(inputFile))
+        if (hasExtraFileData)
         {
             if (promptTruncateExtraData())
                 filter.m_clearExtraFileData = true;
         }
 
-        std::cout << "Generating new STL - " << newFile << "\n";
-        BinarySTLFileReader reader(inputFile);
-        reader.readFile(filter);
+        RepairOptions repairOptions = filter.getRepairOptions();
+        repairOptions.m_resynchronize = options.m_resynchronize;
+
+        if (isResuming && !isCheckpointFor(checkpoint, inputFile, repairOptions))
+        {
+            std::cout << "Checkpoint is for a different repair. Starting over.\n";
+            isResuming = false;
+        }
+        if (options.m_checkpoint && !isResuming)
+        {
+            remove(checkpointPath.c_str());
+            checkpoint = makeInitialCheckpoint(inputFile, repairOptions, newFile, tempFile);
+        }
+
+        std::unique_ptr<RepairCache> spCache;
+        std::string cacheKey;
+        if (!options.m_cacheDirectory.empty())
+        {
+            STLREPAIR_STATS_PHASE(CACHE);
+            spCache = std::make_unique<RepairCache>(options.m_cacheDirectory, options.m_cacheSizeInBytes);
+            cacheKey = RepairCache::makeKey(inputFile, repairOptions, filter.m_outputCompression);
+            if (spCache->fetch(cacheKey, newFile))
+            {
+                if (options.m_checkpoint)
+                    remove(checkpointPath.c_str());
+                std::cout << "Reused cached repair - " << newFile << "\n";
+                std::cout << "Done.\n";
+                return 0;
+            }
+        }
+
+        // A compressed output can't be patched, so if the repair is going to
+        // change the start of the file, that has to be worked out up front.
+        if ((filter.m_outputCompression != CompressionFormat::NONE) &&
+            (repairOptions.m_updateTriangleCount || repairOptions.m_stampPayloadDigest))
+        {
+            STLREPAIR_STATS_PHASE(PROBE);
+            STLBinaryHeader header;
+            uint32_t triangleCount = 0;
+            predictFileStart(inputFile, repairOptions, header, triangleCount);
+            filter.setFileStart(header, triangleCount);
+        }
+
+        if (isResuming)
+            std::cout << "Resuming new STL from byte " << checkpoint.m_reader.m_fileOffset << " - " << newFile << "\n";
+        else if (options.m_follow)
+            std::cout << "Generating new STL as " << inputFile << " is written - " << newFile << std::endl;
+        else
+            std::cout << "Generating new STL - " << newFile << "\n";
+
+        std::unique_ptr<ByteSource> spSource;
+        if (inputCompression != CompressionFormat::NONE)
+            spSource = openCompressedFileByteSource(inputFile);
+        else if (options.m_follow)
+            spSource = openFollowingFileByteSource(inputFile);
+        else if (options.m_asyncIO.m_isEnabled)
+            spSource = openAsyncFileByteSource(inputFile, options.m_asyncIO);
+        else if (options.m_directIO)
+            spSource = openDirectFileByteSource(inputFile);
+        else
+            spSource = std::make_unique<FileByteSource>(inputFile);
+
+        // Decompression is already on a thread of its own.
+        if (options.m_pipelined && (inputCompression == CompressionFormat::NONE))
+            spSource = std::make_unique<PrefetchingByteSource>(std::move(spSource));
+
+        BinarySTLFileReader reader(std::move(spSource));
+        reader.setResynchronizationEnabled(options.m_resynchronize);
+        if (options.m_checkpoint)
+        {
+            RepairCheckpointer checkpointer(reader, filter, checkpointPath, checkpoint,
+                options.m_checkpointIntervalInBytes);
+            if (isResuming)
+            {
+                filter.resumeFrom(checkpoint.m_filter);
+                reader.resumeFile(checkpointer, checkpoint.m_reader);
+            }
+            else
+            {
+                reader.readFile(checkpointer);
+            }
+        }
+        else
+        {
+            reader.readFile(filter);
+        }
+
+        if (filter.getSkippedByteCount() > 0)
+            std::cout << "Skipped " << filter.getSkippedByteCount() << " byte(s) of misaligned data.\n";
+
+        {
+            STLREPAIR_STATS_PHASE(COMMIT);
+            OutputCommitter(options.m_durability).commit(tempFile, newFile);
+            tempFileGuard.dismiss();
+            if (options.m_checkpoint)
+                remove(checkpointPath.c_str());
+        }
+
+        if (spCache)
+        {
+            STLREPAIR_STATS_PHASE(CACHE);
+            spCache->store(cacheKey, newFile);
+        }
 
         std::cout << "Done.\n";
     }
@@ -0,0 +1,80 @@
+#include "MappedFile.h"
+#include "CallGuard.h"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @since 2026 Oct 19
+ */
+MappedFile::MappedFile(const std::string& filepath) :
+    m_pData(nullptr),
+    m_size(0)
+{
+#if defined(_WIN32)
+    m_fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+    auto fileGuard = makeCallGuard([&]() { CloseHandle(m_fileHandle); });
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_fileHandle, &fileSize) || (fileSize.QuadPart == 0))
+        throw std::runtime_error("Could not map " + filepath);
+
+    m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mappingHandle)
+        throw std::runtime_error("Could not map " + filepath);
+    auto mappingGuard = makeCallGuard([&]() { CloseHandle(m_mappingHandle); });
+
+    m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!m_pData)
+        throw std::runtime_error("Could not map " + filepath);
+
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    mappingGuard.dismiss();
+    fileGuard.dismiss();
+#else
+    int descriptor = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+
+    // The mapping keeps the file alive, so the descriptor can go right away.
+    auto descriptorGuard = makeCallGuard([&]() { close(descriptor); });
+
+    struct stat fileStatus;
+    if ((fstat(descriptor, &fileStatus) != 0) || (fileStatus.st_size == 0))
+        throw std::runtime_error("Could not map " + filepath);
+
+    void* pData = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (pData == MAP_FAILED)
+        throw std::runtime_error("Could not map " + filepath);
+
+    madvise(pData, static_cast<size_t>(fileStatus.st_size), MADV_SEQUENTIAL);
+    m_pData = static_cast<const uint8_t*>(pData);
+    m_size = static_cast<size_t>(fileStatus.st_size);
+#endif
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+MappedFile::~MappedFile()
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(m_pData);
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_fileHandle);
+#else
+    munmap(const_cast<uint8_t*>(m_pData), m_size);
+#endif
+}
@@ -0,0 +1,47 @@
+#ifndef STLREPAIR_MAPPEDFILE__H_
+#define STLREPAIR_MAPPEDFILE__H_
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Read-only memory mapping of an entire file.
+ */
+class MappedFile
+{
+public:
+
+    /**
+     * Constructor. Maps the whole file and hints to the OS that it'll be
+     * read sequentially.
+     *
+     * @throws std::runtime_error if the file can't be opened or mapped.
+     *         Empty files can't be mapped.
+     */
+    explicit MappedFile(const std::string& filepath);
+
+    //! Destructor. Unmaps the file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! Returns the start of the mapped data.
+    const uint8_t* data() const { return m_pData; }
+
+    //! Returns the size of the mapped data in bytes.
+    size_t size() const { return m_size; }
+
+private:
+
+    const uint8_t* m_pData;
+    size_t m_size;
+
+#if defined(_WIN32)
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+};
+
+#endif
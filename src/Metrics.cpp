@@ -0,0 +1,227 @@
+#include "Metrics.h"
+#include "ThreadSlots.h"
+
+#include <atomic>
+#include <sstream>
+
+namespace
+{
+    /**
+     * One thread's counts. Only the owning thread writes, so increments are
+     * plain loads and stores. They're atomic only so snapshots can read
+     * them at any time.
+     *
+     * A thread that inherits another's slot (see ThreadSlots) carries on
+     * counting into it, which is fine for cumulative counters.
+     */
+    struct ThreadMetrics
+    {
+        std::atomic<uint64_t> m_counters[METRICS_SOURCE_COUNT][METRICS_COUNTER_COUNT] = {};
+        std::atomic<uint64_t> m_latencyBuckets[METRICS_SOURCE_COUNT][METRICS_LATENCY_BUCKET_COUNT] = {};
+        std::atomic<uint64_t> m_latencySumNs[METRICS_SOURCE_COUNT] = {};
+    };
+
+    std::atomic<bool> s_isEnabled(false);
+    std::atomic<uint64_t> s_queueDepth(0);
+
+    ThreadMetrics& getThreadMetrics()
+    {
+        return ThreadSlots<ThreadMetrics>::get();
+    }
+
+    //! Only the owning thread adds, so there's no need for a locked add.
+    void increment(std::atomic<uint64_t>& value, uint64_t amount)
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    const char* const SOURCE_NAMES[METRICS_SOURCE_COUNT] = { "watch", "serve" };
+
+    void writeCounter(std::ostream& stream, const MetricsSnapshot& snapshot, const char* pName,
+        const char* pHelp, MetricsCounter counter)
+    {
+        stream << "# HELP " << pName << " " << pHelp << "\n"
+               << "# TYPE " << pName << " counter\n";
+        for (size_t source = 0; source < METRICS_SOURCE_COUNT; ++source)
+        {
+            stream << pName << "{source=\"" << SOURCE_NAMES[source] << "\"} "
+                   << snapshot.m_counters[source][static_cast<size_t>(counter)] << "\n";
+        }
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Metrics::setEnabled(bool enabled)
+{
+    s_isEnabled = enabled;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool Metrics::isEnabled()
+{
+    return s_isEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Metrics::add(MetricsSource source, MetricsCounter counter, uint64_t amount)
+{
+    if (!isEnabled())
+        return;
+
+    increment(getThreadMetrics().m_counters[static_cast<size_t>(source)][static_cast<size_t>(counter)], amount);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Metrics::observeLatency(MetricsSource source, uint64_t durationNs)
+{
+    if (!isEnabled())
+        return;
+
+    const double seconds = durationNs / 1e9;
+    size_t bucket = 0;
+    while ((bucket < METRICS_LATENCY_BUCKET_COUNT - 1) && (seconds > METRICS_LATENCY_BUCKETS[bucket]))
+        ++bucket;
+
+    ThreadMetrics& metrics = getThreadMetrics();
+    increment(metrics.m_latencyBuckets[static_cast<size_t>(source)][bucket], 1);
+    increment(metrics.m_latencySumNs[static_cast<size_t>(source)], durationNs);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Metrics::setQueueDepth(size_t queueDepth)
+{
+    if (isEnabled())
+        s_queueDepth.store(queueDepth, std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Metrics::recordRepair(MetricsSource source, uint64_t inputSize,
+    const RepairResult& result, uint64_t durationNs)
+{
+    if (!isEnabled())
+        return;
+
+    add(source, MetricsCounter::FILES_REPAIRED);
+    add(source, MetricsCounter::INPUT_BYTES, inputSize);
+    add(source, MetricsCounter::OUTPUT_BYTES, result.m_outputSize);
+    add(source, MetricsCounter::FACETS, result.m_triangleCount);
+    if (result.m_isHeaderCleared)
+        add(source, MetricsCounter::HEADERS_CLEARED);
+    if (result.m_isTriangleCountChanged)
+        add(source, MetricsCounter::COUNTS_SYNCED);
+    if (result.m_zeroedAttributeCount > 0)
+        add(source, MetricsCounter::ATTRIBUTES_ZEROED);
+    if (result.m_droppedByteCount > 0)
+        add(source, MetricsCounter::EXTRA_DATA_DROPPED);
+    observeLatency(source, durationNs);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Metrics::recordFailure(MetricsSource source, uint64_t durationNs)
+{
+    add(source, MetricsCounter::FILES_FAILED);
+    observeLatency(source, durationNs);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsSnapshot Metrics::getSnapshot()
+{
+    MetricsSnapshot snapshot;
+    ThreadSlots<ThreadMetrics>::forEach([&snapshot](const ThreadMetrics& metrics)
+    {
+        for (size_t source = 0; source < METRICS_SOURCE_COUNT; ++source)
+        {
+            for (size_t counter = 0; counter < METRICS_COUNTER_COUNT; ++counter)
+                snapshot.m_counters[source][counter] += metrics.m_counters[source][counter].load(std::memory_order_relaxed);
+            for (size_t bucket = 0; bucket < METRICS_LATENCY_BUCKET_COUNT; ++bucket)
+                snapshot.m_latencyBuckets[source][bucket] += metrics.m_latencyBuckets[source][bucket].load(std::memory_order_relaxed);
+            snapshot.m_latencySumNs[source] += metrics.m_latencySumNs[source].load(std::memory_order_relaxed);
+        }
+    });
+
+    snapshot.m_queueDepth = s_queueDepth.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string formatPrometheusText(const MetricsSnapshot& snapshot)
+{
+    std::ostringstream stream;
+    stream.precision(10);
+
+    stream << "# HELP stlrepair_files_total Files or requests repaired, by result.\n"
+              "# TYPE stlrepair_files_total counter\n";
+    for (size_t source = 0; source < METRICS_SOURCE_COUNT; ++source)
+    {
+        stream << "stlrepair_files_total{source=\"" << SOURCE_NAMES[source] << "\",result=\"repaired\"} "
+               << snapshot.m_counters[source][static_cast<size_t>(MetricsCounter::FILES_REPAIRED)] << "\n"
+               << "stlrepair_files_total{source=\"" << SOURCE_NAMES[source] << "\",result=\"failed\"} "
+               << snapshot.m_counters[source][static_cast<size_t>(MetricsCounter::FILES_FAILED)] << "\n";
+    }
+
+    writeCounter(stream, snapshot, "stlrepair_input_bytes_total", "Bytes of STL data repaired.", MetricsCounter::INPUT_BYTES);
+    writeCounter(stream, snapshot, "stlrepair_output_bytes_total", "Bytes of repaired STL data written.", MetricsCounter::OUTPUT_BYTES);
+    writeCounter(stream, snapshot, "stlrepair_facets_total", "Facets written.", MetricsCounter::FACETS);
+
+    const struct { const char* m_pKind; MetricsCounter m_counter; } REPAIR_KINDS[] = {
+        { "header_cleared", MetricsCounter::HEADERS_CLEARED },
+        { "count_synced", MetricsCounter::COUNTS_SYNCED },
+        { "attributes_zeroed", MetricsCounter::ATTRIBUTES_ZEROED },
+        { "extra_data_dropped", MetricsCounter::EXTRA_DATA_DROPPED } };
+
+    stream << "# HELP stlrepair_repairs_total Repairs made, by kind.\n"
+              "# TYPE stlrepair_repairs_total counter\n";
+    for (size_t source = 0; source < METRICS_SOURCE_COUNT; ++source)
+    {
+        for (const auto& kind : REPAIR_KINDS)
+        {
+            stream << "stlrepair_repairs_total{source=\"" << SOURCE_NAMES[source] << "\",kind=\"" << kind.m_pKind << "\"} "
+                   << snapshot.m_counters[source][static_cast<size_t>(kind.m_counter)] << "\n";
+        }
+    }
+
+    stream << "# HELP stlrepair_repair_duration_seconds Time taken by each repair, including reading and writing.\n"
+              "# TYPE stlrepair_repair_duration_seconds histogram\n";
+    for (size_t source = 0; source < METRICS_SOURCE_COUNT; ++source)
+    {
+        uint64_t cumulativeCount = 0;
+        for (size_t bucket = 0; bucket < METRICS_LATENCY_BUCKET_COUNT; ++bucket)
+        {
+            cumulativeCount += snapshot.m_latencyBuckets[source][bucket];
+            stream << "stlrepair_repair_duration_seconds_bucket{source=\"" << SOURCE_NAMES[source] << "\",le=\"";
+            if (bucket < METRICS_LATENCY_BUCKET_COUNT - 1)
+                stream << METRICS_LATENCY_BUCKETS[bucket];
+            else
+                stream << "+Inf";
+            stream << "\"} " << cumulativeCount << "\n";
+        }
+        stream << "stlrepair_repair_duration_seconds_sum{source=\"" << SOURCE_NAMES[source] << "\"} "
+               << (snapshot.m_latencySumNs[source] / 1e9) << "\n"
+               << "stlrepair_repair_duration_seconds_count{source=\"" << SOURCE_NAMES[source] << "\"} "
+               << cumulativeCount << "\n";
+    }
+
+    stream << "# HELP stlrepair_queue_depth Repairs waiting for a worker.\n"
+              "# TYPE stlrepair_queue_depth gauge\n"
+              "stlrepair_queue_depth " << snapshot.m_queueDepth << "\n";
+
+    return stream.str();
+}
@@ -0,0 +1,111 @@
+#ifndef STLREPAIR_METRICS__H_
+#define STLREPAIR_METRICS__H_
+
+#include "FilterStages.h"
+#include "InMemoryRepair.h"
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Which long-running mode a repair came through. Used as a label, so the
+ * modes can be told apart when both run on one machine.
+ */
+enum class MetricsSource
+{
+    WATCH,
+    SERVE,
+    SOURCE_COUNT
+};
+
+//! The cumulative counters kept for each source.
+enum class MetricsCounter
+{
+    FILES_REPAIRED,
+    FILES_FAILED,
+    INPUT_BYTES,
+    OUTPUT_BYTES,
+    FACETS,
+    HEADERS_CLEARED,
+    COUNTS_SYNCED,
+    ATTRIBUTES_ZEROED,
+    EXTRA_DATA_DROPPED,
+    COUNTER_COUNT
+};
+
+//! Upper bounds of the repair latency histogram buckets, in seconds. There's a +Inf bucket after these.
+constexpr const double METRICS_LATENCY_BUCKETS[] = {
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0 };
+constexpr const size_t METRICS_LATENCY_BUCKET_COUNT = sizeof(METRICS_LATENCY_BUCKETS) / sizeof(METRICS_LATENCY_BUCKETS[0]) + 1;
+
+constexpr const size_t METRICS_SOURCE_COUNT = static_cast<size_t>(MetricsSource::SOURCE_COUNT);
+constexpr const size_t METRICS_COUNTER_COUNT = static_cast<size_t>(MetricsCounter::COUNTER_COUNT);
+
+/**
+ * Everything recorded so far, summed over every thread.
+ */
+struct MetricsSnapshot
+{
+    uint64_t m_counters[METRICS_SOURCE_COUNT][METRICS_COUNTER_COUNT] = {};
+
+    //! Observations per bucket. Not cumulative.
+    uint64_t m_latencyBuckets[METRICS_SOURCE_COUNT][METRICS_LATENCY_BUCKET_COUNT] = {};
+    uint64_t m_latencySumNs[METRICS_SOURCE_COUNT] = {};
+
+    uint64_t m_queueDepth = 0;
+
+    uint64_t get(MetricsSource source, MetricsCounter counter) const
+    {
+        return m_counters[static_cast<size_t>(source)][static_cast<size_t>(counter)];
+    }
+};
+
+/**
+ * Counters and latency histograms for the long-running modes, to be
+ * scraped by Prometheus (see formatPrometheusText() and MetricsExporter.h).
+ *
+ * Each thread counts into a block of its own, so recording costs a few
+ * uncontended increments. Blocks are only summed when a snapshot is taken.
+ * Nothing is recorded until metrics are enabled.
+ */
+class Metrics
+{
+public:
+
+    //! Turns recording on or off. What's already been counted is kept either way.
+    static void setEnabled(bool enabled);
+
+    //! Returns true if recording is on.
+    static bool isEnabled();
+
+    //! Adds to a counter.
+    static void add(MetricsSource source, MetricsCounter counter, uint64_t amount = 1);
+
+    //! Records how long a repair took.
+    static void observeLatency(MetricsSource source, uint64_t durationNs);
+
+    //! Records the number of jobs waiting for a worker.
+    static void setQueueDepth(size_t queueDepth);
+
+    /**
+     * Records a successful repair: the file, its bytes and facets, which
+     * repairs changed something (not just which were asked for), and how
+     * long it took.
+     */
+    static void recordRepair(MetricsSource source, uint64_t inputSize,
+        const RepairResult& result, uint64_t durationNs);
+
+    //! Records a failed repair and how long it took to fail.
+    static void recordFailure(MetricsSource source, uint64_t durationNs);
+
+    //! Returns what's been recorded so far.
+    static MetricsSnapshot getSnapshot();
+};
+
+/**
+ * Returns the snapshot in the Prometheus text exposition format (0.0.4).
+ */
+std::string formatPrometheusText(const MetricsSnapshot& snapshot);
+
+#endif
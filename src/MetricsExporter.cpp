@@ -0,0 +1,256 @@
+#include "MetricsExporter.h"
+#include "Metrics.h"
+#include "CallGuard.h"
+
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsTextfileWriter::MetricsTextfileWriter(const std::string& filepath, std::chrono::seconds interval) :
+    m_filepath(filepath),
+    m_interval(interval),
+    m_isStopping(false)
+{
+    write();
+    m_thread = std::thread([this]() { writePeriodically(); });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsTextfileWriter::~MetricsTextfileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_stopRequested.notify_one();
+    m_thread.join();
+
+    try
+    {
+        write();
+    }
+    catch (const std::exception&)
+    {
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void MetricsTextfileWriter::write()
+{
+    const std::string text = formatPrometheusText(Metrics::getSnapshot());
+    const std::string tempFile = m_filepath + ".tmp";
+
+    FILE* pFile = fopen(tempFile.c_str(), "wb");
+    if (!pFile)
+        throw std::runtime_error("Could not write metrics file - " + tempFile);
+    auto removeGuard = makeCallGuard([&]() { remove(tempFile.c_str()); });
+
+    const bool isWritten = (fwrite(text.data(), 1, text.size(), pFile) == text.size());
+    if ((fclose(pFile) != 0) || !isWritten)
+        throw std::runtime_error("Could not write metrics file - " + tempFile);
+
+#if defined(_WIN32)
+    remove(m_filepath.c_str()); // rename() won't replace an existing file here.
+#endif
+    if (rename(tempFile.c_str(), m_filepath.c_str()) != 0)
+        throw std::runtime_error("Could not write metrics file - " + m_filepath);
+
+    removeGuard.dismiss();
+}
+
+/**
+ * Runs on the writer's thread. A failed write is tried again next time.
+ *
+ * @since 2026 Oct 19
+ */
+void MetricsTextfileWriter::writePeriodically()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopRequested.wait_for(lock, m_interval, [this]() { return m_isStopping; }))
+    {
+        lock.unlock();
+        try
+        {
+            write();
+        }
+        catch (const std::exception&)
+        {
+        }
+        lock.lock();
+    }
+}
+
+#if !defined(_WIN32)
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsHttpEndpoint::MetricsHttpEndpoint(uint16_t port) :
+    m_port(port),
+    m_listenSocket(-1),
+    m_stopPipe{ -1, -1 }
+{
+    auto cleanupGuard = makeCallGuard([this]()
+    {
+        if (m_listenSocket != -1)
+            close(m_listenSocket);
+        if (m_stopPipe[0] != -1)
+            close(m_stopPipe[0]);
+        if (m_stopPipe[1] != -1)
+            close(m_stopPipe[1]);
+    });
+
+    if (pipe(m_stopPipe) != 0)
+        throw std::runtime_error(std::string("Could not serve metrics - ") + strerror(errno));
+
+    m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket == -1)
+        throw std::runtime_error(std::string("Could not serve metrics - ") + strerror(errno));
+
+    const int reuse = 1;
+    setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if ((bind(m_listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) ||
+        (listen(m_listenSocket, 16) != 0))
+    {
+        throw std::runtime_error("Could not serve metrics on port " + std::to_string(port) + " - " + strerror(errno));
+    }
+
+    socklen_t addressSize = sizeof(address);
+    if (getsockname(m_listenSocket, reinterpret_cast<sockaddr*>(&address), &addressSize) == 0)
+        m_port = ntohs(address.sin_port);
+
+    m_thread = std::thread([this]() { serveScrapes(); });
+    cleanupGuard.dismiss();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsHttpEndpoint::~MetricsHttpEndpoint()
+{
+    const char wake = 1;
+    ssize_t written = ::write(m_stopPipe[1], &wake, 1);
+    (void)written;
+    m_thread.join();
+
+    close(m_listenSocket);
+    close(m_stopPipe[0]);
+    close(m_stopPipe[1]);
+}
+
+/**
+ * Runs on the endpoint's thread.
+ *
+ * @since 2026 Oct 19
+ */
+void MetricsHttpEndpoint::serveScrapes()
+{
+    for (;;)
+    {
+        pollfd fds[2] = { { m_listenSocket, POLLIN, 0 }, { m_stopPipe[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        if (fds[1].revents != 0)
+            return;
+
+        const int connection = accept(m_listenSocket, nullptr, nullptr);
+        if (connection == -1)
+            continue;
+        auto closeGuard = makeCallGuard([&]() { close(connection); });
+
+        // Whatever was asked for, the answer's the same. But read the request
+        // first, or closing with it unread can reset the connection before
+        // the client's seen the response. Don't wait long for it though.
+        timeval timeout = { 1, 0 };
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        char buffer[1024];
+        while ((request.size() < 8192) && (request.find("\r\n\r\n") == std::string::npos))
+        {
+            const ssize_t received = recv(connection, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+                break;
+            request.append(buffer, static_cast<size_t>(received));
+        }
+
+        const std::string body = formatPrometheusText(Metrics::getSnapshot());
+        const std::string response =
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n"
+            "\r\n" + body;
+
+        const char* pNext = response.data();
+        size_t remaining = response.size();
+        while (remaining > 0)
+        {
+#if defined(MSG_NOSIGNAL)
+            const ssize_t sent = send(connection, pNext, remaining, MSG_NOSIGNAL);
+#else
+            const ssize_t sent = send(connection, pNext, remaining, 0);
+#endif
+            if (sent <= 0)
+                break;
+            pNext += sent;
+            remaining -= static_cast<size_t>(sent);
+        }
+    }
+}
+
+#else
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsHttpEndpoint::MetricsHttpEndpoint(uint16_t port) :
+    m_port(port),
+    m_listenSocket(-1),
+    m_stopPipe{ -1, -1 }
+{
+    throw std::runtime_error("Serving metrics over HTTP isn't supported on this platform. Use a metrics file.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+MetricsHttpEndpoint::~MetricsHttpEndpoint()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void MetricsHttpEndpoint::serveScrapes()
+{
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef STLREPAIR_METRICSEXPORTER__H_
+#define STLREPAIR_METRICSEXPORTER__H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+/**
+ * Rewrites a file with the current metrics (see Metrics) every so often,
+ * for node_exporter's textfile collector. Each rewrite goes to a temp file
+ * that's renamed into place, so the collector never sees half a file.
+ */
+class MetricsTextfileWriter
+{
+public:
+
+    /**
+     * Constructor. Writes the file straight away, then once per interval.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
+    MetricsTextfileWriter(const std::string& filepath, std::chrono::seconds interval);
+
+    //! Destructor. Writes the file one last time.
+    ~MetricsTextfileWriter();
+
+    MetricsTextfileWriter(const MetricsTextfileWriter&) = delete;
+    MetricsTextfileWriter& operator=(const MetricsTextfileWriter&) = delete;
+
+    /**
+     * Writes the file now.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
+    void write();
+
+private:
+
+    void writePeriodically();
+
+    std::string m_filepath;
+    std::chrono::seconds m_interval;
+    std::mutex m_mutex;
+    std::condition_variable m_stopRequested;
+    bool m_isStopping;
+    std::thread m_thread;
+};
+
+/**
+ * Serves the current metrics over HTTP on a loopback port, for Prometheus
+ * to scrape. Every path gets the metrics. Connections are handled one at a
+ * time on a thread of its own.
+ *
+ * Not supported on Windows.
+ */
+class MetricsHttpEndpoint
+{
+public:
+
+    /**
+     * Constructor. Starts listening on 127.0.0.1.
+     *
+     * @throws std::runtime_error if the port can't be listened on.
+     */
+    explicit MetricsHttpEndpoint(uint16_t port);
+
+    //! Destructor. Stops listening.
+    ~MetricsHttpEndpoint();
+
+    MetricsHttpEndpoint(const MetricsHttpEndpoint&) = delete;
+    MetricsHttpEndpoint& operator=(const MetricsHttpEndpoint&) = delete;
+
+    //! Returns the port being listened on. Useful if 0 was asked for.
+    uint16_t getPort() const { return m_port; }
+
+private:
+
+    void serveScrapes();
+
+    uint16_t m_port;
+    int m_listenSocket;
+    int m_stopPipe[2];
+    std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "MortonCode.h"
+#include "RadixSort.h"
+#include "Parallel.h"
+#include "Contracts.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+    uint64_t quantize(float value, float minValue, float maxValue)
+    {
+        const float maxCell = static_cast<float>((1 << MORTON_BITS_PER_AXIS) - 1);
+        const float extent = maxValue - minValue;
+        if (!(extent > 0.0f))
+            return 0;
+
+        // The negated comparisons also catch NaN.
+        float t = (value - minValue) / extent;
+        if (!(t > 0.0f))
+            t = 0.0f;
+        if (!(t < 1.0f))
+            t = 1.0f;
+
+        return static_cast<uint64_t>(t * maxCell);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t computeMortonCode(const Vec3& point, const BoundingBox& bounds)
+{
+    const uint64_t x = quantize(point.x, bounds.m_min.x, bounds.m_max.x);
+    const uint64_t y = quantize(point.y, bounds.m_min.y, bounds.m_max.y);
+    const uint64_t z = quantize(point.z, bounds.m_min.z, bounds.m_max.z);
+
+    return (spreadMortonBits(x) << 2) | (spreadMortonBits(y) << 1) | spreadMortonBits(z);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void sortByMortonCode(const std::vector<STLBinaryTriangleData>& triangles,
+    std::vector<uint64_t>& codes, std::vector<uint32_t>& order)
+{
+    precondition_throw(triangles.size() < std::numeric_limits<uint32_t>::max(),
+        std::runtime_error("Too many triangles to sort."));
+
+    const size_t count = triangles.size();
+    std::vector<Vec3> centroids(count);
+    BoundingBox bounds;
+    std::mutex boundsMutex;
+
+    parallelFor(count, [&](size_t begin, size_t end)
+    {
+        BoundingBox chunkBounds;
+        for (size_t i = begin; i < end; ++i)
+        {
+            centroids[i] = computeCentroid(decodeFacet(triangles[i]));
+            chunkBounds.extend(centroids[i]);
+        }
+
+        std::lock_guard<std::mutex> lock(boundsMutex);
+        bounds.extend(chunkBounds);
+    });
+
+    codes.resize(count);
+    order.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            codes[i] = computeMortonCode(centroids[i], bounds);
+            order[i] = static_cast<uint32_t>(i);
+        }
+    });
+
+    radixSort(codes, order);
+}
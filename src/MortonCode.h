@@ -0,0 +1,72 @@
+#ifndef STLREPAIR_MORTONCODE__H_
+#define STLREPAIR_MORTONCODE__H_
+
+#include "STLGeometry.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Number of bits used per axis when building 64-bit Morton codes.
+ */
+constexpr const int MORTON_BITS_PER_AXIS = 21;
+
+/**
+ * Spreads the low 21 bits of the given value so that there are two zero
+ * bits between each of them.
+ */
+inline uint64_t spreadMortonBits(uint64_t value)
+{
+    value &= 0x1FFFFF;
+    value = (value | (value << 32)) & 0x001F00000000FFFFull;
+    value = (value | (value << 16)) & 0x001F0000FF0000FFull;
+    value = (value | (value << 8))  & 0x100F00F00F00F00Full;
+    value = (value | (value << 4))  & 0x10C30C30C30C30C3ull;
+    value = (value | (value << 2))  & 0x1249249249249249ull;
+    return value;
+}
+
+/**
+ * Returns the 63-bit Morton (Z-order) code of the given point, quantized
+ * relative to the given bounds. Points outside the bounds are clamped.
+ */
+uint64_t computeMortonCode(const Vec3& point, const BoundingBox& bounds);
+
+/**
+ * Sorts triangles along the Z-order curve, using the Morton code of each
+ * triangle's centroid relative to the bounds of all the centroids.
+ *
+ * @param triangles The triangles to sort.
+ * @param codes Receives the Morton codes, in sorted order.
+ * @param order Receives the triangle indices, in sorted order. Triangles
+ *  with identical codes keep their original relative order.
+ */
+void sortByMortonCode(const std::vector<STLBinaryTriangleData>& triangles,
+    std::vector<uint64_t>& codes, std::vector<uint32_t>& order);
+
+/**
+ * Returns the number of leading zero bits in the given value. Returns 64
+ * for zero.
+ */
+inline int countLeadingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (value == 0) ? 64 : __builtin_clzll(value);
+#else
+    if (value == 0)
+        return 64;
+
+    int count = 0;
+    for (int shift = 32; shift > 0; shift >>= 1)
+    {
+        if ((value >> (64 - shift)) == 0)
+        {
+            count += shift;
+            value <<= shift;
+        }
+    }
+    return count;
+#endif
+}
+
+#endif
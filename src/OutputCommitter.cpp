@@ -0,0 +1,271 @@
+#include "OutputCommitter.h"
+#include "FileUtils.h"
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::string getDirectory(const std::string& filepath)
+    {
+        const std::string directory = fs::path(filepath).parent_path().string();
+        return directory.empty() ? "." : directory;
+    }
+
+    std::string describeError(const std::string& what, const std::string& filepath)
+    {
+        return what + " " + filepath + " - " + strerror(errno);
+    }
+
+    //! Flushes the file's data, and as much metadata as it takes to read it back.
+    void syncFile(const std::string& filepath)
+    {
+#if defined(_WIN32)
+        HANDLE handle = CreateFileA(filepath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Could not open " + filepath + " to flush it.");
+
+        const bool isFlushed = (FlushFileBuffers(handle) != 0);
+        CloseHandle(handle);
+        if (!isFlushed)
+            throw std::runtime_error("Could not flush " + filepath);
+#else
+        const int fd = open(filepath.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error(describeError("Could not open", filepath));
+
+#if defined(__linux__)
+        const bool isFlushed = (fdatasync(fd) == 0);
+#else
+        const bool isFlushed = (fsync(fd) == 0);
+#endif
+        const std::string error = isFlushed ? std::string() : describeError("Could not flush", filepath);
+        close(fd);
+        if (!isFlushed)
+            throw std::runtime_error(error);
+#endif
+    }
+
+    //! Makes renames into the directory stick. Nothing to do on Windows (see renameFile()).
+    void syncDirectory(const std::string& directory)
+    {
+#if !defined(_WIN32)
+        const int fd = open(directory.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error(describeError("Could not open", directory));
+
+        const bool isFlushed = (fsync(fd) == 0);
+        const std::string error = isFlushed ? std::string() : describeError("Could not flush", directory);
+        close(fd);
+        if (!isFlushed)
+            throw std::runtime_error(error);
+#else
+        (void)directory;
+#endif
+    }
+
+    void renameFile(const std::string& tempFile, const std::string& outputFile, bool writeThrough)
+    {
+#if defined(_WIN32)
+        // rename() won't replace an existing file on Windows.
+        const DWORD flags = MOVEFILE_REPLACE_EXISTING | (writeThrough ? MOVEFILE_WRITE_THROUGH : 0);
+        if (!MoveFileExA(tempFile.c_str(), outputFile.c_str(), flags))
+            throw std::runtime_error("Could not rename " + tempFile + " to " + outputFile);
+#else
+        (void)writeThrough;
+        if (rename(tempFile.c_str(), outputFile.c_str()) != 0)
+            throw std::runtime_error("Could not rename " + tempFile + " to " + outputFile + " - " + strerror(errno));
+#endif
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string makeTempOutputPath(const std::string& outputFile)
+{
+    const fs::path path(outputFile);
+    return (path.parent_path() /
+        ("." + path.filename().string() + "." + FileUtils::generateRandomSuffix() + ".partial")).string();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+OutputCommitter::OutputCommitter(DurabilityPolicy policy) :
+    m_policy(policy),
+    m_syncCount(0),
+    m_isCommitting(false)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void OutputCommitter::commit(const std::string& tempFile, const std::string& outputFile)
+{
+    if (m_policy == DurabilityPolicy::NONE)
+    {
+        renameFile(tempFile, outputFile, false);
+        return;
+    }
+
+    if (m_policy == DurabilityPolicy::FDATASYNC)
+    {
+        syncFile(tempFile);
+        renameFile(tempFile, outputFile, true);
+        syncDirectory(getDirectory(outputFile));
+        m_syncCount += 2;
+        return;
+    }
+
+    PendingCommit pending = { &tempFile, &outputFile, std::string(), false };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_pendingCommits.push_back(&pending);
+    while (!pending.m_isDone)
+    {
+        // Someone else is flushing. Whatever's waiting when they're done
+        // goes in the next group, which may well be ours.
+        if (m_isCommitting)
+        {
+            m_groupCommitted.wait(lock);
+            continue;
+        }
+
+        m_isCommitting = true;
+        std::vector<PendingCommit*> group;
+        group.swap(m_pendingCommits);
+        lock.unlock();
+
+        commitGroup(group);
+
+        lock.lock();
+        for (PendingCommit* pCommit : group)
+            pCommit->m_isDone = true;
+        m_isCommitting = false;
+        m_groupCommitted.notify_all();
+    }
+
+    if (!pending.m_error.empty())
+        throw std::runtime_error(pending.m_error);
+}
+
+/**
+ * Flushes, renames and flushes the directories of every commit in the
+ * group, noting any failure against the commit it belongs to. Never throws.
+ *
+ * @since 2026 Oct 19
+ */
+void OutputCommitter::commitGroup(const std::vector<PendingCommit*>& group)
+{
+    auto tryTo = [](PendingCommit* pCommit, auto&& action)
+    {
+        if (!pCommit->m_error.empty())
+            return;
+
+        try
+        {
+            action();
+        }
+        catch (const std::exception& e)
+        {
+            pCommit->m_error = e.what();
+        }
+    };
+
+#if defined(__linux__)
+    if (group.size() > 1)
+    {
+        // One syncfs() per file system, however many files are on it.
+        std::map<dev_t, std::string> syncErrors;
+        for (PendingCommit* pCommit : group)
+        {
+            tryTo(pCommit, [&]()
+            {
+                const std::string& tempFile = *pCommit->m_pTempFile;
+                struct stat status;
+                if (stat(tempFile.c_str(), &status) != 0)
+                    throw std::runtime_error(describeError("Could not stat", tempFile));
+
+                auto found = syncErrors.find(status.st_dev);
+                if (found == syncErrors.end())
+                {
+                    std::string error;
+                    const int fd = open(tempFile.c_str(), O_RDONLY);
+                    if ((fd == -1) || (syncfs(fd) != 0))
+                        error = describeError("Could not flush the file system holding", tempFile);
+                    if (fd != -1)
+                        close(fd);
+
+                    ++m_syncCount;
+                    found = syncErrors.emplace(status.st_dev, error).first;
+                }
+
+                if (!found->second.empty())
+                    throw std::runtime_error(found->second);
+            });
+        }
+    }
+    else
+#endif
+    {
+        for (PendingCommit* pCommit : group)
+        {
+            tryTo(pCommit, [&]()
+            {
+                syncFile(*pCommit->m_pTempFile);
+                ++m_syncCount;
+            });
+        }
+    }
+
+    std::set<std::string> directories;
+    for (PendingCommit* pCommit : group)
+    {
+        tryTo(pCommit, [&]()
+        {
+            renameFile(*pCommit->m_pTempFile, *pCommit->m_pOutputFile, true);
+            directories.insert(getDirectory(*pCommit->m_pOutputFile));
+        });
+    }
+
+    std::map<std::string, std::string> directoryErrors;
+    for (const std::string& directory : directories)
+    {
+        try
+        {
+            syncDirectory(directory);
+            ++m_syncCount;
+        }
+        catch (const std::exception& e)
+        {
+            directoryErrors[directory] = e.what();
+        }
+    }
+
+    // The file's in place by now, but it mightn't stay there.
+    for (PendingCommit* pCommit : group)
+    {
+        auto found = directoryErrors.find(getDirectory(*pCommit->m_pOutputFile));
+        if (pCommit->m_error.empty() && (found != directoryErrors.end()))
+            pCommit->m_error = found->second;
+    }
+}
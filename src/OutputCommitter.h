@@ -0,0 +1,92 @@
+#ifndef STLREPAIR_OUTPUTCOMMITTER__H_
+#define STLREPAIR_OUTPUTCOMMITTER__H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * How hard an OutputCommitter works to make sure a committed file survives
+ * a crash or power cut. Whichever is chosen, a file only ever appears under
+ * its final name complete.
+ */
+enum class DurabilityPolicy
+{
+    NONE,           //!< Rename into place and leave flushing to the OS.
+    FDATASYNC,      //!< Flush each file (and its directory entry) before it's done.
+    GROUP_COMMIT    //!< Like FDATASYNC, but files committed together share the flushes.
+};
+
+/**
+ * Returns a path for a hidden temp file next to outputFile, to write the
+ * output to before it's committed. It's on the same file system, so it can
+ * be renamed into place. Unique across threads and processes.
+ */
+std::string makeTempOutputPath(const std::string& outputFile);
+
+/**
+ * Moves finished output from a temp file (see makeTempOutputPath()) to its
+ * final name in one atomic rename, so a crash part way through a repair
+ * never leaves a truncated file that looks like a good one.
+ *
+ * With GROUP_COMMIT, whichever commit comes along while nobody else is
+ * flushing does the flushing for every commit waiting at that point, with
+ * one syncfs() per file system on Linux instead of an fdatasync() per file.
+ * There's no timer. Batches grow with however many threads are committing
+ * at once, and a lone commit costs the same as FDATASYNC.
+ *
+ * Safe to use from any number of threads.
+ */
+class OutputCommitter
+{
+public:
+
+    //! Constructor.
+    explicit OutputCommitter(DurabilityPolicy policy = DurabilityPolicy::NONE);
+
+    OutputCommitter(const OutputCommitter&) = delete;
+    OutputCommitter& operator=(const OutputCommitter&) = delete;
+
+    /**
+     * Renames the temp file to outputFile, replacing anything already
+     * there, once the policy has been satisfied. Returns once the file is
+     * in place. The temp file must be closed.
+     *
+     * @throws std::runtime_error if the file couldn't be flushed or renamed,
+     *         in which case the temp file is left where it is, or if the
+     *         rename couldn't be flushed.
+     */
+    void commit(const std::string& tempFile, const std::string& outputFile);
+
+    //! Returns the policy given to the constructor.
+    DurabilityPolicy getPolicy() const { return m_policy; }
+
+    //! Returns the number of flushes made so far, of files, file systems or directories.
+    uint64_t getSyncCount() const { return m_syncCount; }
+
+private:
+
+    struct PendingCommit
+    {
+        const std::string* m_pTempFile;
+        const std::string* m_pOutputFile;
+        std::string m_error;
+        bool m_isDone;
+    };
+
+    void commitGroup(const std::vector<PendingCommit*>& group);
+
+    const DurabilityPolicy m_policy;
+    std::atomic<uint64_t> m_syncCount;
+
+    // Group commit.
+    std::mutex m_mutex;
+    std::condition_variable m_groupCommitted;
+    std::vector<PendingCommit*> m_pendingCommits;
+    bool m_isCommitting;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef STLREPAIR_PARALLEL__H_
+#define STLREPAIR_PARALLEL__H_
+
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Returns the number of worker threads parallel algorithms should use.
+ * Always at least 1.
+ */
+inline unsigned getWorkerThreadCount()
+{
+    unsigned count = std::thread::hardware_concurrency();
+    return (count == 0) ? 1 : count;
+}
+
+/**
+ * Splits the range [0, count) into contiguous chunks and invokes
+ * fn(begin, end) for each chunk on its own thread. The calling thread
+ * takes the first chunk. Blocks until all chunks are done.
+ *
+ * If any invocation throws, the first exception is rethrown on the
+ * calling thread once all workers have finished.
+ *
+ * Each chunk shows up in the trace, if one is being recorded, so it's
+ * easy to see how evenly the work was spread. That includes the single
+ * chunk of a range too small (or a machine too narrow) to split.
+ */
+template<typename Fn>
+void parallelFor(size_t count, Fn fn, size_t minChunkSize = 1024)
+{
+    if (count == 0)
+        return;
+
+    minChunkSize = std::max<size_t>(minChunkSize, 1);
+    size_t chunkCount = std::min<size_t>(getWorkerThreadCount(),
+        (count + minChunkSize - 1) / minChunkSize);
+
+    if (chunkCount <= 1)
+    {
+        STLREPAIR_TRACE_SCOPE("parallel chunk", "scheduling");
+        fn(size_t(0), count);
+        return;
+    }
+
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    std::vector<std::exception_ptr> errors(chunkCount);
+    std::vector<std::thread> threads;
+    threads.reserve(chunkCount - 1);
+
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        const size_t begin = chunk * chunkSize;
+        const size_t end = std::min(count, begin + chunkSize);
+        threads.emplace_back([&fn, &errors, chunk, begin, end]()
+        {
+            STLREPAIR_TRACE_THREAD_NAME("worker");
+            try
+            {
+                STLREPAIR_TRACE_SCOPE("parallel chunk", "scheduling");
+                if (begin < end)
+                    fn(begin, end);
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+            }
+        });
+    }
+
+    try
+    {
+        STLREPAIR_TRACE_SCOPE("parallel chunk", "scheduling");
+        fn(size_t(0), std::min(count, chunkSize));
+    }
+    catch (...)
+    {
+        errors[0] = std::current_exception();
+    }
+
+    {
+        STLREPAIR_TRACE_SCOPE("join workers", "scheduling");
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    for (auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Sorts the given vector using all available cores. Chunks are sorted
+ * independently and then merged pairwise.
+ */
+template<typename T, typename Compare>
+void parallelSort(std::vector<T>& values, Compare compare)
+{
+    const size_t count = values.size();
+    const size_t chunkCount = std::min<size_t>(getWorkerThreadCount(),
+        std::max<size_t>(count / 65536, 1));
+
+    if (chunkCount <= 1)
+    {
+        std::sort(values.begin(), values.end(), compare);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunkCount + 1);
+    for (size_t i = 0; i <= chunkCount; ++i)
+        bounds[i] = (count * i) / chunkCount;
+
+    parallelFor(chunkCount, [&](size_t begin, size_t end)
+    {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+            std::sort(values.begin() + bounds[chunk], values.begin() + bounds[chunk + 1], compare);
+    }, 1);
+
+    // Merge neighbouring runs until only one is left.
+    while (bounds.size() > 2)
+    {
+        const size_t pairCount = (bounds.size() - 1) / 2;
+        parallelFor(pairCount, [&](size_t begin, size_t end)
+        {
+            for (size_t pair = begin; pair < end; ++pair)
+            {
+                auto first = values.begin() + bounds[pair * 2];
+                auto middle = values.begin() + bounds[pair * 2 + 1];
+                auto last = values.begin() + bounds[pair * 2 + 2];
+                std::inplace_merge(first, middle, last, compare);
+            }
+        }, 1);
+
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2)
+            merged.push_back(bounds[i]);
+        if (merged.back() != count)
+            merged.push_back(count);
+        bounds.swap(merged);
+    }
+}
+
+#endif
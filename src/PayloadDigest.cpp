@@ -0,0 +1,155 @@
+#include "PayloadDigest.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const size_t FACET_RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    const size_t DIGEST_HEX_DIGITS = 16;
+    const size_t TAG_LENGTH = sizeof(PAYLOAD_DIGEST_TAG) - 1;
+
+    static_assert(TAG_LENGTH + DIGEST_HEX_DIGITS <= BINARY_STL_HEADER_SIZE_IN_BYTES,
+        "Payload digest doesn't fit in the header.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+PayloadDigest::PayloadDigest() :
+    m_chunkFacetCount(0),
+    m_facetCount(0)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PayloadDigest::update(const STLBinaryTriangleData& triangle, uint16_t attributeByteCount)
+{
+    m_chunkHash.update(triangle.data(), triangle.size());
+    m_chunkHash.update(&attributeByteCount, sizeof(attributeByteCount));
+    ++m_facetCount;
+
+    if (++m_chunkFacetCount == PAYLOAD_DIGEST_CHUNK_FACET_COUNT)
+    {
+        const uint64_t chunkDigest = m_chunkHash.digest();
+        m_combinedHash.update(&chunkDigest, sizeof(chunkDigest));
+        m_chunkHash = XXHash64();
+        m_chunkFacetCount = 0;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t PayloadDigest::digest() const
+{
+    XXHash64 combinedHash = m_combinedHash;
+    if (m_chunkFacetCount > 0)
+    {
+        const uint64_t chunkDigest = m_chunkHash.digest();
+        combinedHash.update(&chunkDigest, sizeof(chunkDigest));
+    }
+
+    combinedHash.update(&m_facetCount, sizeof(m_facetCount));
+    return combinedHash.digest();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t computePayloadDigest(const uint8_t* pRecords, uint64_t facetCount)
+{
+    const size_t chunkCount = static_cast<size_t>(
+        (facetCount + PAYLOAD_DIGEST_CHUNK_FACET_COUNT - 1) / PAYLOAD_DIGEST_CHUNK_FACET_COUNT);
+    std::vector<uint64_t> chunkDigests(chunkCount);
+
+    parallelFor(chunkCount, [&](size_t begin, size_t end)
+    {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            const uint64_t firstFacet = static_cast<uint64_t>(chunk) * PAYLOAD_DIGEST_CHUNK_FACET_COUNT;
+            const uint64_t chunkFacetCount = std::min<uint64_t>(PAYLOAD_DIGEST_CHUNK_FACET_COUNT, facetCount - firstFacet);
+
+            XXHash64 chunkHash;
+            chunkHash.update(pRecords + firstFacet * FACET_RECORD_SIZE,
+                static_cast<size_t>(chunkFacetCount * FACET_RECORD_SIZE));
+            chunkDigests[chunk] = chunkHash.digest();
+        }
+    }, 1);
+
+    XXHash64 combinedHash;
+    combinedHash.update(chunkDigests.data(), chunkDigests.size() * sizeof(uint64_t));
+    combinedHash.update(&facetCount, sizeof(facetCount));
+    return combinedHash.digest();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void stampPayloadDigest(STLBinaryHeader& header, uint64_t digest)
+{
+    char hexDigits[DIGEST_HEX_DIGITS + 1];
+    snprintf(hexDigits, sizeof(hexDigits), "%016llx", static_cast<unsigned long long>(digest));
+
+    memset(header.data(), 0, header.size());
+    memcpy(header.data(), PAYLOAD_DIGEST_TAG, TAG_LENGTH);
+    memcpy(header.data() + TAG_LENGTH, hexDigits, DIGEST_HEX_DIGITS);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool readPayloadDigest(const STLBinaryHeader& header, uint64_t& digest)
+{
+    if (memcmp(header.data(), PAYLOAD_DIGEST_TAG, TAG_LENGTH) != 0)
+        return false;
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < DIGEST_HEX_DIGITS; ++i)
+    {
+        const char digit = static_cast<char>(header[TAG_LENGTH + i]);
+        if ((digit >= '0') && (digit <= '9'))
+            value = (value << 4) | static_cast<uint64_t>(digit - '0');
+        else if ((digit >= 'a') && (digit <= 'f'))
+            value = (value << 4) | static_cast<uint64_t>(digit - 'a' + 10);
+        else
+            return false;
+    }
+
+    digest = value;
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+PayloadDigestCheck verifyPayloadDigest(const std::string& filepath)
+{
+    const size_t payloadOffset = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    MappedFile file(filepath);
+    if (file.size() < payloadOffset)
+        return PayloadDigestCheck::NOT_STAMPED;
+
+    STLBinaryHeader header;
+    memcpy(header.data(), file.data(), header.size());
+
+    uint64_t stampedDigest = 0;
+    if (!readPayloadDigest(header, stampedDigest))
+        return PayloadDigestCheck::NOT_STAMPED;
+
+    uint32_t facetCount = 0;
+    memcpy(&facetCount, file.data() + BINARY_STL_HEADER_SIZE_IN_BYTES, sizeof(facetCount));
+
+    if ((file.size() - payloadOffset) / FACET_RECORD_SIZE < facetCount)
+        return PayloadDigestCheck::MISMATCH;
+
+    return (computePayloadDigest(file.data() + payloadOffset, facetCount) == stampedDigest) ?
+        PayloadDigestCheck::MATCH : PayloadDigestCheck::MISMATCH;
+}
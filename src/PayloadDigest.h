@@ -0,0 +1,83 @@
+#ifndef STLREPAIR_PAYLOADDIGEST__H_
+#define STLREPAIR_PAYLOADDIGEST__H_
+
+#include "STLFileTypes.h"
+#include "XXHash64.h"
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Number of facet records hashed together as one chunk of the payload
+ * digest. Chunks are hashed independently, which is what lets verification
+ * spread across every core.
+ */
+constexpr const size_t PAYLOAD_DIGEST_CHUNK_FACET_COUNT = 16384;
+
+/**
+ * Marks a header that carries a payload digest. The digest follows as 16
+ * hex digits, and the rest of the header is zeros.
+ */
+constexpr const char PAYLOAD_DIGEST_TAG[] = "STLREPAIR-DIGEST:XXH64T:";
+
+/**
+ * Digest of the facet records of a binary STL (everything from the end of
+ * the triangle count, for as many records as the count says). Each chunk of
+ * PAYLOAD_DIGEST_CHUNK_FACET_COUNT records is hashed with XXH64, and the
+ * digest is the XXH64 of those chunk hashes followed by the facet count.
+ *
+ * This class builds the digest a facet at a time, as the file is written.
+ */
+class PayloadDigest
+{
+public:
+
+    //! Constructor.
+    PayloadDigest();
+
+    //! Adds the next facet record.
+    void update(const STLBinaryTriangleData& triangle, uint16_t attributeByteCount);
+
+    //! Returns the digest of every facet added so far.
+    uint64_t digest() const;
+
+private:
+
+    XXHash64 m_chunkHash;
+    size_t m_chunkFacetCount;
+    XXHash64 m_combinedHash;
+    uint64_t m_facetCount;
+};
+
+/**
+ * Returns the digest of the given facet records, hashing chunks on all
+ * cores.
+ */
+uint64_t computePayloadDigest(const uint8_t* pRecords, uint64_t facetCount);
+
+//! Writes the digest into the header, replacing whatever was there.
+void stampPayloadDigest(STLBinaryHeader& header, uint64_t digest);
+
+//! Reads the digest back out of the header. Returns false if there isn't one.
+bool readPayloadDigest(const STLBinaryHeader& header, uint64_t& digest);
+
+/**
+ * Outcome of checking a file against the digest in its header.
+ */
+enum class PayloadDigestCheck
+{
+    MATCH,
+    MISMATCH,       //!< Includes files too short to hold every facet.
+    NOT_STAMPED
+};
+
+/**
+ * Checks the facet records of the given file against the digest stamped
+ * in its header.
+ *
+ * @throws std::runtime_error if the file can't be read.
+ */
+PayloadDigestCheck verifyPayloadDigest(const std::string& filepath);
+
+#endif
@@ -0,0 +1,326 @@
+#include "PipelinedByteStream.h"
+#include "Contracts.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+/**
+ * @since 2026 Oct 19
+ */
+PrefetchingByteSource::PrefetchingByteSource(std::unique_ptr<ByteSource> spSource,
+    size_t blockSize, size_t blockCount) :
+    m_spSource(std::move(spSource)),
+    m_blockSize(std::max<size_t>(blockSize, 1)),
+    m_blockCount(std::max<size_t>(blockCount, 2)),
+    m_filledBlocks(m_blockCount),
+    m_emptyBlocks(m_blockCount),
+    m_stopRequested(false),
+    m_currentBlockOffset(0),
+    m_position(0),
+    m_isEndOfData(false)
+{
+    precondition_throw(m_spSource != nullptr, std::runtime_error("Prefetching requires a source."));
+
+    startReading();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+PrefetchingByteSource::~PrefetchingByteSource()
+{
+    stopReading();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+size_t PrefetchingByteSource::read(uint8_t* pBuffer, size_t size)
+{
+    size_t bytesRead = 0;
+
+    while (bytesRead < size)
+    {
+        if (m_currentBlockOffset == m_currentBlock.m_size)
+        {
+            if (m_isEndOfData)
+                break;
+
+            // Hand the block we're done with back for refilling. There are
+            // never more blocks than slots, so there's always room.
+            if (!m_currentBlock.m_data.empty())
+            {
+                bool wasReturned = m_emptyBlocks.tryPush(m_currentBlock);
+                invariant_throw(wasReturned, std::runtime_error("Prefetch block pool overflowed."));
+            }
+
+            waitUntil([&]() { return m_filledBlocks.tryPop(m_currentBlock); });
+            m_currentBlockOffset = 0;
+
+            if (m_currentBlock.m_error)
+            {
+                m_isEndOfData = true;
+                std::rethrow_exception(m_currentBlock.m_error);
+            }
+
+            if (m_currentBlock.m_size == 0)
+            {
+                m_isEndOfData = true;
+                break;
+            }
+        }
+
+        const size_t bytesToCopy = std::min(size - bytesRead, m_currentBlock.m_size - m_currentBlockOffset);
+        memcpy(pBuffer + bytesRead, m_currentBlock.m_data.data() + m_currentBlockOffset, bytesToCopy);
+        m_currentBlockOffset += bytesToCopy;
+        bytesRead += bytesToCopy;
+    }
+
+    m_position += bytesRead;
+    return bytesRead;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool PrefetchingByteSource::seek(uint64_t offset)
+{
+    if (offset == m_position)
+        return true;
+
+    stopReading();
+    bool isSeekOk = m_spSource->seek(offset);
+    if (isSeekOk)
+        m_position = offset;
+    startReading();
+
+    return isSeekOk;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PrefetchingByteSource::startReading()
+{
+    m_currentBlock = Block();
+    m_currentBlockOffset = 0;
+    m_isEndOfData = false;
+
+    for (size_t i = 0; i < m_blockCount; ++i)
+    {
+        Block block;
+        block.m_data.resize(m_blockSize);
+        m_emptyBlocks.tryPush(block);
+    }
+
+    m_stopRequested = false;
+    m_thread = std::thread([this]() { readBlocks(); });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PrefetchingByteSource::stopReading()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_stopRequested = true;
+    m_thread.join();
+
+    Block block;
+    while (m_filledBlocks.tryPop(block));
+    while (m_emptyBlocks.tryPop(block));
+}
+
+/**
+ * Runs on the background thread.
+ *
+ * @since 2026 Oct 19
+ */
+void PrefetchingByteSource::readBlocks()
+{
+    STLREPAIR_TRACE_THREAD_NAME("prefetch");
+
+    for (;;)
+    {
+        Block block;
+        waitUntil([&]() { return m_stopRequested || m_emptyBlocks.tryPop(block); });
+        if (m_stopRequested)
+            return;
+
+        block.m_size = 0;
+        try
+        {
+            STLREPAIR_TRACE_SCOPE("read block", "prefetch");
+            while (block.m_size < block.m_data.size())
+            {
+                size_t bytesRead = m_spSource->read(block.m_data.data() + block.m_size,
+                    block.m_data.size() - block.m_size);
+                if (bytesRead == 0)
+                    break;
+                block.m_size += bytesRead;
+            }
+        }
+        catch (...)
+        {
+            block.m_error = std::current_exception();
+        }
+
+        const bool isLastBlock = (block.m_size == 0) || block.m_error;
+        waitUntil([&]() { return m_stopRequested || m_filledBlocks.tryPush(block); });
+        if (isLastBlock || m_stopRequested)
+            return;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AsyncByteSink::AsyncByteSink(std::unique_ptr<ByteSink> spSink,
+    size_t blockSize, size_t blockCount) :
+    m_spSink(std::move(spSink)),
+    m_blockSize(std::max<size_t>(blockSize, 1)),
+    m_filledBlocks(std::max<size_t>(blockCount, 2)),
+    m_emptyBlocks(std::max<size_t>(blockCount, 2)),
+    m_hasFailed(false),
+    m_isClosed(false)
+{
+    precondition_throw(m_spSink != nullptr, std::runtime_error("Asynchronous writing requires a sink."));
+
+    // We always hold on to one block for filling, so the pool starts one short.
+    m_currentBlock.m_data.resize(m_blockSize);
+    for (size_t i = 0; i + 1 < std::max<size_t>(blockCount, 2); ++i)
+    {
+        Block block;
+        block.m_data.resize(m_blockSize);
+        m_emptyBlocks.tryPush(block);
+    }
+
+    m_thread = std::thread([this]() { writeBlocks(); });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+AsyncByteSink::~AsyncByteSink()
+{
+    // Anything worth reporting would have been reported by an explicit
+    // close(). Destructors don't get to throw.
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void AsyncByteSink::write(const uint8_t* pData, size_t size)
+{
+    invariant_throw(!m_isClosed, std::runtime_error("Sink already closed!"));
+    throwIfFailed();
+
+    while (size > 0)
+    {
+        if (m_currentBlock.m_size == m_currentBlock.m_data.size())
+            submitCurrentBlock();
+
+        const size_t bytesToCopy = std::min(size, m_currentBlock.m_data.size() - m_currentBlock.m_size);
+        memcpy(m_currentBlock.m_data.data() + m_currentBlock.m_size, pData, bytesToCopy);
+        m_currentBlock.m_size += bytesToCopy;
+        pData += bytesToCopy;
+        size -= bytesToCopy;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void AsyncByteSink::close()
+{
+    if (m_isClosed)
+        return;
+    m_isClosed = true;
+
+    if ((m_currentBlock.m_size > 0) && !m_hasFailed)
+    {
+        waitUntil([&]() { return m_filledBlocks.tryPush(m_currentBlock); });
+        m_currentBlock = Block();
+    }
+
+    // The background thread keeps draining even after a failure, so this
+    // always gets through.
+    Block endOfStream;
+    waitUntil([&]() { return m_filledBlocks.tryPush(endOfStream); });
+    m_thread.join();
+
+    throwIfFailed();
+    m_spSink->close();
+}
+
+/**
+ * Hands the current block to the background thread and picks up an empty
+ * one, waiting for it if need be.
+ *
+ * @since 2026 Oct 19
+ */
+void AsyncByteSink::submitCurrentBlock()
+{
+    waitUntil([&]() { return m_hasFailed || m_filledBlocks.tryPush(m_currentBlock); });
+    throwIfFailed();
+
+    waitUntil([&]() { return m_hasFailed || m_emptyBlocks.tryPop(m_currentBlock); });
+    throwIfFailed();
+
+    m_currentBlock.m_size = 0;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void AsyncByteSink::throwIfFailed()
+{
+    if (m_hasFailed)
+        std::rethrow_exception(m_error);
+}
+
+/**
+ * Runs on the background thread.
+ *
+ * @since 2026 Oct 19
+ */
+void AsyncByteSink::writeBlocks()
+{
+    STLREPAIR_TRACE_THREAD_NAME("async writer");
+
+    for (;;)
+    {
+        Block block;
+        waitUntil([&]() { return m_filledBlocks.tryPop(block); });
+        if (block.m_data.empty())
+            return; // End of stream.
+
+        if (!m_hasFailed)
+        {
+            try
+            {
+                STLREPAIR_TRACE_SCOPE("write block", "async writer");
+                m_spSink->write(block.m_data.data(), block.m_size);
+            }
+            catch (...)
+            {
+                m_error = std::current_exception();
+                m_hasFailed = true;
+            }
+        }
+
+        block.m_size = 0;
+        m_emptyBlocks.tryPush(block);
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef STLREPAIR_PIPELINEDBYTESTREAM__H_
+#define STLREPAIR_PIPELINEDBYTESTREAM__H_
+
+#include "ByteStream.h"
+#include "SPSCRingBuffer.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Default size of the blocks handed between pipeline threads.
+ */
+constexpr const size_t DEFAULT_PIPELINE_BLOCK_SIZE = 1024 * 1024;
+
+/**
+ * Default number of blocks in flight per pipeline stage. This, times the
+ * block size, is the most memory a stage will ever hold on to.
+ */
+constexpr const size_t DEFAULT_PIPELINE_BLOCK_COUNT = 8;
+
+/**
+ * ByteSource that reads ahead from another source on a background thread.
+ *
+ * Filled blocks are handed to the consuming thread through a lock-free
+ * single-producer/single-consumer ring, and the empty ones come back through
+ * another. There are only ever blockCount blocks, so when the consumer falls
+ * behind, the background thread simply waits for one to come back.
+ *
+ * Errors on the background thread are rethrown from read().
+ */
+class PrefetchingByteSource : public ByteSource
+{
+public:
+
+    /**
+     * Constructor. Reading ahead starts immediately.
+     */
+    explicit PrefetchingByteSource(std::unique_ptr<ByteSource> spSource,
+        size_t blockSize = DEFAULT_PIPELINE_BLOCK_SIZE,
+        size_t blockCount = DEFAULT_PIPELINE_BLOCK_COUNT);
+
+    //! Destructor. Stops the background thread.
+    ~PrefetchingByteSource();
+
+    size_t read(uint8_t* pBuffer, size_t size) override;
+
+    /**
+     * Seeking anywhere other than the current position throws away whatever
+     * has been read ahead and starts over from the new position.
+     */
+    bool seek(uint64_t offset) override;
+
+private:
+
+    // A block with no data and no error marks the end of the source.
+    struct Block
+    {
+        std::vector<uint8_t> m_data;
+        size_t m_size = 0;
+        std::exception_ptr m_error;
+    };
+
+    void startReading();
+    void stopReading();
+    void readBlocks();
+
+    std::unique_ptr<ByteSource> m_spSource;
+    const size_t m_blockSize;
+    const size_t m_blockCount;
+
+    SPSCRingBuffer<Block> m_filledBlocks;
+    SPSCRingBuffer<Block> m_emptyBlocks;
+    std::atomic<bool> m_stopRequested;
+    std::thread m_thread;
+
+    // Consumer side.
+    Block m_currentBlock;
+    size_t m_currentBlockOffset;
+    uint64_t m_position;
+    bool m_isEndOfData;
+};
+
+/**
+ * ByteSink that does its writing to another sink on a background thread.
+ *
+ * Writes are gathered into blocks, which are handed to the background thread
+ * through a lock-free single-producer/single-consumer ring and come back
+ * empty through another. There are only ever blockCount blocks, so when the
+ * background thread falls behind, write() waits for one to come back.
+ *
+ * Errors on the background thread are rethrown from write() or close().
+ */
+class AsyncByteSink : public ByteSink
+{
+public:
+
+    /**
+     * Constructor. The background thread starts immediately.
+     */
+    explicit AsyncByteSink(std::unique_ptr<ByteSink> spSink,
+        size_t blockSize = DEFAULT_PIPELINE_BLOCK_SIZE,
+        size_t blockCount = DEFAULT_PIPELINE_BLOCK_COUNT);
+
+    //! Destructor. Closes the sink if that hasn't happened already.
+    ~AsyncByteSink();
+
+    void write(const uint8_t* pData, size_t size) override;
+
+    /**
+     * Waits for everything written so far to reach the underlying sink, then
+     * closes it.
+     */
+    void close() override;
+
+private:
+
+    // A block with no data marks the end of the stream.
+    struct Block
+    {
+        std::vector<uint8_t> m_data;
+        size_t m_size = 0;
+    };
+
+    void submitCurrentBlock();
+    void throwIfFailed();
+    void writeBlocks();
+
+    std::unique_ptr<ByteSink> m_spSink;
+    const size_t m_blockSize;
+
+    SPSCRingBuffer<Block> m_filledBlocks;
+    SPSCRingBuffer<Block> m_emptyBlocks;
+    std::atomic<bool> m_hasFailed;
+    std::exception_ptr m_error;
+    std::thread m_thread;
+
+    // Producer side.
+    Block m_currentBlock;
+    bool m_isClosed;
+};
+
+#endif
@@ -0,0 +1,289 @@
+#include "PositionalFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    //! Largest single read or write, so sizes always fit a DWORD or ssize_t.
+    const uint64_t MAX_TRANSFER_SIZE = 1u << 30;
+
+#if defined(_WIN32)
+    const NativeFileHandle CLOSED_HANDLE = INVALID_HANDLE_VALUE;
+#else
+    const NativeFileHandle CLOSED_HANDLE = -1;
+#endif
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+PositionalFile::PositionalFile(const std::string& filepath, PositionalFileMode mode, uint64_t size) :
+    m_filepath(filepath),
+    m_isOwned(true)
+{
+    const bool isForWriting = (mode == PositionalFileMode::WRITE);
+#if defined(_WIN32)
+    m_handle = isForWriting ?
+        CreateFileA(filepath.c_str(), GENERIC_WRITE, 0, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) :
+        CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_handle == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+#else
+    m_handle = isForWriting ?
+        open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) :
+        open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_handle < 0)
+        throw std::runtime_error("Unknown error when opening " + filepath);
+#endif
+
+    if (isForWriting && (size > 0))
+    {
+        try
+        {
+            setSize(size);
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+PositionalFile::PositionalFile(NativeFileHandle handle, const std::string& filepath, bool isOwned) :
+    m_filepath(filepath),
+    m_handle(handle),
+    m_isOwned(isOwned)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+PositionalFile::~PositionalFile()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+int64_t PositionalFile::tryReadAt(uint8_t* pBuffer, size_t size, uint64_t offset)
+{
+    size = static_cast<size_t>(std::min<uint64_t>(size, MAX_TRANSFER_SIZE));
+#if defined(_WIN32)
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD bytesRead = 0;
+    if (!ReadFile(m_handle, pBuffer, static_cast<DWORD>(size), &bytesRead, &overlapped))
+        return (GetLastError() == ERROR_HANDLE_EOF) ? 0 : -EIO;
+    return bytesRead;
+#else
+    for (;;)
+    {
+        const ssize_t bytesRead = pread(m_handle, pBuffer, size, static_cast<off_t>(offset));
+        if ((bytesRead >= 0) || (errno != EINTR))
+            return (bytesRead >= 0) ? bytesRead : -errno;
+    }
+#endif
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+int64_t PositionalFile::tryWriteAt(const uint8_t* pData, size_t size, uint64_t offset)
+{
+    size = static_cast<size_t>(std::min<uint64_t>(size, MAX_TRANSFER_SIZE));
+#if defined(_WIN32)
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD bytesWritten = 0;
+    if (!WriteFile(m_handle, pData, static_cast<DWORD>(size), &bytesWritten, &overlapped))
+        return -EIO;
+    return bytesWritten;
+#else
+    for (;;)
+    {
+        const ssize_t bytesWritten = pwrite(m_handle, pData, size, static_cast<off_t>(offset));
+        if ((bytesWritten >= 0) || (errno != EINTR))
+            return (bytesWritten >= 0) ? bytesWritten : -errno;
+    }
+#endif
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t PositionalFile::readAt(uint8_t* pBuffer, uint64_t size, uint64_t offset)
+{
+    uint64_t totalRead = 0;
+    while (totalRead < size)
+    {
+        const int64_t bytesRead = tryReadAt(pBuffer + totalRead,
+            static_cast<size_t>(std::min(size - totalRead, MAX_TRANSFER_SIZE)), offset + totalRead);
+        if (bytesRead < 0)
+            throw std::runtime_error("Error reading from " + m_filepath + " - " + strerror(static_cast<int>(-bytesRead)));
+        if (bytesRead == 0)
+            break;
+        totalRead += static_cast<uint64_t>(bytesRead);
+    }
+    return totalRead;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PositionalFile::writeAt(const uint8_t* pData, uint64_t size, uint64_t offset)
+{
+    while (size > 0)
+    {
+        const int64_t bytesWritten = tryWriteAt(pData,
+            static_cast<size_t>(std::min(size, MAX_TRANSFER_SIZE)), offset);
+        if (bytesWritten < 0)
+            throw std::runtime_error("Error writing to " + m_filepath + " - " + strerror(static_cast<int>(-bytesWritten)));
+        if (bytesWritten == 0)
+            throw std::runtime_error("Error writing to " + m_filepath + " - no progress");
+        pData += bytesWritten;
+        size -= static_cast<uint64_t>(bytesWritten);
+        offset += static_cast<uint64_t>(bytesWritten);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t PositionalFile::getSize() const
+{
+#if defined(_WIN32)
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_handle, &size))
+        throw std::runtime_error("Could not get the size of " + m_filepath);
+    return static_cast<uint64_t>(size.QuadPart);
+#else
+    struct stat status;
+    if (fstat(m_handle, &status) != 0)
+        throw std::runtime_error("Could not get the size of " + m_filepath + " - " + strerror(errno));
+    return static_cast<uint64_t>(status.st_size);
+#endif
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void PositionalFile::setSize(uint64_t size)
+{
+#if defined(_WIN32)
+    FILE_END_OF_FILE_INFO endOfFile;
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFileInformationByHandle(m_handle, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile)))
+        throw std::runtime_error("Could not size " + m_filepath);
+#else
+    if (ftruncate(m_handle, static_cast<off_t>(size)) != 0)
+        throw std::runtime_error("Could not size " + m_filepath + " - " + strerror(errno));
+#endif
+}
+
+#if defined(__linux__)
+
+/**
+ * @since 2026 Oct 19
+ */
+bool PositionalFile::copyFrom(const std::string& inputFile, uint64_t& inputOffset, uint64_t& outputOffset, uint64_t& size)
+{
+    const int inputDescriptor = open(inputFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inputDescriptor < 0)
+        throw std::runtime_error("Unknown error when opening " + inputFile);
+
+    bool isCopied = true;
+    std::string error;
+    while ((size > 0) && isCopied && error.empty())
+    {
+        loff_t inputPosition = static_cast<loff_t>(inputOffset);
+        loff_t outputPosition = static_cast<loff_t>(outputOffset);
+        const ssize_t bytesCopied = copy_file_range(inputDescriptor, &inputPosition,
+            m_handle, &outputPosition, static_cast<size_t>(size), 0);
+        if (bytesCopied > 0)
+        {
+            inputOffset += static_cast<uint64_t>(bytesCopied);
+            outputOffset += static_cast<uint64_t>(bytesCopied);
+            size -= static_cast<uint64_t>(bytesCopied);
+        }
+        else if (bytesCopied == 0)
+        {
+            error = inputFile + " got shorter while it was being copied.";
+        }
+        else if ((errno == EXDEV) || (errno == ENOSYS) || (errno == EINVAL) || (errno == EOPNOTSUPP))
+        {
+            isCopied = false;
+        }
+        else if (errno != EINTR)
+        {
+            error = "Error copying from " + inputFile + " - " + strerror(errno);
+        }
+    }
+
+    ::close(inputDescriptor);
+    if (!error.empty())
+        throw std::runtime_error(error);
+    return isCopied;
+}
+
+#else
+
+/**
+ * @since 2026 Oct 19
+ */
+bool PositionalFile::copyFrom(const std::string& /*inputFile*/, uint64_t& /*inputOffset*/,
+    uint64_t& /*outputOffset*/, uint64_t& /*size*/)
+{
+    return false;
+}
+
+#endif
+
+/**
+ * @since 2026 Oct 19
+ */
+void PositionalFile::close()
+{
+    if (m_handle == CLOSED_HANDLE)
+        return;
+
+    const NativeFileHandle handle = m_handle;
+    m_handle = CLOSED_HANDLE;
+    if (!m_isOwned)
+        return;
+
+#if defined(_WIN32)
+    if (!CloseHandle(handle))
+        throw std::runtime_error("Error closing " + m_filepath);
+#else
+    if (::close(handle) != 0)
+        throw std::runtime_error("Error closing " + m_filepath + " - " + strerror(errno));
+#endif
+}
@@ -0,0 +1,131 @@
+#ifndef STLREPAIR_POSITIONALFILE__H_
+#define STLREPAIR_POSITIONALFILE__H_
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The OS's own handle for an open file: a HANDLE on Windows, a descriptor
+ * everywhere else.
+ */
+#if defined(_WIN32)
+typedef void* NativeFileHandle;
+#else
+typedef int NativeFileHandle;
+#endif
+
+/**
+ * How a PositionalFile is opened.
+ */
+enum class PositionalFileMode
+{
+    READ,   //!< An existing file, read-only.
+    WRITE   //!< Created, or truncated if it's already there, write-only.
+};
+
+/**
+ * A file read and written at explicit offsets (pread()/pwrite(), or
+ * overlapped ReadFile()/WriteFile() on Windows) rather than through a file
+ * position, so any number of threads can use it at once.
+ */
+class PositionalFile
+{
+public:
+
+    /**
+     * Constructor. Opens the file in the given mode. A file opened for
+     * writing is then sized to the given number of bytes.
+     *
+     * @throws std::runtime_error if the file can't be opened or sized.
+     */
+    explicit PositionalFile(const std::string& filepath,
+        PositionalFileMode mode = PositionalFileMode::WRITE, uint64_t size = 0);
+
+    /**
+     * Constructor. Takes on a file that's already open, for when it has to
+     * be opened some special way or comes from elsewhere. The name is only
+     * for error messages. If isOwned, the handle is closed along with us.
+     */
+    PositionalFile(NativeFileHandle handle, const std::string& filepath, bool isOwned);
+
+    //! Destructor. Closes the file if close() hasn't been called.
+    ~PositionalFile();
+
+    PositionalFile(const PositionalFile&) = delete;
+    PositionalFile& operator=(const PositionalFile&) = delete;
+
+    //! Returns the OS's handle for the file.
+    NativeFileHandle getHandle() const { return m_handle; }
+
+    /**
+     * One read of up to size bytes at the given offset, retried if it's
+     * interrupted. Returns the number of bytes read, which is only 0 at the
+     * end of the file, or -errno on failure (-EIO on Windows). Never throws,
+     * so callers can act on particular errors.
+     */
+    int64_t tryReadAt(uint8_t* pBuffer, size_t size, uint64_t offset);
+
+    /**
+     * One write of up to size bytes at the given offset, retried if it's
+     * interrupted. Returns the number of bytes written or -errno, as for
+     * tryReadAt().
+     */
+    int64_t tryWriteAt(const uint8_t* pData, size_t size, uint64_t offset);
+
+    /**
+     * Reads size bytes from the given offset, or as many as there are
+     * before the end of the file. Returns the number read.
+     *
+     * @throws std::runtime_error on a read error.
+     */
+    uint64_t readAt(uint8_t* pBuffer, uint64_t size, uint64_t offset);
+
+    /**
+     * Writes all of the data at the given offset.
+     *
+     * @throws std::runtime_error on a write error.
+     */
+    void writeAt(const uint8_t* pData, uint64_t size, uint64_t offset);
+
+    /**
+     * Copies from another file without the data passing through us, with
+     * copy_file_range() on Linux, advancing both offsets and the size by
+     * however much was copied. Returns false, with the offsets where they
+     * got to, if the kernel or the file systems can't do that. Always
+     * returns false on other platforms.
+     *
+     * @throws std::runtime_error if the input can't be opened or read, or
+     *         runs out before size bytes have been copied.
+     */
+    bool copyFrom(const std::string& inputFile, uint64_t& inputOffset, uint64_t& outputOffset, uint64_t& size);
+
+    /**
+     * Returns the size of the file.
+     *
+     * @throws std::runtime_error if it can't be found out.
+     */
+    uint64_t getSize() const;
+
+    /**
+     * Extends or truncates the file to the given size.
+     *
+     * @throws std::runtime_error on failure.
+     */
+    void setSize(uint64_t size);
+
+    /**
+     * Closes the file, if we own it. Does nothing if it's already closed.
+     *
+     * @throws std::runtime_error if closing fails.
+     */
+    void close();
+
+private:
+
+    const std::string m_filepath;
+    NativeFileHandle m_handle;
+    bool m_isOwned;
+};
+
+#endif
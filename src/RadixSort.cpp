@@ -0,0 +1,98 @@
+#include "RadixSort.h"
+#include "Parallel.h"
+#include "Contracts.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+    constexpr const int RADIX_BITS = 8;
+    constexpr const size_t BUCKET_COUNT = size_t(1) << RADIX_BITS;
+
+    using Histogram = std::array<size_t, BUCKET_COUNT>;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values)
+{
+    precondition_throw(keys.size() == values.size(),
+        std::runtime_error("Radix sort keys and values must be the same size."));
+
+    const size_t count = keys.size();
+    if (count < 2)
+        return;
+
+    // Chunk boundaries have to be the same for the counting and scatter
+    // steps, so we pick them here rather than leaving it to parallelFor.
+    const size_t chunkCount = std::min<size_t>(getWorkerThreadCount(),
+        std::max<size_t>(count / 16384, 1));
+    std::vector<size_t> bounds(chunkCount + 1);
+    for (size_t i = 0; i <= chunkCount; ++i)
+        bounds[i] = (count * i) / chunkCount;
+
+    std::vector<uint64_t> scratchKeys(count);
+    std::vector<uint32_t> scratchValues(count);
+    std::vector<Histogram> histograms(chunkCount);
+
+    for (int shift = 0; shift < 64; shift += RADIX_BITS)
+    {
+        parallelFor(chunkCount, [&](size_t begin, size_t end)
+        {
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                Histogram& histogram = histograms[chunk];
+                histogram.fill(0);
+                for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i)
+                    ++histogram[(keys[i] >> shift) & (BUCKET_COUNT - 1)];
+            }
+        }, 1);
+
+        // If one bucket holds everything, this digit doesn't change the order.
+        bool isTrivialPass = false;
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+        {
+            size_t total = 0;
+            for (const auto& histogram : histograms)
+                total += histogram[bucket];
+            if (total == count)
+                isTrivialPass = true;
+            if (total != 0)
+                break;
+        }
+        if (isTrivialPass)
+            continue;
+
+        // Turn the counts into starting offsets. Bucket-major, chunk-minor
+        // keeps the sort stable.
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+        {
+            for (auto& histogram : histograms)
+            {
+                const size_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+        }
+
+        parallelFor(chunkCount, [&](size_t begin, size_t end)
+        {
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                Histogram& offsets = histograms[chunk];
+                for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i)
+                {
+                    const size_t destination = offsets[(keys[i] >> shift) & (BUCKET_COUNT - 1)]++;
+                    scratchKeys[destination] = keys[i];
+                    scratchValues[destination] = values[i];
+                }
+            }
+        }, 1);
+
+        keys.swap(scratchKeys);
+        values.swap(scratchValues);
+    }
+}
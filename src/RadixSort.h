@@ -0,0 +1,19 @@
+#ifndef STLREPAIR_RADIXSORT__H_
+#define STLREPAIR_RADIXSORT__H_
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Sorts the keys in ascending order, applying the same permutation to the
+ * values. This is a stable LSD radix sort, 8 bits per pass, with every pass
+ * split across all cores. Passes where every key has the same digit are
+ * skipped, so keys that only use their low bits sort quickly.
+ *
+ * Both vectors must be the same size.
+ *
+ * @throws std::runtime_error
+ */
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values);
+
+#endif
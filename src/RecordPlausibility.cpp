@@ -0,0 +1,187 @@
+#include "RecordPlausibility.h"
+#include "STLFileTypes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define STLREPAIR_RECORDPLAUSIBILITY_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const size_t RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    const size_t FLOATS_PER_RECORD = BINARY_STL_TRIANGLE_SIZE_IN_BYTES / sizeof(float);
+
+    // Real models don't get anywhere near these. Random bit patterns land
+    // outside them about half the time.
+    const float MAXIMUM_MAGNITUDE = 1.0e9f;
+    const float MINIMUM_MAGNITUDE = 1.0e-30f;
+
+    // Normals have to be within about 18 degrees of their facets.
+    const double MINIMUM_NORMAL_AGREEMENT = 0.9;
+    const double ZERO_NORMAL_AGREEMENT = 0.95;
+
+    /*
+     * Every float is finite and, unless it's exactly zero, has a sane
+     * magnitude. This check does most of the rejecting, so it gets the
+     * SIMD treatment.
+     */
+    bool hasSaneFloats(const uint8_t* pRecord)
+    {
+#ifdef STLREPAIR_RECORDPLAUSIBILITY_USE_SSE2
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 maximum = _mm_set1_ps(MAXIMUM_MAGNITUDE);
+        const __m128 minimum = _mm_set1_ps(MINIMUM_MAGNITUDE);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 bad = zero;
+        for (size_t i = 0; i < FLOATS_PER_RECORD; i += 4)
+        {
+            const __m128 value = _mm_loadu_ps(reinterpret_cast<const float*>(pRecord) + i);
+            const __m128 magnitude = _mm_andnot_ps(signMask, value);
+
+            // NaN fails every ordered comparison, so it's caught separately.
+            bad = _mm_or_ps(bad, _mm_cmpunord_ps(value, value));
+            bad = _mm_or_ps(bad, _mm_cmpgt_ps(magnitude, maximum));
+            bad = _mm_or_ps(bad, _mm_and_ps(_mm_cmplt_ps(magnitude, minimum),
+                _mm_cmpneq_ps(magnitude, zero)));
+        }
+        return _mm_movemask_ps(bad) == 0;
+#else
+        float values[FLOATS_PER_RECORD];
+        memcpy(values, pRecord, sizeof(values));
+        for (float value : values)
+        {
+            const float magnitude = std::fabs(value);
+            if (!(magnitude <= MAXIMUM_MAGNITUDE))
+                return false;
+            if (magnitude < MINIMUM_MAGNITUDE && magnitude != 0.0f)
+                return false;
+        }
+        return true;
+#endif
+    }
+
+    /*
+     * Returns the squared cosine of the angle between the facet's normal and
+     * the normal implied by its vertices, or -1 for degenerate facets. Which
+     * way the normal points doesn't matter, and neither does its length,
+     * since some exporters write area-weighted normals. Some exporters don't
+     * bother with normals at all, so a zero normal passes too, but only just.
+     * Zeros are also what junk is most often made of.
+     */
+    double measureNormalAgreement(const STLFacet& facet)
+    {
+        const Vec3& a = facet.vertices[0];
+        const Vec3& b = facet.vertices[1];
+        const Vec3& c = facet.vertices[2];
+        const double e1[3] = { double(b.x) - a.x, double(b.y) - a.y, double(b.z) - a.z };
+        const double e2[3] = { double(c.x) - a.x, double(c.y) - a.y, double(c.z) - a.z };
+        const double cross[3] = {
+            e1[1] * e2[2] - e1[2] * e2[1],
+            e1[2] * e2[0] - e1[0] * e2[2],
+            e1[0] * e2[1] - e1[1] * e2[0] };
+        const double crossLength2 = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+        if (crossLength2 == 0.0)
+            return -1.0;
+
+        const Vec3& n = facet.normal;
+        const double normalLength2 = double(n.x) * n.x + double(n.y) * n.y + double(n.z) * n.z;
+        if (normalLength2 == 0.0)
+            return ZERO_NORMAL_AGREEMENT;
+
+        const double dot = n.x * cross[0] + n.y * cross[1] + n.z * cross[2];
+        return (dot * dot) / (normalLength2 * crossLength2);
+    }
+
+    STLFacet decodeRecord(const uint8_t* pRecord)
+    {
+        STLBinaryTriangleData triangle;
+        memcpy(triangle.data(), pRecord, triangle.size());
+        return decodeFacet(triangle);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool isPlausibleTriangleRecord(const uint8_t* pRecord)
+{
+    if (!hasSaneFloats(pRecord))
+        return false;
+
+    // Degenerate facets do turn up in real files, but they're far more
+    // common in misaligned data (runs of zeros, mostly). A genuine one
+    // surrounded by good facets is still kept. See hasUsableVertices().
+    return measureNormalAgreement(decodeRecord(pRecord)) > MINIMUM_NORMAL_AGREEMENT;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+double scoreTriangleRecord(const uint8_t* pRecord)
+{
+    if (!hasSaneFloats(pRecord))
+        return 0.0;
+
+    return std::max(measureNormalAgreement(decodeRecord(pRecord)), 0.0);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+size_t countPlausibleTriangleRecords(const uint8_t* pData, size_t recordCount)
+{
+    size_t count = 0;
+    while (count < recordCount && isPlausibleTriangleRecord(pData + count * RECORD_SIZE))
+        ++count;
+    return count;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool isRecordNearBounds(const uint8_t* pRecord, const BoundingBox& bounds)
+{
+    if (bounds.isEmpty())
+        return true;
+
+    // Early on, the bounds may only cover a triangle or two. Letting the
+    // margin grow with the distance from the origin keeps that from
+    // rejecting the rest of the model.
+    const float margin = std::max({ bounds.m_max.x - bounds.m_min.x,
+        bounds.m_max.y - bounds.m_min.y, bounds.m_max.z - bounds.m_min.z,
+        std::fabs(bounds.m_min.x), std::fabs(bounds.m_min.y), std::fabs(bounds.m_min.z),
+        std::fabs(bounds.m_max.x), std::fabs(bounds.m_max.y), std::fabs(bounds.m_max.z), 1.0f });
+
+    const STLFacet facet = decodeRecord(pRecord);
+    for (const auto& vertex : facet.vertices)
+    {
+        if (!(vertex.x >= bounds.m_min.x - margin && vertex.x <= bounds.m_max.x + margin &&
+              vertex.y >= bounds.m_min.y - margin && vertex.y <= bounds.m_max.y + margin &&
+              vertex.z >= bounds.m_min.z - margin && vertex.z <= bounds.m_max.z + margin))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool hasUsableVertices(const uint8_t* pRecord, const BoundingBox& bounds)
+{
+    float values[9];
+    memcpy(values, pRecord + 3 * sizeof(float), sizeof(values));
+
+    bool isAllZero = true;
+    for (float value : values)
+    {
+        if (!(std::fabs(value) <= MAXIMUM_MAGNITUDE))
+            return false;
+        isAllZero = isAllZero && (value == 0.0f);
+    }
+    return !isAllZero && isRecordNearBounds(pRecord, bounds);
+}
@@ -0,0 +1,64 @@
+#ifndef STLREPAIR_RECORDPLAUSIBILITY__H_
+#define STLREPAIR_RECORDPLAUSIBILITY__H_
+
+#include "STLGeometry.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Heuristics for telling whether 50 bytes look like a real triangle record
+ * (normal, three vertices and an attribute byte count). Used to notice when
+ * a reader has lost its alignment with the records in a file, and to find
+ * where the records pick up again.
+ *
+ * A record is plausible if:
+ *
+ *  - Every float is finite.
+ *  - No float is absurdly large, or so tiny it's almost certainly the
+ *    bytes of something else. Exact zeros are fine.
+ *  - The facet isn't degenerate.
+ *  - The normal is either zero (some exporters don't bother) or roughly
+ *    parallel to the facet.
+ *
+ * Misaligned float data almost never passes all of these, even for a handful
+ * of records in a row.
+ */
+
+/**
+ * Returns true if the record at pRecord looks like a real triangle.
+ */
+bool isPlausibleTriangleRecord(const uint8_t* pRecord);
+
+/**
+ * Returns the number of consecutive plausible records at pData, looking at
+ * no more than recordCount of them.
+ */
+size_t countPlausibleTriangleRecords(const uint8_t* pData, size_t recordCount);
+
+/**
+ * Returns true if all vertices of the record at pRecord fall within the
+ * given bounds, grown in every direction by their own extent or their
+ * distance from the origin, whichever is larger. This is
+ * intentionally loose. It's only meant to reject records that land
+ * somewhere the model has never been anywhere near.
+ */
+bool isRecordNearBounds(const uint8_t* pRecord, const BoundingBox& bounds);
+
+/**
+ * Returns how much the record at pRecord looks like a real triangle, from
+ * 0 to 1, based on how well its normal agrees with its vertices. Used to
+ * pick between two plausible interpretations of the same bytes.
+ */
+double scoreTriangleRecord(const uint8_t* pRecord);
+
+/**
+ * Returns true if the vertices of the record at pRecord could be real
+ * geometry, i.e., they're finite, not all zero, and near the given bounds
+ * (see isRecordNearBounds()). This is a much weaker test than
+ * isPlausibleTriangleRecord(). It's used to decide whether a lone odd
+ * record is a badly exported triangle worth keeping, or just junk.
+ */
+bool hasUsableVertices(const uint8_t* pRecord, const BoundingBox& bounds);
+
+#endif
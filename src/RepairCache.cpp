@@ -0,0 +1,244 @@
+#include "RepairCache.h"
+#include "XXHash64.h"
+#include "CallGuard.h"
+#include "FileUtils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char* const CACHE_ENTRY_EXTENSION = ".stl";
+    const char* const CACHE_TEMP_EXTENSION = ".tmp";
+
+    //! Temp files older than this were left behind by a worker that died.
+    const auto STALE_TEMP_FILE_AGE = std::chrono::hours(1);
+
+    std::string toHex(uint64_t value)
+    {
+        char buffer[17];
+        snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    /**
+     * Makes destination a copy-on-write clone of source. Returns false,
+     * leaving nothing behind, if the file system can't do that.
+     */
+    bool reflinkFile(const std::string& source, const std::string& destination)
+    {
+#if defined(__linux__) && defined(FICLONE)
+        int sourceFd = open(source.c_str(), O_RDONLY);
+        if (sourceFd < 0)
+            return false;
+        auto sourceGuard = makeCallGuard([&]() { close(sourceFd); });
+
+        int destinationFd = open(destination.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if (destinationFd < 0)
+            return false;
+
+        const bool isCloned = (ioctl(destinationFd, FICLONE, sourceFd) == 0);
+        close(destinationFd);
+        if (!isCloned)
+            unlink(destination.c_str());
+
+        return isCloned;
+#elif defined(__APPLE__)
+        return clonefile(source.c_str(), destination.c_str(), 0) == 0;
+#else
+        (void)source;
+        (void)destination;
+        return false;
+#endif
+    }
+
+    //! Read-only files can't be removed on Windows, so retry with write access.
+    bool removeFile(const fs::path& path)
+    {
+        std::error_code error;
+        if (fs::remove(path, error))
+            return true;
+
+        fs::permissions(path, fs::perms::owner_write, fs::perm_options::add, error);
+        return fs::remove(path, error);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairCache::RepairCache(const std::string& directory, uint64_t maximumSizeInBytes) :
+    m_directory(directory),
+    m_maximumSizeInBytes(maximumSizeInBytes)
+{
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory, error))
+        throw std::runtime_error("Could not create cache directory " + directory);
+}
+
+/**
+ * The key is the hash of the input followed by the hash of the options. A
+ * compressed output gets a suffix naming its format, since its bytes are
+ * nothing like those of the uncompressed repair.
+ *
+ * @since 2026 Oct 19
+ */
+std::string RepairCache::makeKey(const std::string& inputFile, const RepairOptions& options,
+    CompressionFormat outputCompression)
+{
+    std::string key = toHex(hashFile(inputFile)) + toHex(hashRepairOptions(options));
+    switch (outputCompression)
+    {
+    case CompressionFormat::NONE:
+        break;
+    case CompressionFormat::GZIP:
+        key += "-gz";
+        break;
+    case CompressionFormat::ZSTD:
+        key += "-zst";
+        break;
+    }
+
+    return key;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool RepairCache::fetch(const std::string& key, const std::string& outputFile)
+{
+    const std::string entryPath = getEntryPath(key);
+
+    std::error_code error;
+    if (!fs::is_regular_file(entryPath, error))
+        return false;
+
+    if (!reflinkFile(entryPath, outputFile))
+    {
+        fs::create_hard_link(entryPath, outputFile, error);
+        if (error)
+            return false;
+    }
+
+    // Most recently used.
+    fs::last_write_time(entryPath, fs::file_time_type::clock::now(), error);
+
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairCache::store(const std::string& key, const std::string& repairedFile)
+{
+    const std::string entryPath = getEntryPath(key);
+    const std::string tempPath = entryPath + "." + FileUtils::generateRandomSuffix() + CACHE_TEMP_EXTENSION;
+
+    std::error_code error;
+    if (!reflinkFile(repairedFile, tempPath))
+    {
+        fs::copy_file(repairedFile, tempPath, error);
+        if (error)
+        {
+            removeFile(tempPath);
+            return;
+        }
+    }
+
+    // Read-only, so nobody writes through a hard link into the cache.
+    fs::permissions(tempPath, fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+        fs::perm_options::remove, error);
+
+    // Renaming is atomic, so nobody ever sees a partial entry.
+    fs::rename(tempPath, entryPath, error);
+    if (error)
+        removeFile(tempPath);
+
+    trim();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairCache::trim()
+{
+    struct Entry
+    {
+        fs::path m_path;
+        uint64_t m_size;
+        fs::file_time_type m_lastUsed;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+    const auto now = fs::file_time_type::clock::now();
+
+    // Anything can disappear from under us while we look, since other
+    // processes are trimming too. Errors just mean we skip that file.
+    std::error_code error;
+    for (fs::directory_iterator it(m_directory, error), end; !error && (it != end); it.increment(error))
+    {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError))
+            continue;
+
+        const fs::path& path = it->path();
+        const auto lastWriteTime = it->last_write_time(entryError);
+        if (entryError)
+            continue;
+
+        if (path.extension() == CACHE_TEMP_EXTENSION)
+        {
+            if (now - lastWriteTime > STALE_TEMP_FILE_AGE)
+                removeFile(path);
+        }
+        else if (path.extension() == CACHE_ENTRY_EXTENSION)
+        {
+            const uint64_t size = it->file_size(entryError);
+            if (entryError)
+                continue;
+
+            entries.push_back({ path, size, lastWriteTime });
+            totalSize += size;
+        }
+    }
+
+    if (totalSize <= m_maximumSizeInBytes)
+        return;
+
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.m_lastUsed < b.m_lastUsed; });
+
+    for (const Entry& entry : entries)
+    {
+        if (totalSize <= m_maximumSizeInBytes)
+            break;
+
+        removeFile(entry.m_path);
+        totalSize -= entry.m_size;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string RepairCache::getEntryPath(const std::string& key) const
+{
+    return (fs::path(m_directory) / (key + CACHE_ENTRY_EXTENSION)).string();
+}
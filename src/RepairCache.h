@@ -0,0 +1,76 @@
+#ifndef STLREPAIR_REPAIRCACHE__H_
+#define STLREPAIR_REPAIRCACHE__H_
+
+#include "FilterStages.h"
+#include "CompressedByteStream.h"
+
+#include <string>
+#include <cstdint>
+
+/**
+ * Default limit on the total size of everything in a repair cache.
+ */
+constexpr const uint64_t DEFAULT_REPAIR_CACHE_SIZE_IN_BYTES = 1024ull * 1024 * 1024;
+
+/**
+ * On-disk cache of repaired files, keyed by the content of the input and the
+ * repairs made to it. Repairing a file that's been seen before comes down to
+ * hashing it and linking the earlier result into place.
+ *
+ * Entries are only ever created by renaming a finished file into the cache
+ * directory, and removing one doesn't affect anyone who already has it, so
+ * any number of processes can share a cache. When the cache grows past its
+ * size limit, the least recently used entries are removed.
+ */
+class RepairCache
+{
+public:
+
+    /**
+     * Constructor. Creates the cache directory if it doesn't exist.
+     *
+     * @throws std::runtime_error if the directory can't be created.
+     */
+    RepairCache(const std::string& directory,
+        uint64_t maximumSizeInBytes = DEFAULT_REPAIR_CACHE_SIZE_IN_BYTES);
+
+    /**
+     * Returns the key for repairing the given file with the given options
+     * into an output compressed with the given format. The input is hashed
+     * in full.
+     *
+     * @throws std::runtime_error if the file can't be read.
+     */
+    static std::string makeKey(const std::string& inputFile, const RepairOptions& options,
+        CompressionFormat outputCompression = CompressionFormat::NONE);
+
+    /**
+     * If there's an entry for the key, puts a copy of it at outputFile and
+     * returns true. The copy is a reflink where the file system supports
+     * them, or else a hard link. Either way it costs no extra space. Entries
+     * are read-only, and so are hard links to them.
+     */
+    bool fetch(const std::string& key, const std::string& outputFile);
+
+    /**
+     * Adds a copy of the repaired file to the cache, then evicts entries if
+     * the cache has grown too big. Failures are ignored. The cache is only
+     * ever an optimization.
+     */
+    void store(const std::string& key, const std::string& repairedFile);
+
+    /**
+     * Removes least recently used entries until the cache fits within its
+     * size limit.
+     */
+    void trim();
+
+private:
+
+    std::string getEntryPath(const std::string& key) const;
+
+    std::string m_directory;
+    uint64_t m_maximumSizeInBytes;
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include "RepairCheckpoint.h"
+#include "OutputCommitter.h"
+#include "XXHash64.h"
+#include "CallGuard.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdio>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char CHECKPOINT_MAGIC[8] = { 'S', 'T', 'L', 'R', 'C', 'K', 'P', 'T' };
+    const uint32_t CHECKPOINT_FORMAT_VERSION = 1;
+
+    //! Sidecars are only ever read by the same build that wrote them, so values go in as they are in memory.
+    class CheckpointWriter
+    {
+    public:
+
+        template <typename T>
+        void put(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values go in as is.");
+            const uint8_t* pValue = reinterpret_cast<const uint8_t*>(&value);
+            m_data.insert(m_data.end(), pValue, pValue + sizeof(value));
+        }
+
+        void putBytes(const void* pData, size_t size)
+        {
+            put(static_cast<uint32_t>(size));
+            const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+            m_data.insert(m_data.end(), pBytes, pBytes + size);
+        }
+
+        std::vector<uint8_t> m_data;
+    };
+
+    //! Reads back what CheckpointWriter wrote. Every get returns false once the data runs out.
+    class CheckpointReader
+    {
+    public:
+
+        CheckpointReader(const uint8_t* pData, size_t size) : m_pData(pData), m_remaining(size) {}
+
+        template <typename T>
+        bool get(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values come out as is.");
+            if (m_remaining < sizeof(value))
+                return false;
+
+            memcpy(&value, m_pData, sizeof(value));
+            m_pData += sizeof(value);
+            m_remaining -= sizeof(value);
+            return true;
+        }
+
+        template <typename Container>
+        bool getBytes(Container& bytes)
+        {
+            uint32_t size = 0;
+            if (!get(size) || (m_remaining < size))
+                return false;
+
+            bytes.assign(m_pData, m_pData + size);
+            m_pData += size;
+            m_remaining -= size;
+            return true;
+        }
+
+        bool isEmpty() const { return m_remaining == 0; }
+
+    private:
+
+        const uint8_t* m_pData;
+        size_t m_remaining;
+    };
+
+    int64_t getModifiedTime(const std::string& filepath)
+    {
+        std::error_code error;
+        const auto modifiedTime = fs::last_write_time(filepath, error);
+        if (error)
+            throw std::runtime_error("Could not get the modification time of " + filepath);
+
+        return static_cast<int64_t>(modifiedTime.time_since_epoch().count());
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string getCheckpointPath(const std::string& inputFile)
+{
+    const fs::path path(inputFile);
+    return (path.parent_path() / ("." + path.filename().string() + ".checkpoint")).string();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairCheckpoint makeInitialCheckpoint(const std::string& inputFile, const RepairOptions& options,
+    const std::string& outputFile, const std::string& tempFile)
+{
+    std::error_code error;
+    const uint64_t inputSize = fs::file_size(inputFile, error);
+    if (error)
+        throw std::runtime_error("Could not get the size of " + inputFile);
+
+    RepairCheckpoint checkpoint;
+    checkpoint.m_inputSize = inputSize;
+    checkpoint.m_inputModifiedTime = getModifiedTime(inputFile);
+    checkpoint.m_optionsHash = hashRepairOptions(options);
+    checkpoint.m_outputFile = outputFile;
+    checkpoint.m_tempFile = tempFile;
+    return checkpoint;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool isCheckpointFor(const RepairCheckpoint& checkpoint, const std::string& inputFile,
+    const RepairOptions& options)
+{
+    std::error_code error;
+    const uint64_t inputSize = fs::file_size(inputFile, error);
+    if (error)
+        return false;
+
+    try
+    {
+        return (checkpoint.m_inputSize == inputSize) &&
+            (checkpoint.m_inputModifiedTime == getModifiedTime(inputFile)) &&
+            (checkpoint.m_optionsHash == hashRepairOptions(options));
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void writeRepairCheckpoint(const std::string& checkpointPath, const RepairCheckpoint& checkpoint)
+{
+    CheckpointWriter writer;
+    writer.put(CHECKPOINT_MAGIC);
+    writer.put(CHECKPOINT_FORMAT_VERSION);
+    writer.put(checkpoint.m_inputSize);
+    writer.put(checkpoint.m_inputModifiedTime);
+    writer.put(checkpoint.m_optionsHash);
+    writer.putBytes(checkpoint.m_outputFile.data(), checkpoint.m_outputFile.size());
+    writer.putBytes(checkpoint.m_tempFile.data(), checkpoint.m_tempFile.size());
+
+    writer.put(checkpoint.m_reader.m_fileOffset);
+    writer.put(checkpoint.m_reader.m_triangleIndex);
+    writer.put(static_cast<uint8_t>(checkpoint.m_reader.m_isResynchronizing));
+    writer.put(checkpoint.m_reader.m_verifiedRecordCount);
+    writer.put(checkpoint.m_reader.m_seenBounds);
+
+    writer.put(checkpoint.m_filter.m_header);
+    writer.put(checkpoint.m_filter.m_triangleCount);
+    writer.put(checkpoint.m_filter.m_writtenTriangleCount);
+    writer.put(checkpoint.m_filter.m_skippedByteCount);
+    writer.put(static_cast<uint32_t>(checkpoint.m_filter.m_stageStates.size()));
+    for (const auto& state : checkpoint.m_filter.m_stageStates)
+        writer.putBytes(state.data(), state.size());
+
+    XXHash64 hash;
+    hash.update(writer.m_data.data(), writer.m_data.size());
+    writer.put(hash.digest());
+
+    const std::string tempPath = makeTempOutputPath(checkpointPath);
+    auto removeGuard = makeCallGuard([&]() { remove(tempPath.c_str()); });
+
+    FILE* pFile = fopen(tempPath.c_str(), "wb");
+    if (!pFile)
+        throw std::runtime_error("Could not create checkpoint " + tempPath);
+
+    const bool isWritten = (fwrite(writer.m_data.data(), 1, writer.m_data.size(), pFile) == writer.m_data.size());
+    if ((fclose(pFile) != 0) || !isWritten)
+        throw std::runtime_error("Could not write checkpoint " + tempPath);
+
+    OutputCommitter(DurabilityPolicy::FDATASYNC).commit(tempPath, checkpointPath);
+    removeGuard.dismiss();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool readRepairCheckpoint(const std::string& checkpointPath, RepairCheckpoint& checkpoint)
+{
+    std::ifstream file(checkpointPath, std::ios::binary);
+    if (!file)
+        return false;
+
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t storedHash = 0;
+    if (data.size() < sizeof(storedHash))
+        return false;
+
+    const size_t payloadSize = data.size() - sizeof(storedHash);
+    XXHash64 hash;
+    hash.update(data.data(), payloadSize);
+    memcpy(&storedHash, data.data() + payloadSize, sizeof(storedHash));
+    if (hash.digest() != storedHash)
+        return false;
+
+    CheckpointReader reader(data.data(), payloadSize);
+    char magic[sizeof(CHECKPOINT_MAGIC)] = {};
+    uint32_t formatVersion = 0;
+    if (!reader.get(magic) || (memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) ||
+        !reader.get(formatVersion) || (formatVersion != CHECKPOINT_FORMAT_VERSION))
+    {
+        return false;
+    }
+
+    RepairCheckpoint loaded;
+    uint8_t isResynchronizing = 0;
+    uint32_t stageCount = 0;
+    bool isRead = reader.get(loaded.m_inputSize) &&
+        reader.get(loaded.m_inputModifiedTime) &&
+        reader.get(loaded.m_optionsHash) &&
+        reader.getBytes(loaded.m_outputFile) &&
+        reader.getBytes(loaded.m_tempFile) &&
+        reader.get(loaded.m_reader.m_fileOffset) &&
+        reader.get(loaded.m_reader.m_triangleIndex) &&
+        reader.get(isResynchronizing) &&
+        reader.get(loaded.m_reader.m_verifiedRecordCount) &&
+        reader.get(loaded.m_reader.m_seenBounds) &&
+        reader.get(loaded.m_filter.m_header) &&
+        reader.get(loaded.m_filter.m_triangleCount) &&
+        reader.get(loaded.m_filter.m_writtenTriangleCount) &&
+        reader.get(loaded.m_filter.m_skippedByteCount) &&
+        reader.get(stageCount);
+
+    for (uint32_t stage = 0; isRead && (stage < stageCount); ++stage)
+    {
+        loaded.m_filter.m_stageStates.emplace_back();
+        isRead = reader.getBytes(loaded.m_filter.m_stageStates.back());
+    }
+
+    if (!isRead || !reader.isEmpty())
+        return false;
+
+    loaded.m_reader.m_isResynchronizing = (isResynchronizing != 0);
+    checkpoint = std::move(loaded);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairCheckpointer::RepairCheckpointer(const BinarySTLFileReader& reader, FilterChain& chain,
+    const std::string& checkpointPath, const RepairCheckpoint& initialCheckpoint, uint64_t intervalBytes) :
+    m_reader(reader),
+    m_chain(chain),
+    m_checkpointPath(checkpointPath),
+    m_checkpoint(initialCheckpoint),
+    m_intervalBytes(std::max<uint64_t>(intervalBytes, 1)),
+    m_nextCheckpointOffset(initialCheckpoint.m_reader.m_fileOffset + m_intervalBytes),
+    m_checkpointCount(0)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool RepairCheckpointer::onReadTriangle(const STLBinaryTriangleData& triangleData, const uint16_t attributeByteCount)
+{
+    if (!m_chain.onReadTriangle(triangleData, attributeByteCount))
+        return false;
+
+    const BinarySTLFileReaderCheckpoint readerCheckpoint = m_reader.getCheckpoint();
+    if ((readerCheckpoint.m_fileOffset < m_nextCheckpointOffset) || !m_chain.saveCheckpoint(m_checkpoint.m_filter))
+        return true;
+
+    m_checkpoint.m_reader = readerCheckpoint;
+    writeRepairCheckpoint(m_checkpointPath, m_checkpoint);
+    m_nextCheckpointOffset = readerCheckpoint.m_fileOffset + m_intervalBytes;
+    ++m_checkpointCount;
+    return true;
+}
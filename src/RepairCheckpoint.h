@@ -0,0 +1,111 @@
+#ifndef STLREPAIR_REPAIRCHECKPOINT__H_
+#define STLREPAIR_REPAIRCHECKPOINT__H_
+
+#include "BinarySTLFileReader.h"
+#include "FilterChain.h"
+#include "FilterStages.h"
+
+#include <string>
+#include <cstdint>
+
+/**
+ * Default amount of input read between checkpoints. Each one costs a sync
+ * of the output, so they shouldn't be too frequent.
+ */
+constexpr const uint64_t DEFAULT_CHECKPOINT_INTERVAL_BYTES = 256ull * 1024 * 1024;
+
+/**
+ * Everything needed to pick a repair of one file back up after the process
+ * running it died, as kept in a small sidecar file.
+ */
+struct RepairCheckpoint
+{
+    // What was being repaired, so a checkpoint isn't applied to anything else.
+    uint64_t m_inputSize = 0;
+    int64_t m_inputModifiedTime = 0;
+    uint64_t m_optionsHash = 0;            //!< See hashRepairOptions().
+
+    std::string m_outputFile;               //!< Where the output goes once it's done.
+    std::string m_tempFile;                 //!< Where it's written in the meantime.
+
+    BinarySTLFileReaderCheckpoint m_reader;
+    FilterChainCheckpoint m_filter;
+};
+
+/**
+ * Returns the path of the sidecar file for checkpoints of the given input.
+ * It's hidden, next to the input.
+ */
+std::string getCheckpointPath(const std::string& inputFile);
+
+/**
+ * Returns a checkpoint with nothing done yet, for repairing the input with
+ * the given options.
+ *
+ * @throws std::runtime_error if the input can't be looked at.
+ */
+RepairCheckpoint makeInitialCheckpoint(const std::string& inputFile, const RepairOptions& options,
+    const std::string& outputFile, const std::string& tempFile);
+
+/**
+ * Returns true if the checkpoint is of the same input (same size and
+ * modification time) repaired with the same options.
+ */
+bool isCheckpointFor(const RepairCheckpoint& checkpoint, const std::string& inputFile,
+    const RepairOptions& options);
+
+/**
+ * Writes the checkpoint to its sidecar file, replacing the one before, and
+ * makes sure it's on disk.
+ *
+ * @throws std::runtime_error if the file can't be written.
+ */
+void writeRepairCheckpoint(const std::string& checkpointPath, const RepairCheckpoint& checkpoint);
+
+/**
+ * Reads a checkpoint back. Returns false if there isn't one, or if it's
+ * damaged or from another version.
+ */
+bool readRepairCheckpoint(const std::string& checkpointPath, RepairCheckpoint& checkpoint);
+
+/**
+ * Sits between a BinarySTLFileReader and the FilterChain it feeds, passing
+ * everything along, and writes a checkpoint every so often as the input is
+ * read. Checkpoints can only be taken between batches, so each comes at the
+ * first batch boundary after the interval's up.
+ */
+class RepairCheckpointer : public BinarySTLFileReaderListener
+{
+public:
+
+    /**
+     * Constructor. The initial checkpoint says what's being repaired, and
+     * where from if resuming.
+     */
+    RepairCheckpointer(const BinarySTLFileReader& reader, FilterChain& chain,
+        const std::string& checkpointPath, const RepairCheckpoint& initialCheckpoint,
+        uint64_t intervalBytes = DEFAULT_CHECKPOINT_INTERVAL_BYTES);
+
+    bool onReadBegin() override { return m_chain.onReadBegin(); }
+    void onReadEnd() override { m_chain.onReadEnd(); }
+    bool onReadFileHeader(const STLBinaryHeader& header) override { return m_chain.onReadFileHeader(header); }
+    bool onReadTriangleCount(const uint32_t triangleCount) override { return m_chain.onReadTriangleCount(triangleCount); }
+    bool onReadTriangle(const STLBinaryTriangleData& triangleData, const uint16_t attributeByteCount) override;
+    bool onReadUnknownData(const uint8_t* const pData, const size_t dataSize) override { return m_chain.onReadUnknownData(pData, dataSize); }
+    bool onReadSkippedData(const uint64_t fileOffset, const uint64_t dataSize) override { return m_chain.onReadSkippedData(fileOffset, dataSize); }
+
+    //! Returns the number of checkpoints written so far.
+    uint64_t getCheckpointCount() const { return m_checkpointCount; }
+
+private:
+
+    const BinarySTLFileReader& m_reader;
+    FilterChain& m_chain;
+    const std::string m_checkpointPath;
+    RepairCheckpoint m_checkpoint;
+    const uint64_t m_intervalBytes;
+    uint64_t m_nextCheckpointOffset;
+    uint64_t m_checkpointCount;
+};
+
+#endif
@@ -0,0 +1,233 @@
+#include "RepairClient.h"
+#include "RepairProtocol.h"
+
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+
+namespace
+{
+#if defined(MSG_NOSIGNAL)
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    void sendAll(int socket, const void* pData, size_t size)
+    {
+        const char* pNext = static_cast<const char*>(pData);
+        while (size > 0)
+        {
+            const ssize_t sent = send(socket, pNext, size, SEND_FLAGS);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error(std::string("Lost connection to repair server - ") + strerror(errno));
+            }
+            pNext += sent;
+            size -= static_cast<size_t>(sent);
+        }
+    }
+
+    void receiveAll(int socket, void* pData, size_t size)
+    {
+        char* pNext = static_cast<char*>(pData);
+        while (size > 0)
+        {
+            const ssize_t received = recv(socket, pNext, size, 0);
+            if (received < 0 && errno == EINTR)
+                continue;
+            if (received <= 0)
+                throw std::runtime_error("Lost connection to repair server.");
+            pNext += received;
+            size -= static_cast<size_t>(received);
+        }
+    }
+
+    //! Sends the header, with the descriptors attached to it.
+    void sendHeader(int socket, const RepairRequestHeader& header, const int* pFds, size_t fdCount)
+    {
+        if (fdCount == 0)
+        {
+            sendAll(socket, &header, sizeof(header));
+            return;
+        }
+
+        iovec io = { const_cast<RepairRequestHeader*>(&header), sizeof(header) };
+        alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))];
+        memset(control, 0, sizeof(control));
+
+        msghdr message = {};
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = CMSG_SPACE(fdCount * sizeof(int));
+
+        cmsghdr* pControl = CMSG_FIRSTHDR(&message);
+        pControl->cmsg_level = SOL_SOCKET;
+        pControl->cmsg_type = SCM_RIGHTS;
+        pControl->cmsg_len = CMSG_LEN(fdCount * sizeof(int));
+        memcpy(CMSG_DATA(pControl), pFds, fdCount * sizeof(int));
+
+        ssize_t sent;
+        do
+        {
+            sent = sendmsg(socket, &message, SEND_FLAGS);
+        } while ((sent < 0) && (errno == EINTR));
+        if (sent < 0)
+            throw std::runtime_error(std::string("Lost connection to repair server - ") + strerror(errno));
+
+        // The descriptors went with the first byte. The rest, if any, can go normally.
+        if (static_cast<size_t>(sent) < sizeof(header))
+            sendAll(socket, reinterpret_cast<const char*>(&header) + sent, sizeof(header) - sent);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairClient::RepairClient(const std::string& socketPath) :
+    m_socket(-1)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Socket path is too long - " + socketPath);
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket == -1)
+        throw std::runtime_error(std::string("Could not create socket - ") + strerror(errno));
+
+    if (connect(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        const int error = errno;
+        close(m_socket);
+        throw std::runtime_error("Could not connect to repair server at " + socketPath + " - " + strerror(error));
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairClient::~RepairClient()
+{
+    close(m_socket);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult RepairClient::sendRequest(uint32_t flags, const RepairOptions& options, const uint8_t* pInput,
+    size_t inputSize, const int* pFds, size_t fdCount, std::vector<uint8_t>* pOutput)
+{
+    RepairRequestHeader request = {};
+    request.m_magic = REPAIR_REQUEST_MAGIC;
+    request.m_flags = flags | encodeRepairFlags(options);
+    request.m_triangleLimit = options.m_triangleLimit;
+    request.m_inputSize = inputSize;
+
+    sendHeader(m_socket, request, pFds, fdCount);
+    if (inputSize > 0)
+        sendAll(m_socket, pInput, inputSize);
+
+    RepairResponseHeader response = {};
+    receiveAll(m_socket, &response, sizeof(response));
+    if (response.m_magic != REPAIR_RESPONSE_MAGIC)
+        throw std::runtime_error("Unexpected response from repair server.");
+
+    if (response.m_status != REPAIR_RESPONSE_OK)
+    {
+        std::string message(static_cast<size_t>(response.m_payloadSize), '\0');
+        receiveAll(m_socket, &message[0], message.size());
+        throw std::runtime_error(message);
+    }
+
+    RepairResult result;
+    result.m_triangleCount = response.m_triangleCount;
+    result.m_skippedByteCount = response.m_skippedByteCount;
+    result.m_outputSize = static_cast<size_t>(response.m_outputSize);
+
+    if (pOutput)
+    {
+        pOutput->resize(static_cast<size_t>(response.m_payloadSize));
+        receiveAll(m_socket, pOutput->data(), pOutput->size());
+    }
+
+    return result;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult RepairClient::repair(const uint8_t* pInput, size_t inputSize, std::vector<uint8_t>& output,
+    const RepairOptions& options, bool shouldPlanRepairs)
+{
+    const uint32_t flags = shouldPlanRepairs ? static_cast<uint32_t>(REPAIR_REQUEST_PLAN_REPAIRS) : 0u;
+    return sendRequest(flags, options, pInput, inputSize, nullptr, 0, &output);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult RepairClient::repair(int inputFd, int outputFd, const RepairOptions& options, bool shouldPlanRepairs)
+{
+    const uint32_t flags = REPAIR_REQUEST_INPUT_FD | REPAIR_REQUEST_OUTPUT_FD |
+        (shouldPlanRepairs ? static_cast<uint32_t>(REPAIR_REQUEST_PLAN_REPAIRS) : 0u);
+    const int fds[2] = { inputFd, outputFd };
+    return sendRequest(flags, options, nullptr, 0, fds, 2, nullptr);
+}
+
+#else
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairClient::RepairClient(const std::string& /*socketPath*/) :
+    m_socket(-1)
+{
+    throw std::runtime_error("Repair servers aren't supported on this platform.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairClient::~RepairClient()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult RepairClient::sendRequest(uint32_t, const RepairOptions&, const uint8_t*,
+    size_t, const int*, size_t, std::vector<uint8_t>*)
+{
+    return RepairResult();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult RepairClient::repair(const uint8_t*, size_t, std::vector<uint8_t>&, const RepairOptions&, bool)
+{
+    return RepairResult();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairResult RepairClient::repair(int, int, const RepairOptions&, bool)
+{
+    return RepairResult();
+}
+
+#endif
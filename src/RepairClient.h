@@ -0,0 +1,65 @@
+#ifndef STLREPAIR_REPAIRCLIENT__H_
+#define STLREPAIR_REPAIRCLIENT__H_
+
+#include "InMemoryRepair.h"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Sends repairs to a RepairServer over its Unix domain socket, for services
+ * that want repairs without starting a process or writing temp files each
+ * time. One connection is kept open for the life of the client. A client
+ * is not thread safe. Use one per thread.
+ *
+ * Not supported on Windows.
+ */
+class RepairClient
+{
+public:
+
+    /**
+     * Constructor. Connects to the server.
+     *
+     * @throws std::runtime_error if the server can't be reached.
+     */
+    explicit RepairClient(const std::string& socketPath);
+
+    //! Destructor. Disconnects.
+    ~RepairClient();
+
+    RepairClient(const RepairClient&) = delete;
+    RepairClient& operator=(const RepairClient&) = delete;
+
+    /**
+     * Sends the STL data to be repaired and puts the result in output. If
+     * shouldPlanRepairs is true, the server adds whatever count and
+     * trailing data repairs the input needs (see planRepairs()).
+     *
+     * @throws std::runtime_error if the repair fails, with the server's
+     *         reason, or the connection is lost.
+     */
+    RepairResult repair(const uint8_t* pInput, size_t inputSize, std::vector<uint8_t>& output,
+        const RepairOptions& options, bool shouldPlanRepairs = true);
+
+    /**
+     * Has the server repair one open file into another. Only the
+     * descriptors go over the socket. The output file is truncated to the
+     * size of the result.
+     *
+     * @throws std::runtime_error if the repair fails, with the server's
+     *         reason, or the connection is lost.
+     */
+    RepairResult repair(int inputFd, int outputFd, const RepairOptions& options, bool shouldPlanRepairs = true);
+
+private:
+
+    RepairResult sendRequest(uint32_t flags, const RepairOptions& options, const uint8_t* pInput,
+        size_t inputSize, const int* pFds, size_t fdCount, std::vector<uint8_t>* pOutput);
+
+    int m_socket;
+};
+
+#endif
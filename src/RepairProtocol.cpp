@@ -0,0 +1,49 @@
+#include "RepairProtocol.h"
+#include "Contracts.h"
+
+#include <stdexcept>
+
+/**
+ * @since 2026 Oct 19
+ */
+uint32_t encodeRepairFlags(const RepairOptions& options)
+{
+    precondition_throw(options.m_transform.isIdentity(),
+        std::runtime_error("Transforms can't be sent to a repair server."));
+
+    uint32_t flags = 0;
+    if (options.m_zeroOutHeader)
+        flags |= REPAIR_REQUEST_ZERO_HEADER;
+    if (options.m_updateTriangleCount)
+        flags |= REPAIR_REQUEST_UPDATE_TRIANGLE_COUNT;
+    if (options.m_zeroAttributeByteCounts)
+        flags |= REPAIR_REQUEST_ZERO_ATTRIBUTE_BYTE_COUNTS;
+    if (options.m_clearExtraFileData)
+        flags |= REPAIR_REQUEST_CLEAR_EXTRA_DATA;
+    if (options.m_sortByMortonCode)
+        flags |= REPAIR_REQUEST_SORT_BY_MORTON_CODE;
+    if (options.m_stampPayloadDigest)
+        flags |= REPAIR_REQUEST_STAMP_PAYLOAD_DIGEST;
+    if (options.m_resynchronize)
+        flags |= REPAIR_REQUEST_RESYNCHRONIZE;
+
+    return flags;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairOptions decodeRepairFlags(uint32_t flags, uint32_t triangleLimit)
+{
+    RepairOptions options;
+    options.m_zeroOutHeader = (flags & REPAIR_REQUEST_ZERO_HEADER) != 0;
+    options.m_updateTriangleCount = (flags & REPAIR_REQUEST_UPDATE_TRIANGLE_COUNT) != 0;
+    options.m_zeroAttributeByteCounts = (flags & REPAIR_REQUEST_ZERO_ATTRIBUTE_BYTE_COUNTS) != 0;
+    options.m_clearExtraFileData = (flags & REPAIR_REQUEST_CLEAR_EXTRA_DATA) != 0;
+    options.m_sortByMortonCode = (flags & REPAIR_REQUEST_SORT_BY_MORTON_CODE) != 0;
+    options.m_stampPayloadDigest = (flags & REPAIR_REQUEST_STAMP_PAYLOAD_DIGEST) != 0;
+    options.m_resynchronize = (flags & REPAIR_REQUEST_RESYNCHRONIZE) != 0;
+    options.m_triangleLimit = triangleLimit;
+
+    return options;
+}
@@ -0,0 +1,88 @@
+#ifndef STLREPAIR_REPAIRPROTOCOL__H_
+#define STLREPAIR_REPAIRPROTOCOL__H_
+
+#include "FilterStages.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * What goes over the socket between a RepairClient and a RepairServer.
+ *
+ * Each request is a RepairRequestHeader followed by m_inputSize bytes of
+ * STL data. Or, if REPAIR_REQUEST_INPUT_FD is set, by nothing at all, with
+ * the input file's descriptor passed alongside the header (SCM_RIGHTS).
+ * The output file's descriptor can be passed the same way, in which case
+ * the repaired data is written straight to it.
+ *
+ * Each response is a RepairResponseHeader followed by m_payloadSize bytes:
+ * the repaired data if the repair worked and there was no output file, or
+ * an error message if it didn't. A connection is closed after a bad
+ * request, since there's no telling where the next one starts.
+ *
+ * Everything is little-endian. Any number of requests can be sent over one
+ * connection, one at a time.
+ */
+
+constexpr const uint32_t REPAIR_REQUEST_MAGIC = 0x51524c53;    // "SLRQ"
+constexpr const uint32_t REPAIR_RESPONSE_MAGIC = 0x50524c53;   // "SLRP"
+
+//! Flags for RepairRequestHeader::m_flags.
+enum RepairRequestFlags : uint32_t
+{
+    REPAIR_REQUEST_ZERO_HEADER = 1u << 0,
+    REPAIR_REQUEST_UPDATE_TRIANGLE_COUNT = 1u << 1,
+    REPAIR_REQUEST_ZERO_ATTRIBUTE_BYTE_COUNTS = 1u << 2,
+    REPAIR_REQUEST_CLEAR_EXTRA_DATA = 1u << 3,
+    REPAIR_REQUEST_SORT_BY_MORTON_CODE = 1u << 4,
+    REPAIR_REQUEST_STAMP_PAYLOAD_DIGEST = 1u << 5,
+    REPAIR_REQUEST_RESYNCHRONIZE = 1u << 6,
+
+    //! Add whatever count and trailing data repairs the input needs. See planRepairs().
+    REPAIR_REQUEST_PLAN_REPAIRS = 1u << 7,
+
+    REPAIR_REQUEST_INPUT_FD = 1u << 16,
+    REPAIR_REQUEST_OUTPUT_FD = 1u << 17
+};
+
+struct RepairRequestHeader
+{
+    uint32_t m_magic;
+    uint32_t m_flags;
+    uint32_t m_triangleLimit;   //!< 0 for no limit.
+    uint32_t m_reserved;
+    uint64_t m_inputSize;       //!< Bytes of STL data that follow. 0 if passed as a descriptor.
+};
+
+//! Status codes for RepairResponseHeader::m_status.
+enum RepairResponseStatus : uint32_t
+{
+    REPAIR_RESPONSE_OK = 0,
+    REPAIR_RESPONSE_REPAIR_FAILED = 1,
+    REPAIR_RESPONSE_BAD_REQUEST = 2
+};
+
+struct RepairResponseHeader
+{
+    uint32_t m_magic;
+    uint32_t m_status;
+    uint32_t m_triangleCount;
+    uint32_t m_reserved;
+    uint64_t m_skippedByteCount;
+    uint64_t m_outputSize;      //!< Size of the repaired data, wherever it went.
+    uint64_t m_payloadSize;     //!< Bytes that follow. Repaired data, or an error message.
+};
+
+static_assert(sizeof(RepairRequestHeader) == 24, "Request header has to match the wire format.");
+static_assert(sizeof(RepairResponseHeader) == 40, "Response header has to match the wire format.");
+
+/**
+ * Turns repair options into request flags. The transform can't be sent,
+ * so it has to be the identity.
+ */
+uint32_t encodeRepairFlags(const RepairOptions& options);
+
+//! Turns a request back into repair options.
+RepairOptions decodeRepairFlags(uint32_t flags, uint32_t triangleLimit);
+
+#endif
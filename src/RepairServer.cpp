@@ -0,0 +1,736 @@
+#include "RepairServer.h"
+#include "RepairProtocol.h"
+#include "InMemoryRepair.h"
+#include "CallGuard.h"
+#include "TraceRecorder.h"
+#include "Metrics.h"
+#include "PositionalFile.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+/**
+ * A client connection, and the request it's working on.
+ */
+struct RepairServer::Connection
+{
+    int m_socket = -1;
+    RepairRequestHeader m_request = {};
+    size_t m_headerByteCount = 0;
+    std::vector<uint8_t> m_input;
+    size_t m_inputByteCount = 0;
+    std::vector<int> m_fds;
+
+    //! Why the request is bad, if it is. The connection is closed once the client's been told.
+    std::string m_badRequest;
+
+    bool m_isComplete = false;
+
+    //! Set while a worker has the connection. The event loop leaves it alone until it's returned.
+    bool m_isBusy = false;
+
+    //! Set by the worker if the response couldn't be sent.
+    bool m_isBroken = false;
+
+    int getInputFd() const
+    {
+        return ((m_request.m_flags & REPAIR_REQUEST_INPUT_FD) && !m_fds.empty()) ? m_fds[0] : -1;
+    }
+
+    int getOutputFd() const
+    {
+        const size_t index = (m_request.m_flags & REPAIR_REQUEST_INPUT_FD) ? 1 : 0;
+        return ((m_request.m_flags & REPAIR_REQUEST_OUTPUT_FD) && (index < m_fds.size())) ? m_fds[index] : -1;
+    }
+
+    void closeFds();
+    void reset();
+};
+
+#if !defined(_WIN32)
+
+namespace
+{
+#if defined(MSG_NOSIGNAL)
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+#if defined(MSG_CMSG_CLOEXEC)
+    const int RECEIVE_FLAGS = MSG_CMSG_CLOEXEC;
+#else
+    const int RECEIVE_FLAGS = 0;
+#endif
+
+    //! Requests smaller than this are batched with others that arrive at the same time.
+    const uint64_t SMALL_REQUEST_SIZE = 256 * 1024;
+    const size_t MAXIMUM_BATCH_REQUEST_COUNT = 64;
+    const uint64_t MAXIMUM_BATCH_SIZE = 4 * 1024 * 1024;
+
+    //! Number of receive buffers kept from closed connections for new ones.
+    const size_t MAXIMUM_SPARE_BUFFER_COUNT = 64;
+
+    //! How long a client gets to make room for a response before it's dropped.
+    const int SEND_TIMEOUT_MS = 30000;
+
+    void setNonBlocking(int fd)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+    }
+
+    //! Sends everything, waiting for room as needed. Returns false if the client's gone.
+    bool sendAll(int socket, const void* pData, size_t size)
+    {
+        const char* pNext = static_cast<const char*>(pData);
+        while (size > 0)
+        {
+            const ssize_t sent = send(socket, pNext, size, SEND_FLAGS);
+            if (sent >= 0)
+            {
+                pNext += sent;
+                size -= static_cast<size_t>(sent);
+            }
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                pollfd fd = { socket, POLLOUT, 0 };
+                if (poll(&fd, 1, SEND_TIMEOUT_MS) <= 0)
+                    return false;
+            }
+            else if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The descriptors belong to the connection, which closes them.
+
+    void readDescriptor(int fd, std::vector<uint8_t>& data)
+    {
+        PositionalFile file(fd, "the input file", false);
+        data.resize(static_cast<size_t>(file.getSize()));
+        data.resize(static_cast<size_t>(file.readAt(data.data(), data.size(), 0)));
+    }
+
+    void writeDescriptor(int fd, const std::vector<uint8_t>& data)
+    {
+        PositionalFile file(fd, "the output file", false);
+        file.writeAt(data.data(), data.size(), 0);
+        file.setSize(data.size());
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::Connection::closeFds()
+{
+    for (int fd : m_fds)
+        close(fd);
+    m_fds.clear();
+}
+
+/**
+ * Gets ready for the next request.
+ *
+ * @since 2026 Oct 19
+ */
+void RepairServer::Connection::reset()
+{
+    closeFds();
+    m_request = {};
+    m_headerByteCount = 0;
+    m_inputByteCount = 0;
+    m_badRequest.clear();
+    m_isComplete = false;
+    m_isBusy = false;
+    m_isBroken = false;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairServer::RepairServer(const std::string& socketPath, unsigned workerCount, uint64_t maximumRequestSize) :
+    m_socketPath(socketPath),
+    m_maximumRequestSize(maximumRequestSize),
+    m_listenSocket(-1),
+    m_wakePipe{ -1, -1 },
+    m_isStopping(false),
+    m_repairedRequestCount(0),
+    m_failedRequestCount(0)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || (socketPath.size() >= sizeof(address.sun_path)))
+        throw std::runtime_error("Invalid socket path - " + socketPath);
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    struct stat status;
+    if (lstat(socketPath.c_str(), &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+            throw std::runtime_error("Something other than a socket is already at " + socketPath);
+        unlink(socketPath.c_str());
+    }
+
+    auto cleanupGuard = makeCallGuard([this]()
+    {
+        if (m_listenSocket != -1)
+            close(m_listenSocket);
+        if (m_wakePipe[0] != -1)
+            close(m_wakePipe[0]);
+        if (m_wakePipe[1] != -1)
+            close(m_wakePipe[1]);
+    });
+
+    if (pipe(m_wakePipe) != 0)
+        throw std::runtime_error(std::string("Could not start repair server - ") + strerror(errno));
+    setNonBlocking(m_wakePipe[0]);
+    setNonBlocking(m_wakePipe[1]);
+
+    m_listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenSocket == -1)
+        throw std::runtime_error(std::string("Could not create socket - ") + strerror(errno));
+    setNonBlocking(m_listenSocket);
+
+    if ((bind(m_listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) ||
+        (listen(m_listenSocket, SOMAXCONN) != 0))
+    {
+        throw std::runtime_error("Could not listen on " + socketPath + " - " + strerror(errno));
+    }
+
+    m_spWorkers = std::make_unique<RepairWorkerPool>(workerCount);
+    cleanupGuard.dismiss();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairServer::~RepairServer()
+{
+    m_spWorkers.reset();
+
+    while (!m_connections.empty())
+        closeConnection(m_connections.begin()->first);
+
+    close(m_listenSocket);
+    unlink(m_socketPath.c_str());
+    close(m_wakePipe[0]);
+    close(m_wakePipe[1]);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::run()
+{
+    std::vector<pollfd> fds;
+    std::vector<Connection*> requests;
+
+    while (!m_isStopping)
+    {
+        fds.clear();
+        fds.push_back({ m_wakePipe[0], POLLIN, 0 });
+        fds.push_back({ m_listenSocket, POLLIN, 0 });
+        for (const auto& entry : m_connections)
+        {
+            if (!entry.second->m_isBusy)
+                fds.push_back({ entry.first, POLLIN, 0 });
+        }
+
+        if (poll(fds.data(), fds.size(), -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("Error waiting for requests - ") + strerror(errno));
+        }
+
+        if (fds[0].revents != 0)
+        {
+            char discard[64];
+            while (read(m_wakePipe[0], discard, sizeof(discard)) > 0)
+                ;
+
+            std::vector<Connection*> returned;
+            {
+                std::lock_guard<std::mutex> lock(m_returnedMutex);
+                returned.swap(m_returnedConnections);
+            }
+
+            for (Connection* pConnection : returned)
+            {
+                if (pConnection->m_isBroken || !pConnection->m_badRequest.empty())
+                    closeConnection(pConnection->m_socket);
+                else
+                    pConnection->reset();
+            }
+        }
+
+        if (m_isStopping)
+            break;
+
+        if (fds[1].revents != 0)
+            acceptConnections();
+
+        for (size_t i = 2; i < fds.size(); ++i)
+        {
+            if (fds[i].revents == 0)
+                continue;
+
+            Connection& connection = *m_connections[fds[i].fd];
+            if (!readRequest(connection))
+            {
+                closeConnection(fds[i].fd);
+            }
+            else if (connection.m_isComplete)
+            {
+                connection.m_isBusy = true;
+                requests.push_back(&connection);
+            }
+        }
+
+        if (!requests.empty())
+        {
+            dispatchRequests(requests);
+            requests.clear();
+        }
+    }
+
+    // Let the workers finish what they started. Everything they have is
+    // handed back, and the clients have had their responses.
+    m_spWorkers->waitUntilIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_returnedMutex);
+        m_returnedConnections.clear();
+    }
+    while (!m_connections.empty())
+        closeConnection(m_connections.begin()->first);
+
+    m_isStopping = false;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::stop()
+{
+    // write() is one of the few things a signal handler is allowed to do.
+    m_isStopping = true;
+    const char wake = 1;
+    ssize_t written = write(m_wakePipe[1], &wake, 1);
+    (void)written;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::acceptConnections()
+{
+    for (;;)
+    {
+        const int socket = accept(m_listenSocket, nullptr, nullptr);
+        if (socket == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return; // Nothing more waiting, or nothing we can do about it.
+        }
+        setNonBlocking(socket);
+
+        auto spConnection = std::make_unique<Connection>();
+        spConnection->m_socket = socket;
+        if (!m_spareBuffers.empty())
+        {
+            spConnection->m_input.swap(m_spareBuffers.back());
+            m_spareBuffers.pop_back();
+        }
+
+        m_connections[socket] = std::move(spConnection);
+    }
+}
+
+/**
+ * Reads whatever's arrived of the connection's request. Returns false if
+ * the client has gone away.
+ *
+ * @since 2026 Oct 19
+ */
+bool RepairServer::readRequest(Connection& connection)
+{
+    while (!connection.m_isComplete)
+    {
+        ssize_t received = 0;
+        const bool isReadingHeader = (connection.m_headerByteCount < sizeof(connection.m_request));
+        if (isReadingHeader)
+        {
+            // Descriptors arrive with the header, so it has to be read with recvmsg().
+            iovec io = { reinterpret_cast<char*>(&connection.m_request) + connection.m_headerByteCount,
+                         sizeof(connection.m_request) - connection.m_headerByteCount };
+            alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))];
+
+            msghdr message = {};
+            message.msg_iov = &io;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            received = recvmsg(connection.m_socket, &message, RECEIVE_FLAGS);
+            if (received > 0)
+            {
+                for (cmsghdr* pControl = CMSG_FIRSTHDR(&message); pControl; pControl = CMSG_NXTHDR(&message, pControl))
+                {
+                    if ((pControl->cmsg_level != SOL_SOCKET) || (pControl->cmsg_type != SCM_RIGHTS))
+                        continue;
+
+                    const size_t fdCount = (pControl->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                    for (size_t i = 0; i < fdCount; ++i)
+                    {
+                        int fd;
+                        memcpy(&fd, CMSG_DATA(pControl) + i * sizeof(int), sizeof(fd));
+                        connection.m_fds.push_back(fd);
+                    }
+                }
+
+                if (message.msg_flags & MSG_CTRUNC)
+                    connection.m_badRequest = "Too many descriptors.";
+            }
+        }
+        else
+        {
+            received = recv(connection.m_socket, connection.m_input.data() + connection.m_inputByteCount,
+                connection.m_input.size() - connection.m_inputByteCount, 0);
+        }
+
+        if (received == 0)
+            return false;
+        if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+        }
+
+        if (!isReadingHeader)
+        {
+            connection.m_inputByteCount += static_cast<size_t>(received);
+            connection.m_isComplete = (connection.m_inputByteCount == connection.m_input.size());
+            continue;
+        }
+
+        connection.m_headerByteCount += static_cast<size_t>(received);
+        if (connection.m_headerByteCount < sizeof(connection.m_request))
+            continue;
+
+        const RepairRequestHeader& request = connection.m_request;
+        const bool isInputFd = (request.m_flags & REPAIR_REQUEST_INPUT_FD) != 0;
+        const bool isOutputFd = (request.m_flags & REPAIR_REQUEST_OUTPUT_FD) != 0;
+        const size_t expectedFdCount = (isInputFd ? 1 : 0) + (isOutputFd ? 1 : 0);
+
+        if (connection.m_badRequest.empty())
+        {
+            if (request.m_magic != REPAIR_REQUEST_MAGIC)
+                connection.m_badRequest = "Not a repair request.";
+            else if (connection.m_fds.size() != expectedFdCount)
+                connection.m_badRequest = "Expected " + std::to_string(expectedFdCount) + " descriptors.";
+            else if (isInputFd && (request.m_inputSize != 0))
+                connection.m_badRequest = "Input can't be sent along with an input descriptor.";
+            else if (request.m_inputSize > m_maximumRequestSize)
+                connection.m_badRequest = "Request too large.";
+        }
+
+        if (!connection.m_badRequest.empty())
+        {
+            connection.m_isComplete = true;
+        }
+        else
+        {
+            connection.m_input.resize(static_cast<size_t>(request.m_inputSize));
+            connection.m_isComplete = connection.m_input.empty();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Hands the requests to the workers. Small ones go in batches.
+ *
+ * @since 2026 Oct 19
+ */
+void RepairServer::dispatchRequests(std::vector<Connection*>& requests)
+{
+    auto submit = [this](std::vector<Connection*> connections)
+    {
+        m_spWorkers->submit([this, connections](RepairWorkspace& workspace)
+        {
+            for (Connection* pConnection : connections)
+                serveRequest(*pConnection, workspace);
+            returnConnections(connections);
+        });
+    };
+
+    std::vector<Connection*> batch;
+    uint64_t batchSize = 0;
+    for (Connection* pConnection : requests)
+    {
+        // There's no telling how big a file behind a descriptor is without
+        // asking, so those don't get batched.
+        const uint64_t size = pConnection->m_request.m_inputSize;
+        if ((pConnection->getInputFd() != -1) || (size >= SMALL_REQUEST_SIZE))
+        {
+            submit({ pConnection });
+            continue;
+        }
+
+        batch.push_back(pConnection);
+        batchSize += size;
+        if ((batch.size() >= MAXIMUM_BATCH_REQUEST_COUNT) || (batchSize >= MAXIMUM_BATCH_SIZE))
+        {
+            submit(std::move(batch));
+            batch.clear();
+            batchSize = 0;
+        }
+    }
+
+    if (!batch.empty())
+        submit(std::move(batch));
+}
+
+/**
+ * Repairs the connection's request and sends the response. Runs on a
+ * worker thread.
+ *
+ * @since 2026 Oct 19
+ */
+void RepairServer::serveRequest(Connection& connection, RepairWorkspace& workspace)
+{
+    STLREPAIR_TRACE_SCOPE("serve request", "server");
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    try
+    {
+        RepairResponseHeader response = {};
+        response.m_magic = REPAIR_RESPONSE_MAGIC;
+        const uint8_t* pPayload = nullptr;
+        std::string message;
+        RepairResult result;
+        uint64_t inputSize = 0;
+
+        if (!connection.m_badRequest.empty())
+        {
+            response.m_status = REPAIR_RESPONSE_BAD_REQUEST;
+            message = connection.m_badRequest;
+        }
+        else
+        {
+            try
+            {
+                const std::vector<uint8_t>* pInput = &connection.m_input;
+                if (connection.getInputFd() != -1)
+                {
+                    readDescriptor(connection.getInputFd(), workspace.m_input);
+                    pInput = &workspace.m_input;
+                }
+
+                const RepairRequestHeader& request = connection.m_request;
+                RepairOptions options = decodeRepairFlags(request.m_flags, request.m_triangleLimit);
+                if (request.m_flags & REPAIR_REQUEST_PLAN_REPAIRS)
+                    options = planRepairs(pInput->data(), pInput->size(), options);
+
+                inputSize = pInput->size();
+                workspace.m_output.clear();
+                result = repairSTL(pInput->data(), pInput->size(), workspace.m_output, options);
+
+                if (connection.getOutputFd() != -1)
+                    writeDescriptor(connection.getOutputFd(), workspace.m_output);
+                else
+                    pPayload = workspace.m_output.data();
+
+                response.m_status = REPAIR_RESPONSE_OK;
+                response.m_triangleCount = result.m_triangleCount;
+                response.m_skippedByteCount = result.m_skippedByteCount;
+                response.m_outputSize = workspace.m_output.size();
+                response.m_payloadSize = pPayload ? workspace.m_output.size() : 0;
+            }
+            catch (const std::exception& e)
+            {
+                response.m_status = REPAIR_RESPONSE_REPAIR_FAILED;
+                message = e.what();
+            }
+        }
+
+        const uint64_t durationNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+        if (response.m_status != REPAIR_RESPONSE_OK)
+        {
+            pPayload = reinterpret_cast<const uint8_t*>(message.data());
+            response.m_payloadSize = message.size();
+            ++m_failedRequestCount;
+            Metrics::recordFailure(MetricsSource::SERVE, durationNs);
+        }
+        else
+        {
+            ++m_repairedRequestCount;
+            Metrics::recordRepair(MetricsSource::SERVE, inputSize, result, durationNs);
+        }
+
+        connection.closeFds();
+        connection.m_isBroken = !sendAll(connection.m_socket, &response, sizeof(response)) ||
+            !sendAll(connection.m_socket, pPayload, static_cast<size_t>(response.m_payloadSize));
+    }
+    catch (...)
+    {
+        connection.m_isBroken = true;
+    }
+}
+
+/**
+ * Gives connections back to the event loop once their requests have been
+ * served. Runs on a worker thread.
+ *
+ * @since 2026 Oct 19
+ */
+void RepairServer::returnConnections(const std::vector<Connection*>& connections)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_returnedMutex);
+        m_returnedConnections.insert(m_returnedConnections.end(), connections.begin(), connections.end());
+    }
+
+    const char wake = 1;
+    ssize_t written = write(m_wakePipe[1], &wake, 1);
+    (void)written;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::closeConnection(int socket)
+{
+    auto found = m_connections.find(socket);
+    if (found == m_connections.end())
+        return;
+
+    Connection& connection = *found->second;
+    connection.closeFds();
+    if ((connection.m_input.capacity() <= MAXIMUM_RETAINED_WORKSPACE_BYTES) &&
+        (m_spareBuffers.size() < MAXIMUM_SPARE_BUFFER_COUNT))
+    {
+        m_spareBuffers.push_back(std::move(connection.m_input));
+    }
+
+    close(socket);
+    m_connections.erase(found);
+}
+
+#else
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::Connection::closeFds()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::Connection::reset()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairServer::RepairServer(const std::string& socketPath, unsigned /*workerCount*/, uint64_t maximumRequestSize) :
+    m_socketPath(socketPath),
+    m_maximumRequestSize(maximumRequestSize),
+    m_listenSocket(-1),
+    m_wakePipe{ -1, -1 },
+    m_isStopping(false),
+    m_repairedRequestCount(0),
+    m_failedRequestCount(0)
+{
+    throw std::runtime_error("Repair servers aren't supported on this platform.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairServer::~RepairServer()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::run()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::stop()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::acceptConnections()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool RepairServer::readRequest(Connection& /*connection*/)
+{
+    return false;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::dispatchRequests(std::vector<Connection*>& /*requests*/)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::serveRequest(Connection& /*connection*/, RepairWorkspace& /*workspace*/)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::returnConnections(const std::vector<Connection*>& /*connections*/)
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairServer::closeConnection(int /*socket*/)
+{
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef STLREPAIR_REPAIRSERVER__H_
+#define STLREPAIR_REPAIRSERVER__H_
+
+#include "RepairWorkerPool.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Largest request a RepairServer accepts by default, not counting files
+ * passed as descriptors.
+ */
+constexpr const uint64_t DEFAULT_MAXIMUM_REPAIR_REQUEST_SIZE = 1024ull * 1024 * 1024;
+
+/**
+ * Serves repairs over a Unix domain socket (see RepairProtocol.h and
+ * RepairClient). Requests are repaired in memory on a shared pool of
+ * workers. Small requests that arrive together are handed to a worker as
+ * one batch, so a flood of them doesn't pay for a queue round trip each.
+ * Connections keep their receive buffers between requests, and workers
+ * their output buffers.
+ *
+ * Not supported on Windows.
+ */
+class RepairServer
+{
+public:
+
+    /**
+     * Constructor. Starts listening. A stale socket file left behind by an
+     * earlier server is replaced. A thread count of 0 means one worker per
+     * core.
+     *
+     * @throws std::runtime_error if the socket can't be created, or there's
+     *         something other than a socket at the path.
+     */
+    RepairServer(const std::string& socketPath, unsigned workerCount = 0,
+        uint64_t maximumRequestSize = DEFAULT_MAXIMUM_REPAIR_REQUEST_SIZE);
+
+    //! Destructor. Removes the socket file.
+    ~RepairServer();
+
+    RepairServer(const RepairServer&) = delete;
+    RepairServer& operator=(const RepairServer&) = delete;
+
+    /**
+     * Serves requests until stop() is called. Requests already being
+     * repaired are finished, and their responses sent, before returning.
+     */
+    void run();
+
+    /**
+     * Makes run() return. Safe to call from any thread, and from a signal
+     * handler.
+     */
+    void stop();
+
+    //! Returns the number of requests repaired successfully.
+    uint64_t getRepairedRequestCount() const { return m_repairedRequestCount; }
+
+    //! Returns the number of requests that failed.
+    uint64_t getFailedRequestCount() const { return m_failedRequestCount; }
+
+private:
+
+    struct Connection;
+
+    void acceptConnections();
+    bool readRequest(Connection& connection);
+    void dispatchRequests(std::vector<Connection*>& requests);
+    void serveRequest(Connection& connection, RepairWorkspace& workspace);
+    void returnConnections(const std::vector<Connection*>& connections);
+    void closeConnection(int socket);
+
+    std::string m_socketPath;
+    uint64_t m_maximumRequestSize;
+    int m_listenSocket;
+    int m_wakePipe[2];
+    std::atomic<bool> m_isStopping;
+    std::map<int, std::unique_ptr<Connection>> m_connections;
+    std::vector<std::vector<uint8_t>> m_spareBuffers;
+    std::mutex m_returnedMutex;
+    std::vector<Connection*> m_returnedConnections;
+    std::unique_ptr<RepairWorkerPool> m_spWorkers;
+    std::atomic<uint64_t> m_repairedRequestCount;
+    std::atomic<uint64_t> m_failedRequestCount;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "RepairWorkerPool.h"
+#include "Parallel.h"
+#include "TraceRecorder.h"
+#include "Metrics.h"
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairWorkerPool::RepairWorkerPool(unsigned threadCount) :
+    m_runningJobCount(0),
+    m_isStopping(false)
+{
+    if (threadCount == 0)
+        threadCount = getWorkerThreadCount();
+
+    m_threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_threads.emplace_back([this]() { runJobs(); });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+RepairWorkerPool::~RepairWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairWorkerPool::submit(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+        Metrics::setQueueDepth(m_jobs.size());
+    }
+    m_jobAvailable.notify_one();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void RepairWorkerPool::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_isIdle.wait(lock, [this]() { return m_jobs.empty() && (m_runningJobCount == 0); });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+size_t RepairWorkerPool::getQueueDepth() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size();
+}
+
+/**
+ * Runs on each worker thread.
+ *
+ * @since 2026 Oct 19
+ */
+void RepairWorkerPool::runJobs()
+{
+    STLREPAIR_TRACE_THREAD_NAME("repair worker");
+
+    RepairWorkspace workspace;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_jobAvailable.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+        if (m_jobs.empty())
+            return; // Stopping, and nothing left to do.
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        Metrics::setQueueDepth(m_jobs.size());
+        ++m_runningJobCount;
+        lock.unlock();
+
+        try
+        {
+            STLREPAIR_TRACE_SCOPE("repair job", "scheduling");
+            job(workspace);
+        }
+        catch (...)
+        {
+        }
+        job = nullptr;
+
+        if (workspace.m_input.capacity() > MAXIMUM_RETAINED_WORKSPACE_BYTES)
+            std::vector<uint8_t>().swap(workspace.m_input);
+        if (workspace.m_output.capacity() > MAXIMUM_RETAINED_WORKSPACE_BYTES)
+            std::vector<uint8_t>().swap(workspace.m_output);
+
+        lock.lock();
+        --m_runningJobCount;
+        if (m_jobs.empty() && (m_runningJobCount == 0))
+            m_isIdle.notify_all();
+    }
+}
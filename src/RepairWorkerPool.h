@@ -0,0 +1,83 @@
+#ifndef STLREPAIR_REPAIRWORKERPOOL__H_
+#define STLREPAIR_REPAIRWORKERPOOL__H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Largest buffer a worker hangs on to between jobs. Anything bigger is
+ * released once the job that needed it is done.
+ */
+constexpr const size_t MAXIMUM_RETAINED_WORKSPACE_BYTES = 64 * 1024 * 1024;
+
+/**
+ * Scratch buffers belonging to one worker. They're handed to every job the
+ * worker runs, so repairs of similar sized files stop allocating after the
+ * first few.
+ */
+struct RepairWorkspace
+{
+    std::vector<uint8_t> m_input;
+    std::vector<uint8_t> m_output;
+};
+
+/**
+ * A fixed set of threads that run repair jobs, for the long-running modes
+ * where starting a thread (or a process) per file would cost more than the
+ * repair. Jobs run in the order they're submitted, each on whichever worker
+ * is free first.
+ */
+class RepairWorkerPool
+{
+public:
+
+    using Job = std::function<void(RepairWorkspace&)>;
+
+    /**
+     * Constructor. Starts the workers. A thread count of 0 means one per
+     * core.
+     */
+    explicit RepairWorkerPool(unsigned threadCount = 0);
+
+    //! Destructor. Runs whatever's still queued, then stops the workers.
+    ~RepairWorkerPool();
+
+    RepairWorkerPool(const RepairWorkerPool&) = delete;
+    RepairWorkerPool& operator=(const RepairWorkerPool&) = delete;
+
+    /**
+     * Queues a job. Jobs are expected to deal with their own errors.
+     * Anything a job throws is swallowed, so one bad file can't take a
+     * worker down.
+     */
+    void submit(Job job);
+
+    //! Blocks until the queue is empty and no job is running.
+    void waitUntilIdle();
+
+    //! Returns the number of jobs waiting for a worker.
+    size_t getQueueDepth() const;
+
+    //! Returns the number of workers.
+    size_t getThreadCount() const { return m_threads.size(); }
+
+private:
+
+    void runJobs();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_isIdle;
+    std::deque<Job> m_jobs;
+    size_t m_runningJobCount;
+    bool m_isStopping;
+    std::vector<std::thread> m_threads;
+};
+
+#endif
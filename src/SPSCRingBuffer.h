@@ -0,0 +1,108 @@
+#ifndef STLREPAIR_SPSCRINGBUFFER__H_
+#define STLREPAIR_SPSCRINGBUFFER__H_
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Fixed-capacity, lock-free queue for exactly one producer thread and one
+ * consumer thread.
+ *
+ * Neither side ever blocks. tryPush() fails when the queue is full and
+ * tryPop() fails when it's empty, and it's up to the caller to decide how to
+ * wait. See waitUntil().
+ */
+template<typename T>
+class SPSCRingBuffer
+{
+public:
+
+    /**
+     * Constructor. The capacity is rounded up to the next power of two.
+     */
+    explicit SPSCRingBuffer(size_t capacity) :
+        m_slots(roundUpToPowerOfTwo(capacity)),
+        m_mask(m_slots.size() - 1),
+        m_head(0),
+        m_tail(0)
+    {
+    }
+
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    //! Returns the maximum number of items the queue can hold.
+    size_t capacity() const { return m_slots.size(); }
+
+    /**
+     * Moves the item onto the back of the queue. Returns false, leaving the
+     * item untouched, if the queue is full. Producer thread only.
+     */
+    bool tryPush(T& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size())
+            return false;
+
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Moves the item at the front of the queue into item. Returns false if
+     * the queue is empty. Consumer thread only.
+     */
+    bool tryPop(T& item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        item = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    std::vector<T> m_slots;
+    const size_t m_mask;
+
+    // Kept on separate cache lines so the two threads don't fight over them.
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+/**
+ * Waits until the given condition is true. Spins briefly, then yields, then
+ * falls back to short sleeps, so a waiting thread doesn't hog a core when
+ * the other side of a queue is slow (say, stuck on a disk).
+ */
+template<typename Condition>
+void waitUntil(Condition condition)
+{
+    for (unsigned attempt = 0; !condition(); ++attempt)
+    {
+        if (attempt < 64)
+            continue;
+        else if (attempt < 256)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+#endif
@@ -2,8 +2,10 @@
 #include "FileUtils.h"
 #include "CallGuard.h"
 #include "BinarySTLFileReader.h"
+#include "CompressedByteStream.h"
 
 #include <stdexcept>
+#include <cstring>
 
 /**
  * @since 2024 Jan 21
@@ -32,6 +34,25 @@ STLFileType determineFileType(const std::string& stlFilePath)
     if (!FileUtils::fileExists(stlFilePath))
         throw std::runtime_error("Specified STL file does not exist - " + stlFilePath);
 
+    // A compressed file is judged by the start of what it holds.
+    if (detectCompressionFormat(stlFilePath) != CompressionFormat::NONE)
+    {
+        std::unique_ptr<ByteSource> spSource = openCompressedFileByteSource(stlFilePath);
+
+        uint8_t start[MINIMUM_BINARY_STL_SIZE_IN_BYTES];
+        size_t bytesRead = 0;
+        while (size_t bytes = spSource->read(start + bytesRead, sizeof(start) - bytesRead))
+            bytesRead += bytes;
+
+        if (bytesRead < 5)
+            return STLFileType::UNKNOWN;
+        if (memcmp(start, "solid", 5) == 0)
+            return STLFileType::ASCII;
+        if (bytesRead < sizeof(start))
+            return STLFileType::UNKNOWN;
+        return STLFileType::BINARY;
+    }
+
     auto fileSize = FileUtils::getFileSize(stlFilePath);
 
     FILE *pFile = fopen(stlFilePath.c_str(), "rb");
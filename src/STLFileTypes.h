@@ -2,6 +2,7 @@
 #define STLREPAIR_STLFILETYPES__H_
 
 #include <string>
+#include <array>
 #include <cstdint>
 
 constexpr const int BINARY_STL_HEADER_SIZE_IN_BYTES = 80;
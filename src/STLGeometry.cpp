@@ -0,0 +1,92 @@
+#include "STLGeometry.h"
+
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+    uint32_t toWeldBits(float value)
+    {
+        if (value == 0.0f)
+            value = 0.0f; // Folds -0.0 into +0.0.
+
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+BoundingBox::BoundingBox()
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    m_min = { inf, inf, inf };
+    m_max = { -inf, -inf, -inf };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void BoundingBox::extend(const Vec3& point)
+{
+    m_min.x = std::min(m_min.x, point.x);
+    m_min.y = std::min(m_min.y, point.y);
+    m_min.z = std::min(m_min.z, point.z);
+    m_max.x = std::max(m_max.x, point.x);
+    m_max.y = std::max(m_max.y, point.y);
+    m_max.z = std::max(m_max.z, point.z);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void BoundingBox::extend(const BoundingBox& box)
+{
+    if (box.isEmpty())
+        return;
+
+    extend(box.m_min);
+    extend(box.m_max);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool BoundingBox::isEmpty() const
+{
+    return m_min.x > m_max.x;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+Vec3 BoundingBox::center() const
+{
+    if (isEmpty())
+        return { 0.0f, 0.0f, 0.0f };
+
+    return { (m_min.x + m_max.x) * 0.5f,
+             (m_min.y + m_max.y) * 0.5f,
+             (m_min.z + m_max.z) * 0.5f };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+Vec3 computeCentroid(const STLFacet& facet)
+{
+    const float third = 1.0f / 3.0f;
+    return { (facet.vertices[0].x + facet.vertices[1].x + facet.vertices[2].x) * third,
+             (facet.vertices[0].y + facet.vertices[1].y + facet.vertices[2].y) * third,
+             (facet.vertices[0].z + facet.vertices[1].z + facet.vertices[2].z) * third };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::array<uint32_t, 3> computeVertexKey(const Vec3& vertex)
+{
+    return { toWeldBits(vertex.x), toWeldBits(vertex.y), toWeldBits(vertex.z) };
+}
@@ -0,0 +1,89 @@
+#ifndef STLREPAIR_STLGEOMETRY__H_
+#define STLREPAIR_STLGEOMETRY__H_
+
+#include "STLFileTypes.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Simple 3 component vector. This matches the in-file layout of the
+ * normal and vertices within a binary STL triangle.
+ */
+struct Vec3
+{
+    float x;
+    float y;
+    float z;
+};
+
+/**
+ * The decoded form of STLBinaryTriangleData.
+ */
+struct STLFacet
+{
+    Vec3 normal;
+    Vec3 vertices[3];
+};
+
+/**
+ * Axis aligned bounding box. A default constructed box is empty and
+ * will adopt the first point it's extended with.
+ */
+struct BoundingBox
+{
+    //! Constructor.
+    BoundingBox();
+
+    //! Grows the box to contain the given point.
+    void extend(const Vec3& point);
+
+    //! Grows the box to contain the given box.
+    void extend(const BoundingBox& box);
+
+    //! Returns true if nothing has been added to the box yet.
+    bool isEmpty() const;
+
+    //! Returns the center point of the box.
+    Vec3 center() const;
+
+    Vec3 m_min;
+    Vec3 m_max;
+};
+
+/**
+ * Decodes raw triangle data into its normal and vertices. The binary STL
+ * format is little-endian, as is every platform we currently build for.
+ */
+inline STLFacet decodeFacet(const STLBinaryTriangleData& triangleData)
+{
+    static_assert(sizeof(STLFacet) == BINARY_STL_TRIANGLE_SIZE_IN_BYTES,
+        "STLFacet must match the binary triangle layout.");
+
+    STLFacet facet;
+    memcpy(&facet, triangleData.data(), sizeof(facet));
+    return facet;
+}
+
+/**
+ * Encodes a facet back into raw triangle data.
+ */
+inline void encodeFacet(const STLFacet& facet, STLBinaryTriangleData& triangleData)
+{
+    memcpy(triangleData.data(), &facet, sizeof(facet));
+}
+
+/**
+ * Returns the centroid of the facet's three vertices.
+ */
+Vec3 computeCentroid(const STLFacet& facet);
+
+/**
+ * Returns a key uniquely identifying a vertex position. Vertices are welded
+ * only if they're bit-for-bit identical, with the exception of negative
+ * zero, which is folded into positive zero.
+ */
+std::array<uint32_t, 3> computeVertexKey(const Vec3& vertex);
+
+#endif
@@ -0,0 +1,197 @@
+#include "STLMerger.h"
+#include "BinarySTLFileReader.h"
+#include "MappedFile.h"
+#include "PositionalFile.h"
+#include "CompressedByteStream.h"
+#include "Parallel.h"
+#include "FileUtils.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const uint64_t FACET_RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    const uint64_t FILE_START_SIZE = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    // Facets repaired at a time, per thread.
+    const uint64_t REPAIR_BLOCK_SIZE_IN_BYTES = (1024 * 1024 / FACET_RECORD_SIZE) * FACET_RECORD_SIZE;
+
+    //! A piece of one input's facets, and where it goes.
+    struct MergeChunk
+    {
+        size_t m_input;
+        uint64_t m_inputOffset;
+        uint64_t m_outputOffset;
+        uint64_t m_size;
+    };
+
+    STLBinaryHeader readHeader(const std::string& filepath)
+    {
+        STLBinaryHeader header;
+        FILE* pFile = fopen(filepath.c_str(), "rb");
+        const bool isRead = pFile && (fread(header.data(), 1, header.size(), pFile) == header.size());
+        if (pFile)
+            fclose(pFile);
+        if (!isRead)
+            throw std::runtime_error("Could not read file header - " + filepath);
+
+        return header;
+    }
+
+    //! Makes the usual repairs to a block of whole facet records, in place.
+    void repairFacets(uint8_t* pRecords, uint64_t size, const MergeOptions& options, bool isTransforming)
+    {
+        for (uint8_t* pRecord = pRecords; pRecord < pRecords + size; pRecord += FACET_RECORD_SIZE)
+        {
+            if (isTransforming)
+            {
+                STLBinaryTriangleData triangleData;
+                memcpy(triangleData.data(), pRecord, triangleData.size());
+                options.m_transform.apply(triangleData);
+                memcpy(pRecord, triangleData.data(), triangleData.size());
+            }
+
+            if (options.m_zeroAttributeByteCounts)
+                memset(pRecord + BINARY_STL_TRIANGLE_SIZE_IN_BYTES, 0, BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES);
+        }
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::vector<MergeInput> planMerge(const std::vector<std::string>& inputFiles)
+{
+    if (inputFiles.empty())
+        throw std::runtime_error("Nothing to merge.");
+
+    std::vector<MergeInput> inputs(inputFiles.size());
+    uint64_t outputOffset = FILE_START_SIZE;
+    uint64_t totalFacetCount = 0;
+    for (size_t i = 0; i < inputFiles.size(); ++i)
+    {
+        const std::string& inputFile = inputFiles[i];
+        if (!FileUtils::fileExists(inputFile))
+            throw std::runtime_error("Specified STL file does not exist - " + inputFile);
+        if (FileUtils::getFileSize(inputFile) < MINIMUM_BINARY_STL_SIZE_IN_BYTES)
+            throw std::runtime_error("Specified file too small to be a binary STL - " + inputFile);
+        if (detectCompressionFormat(inputFile) != CompressionFormat::NONE)
+            throw std::runtime_error("Compressed STLs can't be merged - " + inputFile);
+
+        MergeInput& input = inputs[i];
+        input.m_filepath = inputFile;
+        input.m_declaredCount = readTriangleCount(inputFile);
+        input.m_calculatedCount = calculateTriangleCount(inputFile);
+        input.m_facetCount = std::min(input.m_declaredCount, input.m_calculatedCount);
+        input.m_outputOffset = outputOffset;
+
+        outputOffset += input.m_facetCount * FACET_RECORD_SIZE;
+        totalFacetCount += input.m_facetCount;
+        if (totalFacetCount > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("Too many facets to merge into one STL.");
+    }
+
+    return inputs;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint32_t mergeFiles(const std::vector<std::string>& inputFiles, const std::string& outputFile,
+    const MergeOptions& options)
+{
+    STLREPAIR_TRACE_SCOPE("merge", "merge");
+
+    const std::vector<MergeInput> inputs = planMerge(inputFiles);
+    uint32_t facetCount = 0;
+    for (const MergeInput& input : inputs)
+        facetCount += input.m_facetCount;
+
+    STLBinaryHeader header = readHeader(inputs.front().m_filepath);
+    if (options.m_zeroOutHeader)
+        memset(header.data(), 0, header.size());
+
+    PositionalFile output(outputFile, PositionalFileMode::WRITE, FILE_START_SIZE + facetCount * FACET_RECORD_SIZE);
+    {
+        uint8_t fileStart[FILE_START_SIZE];
+        memcpy(fileStart, header.data(), header.size());
+        memcpy(fileStart + header.size(), &facetCount, sizeof(facetCount));
+        output.writeAt(fileStart, sizeof(fileStart), 0);
+    }
+
+    const uint64_t maxChunkSize = (MERGE_CHUNK_SIZE_IN_BYTES / FACET_RECORD_SIZE) * FACET_RECORD_SIZE;
+    std::vector<MergeChunk> chunks;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        const uint64_t inputSize = inputs[i].m_facetCount * FACET_RECORD_SIZE;
+        for (uint64_t offset = 0; offset < inputSize; offset += maxChunkSize)
+        {
+            chunks.push_back({ i, FILE_START_SIZE + offset, inputs[i].m_outputOffset + offset,
+                std::min(maxChunkSize, inputSize - offset) });
+        }
+    }
+
+    const bool isTransforming = !options.m_transform.isIdentity();
+    const bool isChangingFacets = isTransforming || options.m_zeroAttributeByteCounts;
+    std::atomic<bool> canCopyFileRange(!isChangingFacets);
+
+    // Only mapped if they're needed, and then only once each.
+    std::mutex mappingMutex;
+    std::vector<std::unique_ptr<MappedFile>> mappings(inputs.size());
+    auto getMapping = [&](size_t input) -> const MappedFile&
+    {
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        if (!mappings[input])
+            mappings[input] = std::make_unique<MappedFile>(inputs[input].m_filepath);
+        return *mappings[input];
+    };
+
+    parallelFor(chunks.size(), [&](size_t begin, size_t end)
+    {
+        std::vector<uint8_t> buffer;
+        for (size_t i = begin; i < end; ++i)
+        {
+            STLREPAIR_TRACE_SCOPE("merge chunk", "merge");
+            MergeChunk chunk = chunks[i];
+
+            if (canCopyFileRange &&
+                !output.copyFrom(inputs[chunk.m_input].m_filepath, chunk.m_inputOffset, chunk.m_outputOffset, chunk.m_size))
+            {
+                canCopyFileRange = false;
+            }
+            if (chunk.m_size == 0)
+                continue;
+
+            const MappedFile& mapping = getMapping(chunk.m_input);
+            if (chunk.m_inputOffset + chunk.m_size > mapping.size())
+                throw std::runtime_error(inputs[chunk.m_input].m_filepath + " got shorter while it was being merged.");
+
+            const uint8_t* pSource = mapping.data() + chunk.m_inputOffset;
+            if (!isChangingFacets)
+            {
+                output.writeAt(pSource, chunk.m_size, chunk.m_outputOffset);
+                continue;
+            }
+
+            buffer.resize(static_cast<size_t>(REPAIR_BLOCK_SIZE_IN_BYTES));
+            for (uint64_t offset = 0; offset < chunk.m_size; offset += REPAIR_BLOCK_SIZE_IN_BYTES)
+            {
+                const uint64_t blockSize = std::min(REPAIR_BLOCK_SIZE_IN_BYTES, chunk.m_size - offset);
+                memcpy(buffer.data(), pSource + offset, static_cast<size_t>(blockSize));
+                repairFacets(buffer.data(), blockSize, options, isTransforming);
+                output.writeAt(buffer.data(), blockSize, chunk.m_outputOffset + offset);
+            }
+        }
+    }, 1);
+
+    output.close();
+    return facetCount;
+}
@@ -0,0 +1,67 @@
+#ifndef STLREPAIR_STLMERGER__H_
+#define STLREPAIR_STLMERGER__H_
+
+#include "AffineTransform.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Size of the pieces merge work is split into. Big enough that each is
+ * worth a thread, small enough that one huge input still spreads out.
+ */
+constexpr const uint64_t MERGE_CHUNK_SIZE_IN_BYTES = 64ull * 1024 * 1024;
+
+/**
+ * Repairs made to every input while merging.
+ */
+struct MergeOptions
+{
+    bool m_zeroOutHeader = false;
+    bool m_zeroAttributeByteCounts = false;
+    AffineTransform m_transform;
+};
+
+/**
+ * Where one input's facets come from and go to.
+ */
+struct MergeInput
+{
+    std::string m_filepath;
+    uint32_t m_declaredCount = 0;       //!< As readTriangleCount() has it.
+    uint32_t m_calculatedCount = 0;     //!< As calculateTriangleCount() has it.
+    uint32_t m_facetCount = 0;          //!< What's actually merged. The lesser of the two.
+    uint64_t m_outputOffset = 0;        //!< Where its first facet goes in the output.
+};
+
+/**
+ * Looks at the header and size of every input and works out where each
+ * one's facets go in the merged file. Facets past an input's declared
+ * count, or past the end of the file, aren't merged.
+ *
+ * @throws std::runtime_error if an input can't be read, is compressed or
+ *         is too small to be a binary STL, or if there'd be too many facets
+ *         for one file.
+ */
+std::vector<MergeInput> planMerge(const std::vector<std::string>& inputFiles);
+
+/**
+ * Merges binary STLs into one, with the first input's header and a count
+ * of all the facets. Facets go in input order.
+ *
+ * The inputs are planned (see planMerge()), the output is sized, and then
+ * the facets are copied in MERGE_CHUNK_SIZE_IN_BYTES pieces on every core.
+ * Where no repair changes the facets, they're copied with
+ * copy_file_range() on Linux, which never brings them into user space and
+ * can share blocks on file systems that support it. Otherwise they're read
+ * from a memory mapping, repaired, and written with pwrite().
+ *
+ * Returns the number of facets in the output.
+ *
+ * @throws std::runtime_error
+ */
+uint32_t mergeFiles(const std::vector<std::string>& inputFiles, const std::string& outputFile,
+    const MergeOptions& options = MergeOptions());
+
+#endif
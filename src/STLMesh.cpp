@@ -0,0 +1,65 @@
+#include "STLMesh.h"
+#include "FileUtils.h"
+
+#include <cstring>
+
+/**
+ * @since 2026 Oct 19
+ */
+STLMeshBuilder::STLMeshBuilder(STLMesh& mesh) :
+    m_mesh(mesh)
+{
+    memset(m_mesh.m_header.data(), 0, m_mesh.m_header.size());
+    m_mesh.m_triangles.clear();
+    m_mesh.m_attributeByteCounts.clear();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool STLMeshBuilder::onReadFileHeader(const STLBinaryHeader& header)
+{
+    m_mesh.m_header = header;
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool STLMeshBuilder::onReadTriangleCount(const uint32_t triangleCount)
+{
+    // The reported count can't be trusted (that's half the reason this tool
+    // exists), so it's ignored. readMesh() has already reserved room for as
+    // many triangles as the file's size allows, which never overshoots a
+    // truncated file.
+    (void)triangleCount;
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool STLMeshBuilder::onReadTriangle(const STLBinaryTriangleData& triangleData,
+    const uint16_t attributeByteCount)
+{
+    m_mesh.m_triangles.push_back(triangleData);
+    m_mesh.m_attributeByteCounts.push_back(attributeByteCount);
+    return true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+STLMesh readMesh(const std::string& pathToFile)
+{
+    STLMesh mesh;
+    STLMeshBuilder builder(mesh);
+    BinarySTLFileReader reader(pathToFile);
+
+    const uint32_t maxTriangles = calculateTriangleCount(pathToFile);
+    mesh.m_triangles.reserve(maxTriangles);
+    mesh.m_attributeByteCounts.reserve(maxTriangles);
+
+    reader.readFile(builder);
+    return mesh;
+}
@@ -0,0 +1,61 @@
+#ifndef STLREPAIR_STLMESH__H_
+#define STLREPAIR_STLMESH__H_
+
+#include "BinarySTLFileReader.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * An entire binary STL held in memory. Most of this tool streams triangles
+ * straight from reader to writer, but anything that needs to look at the
+ * mesh as a whole (connectivity, spatial queries, etc.) works on one of
+ * these.
+ *
+ * Only triangle data is kept. Anything the reader reports as unknown data
+ * is dropped.
+ */
+struct STLMesh
+{
+    //! Returns the number of triangles in the mesh.
+    size_t size() const { return m_triangles.size(); }
+
+    STLBinaryHeader m_header;
+    std::vector<STLBinaryTriangleData> m_triangles;
+    std::vector<uint16_t> m_attributeByteCounts;
+};
+
+/**
+ * Reader listener that accumulates everything it's given into an STLMesh.
+ */
+class STLMeshBuilder : public BinarySTLFileReaderListener
+{
+public:
+
+    //! Constructor.
+    explicit STLMeshBuilder(STLMesh& mesh);
+
+    //! Called whenever the file header is parsed.
+    bool onReadFileHeader(const STLBinaryHeader& header) override;
+
+    //! Called whenever the total triangle count has been parsed.
+    bool onReadTriangleCount(const uint32_t triangleCount) override;
+
+    //! Called whenever a triangle has been read.
+    bool onReadTriangle(const STLBinaryTriangleData& triangleData,
+        const uint16_t attributeByteCount) override;
+
+private:
+
+    STLMesh& m_mesh;
+};
+
+/**
+ * Reads the specified binary STL file entirely into memory.
+ *
+ * @throws std::runtime_error
+ */
+STLMesh readMesh(const std::string& pathToFile);
+
+#endif
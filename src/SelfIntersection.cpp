@@ -0,0 +1,122 @@
+#include "SelfIntersection.h"
+#include "FacetBVH.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+    struct Point
+    {
+        double x;
+        double y;
+        double z;
+    };
+
+    Point toPoint(const Vec3& vertex)
+    {
+        return { vertex.x, vertex.y, vertex.z };
+    }
+
+    /**
+     * Signed volume of the tetrahedron (a, b, c, d). Positive when d lies
+     * above the plane through a, b and c (counter-clockwise winding).
+     */
+    double orient(const Point& a, const Point& b, const Point& c, const Point& d)
+    {
+        const double abx = b.x - a.x, aby = b.y - a.y, abz = b.z - a.z;
+        const double acx = c.x - a.x, acy = c.y - a.y, acz = c.z - a.z;
+        const double adx = d.x - a.x, ady = d.y - a.y, adz = d.z - a.z;
+
+        return adx * (aby * acz - abz * acy) +
+               ady * (abz * acx - abx * acz) +
+               adz * (abx * acy - aby * acx);
+    }
+
+    /**
+     * Returns true if the segment (p, q) passes strictly through the
+     * interior of the triangle (a, b, c).
+     */
+    bool doesSegmentCrossTriangle(const Point& p, const Point& q,
+        const Point& a, const Point& b, const Point& c)
+    {
+        const double sideP = orient(a, b, c, p);
+        const double sideQ = orient(a, b, c, q);
+        if (!(((sideP > 0.0) && (sideQ < 0.0)) || ((sideP < 0.0) && (sideQ > 0.0))))
+            return false;
+
+        const double edgeAB = orient(p, q, a, b);
+        const double edgeBC = orient(p, q, b, c);
+        const double edgeCA = orient(p, q, c, a);
+
+        return ((edgeAB > 0.0) && (edgeBC > 0.0) && (edgeCA > 0.0)) ||
+               ((edgeAB < 0.0) && (edgeBC < 0.0) && (edgeCA < 0.0));
+    }
+
+    bool doesAnyEdgeCross(const Point (&edges)[3], const Point (&triangle)[3])
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            if (doesSegmentCrossTriangle(edges[i], edges[(i + 1) % 3],
+                    triangle[0], triangle[1], triangle[2]))
+                return true;
+        }
+        return false;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool doTrianglesIntersect(const STLFacet& facet1, const STLFacet& facet2)
+{
+    const Point triangle1[3] = { toPoint(facet1.vertices[0]),
+        toPoint(facet1.vertices[1]), toPoint(facet1.vertices[2]) };
+    const Point triangle2[3] = { toPoint(facet2.vertices[0]),
+        toPoint(facet2.vertices[1]), toPoint(facet2.vertices[2]) };
+
+    // Any non-coplanar intersection has an endpoint where an edge of one
+    // triangle passes through the other.
+    return doesAnyEdgeCross(triangle1, triangle2) || doesAnyEdgeCross(triangle2, triangle1);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::vector<std::pair<uint32_t, uint32_t>> findSelfIntersections(const STLMesh& mesh)
+{
+    FacetBVH bvh(mesh);
+
+    std::vector<std::pair<uint32_t, uint32_t>> intersections;
+    std::mutex intersectionsMutex;
+
+    // Leaves are visited in Morton order, so neighbouring queries on a
+    // thread walk mostly the same nodes.
+    parallelFor(bvh.leafCount(), [&](size_t begin, size_t end)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> found;
+
+        for (size_t leaf = begin; leaf < end; ++leaf)
+        {
+            const uint32_t triangle = bvh.triangleIndex(static_cast<uint32_t>(leaf));
+            const STLFacet facet = decodeFacet(mesh.m_triangles[triangle]);
+
+            bvh.forEachOverlappingLeaf(static_cast<uint32_t>(leaf), [&](uint32_t otherLeaf)
+            {
+                const uint32_t otherTriangle = bvh.triangleIndex(otherLeaf);
+                if (doTrianglesIntersect(facet, decodeFacet(mesh.m_triangles[otherTriangle])))
+                    found.emplace_back(std::min(triangle, otherTriangle), std::max(triangle, otherTriangle));
+            });
+        }
+
+        if (!found.empty())
+        {
+            std::lock_guard<std::mutex> lock(intersectionsMutex);
+            intersections.insert(intersections.end(), found.begin(), found.end());
+        }
+    }, 256);
+
+    std::sort(intersections.begin(), intersections.end());
+    return intersections;
+}
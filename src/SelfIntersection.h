@@ -0,0 +1,29 @@
+#ifndef STLREPAIR_SELFINTERSECTION__H_
+#define STLREPAIR_SELFINTERSECTION__H_
+
+#include "STLMesh.h"
+#include "STLGeometry.h"
+
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Returns true if the two triangles properly intersect, meaning an edge of
+ * one passes through the interior of the other.
+ *
+ * Triangles that merely touch (shared vertices or edges, as neighbouring
+ * facets always do) are not considered intersecting. Neither are coplanar
+ * overlaps, which are a different kind of defect.
+ */
+bool doTrianglesIntersect(const STLFacet& facet1, const STLFacet& facet2);
+
+/**
+ * Finds every pair of self-intersecting triangles in the mesh using a
+ * FacetBVH. The work is spread across all cores.
+ *
+ * @return Pairs of mesh triangle indices, with first < second, sorted.
+ */
+std::vector<std::pair<uint32_t, uint32_t>> findSelfIntersections(const STLMesh& mesh);
+
+#endif
@@ -0,0 +1,343 @@
+#include "ShardWriter.h"
+#include "BinarySTLFileReader.h"
+#include "PositionalFile.h"
+#include "RepairWorkerPool.h"
+#include "Parallel.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+#include "Contracts.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const uint64_t FACET_RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+    const uint64_t FILE_START_SIZE = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+    float getComponent(const Vec3& vector, int axis)
+    {
+        return (axis == 0) ? vector.x : ((axis == 1) ? vector.y : vector.z);
+    }
+
+    /**
+     * Sorts facets into shards as they're read, handing each shard's buffer
+     * to the writer threads whenever it fills up.
+     */
+    class ShardingListener : public BinarySTLFileReaderListener
+    {
+    public:
+
+        ShardingListener(const ShardPlan& plan, const ShardOptions& options,
+            const std::vector<std::string>& outputPaths, unsigned threadCount) :
+            m_plan(plan),
+            m_options(options),
+            m_isTransforming(!options.m_transform.isIdentity()),
+            m_facetIndex(0),
+            m_maxBuffersInFlight(threadCount * 2),
+            m_buffersInFlight(0),
+            m_pool(threadCount)
+        {
+            memset(m_header.data(), 0, m_header.size());
+
+            m_shards.resize(outputPaths.size());
+            for (size_t i = 0; i < outputPaths.size(); ++i)
+            {
+                m_shards[i].m_spFile = std::make_unique<PositionalFile>(outputPaths[i]);
+                m_shards[i].m_buffer.reserve(SHARD_BUFFER_FACET_COUNT * FACET_RECORD_SIZE);
+            }
+        }
+
+        bool onReadFileHeader(const STLBinaryHeader& header) override
+        {
+            if (!m_options.m_zeroOutHeader)
+                m_header = header;
+            return true;
+        }
+
+        bool onReadTriangleCount(const uint32_t /*triangleCount*/) override
+        {
+            return true;
+        }
+
+        bool onReadTriangle(const STLBinaryTriangleData& triangleData, const uint16_t attributeByteCount) override
+        {
+            Shard& shard = m_shards[m_plan.getShard(m_facetIndex++, decodeFacet(triangleData))];
+
+            STLBinaryTriangleData outputData = triangleData;
+            if (m_isTransforming)
+                m_options.m_transform.apply(outputData);
+            const uint16_t outputAttributeByteCount = m_options.m_zeroAttributeByteCounts ? 0 : attributeByteCount;
+
+            std::vector<uint8_t>& buffer = shard.m_buffer;
+            buffer.insert(buffer.end(), outputData.begin(), outputData.end());
+            const uint8_t* pAttributeByteCount = reinterpret_cast<const uint8_t*>(&outputAttributeByteCount);
+            buffer.insert(buffer.end(), pAttributeByteCount, pAttributeByteCount + sizeof(outputAttributeByteCount));
+            ++shard.m_facetCount;
+
+            if (buffer.size() >= SHARD_BUFFER_FACET_COUNT * FACET_RECORD_SIZE)
+                submit(shard);
+            return true;
+        }
+
+        bool onReadUnknownData(const uint8_t* const /*pData*/, const size_t /*dataSize*/) override
+        {
+            // Junk doesn't go in any shard.
+            return true;
+        }
+
+        /**
+         * Writes whatever's still buffered, then each shard's header and
+         * count, and closes the shards.
+         */
+        void finish()
+        {
+            for (Shard& shard : m_shards)
+            {
+                if (!shard.m_buffer.empty())
+                    submit(shard);
+            }
+            m_pool.waitUntilIdle();
+            throwIfFailed();
+
+            STLREPAIR_TRACE_SCOPE("write shard headers", "shard");
+            for (Shard& shard : m_shards)
+            {
+                uint8_t fileStart[FILE_START_SIZE];
+                memcpy(fileStart, m_header.data(), m_header.size());
+                memcpy(fileStart + m_header.size(), &shard.m_facetCount, sizeof(shard.m_facetCount));
+                shard.m_spFile->writeAt(fileStart, sizeof(fileStart), 0);
+                shard.m_spFile->close();
+            }
+        }
+
+    private:
+
+        struct Shard
+        {
+            std::unique_ptr<PositionalFile> m_spFile;
+            std::vector<uint8_t> m_buffer;
+            uint32_t m_facetCount = 0;
+            uint64_t m_nextOffset = FILE_START_SIZE;
+        };
+
+        //! Hands the shard's buffer to a writer thread, at the next offset in the shard.
+        void submit(Shard& shard)
+        {
+            auto spBuffer = std::make_shared<std::vector<uint8_t>>();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_bufferReturned.wait(lock, [this]() { return m_buffersInFlight < m_maxBuffersInFlight; });
+                ++m_buffersInFlight;
+
+                if (!m_freeBuffers.empty())
+                {
+                    *spBuffer = std::move(m_freeBuffers.back());
+                    m_freeBuffers.pop_back();
+                }
+            }
+            throwIfFailed();
+
+            spBuffer->swap(shard.m_buffer);
+            shard.m_buffer.clear();
+            shard.m_buffer.reserve(SHARD_BUFFER_FACET_COUNT * FACET_RECORD_SIZE);
+
+            const uint64_t offset = shard.m_nextOffset;
+            shard.m_nextOffset += spBuffer->size();
+
+            PositionalFile* pFile = shard.m_spFile.get();
+            m_pool.submit([this, pFile, spBuffer, offset](RepairWorkspace&)
+            {
+                std::string error;
+                try
+                {
+                    STLREPAIR_TRACE_SCOPE("pwrite", "shard");
+                    pFile->writeAt(spBuffer->data(), spBuffer->size(), offset);
+                }
+                catch (const std::exception& e)
+                {
+                    error = e.what();
+                }
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_error.empty())
+                    m_error = error;
+                m_freeBuffers.push_back(std::move(*spBuffer));
+                --m_buffersInFlight;
+                m_bufferReturned.notify_one();
+            });
+        }
+
+        void throwIfFailed()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error.empty())
+                throw std::runtime_error(m_error);
+        }
+
+        const ShardPlan& m_plan;
+        const ShardOptions& m_options;
+        const bool m_isTransforming;
+        STLBinaryHeader m_header;
+        uint32_t m_facetIndex;
+        std::vector<Shard> m_shards;
+
+        // Shared with the writer threads.
+        std::mutex m_mutex;
+        std::condition_variable m_bufferReturned;
+        std::vector<std::vector<uint8_t>> m_freeBuffers;
+        const size_t m_maxBuffersInFlight;
+        size_t m_buffersInFlight;
+        std::string m_error;
+
+        // Last, so the writers are done before anything they use goes away.
+        RepairWorkerPool m_pool;
+    };
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+ShardPlan::ShardPlan(const ShardOptions& options, uint32_t facetCount, const BoundingBox& bounds) :
+    m_mode(options.m_mode),
+    m_shardCount(1),
+    m_facetCount(facetCount),
+    m_facetsPerShard(0),
+    m_bounds(bounds),
+    m_axis(0)
+{
+    switch (m_mode)
+    {
+    case ShardMode::FACET_RANGE:
+    case ShardMode::SLABS:
+        precondition_throw(options.m_shardCount > 0, std::runtime_error("There must be at least one shard."));
+        m_shardCount = options.m_shardCount;
+        break;
+
+    case ShardMode::MAX_BYTES:
+        if (options.m_maxShardBytes < FILE_START_SIZE + FACET_RECORD_SIZE)
+            throw std::runtime_error("Shards must be big enough for at least one facet.");
+
+        m_facetsPerShard = (options.m_maxShardBytes - FILE_START_SIZE) / FACET_RECORD_SIZE;
+        m_shardCount = static_cast<uint32_t>(std::max<uint64_t>((facetCount + m_facetsPerShard - 1) / m_facetsPerShard, 1));
+        break;
+
+    case ShardMode::OCTANTS:
+        m_shardCount = 8;
+        break;
+    }
+
+    if ((m_mode == ShardMode::SLABS) && !m_bounds.isEmpty())
+    {
+        const float extents[3] = { m_bounds.m_max.x - m_bounds.m_min.x,
+                                   m_bounds.m_max.y - m_bounds.m_min.y,
+                                   m_bounds.m_max.z - m_bounds.m_min.z };
+        m_axis = static_cast<int>(std::max_element(extents, extents + 3) - extents);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint32_t ShardPlan::getShard(uint32_t facetIndex, const STLFacet& facet) const
+{
+    switch (m_mode)
+    {
+    case ShardMode::FACET_RANGE:
+        return static_cast<uint32_t>(std::min<uint64_t>(
+            (uint64_t(facetIndex) * m_shardCount) / std::max<uint32_t>(m_facetCount, 1), m_shardCount - 1));
+
+    case ShardMode::MAX_BYTES:
+        return static_cast<uint32_t>(std::min<uint64_t>(facetIndex / m_facetsPerShard, m_shardCount - 1));
+
+    case ShardMode::SLABS:
+    {
+        // Centroids outside the (possibly sampled) bounds go in the end slabs.
+        const float min = getComponent(m_bounds.m_min, m_axis);
+        const float extent = getComponent(m_bounds.m_max, m_axis) - min;
+        const float slab = (getComponent(computeCentroid(facet), m_axis) - min) / extent * m_shardCount;
+        if (!(slab > 0.0f))
+            return 0;
+        return (slab >= m_shardCount) ? m_shardCount - 1 : static_cast<uint32_t>(slab);
+    }
+
+    case ShardMode::OCTANTS:
+    {
+        const Vec3 centroid = computeCentroid(facet);
+        const Vec3 center = m_bounds.center();
+        return (centroid.x >= center.x ? 1 : 0) | (centroid.y >= center.y ? 2 : 0) | (centroid.z >= center.z ? 4 : 0);
+    }
+    }
+
+    return 0;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::vector<std::string> shardFile(const std::string& inputFile, const ShardOptions& options, unsigned threadCount)
+{
+    BinarySTLFileReader reader(inputFile);
+
+    // Facets past the declared count are junk as far as the reader's
+    // concerned, and so are any past the end of the file.
+    const uint32_t facetCount = std::min(readTriangleCount(inputFile), calculateTriangleCount(inputFile));
+
+    BoundingBox bounds;
+    if ((options.m_mode == ShardMode::SLABS) || (options.m_mode == ShardMode::OCTANTS))
+        bounds = scanBoundingBox(inputFile);
+
+    const ShardPlan plan(options, facetCount, bounds);
+
+    // Paths are picked up front, so no two shards can end up with the same one.
+    std::string dir, base, ext;
+    FileUtils::splitPath(inputFile, dir, base, ext);
+
+    std::vector<std::string> outputPaths(plan.getShardCount());
+    for (uint32_t shard = 0; shard < plan.getShardCount(); ++shard)
+        outputPaths[shard] = FileUtils::generateUniqueFilePath(dir + base + "_shard" + std::to_string(shard + 1) + "." + ext);
+
+    if (threadCount == 0)
+        threadCount = getWorkerThreadCount();
+    threadCount = std::min(threadCount, plan.getShardCount());
+
+    // Written under temp names, and only committed once they're all done.
+    std::vector<std::string> tempPaths(outputPaths.size());
+    for (size_t shard = 0; shard < outputPaths.size(); ++shard)
+        tempPaths[shard] = makeTempOutputPath(outputPaths[shard]);
+
+    auto removeGuard = makeCallGuard([&]()
+    {
+        for (size_t shard = 0; shard < outputPaths.size(); ++shard)
+        {
+            remove(tempPaths[shard].c_str());
+            remove(outputPaths[shard].c_str());
+        }
+    });
+
+    {
+        ShardingListener listener(plan, options, tempPaths, threadCount);
+        reader.readFile(listener);
+        listener.finish();
+    }
+
+    {
+        // Committing them all at once lets GROUP_COMMIT share the flushes.
+        STLREPAIR_TRACE_SCOPE("commit shards", "shard");
+        OutputCommitter committer(options.m_durability);
+        parallelFor(outputPaths.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t shard = begin; shard < end; ++shard)
+                committer.commit(tempPaths[shard], outputPaths[shard]);
+        }, 1);
+    }
+
+    removeGuard.dismiss();
+    return outputPaths;
+}
@@ -0,0 +1,97 @@
+#ifndef STLREPAIR_SHARDWRITER__H_
+#define STLREPAIR_SHARDWRITER__H_
+
+#include "AffineTransform.h"
+#include "OutputCommitter.h"
+#include "STLGeometry.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * How the facets of a file are divided between shards.
+ */
+enum class ShardMode
+{
+    FACET_RANGE,    //!< m_shardCount runs of consecutive facets, as equal as can be.
+    MAX_BYTES,      //!< Runs of consecutive facets, as few as fit in m_maxShardBytes each.
+    SLABS,          //!< m_shardCount equal slabs along the longest axis, by centroid.
+    OCTANTS         //!< The eight octants about the center of the bounding box, by centroid.
+};
+
+/**
+ * Facets buffered for each shard before they're handed to a writer thread.
+ */
+constexpr const uint32_t SHARD_BUFFER_FACET_COUNT = 8192;
+
+/**
+ * How a file is to be sharded, and the repairs to make along the way.
+ */
+struct ShardOptions
+{
+    ShardMode m_mode = ShardMode::FACET_RANGE;
+    uint32_t m_shardCount = 2;          //!< For FACET_RANGE and SLABS.
+    uint64_t m_maxShardBytes = 0;       //!< For MAX_BYTES. Includes the header and count.
+
+    bool m_zeroOutHeader = false;
+    bool m_zeroAttributeByteCounts = false;
+    AffineTransform m_transform;
+
+    DurabilityPolicy m_durability = DurabilityPolicy::NONE;     //!< How the finished shards are committed.
+};
+
+/**
+ * Decides which shard each facet goes to.
+ */
+class ShardPlan
+{
+public:
+
+    /**
+     * Constructor. The bounding box is only needed for the spatial modes.
+     *
+     * @throws std::runtime_error if the options don't make sense, e.g., a
+     *         shard size too small for even one facet.
+     */
+    ShardPlan(const ShardOptions& options, uint32_t facetCount, const BoundingBox& bounds = BoundingBox());
+
+    //! Returns the number of shards. Some may end up empty.
+    uint32_t getShardCount() const { return m_shardCount; }
+
+    //! Returns the shard the facet with the given index belongs in.
+    uint32_t getShard(uint32_t facetIndex, const STLFacet& facet) const;
+
+private:
+
+    ShardMode m_mode;
+    uint32_t m_shardCount;
+    uint32_t m_facetCount;
+    uint64_t m_facetsPerShard;
+    BoundingBox m_bounds;
+    int m_axis;
+};
+
+/**
+ * Splits the binary STL into shards, each a valid binary STL with its own
+ * header and count, named after the input (model_shard1.stl, ...). The
+ * input is read once. Each shard's facets are buffered, and full buffers
+ * are written at offsets reserved for them with pwrite() from a pool of
+ * threads, so shards are written concurrently, and in order.
+ *
+ * Shards are written to temp files and only committed under their final
+ * names, with an OutputCommitter, once every one of them is complete.
+ *
+ * Junk after the last facet, or past the declared count, is dropped. The
+ * spatial modes need the bounding box first, which takes a quick pre-scan
+ * (see scanBoundingBox()).
+ *
+ * Returns the paths of the shards written. If anything goes wrong, none
+ * are left behind.
+ *
+ * @throws std::runtime_error
+ */
+std::vector<std::string> shardFile(const std::string& inputFile, const ShardOptions& options,
+    unsigned threadCount = 0);
+
+#endif
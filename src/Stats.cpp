@@ -0,0 +1,293 @@
+#include "Stats.h"
+#include "TraceRecorder.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    const size_t PHASE_COUNT = static_cast<size_t>(StatsPhase::PHASE_COUNT);
+
+    const char* const PHASE_NAMES[PHASE_COUNT] = {
+        "probe", "cache", "read", "filter", "write", "patch", "commit", "verify", "diff" };
+
+    struct PhaseCounters
+    {
+        std::atomic<uint64_t> m_wallTimeNs{ 0 };
+        std::atomic<uint64_t> m_scopeCount{ 0 };
+        std::atomic<uint64_t> m_byteCount{ 0 };
+        std::atomic<uint64_t> m_facetCount{ 0 };
+    };
+
+    std::atomic<bool> s_isEnabled(false);
+    std::atomic<uint64_t> s_enabledAtNs(0);
+    PhaseCounters s_phases[PHASE_COUNT];
+
+    //! The innermost phase timer running on this thread.
+    thread_local ScopedPhaseTimer* t_pCurrentTimer = nullptr;
+
+    uint64_t nowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    PhaseCounters& getCounters(StatsPhase phase)
+    {
+        return s_phases[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * Fills in the syscall counts and peak RSS, as far as the platform
+     * lets us.
+     */
+    void readProcessStats(StatsReport& report)
+    {
+#if defined(_WIN32)
+        IO_COUNTERS ioCounters;
+        if (GetProcessIoCounters(GetCurrentProcess(), &ioCounters))
+        {
+            report.m_readSyscallCount = static_cast<int64_t>(ioCounters.ReadOperationCount);
+            report.m_writeSyscallCount = static_cast<int64_t>(ioCounters.WriteOperationCount);
+        }
+
+        PROCESS_MEMORY_COUNTERS memoryCounters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+            report.m_peakResidentBytes = static_cast<int64_t>(memoryCounters.PeakWorkingSetSize);
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+#if defined(__APPLE__)
+            report.m_peakResidentBytes = static_cast<int64_t>(usage.ru_maxrss);
+#else
+            report.m_peakResidentBytes = static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+        }
+
+#if defined(__linux__)
+        FILE* pFile = fopen("/proc/self/io", "r");
+        if (pFile)
+        {
+            char name[32];
+            long long value = 0;
+            while (fscanf(pFile, "%31s %lld", name, &value) == 2)
+            {
+                if (strcmp(name, "syscr:") == 0)
+                    report.m_readSyscallCount = value;
+                else if (strcmp(name, "syscw:") == 0)
+                    report.m_writeSyscallCount = value;
+            }
+            fclose(pFile);
+        }
+#endif
+#endif
+    }
+
+    std::string formatMilliseconds(uint64_t wallTimeNs)
+    {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(3) << (wallTimeNs / 1.0e6);
+        return stream.str();
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Stats::setEnabled(bool isEnabled)
+{
+    if (isEnabled)
+    {
+        for (auto& counters : s_phases)
+        {
+            counters.m_wallTimeNs = 0;
+            counters.m_scopeCount = 0;
+            counters.m_byteCount = 0;
+            counters.m_facetCount = 0;
+        }
+        s_enabledAtNs = nowNs();
+    }
+
+    s_isEnabled = isEnabled;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool Stats::isEnabled()
+{
+    return s_isEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Stats::addBytes(StatsPhase phase, uint64_t byteCount)
+{
+    if (isEnabled())
+        getCounters(phase).m_byteCount.fetch_add(byteCount, std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Stats::addFacets(StatsPhase phase, uint64_t facetCount)
+{
+    if (isEnabled())
+        getCounters(phase).m_facetCount.fetch_add(facetCount, std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void Stats::addScope(StatsPhase phase, uint64_t wallTimeNs)
+{
+    if (!isEnabled())
+        return;
+
+    PhaseCounters& counters = getCounters(phase);
+    counters.m_wallTimeNs.fetch_add(wallTimeNs, std::memory_order_relaxed);
+    counters.m_scopeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+StatsReport Stats::getReport()
+{
+    StatsReport report;
+    report.m_totalWallTimeNs = nowNs() - s_enabledAtNs;
+
+    for (size_t phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        PhaseStats stats;
+        stats.m_name = PHASE_NAMES[phase];
+        stats.m_wallTimeNs = s_phases[phase].m_wallTimeNs;
+        stats.m_scopeCount = s_phases[phase].m_scopeCount;
+        stats.m_byteCount = s_phases[phase].m_byteCount;
+        stats.m_facetCount = s_phases[phase].m_facetCount;
+        report.m_phases.push_back(stats);
+    }
+
+    readProcessStats(report);
+
+    return report;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+ScopedPhaseTimer::ScopedPhaseTimer(StatsPhase phase) :
+    m_phase(phase),
+    m_isActive(Stats::isEnabled() || TraceRecorder::isRecording()),
+    m_startNs(0),
+    m_nestedNs(0),
+    m_pOuterTimer(nullptr)
+{
+    if (!m_isActive)
+        return;
+
+    m_pOuterTimer = t_pCurrentTimer;
+    t_pCurrentTimer = this;
+    m_startNs = nowNs();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+ScopedPhaseTimer::~ScopedPhaseTimer()
+{
+    if (!m_isActive)
+        return;
+
+    const uint64_t elapsedNs = nowNs() - m_startNs;
+    if (Stats::isEnabled())
+        Stats::addScope(m_phase, elapsedNs - m_nestedNs);
+    if (TraceRecorder::isRecording())
+        TraceRecorder::recordEvent(PHASE_NAMES[static_cast<size_t>(m_phase)], "phase", m_startNs, elapsedNs);
+
+    if (m_pOuterTimer)
+        m_pOuterTimer->m_nestedNs += elapsedNs;
+    t_pCurrentTimer = m_pOuterTimer;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string formatStatsText(const StatsReport& report)
+{
+    std::ostringstream stream;
+    stream << "Statistics:\n";
+    stream << "  " << std::left << std::setw(8) << "phase" << std::right
+           << std::setw(12) << "ms" << std::setw(10) << "scopes"
+           << std::setw(14) << "bytes" << std::setw(12) << "facets" << std::setw(10) << "MB/s" << "\n";
+
+    for (const PhaseStats& phase : report.m_phases)
+    {
+        if (phase.m_scopeCount == 0)
+            continue;
+
+        const double seconds = phase.m_wallTimeNs / 1.0e9;
+        const double megabytesPerSecond = (seconds > 0.0) ? (phase.m_byteCount / 1.0e6) / seconds : 0.0;
+
+        stream << "  " << std::left << std::setw(8) << phase.m_name << std::right
+               << std::setw(12) << formatMilliseconds(phase.m_wallTimeNs)
+               << std::setw(10) << phase.m_scopeCount
+               << std::setw(14) << phase.m_byteCount
+               << std::setw(12) << phase.m_facetCount
+               << std::setw(10) << std::fixed << std::setprecision(1) << megabytesPerSecond << "\n";
+    }
+
+    stream << "  total " << formatMilliseconds(report.m_totalWallTimeNs) << " ms\n";
+    if (report.m_readSyscallCount >= 0)
+        stream << "  read syscalls " << report.m_readSyscallCount << ", write syscalls " << report.m_writeSyscallCount << "\n";
+    if (report.m_peakResidentBytes >= 0)
+        stream << "  peak RSS " << (report.m_peakResidentBytes / 1024) << " KiB\n";
+
+    return stream.str();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+std::string formatStatsJson(const StatsReport& report)
+{
+    std::ostringstream stream;
+    stream << "{\"total_wall_ns\":" << report.m_totalWallTimeNs << ",\"phases\":{";
+
+    bool isFirst = true;
+    for (const PhaseStats& phase : report.m_phases)
+    {
+        if (phase.m_scopeCount == 0)
+            continue;
+
+        stream << (isFirst ? "" : ",") << "\"" << phase.m_name << "\":{"
+               << "\"wall_ns\":" << phase.m_wallTimeNs
+               << ",\"scopes\":" << phase.m_scopeCount
+               << ",\"bytes\":" << phase.m_byteCount
+               << ",\"facets\":" << phase.m_facetCount << "}";
+        isFirst = false;
+    }
+
+    stream << "}";
+    if (report.m_readSyscallCount >= 0)
+        stream << ",\"read_syscalls\":" << report.m_readSyscallCount << ",\"write_syscalls\":" << report.m_writeSyscallCount;
+    if (report.m_peakResidentBytes >= 0)
+        stream << ",\"peak_rss_bytes\":" << report.m_peakResidentBytes;
+    stream << "}";
+
+    return stream.str();
+}
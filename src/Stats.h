@@ -0,0 +1,135 @@
+#ifndef STLREPAIR_STATS__H_
+#define STLREPAIR_STATS__H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Low-overhead instrumentation. Code is divided into phases with
+ * STLREPAIR_STATS_PHASE(), which times the rest of the enclosing scope, and
+ * work done is tallied with STLREPAIR_STATS_COUNT_BYTES() and
+ * STLREPAIR_STATS_COUNT_FACETS(). Nothing is recorded unless
+ * Stats::setEnabled(true) has been called, and defining
+ * STLREPAIR_DISABLE_STATS compiles every hook away entirely.
+ *
+ * Phase times are exclusive. Time spent in a nested phase counts towards
+ * that phase only, so the phase times add up to the time spent in phases.
+ */
+enum class StatsPhase
+{
+    PROBE,      //!< Looking the input over before repairing it.
+    CACHE,      //!< Hashing the input and looking it up in the repair cache.
+    READ,       //!< Pulling input from its source.
+    FILTER,     //!< Running batches through the filter stages.
+    WRITE,      //!< Pushing output to its sink.
+    PATCH,      //!< Going back to fix up the start of the output.
+    COMMIT,     //!< Flushing the output and renaming it into place.
+    VERIFY,     //!< Checking a stamped payload digest.
+    DIFF,       //!< Comparing two files.
+    PHASE_COUNT
+};
+
+/**
+ * What was recorded for one phase.
+ */
+struct PhaseStats
+{
+    std::string m_name;
+    uint64_t m_wallTimeNs = 0;
+    uint64_t m_scopeCount = 0;
+    uint64_t m_byteCount = 0;
+    uint64_t m_facetCount = 0;
+};
+
+/**
+ * Everything recorded since stats were enabled, plus what the OS says about
+ * the process. OS figures that aren't available on this platform are -1.
+ */
+struct StatsReport
+{
+    uint64_t m_totalWallTimeNs = 0;
+    std::vector<PhaseStats> m_phases;
+    int64_t m_readSyscallCount = -1;
+    int64_t m_writeSyscallCount = -1;
+    int64_t m_peakResidentBytes = -1;
+};
+
+/**
+ * Process-wide stats switch and counters. Safe to use from any thread.
+ */
+class Stats
+{
+public:
+
+    //! Turns recording on or off. Turning it on resets everything.
+    static void setEnabled(bool isEnabled);
+
+    //! Returns true if recording is on.
+    static bool isEnabled();
+
+    //! Adds to the given phase's tallies. Does nothing if recording is off.
+    static void addBytes(StatsPhase phase, uint64_t byteCount);
+    static void addFacets(StatsPhase phase, uint64_t facetCount);
+
+    //! Adds a timed scope to the given phase.
+    static void addScope(StatsPhase phase, uint64_t wallTimeNs);
+
+    //! Returns what's been recorded so far.
+    static StatsReport getReport();
+};
+
+/**
+ * Times the rest of the enclosing scope as the given phase. Also shows up
+ * in the trace, if one is being recorded (see TraceRecorder). Use
+ * STLREPAIR_STATS_PHASE() rather than creating these directly.
+ */
+class ScopedPhaseTimer
+{
+public:
+
+    //! Constructor.
+    explicit ScopedPhaseTimer(StatsPhase phase);
+
+    //! Destructor.
+    ~ScopedPhaseTimer();
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+
+    StatsPhase m_phase;
+    bool m_isActive;
+    uint64_t m_startNs;
+    uint64_t m_nestedNs;
+    ScopedPhaseTimer* m_pOuterTimer;
+};
+
+/**
+ * Returns the report as a short human readable table.
+ */
+std::string formatStatsText(const StatsReport& report);
+
+/**
+ * Returns the report as a JSON object.
+ */
+std::string formatStatsJson(const StatsReport& report);
+
+#define STLREPAIR_STATS_CONCAT_(a, b) a##b
+#define STLREPAIR_STATS_CONCAT(a, b) STLREPAIR_STATS_CONCAT_(a, b)
+
+#if defined(STLREPAIR_DISABLE_STATS)
+#define STLREPAIR_STATS_PHASE(phase) ((void)0)
+#define STLREPAIR_STATS_COUNT_BYTES(phase, byteCount) ((void)0)
+#define STLREPAIR_STATS_COUNT_FACETS(phase, facetCount) ((void)0)
+#else
+#define STLREPAIR_STATS_PHASE(phase) \
+    ScopedPhaseTimer STLREPAIR_STATS_CONCAT(statsPhaseTimer, __LINE__)(StatsPhase::phase)
+#define STLREPAIR_STATS_COUNT_BYTES(phase, byteCount) \
+    Stats::addBytes(StatsPhase::phase, (byteCount))
+#define STLREPAIR_STATS_COUNT_FACETS(phase, facetCount) \
+    Stats::addFacets(StatsPhase::phase, (facetCount))
+#endif
+
+#endif
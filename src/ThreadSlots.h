@@ -0,0 +1,98 @@
+#ifndef STLREPAIR_THREADSLOTS__H_
+#define STLREPAIR_THREADSLOTS__H_
+
+#include <atomic>
+
+/**
+ * A T for every thread that asks for one, kept in a lock-free list so
+ * anyone can walk them all at any time with forEach(). What a slot holds,
+ * and how it's safe to read from other threads, is up to T.
+ *
+ * Slots are never freed. When a thread exits, its slot is handed on to the
+ * next new thread, with whatever was left in it, so short-lived threads
+ * don't pile up.
+ *
+ * There's one list per T, so T should be a type of the caller's own.
+ */
+template<typename T>
+class ThreadSlots
+{
+public:
+
+    /**
+     * Returns the calling thread's slot. The first time a thread asks,
+     * it's given a slot and onAcquire(slot) is called, so the slot can be
+     * made the new thread's own.
+     */
+    template<typename Fn>
+    static T& get(Fn onAcquire)
+    {
+        if (!t_owner.m_pSlot)
+        {
+            t_owner.m_pSlot = acquire();
+            onAcquire(t_owner.m_pSlot->m_value);
+        }
+
+        return t_owner.m_pSlot->m_value;
+    }
+
+    //! Returns the calling thread's slot.
+    static T& get()
+    {
+        return get([](T&) {});
+    }
+
+    /**
+     * Calls fn(slot) for every slot handed out so far, whether or not a
+     * thread still has it.
+     */
+    template<typename Fn>
+    static void forEach(Fn fn)
+    {
+        for (Slot* pSlot = s_pSlots.load(std::memory_order_acquire); pSlot; pSlot = pSlot->m_pNext)
+            fn(pSlot->m_value);
+    }
+
+private:
+
+    struct Slot
+    {
+        T m_value;
+        std::atomic<bool> m_isInUse{ true };
+        Slot* m_pNext = nullptr;
+    };
+
+    //! Gives the thread's slot back when the thread exits.
+    struct Owner
+    {
+        Slot* m_pSlot = nullptr;
+
+        ~Owner()
+        {
+            if (m_pSlot)
+                m_pSlot->m_isInUse = false;
+        }
+    };
+
+    static Slot* acquire()
+    {
+        for (Slot* pSlot = s_pSlots.load(std::memory_order_acquire); pSlot; pSlot = pSlot->m_pNext)
+        {
+            bool isInUse = false;
+            if (pSlot->m_isInUse.compare_exchange_strong(isInUse, true))
+                return pSlot;
+        }
+
+        Slot* pSlot = new Slot;
+        pSlot->m_pNext = s_pSlots.load(std::memory_order_relaxed);
+        while (!s_pSlots.compare_exchange_weak(pSlot->m_pNext, pSlot, std::memory_order_release))
+            ;
+
+        return pSlot;
+    }
+
+    static inline std::atomic<Slot*> s_pSlots{ nullptr };
+    static inline thread_local Owner t_owner;
+};
+
+#endif
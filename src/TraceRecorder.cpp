@@ -0,0 +1,227 @@
+#include "TraceRecorder.h"
+#include "ThreadSlots.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace
+{
+    //! A span of time, or a thread name if there's no category.
+    struct TraceEvent
+    {
+        const char* m_pName;
+        const char* m_pCategory;
+        uint64_t m_startNs;
+        uint64_t m_durationNs;
+        uint32_t m_threadId;
+    };
+
+    const size_t EVENTS_PER_BLOCK = 4096;
+
+    //! Caps each thread at about a million events, or 40 MB.
+    const size_t MAXIMUM_BLOCKS_PER_THREAD = 256;
+
+    /**
+     * One thread's events. Only the owning thread appends. Blocks and the
+     * event count are published with release stores, so the writer of the
+     * JSON can read along at any time without locking.
+     *
+     * A thread that inherits another's buffer (see ThreadSlots) gets an id
+     * of its own, which is why every event carries one.
+     */
+    struct ThreadBuffer
+    {
+        uint32_t m_threadId = 0;
+        std::atomic<TraceEvent*> m_blocks[MAXIMUM_BLOCKS_PER_THREAD] = {};
+        std::atomic<size_t> m_eventCount{ 0 };
+        std::atomic<uint64_t> m_droppedEventCount{ 0 };
+    };
+
+    std::atomic<bool> s_isRecording(false);
+    std::atomic<uint64_t> s_startNs(0);
+    std::atomic<uint32_t> s_nextThreadId(1);
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        return ThreadSlots<ThreadBuffer>::get([](ThreadBuffer& buffer) { buffer.m_threadId = s_nextThreadId++; });
+    }
+
+    void writeJsonString(std::ostream& stream, const char* pText)
+    {
+        stream << '"';
+        for (; *pText; ++pText)
+        {
+            const char c = *pText;
+            if ((c == '"') || (c == '\\'))
+                stream << '\\' << c;
+            else if (static_cast<unsigned char>(c) >= 0x20)
+                stream << c;
+        }
+        stream << '"';
+    }
+
+    void appendEvent(const TraceEvent& event)
+    {
+        ThreadBuffer& buffer = getThreadBuffer();
+
+        const size_t index = buffer.m_eventCount.load(std::memory_order_relaxed);
+        const size_t blockIndex = index / EVENTS_PER_BLOCK;
+        if (blockIndex >= MAXIMUM_BLOCKS_PER_THREAD)
+        {
+            buffer.m_droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        TraceEvent* pBlock = buffer.m_blocks[blockIndex].load(std::memory_order_relaxed);
+        if (!pBlock)
+        {
+            pBlock = new TraceEvent[EVENTS_PER_BLOCK];
+            buffer.m_blocks[blockIndex].store(pBlock, std::memory_order_release);
+        }
+
+        pBlock[index % EVENTS_PER_BLOCK] = event;
+        pBlock[index % EVENTS_PER_BLOCK].m_threadId = buffer.m_threadId;
+        buffer.m_eventCount.store(index + 1, std::memory_order_release);
+    }
+
+    //! Nanoseconds since recording started, as the microseconds the format wants.
+    void writeMicroseconds(std::ostream& stream, uint64_t nanoseconds)
+    {
+        stream << (nanoseconds / 1000) << '.' << std::setw(3) << std::setfill('0') << (nanoseconds % 1000);
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TraceRecorder::start()
+{
+    ThreadSlots<ThreadBuffer>::forEach([](ThreadBuffer& buffer)
+    {
+        buffer.m_eventCount = 0;
+        buffer.m_droppedEventCount = 0;
+    });
+
+    s_startNs = now();
+    s_isRecording = true;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TraceRecorder::stop()
+{
+    s_isRecording = false;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+bool TraceRecorder::isRecording()
+{
+    return s_isRecording.load(std::memory_order_relaxed);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TraceRecorder::recordEvent(const char* pName, const char* pCategory, uint64_t startNs, uint64_t durationNs)
+{
+    if (pCategory)
+        appendEvent({ pName, pCategory, startNs, durationNs, 0 });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TraceRecorder::setThreadName(const char* pName)
+{
+    if (isRecording() && pName)
+        appendEvent({ pName, nullptr, 0, 0, 0 });
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t TraceRecorder::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TraceRecorder::writeJson(std::ostream& stream)
+{
+    const uint64_t startNs = s_startNs;
+    const char* pSeparator = "\n";
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    ThreadSlots<ThreadBuffer>::forEach([&](const ThreadBuffer& buffer)
+    {
+        const size_t eventCount = buffer.m_eventCount.load(std::memory_order_acquire);
+        for (size_t index = 0; index < eventCount; ++index)
+        {
+            const TraceEvent* pBlock = buffer.m_blocks[index / EVENTS_PER_BLOCK].load(std::memory_order_acquire);
+            const TraceEvent& event = pBlock[index % EVENTS_PER_BLOCK];
+
+            if (!event.m_pCategory)
+            {
+                stream << pSeparator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << event.m_threadId
+                       << ",\"args\":{\"name\":";
+                writeJsonString(stream, event.m_pName);
+                stream << "}}";
+                pSeparator = ",\n";
+                continue;
+            }
+
+            stream << pSeparator << "{\"name\":";
+            writeJsonString(stream, event.m_pName);
+            stream << ",\"cat\":";
+            writeJsonString(stream, event.m_pCategory);
+            stream << ",\"ph\":\"X\",\"ts\":";
+            writeMicroseconds(stream, (event.m_startNs > startNs) ? event.m_startNs - startNs : 0);
+            stream << ",\"dur\":";
+            writeMicroseconds(stream, event.m_durationNs);
+            stream << ",\"pid\":1,\"tid\":" << event.m_threadId << "}";
+            pSeparator = ",\n";
+        }
+    });
+
+    stream << "\n]}\n";
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void TraceRecorder::writeJson(const std::string& filepath)
+{
+    std::ofstream stream(filepath, std::ios::out | std::ios::trunc);
+    if (!stream)
+        throw std::runtime_error("Could not create trace file " + filepath);
+
+    writeJson(stream);
+
+    stream.close();
+    if (!stream)
+        throw std::runtime_error("Error writing trace file " + filepath);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t TraceRecorder::getDroppedEventCount()
+{
+    uint64_t droppedEventCount = 0;
+    ThreadSlots<ThreadBuffer>::forEach([&droppedEventCount](const ThreadBuffer& buffer)
+    {
+        droppedEventCount += buffer.m_droppedEventCount.load(std::memory_order_relaxed);
+    });
+
+    return droppedEventCount;
+}
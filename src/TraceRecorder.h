@@ -0,0 +1,109 @@
+#ifndef STLREPAIR_TRACERECORDER__H_
+#define STLREPAIR_TRACERECORDER__H_
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+/**
+ * Records a timeline of what every thread was doing, for loading into a
+ * trace viewer (chrome://tracing or Perfetto).
+ *
+ * Each thread appends to a buffer of its own, so recording an event takes
+ * no locks and doesn't contend with other threads. Phase timers (see
+ * Stats.h) record themselves here too, and other code marks spans with
+ * STLREPAIR_TRACE_SCOPE(). Both compile away when STLREPAIR_DISABLE_STATS
+ * is defined.
+ *
+ * Event names and categories must be string literals, or otherwise outlive
+ * the recorder. Only pointers are kept.
+ */
+class TraceRecorder
+{
+public:
+
+    /**
+     * Starts recording, discarding anything recorded before. Must not be
+     * called while traced work is running on other threads.
+     */
+    static void start();
+
+    //! Stops recording. What's been recorded is kept until the next start().
+    static void stop();
+
+    //! Returns true if events are being recorded.
+    static bool isRecording();
+
+    //! Records a span of time on the calling thread.
+    static void recordEvent(const char* pName, const char* pCategory, uint64_t startNs, uint64_t durationNs);
+
+    //! Names the calling thread in the trace. Ignored if not recording.
+    static void setThreadName(const char* pName);
+
+    //! Returns the current time on the clock events are recorded against.
+    static uint64_t now();
+
+    /**
+     * Writes everything recorded as Chrome trace-event JSON. Events being
+     * recorded at the same time may or may not be included.
+     */
+    static void writeJson(std::ostream& stream);
+
+    /**
+     * Writes everything recorded to the given file.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
+    static void writeJson(const std::string& filepath);
+
+    //! Returns the number of events dropped because a thread's buffer was full.
+    static uint64_t getDroppedEventCount();
+};
+
+/**
+ * Records the rest of the enclosing scope as one event. Use
+ * STLREPAIR_TRACE_SCOPE() rather than creating these directly.
+ */
+class ScopedTraceEvent
+{
+public:
+
+    //! Constructor.
+    ScopedTraceEvent(const char* pName, const char* pCategory) :
+        m_pName(pName),
+        m_pCategory(pCategory),
+        m_startNs(TraceRecorder::isRecording() ? TraceRecorder::now() : 0)
+    {
+    }
+
+    //! Destructor.
+    ~ScopedTraceEvent()
+    {
+        if ((m_startNs != 0) && TraceRecorder::isRecording())
+            TraceRecorder::recordEvent(m_pName, m_pCategory, m_startNs, TraceRecorder::now() - m_startNs);
+    }
+
+    ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+private:
+
+    const char* m_pName;
+    const char* m_pCategory;
+    uint64_t m_startNs;
+};
+
+#define STLREPAIR_TRACE_CONCAT_(a, b) a##b
+#define STLREPAIR_TRACE_CONCAT(a, b) STLREPAIR_TRACE_CONCAT_(a, b)
+
+#if defined(STLREPAIR_DISABLE_STATS)
+#define STLREPAIR_TRACE_SCOPE(name, category) ((void)0)
+#define STLREPAIR_TRACE_THREAD_NAME(name) ((void)0)
+#else
+#define STLREPAIR_TRACE_SCOPE(name, category) \
+    ScopedTraceEvent STLREPAIR_TRACE_CONCAT(traceEvent, __LINE__)((name), (category))
+#define STLREPAIR_TRACE_THREAD_NAME(name) \
+    TraceRecorder::setThreadName(name)
+#endif
+
+#endif
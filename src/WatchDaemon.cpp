@@ -0,0 +1,315 @@
+#include "WatchDaemon.h"
+#include "InMemoryRepair.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+#include "Contracts.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    bool isSTLFileName(const std::string& name)
+    {
+        // Leading dots are temp files, ours or someone else's.
+        if ((name.size() < 5) || (name[0] == '.'))
+            return false;
+
+        std::string extension = name.substr(name.size() - 4);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+        return extension == ".stl";
+    }
+
+    /**
+     * There's no one to ask whether a file that starts with "solid" is
+     * really binary, so only believe it is if its size says so.
+     */
+    bool looksLikeASCII(const std::vector<uint8_t>& data)
+    {
+        const uint64_t TRIANGLE_BLOB_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+        const uint64_t FIRST_TRIANGLE_OFFSET = BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES;
+
+        if ((data.size() < FIRST_TRIANGLE_OFFSET) || (memcmp(data.data(), "solid", 5) != 0))
+            return false;
+
+        uint32_t triangleCount = 0;
+        memcpy(&triangleCount, data.data() + BINARY_STL_HEADER_SIZE_IN_BYTES, sizeof(triangleCount));
+        return data.size() != FIRST_TRIANGLE_OFFSET + triangleCount * TRIANGLE_BLOB_SIZE;
+    }
+}
+
+#if defined(__linux__)
+
+/**
+ * @since 2026 Oct 19
+ */
+WatchDaemon::WatchDaemon(const WatchOptions& options) :
+    m_options(options),
+    m_inotifyFd(-1),
+    m_stopPipe{ -1, -1 },
+    m_repairedFileCount(0),
+    m_failedFileCount(0),
+    m_committer(options.m_durability)
+{
+    precondition_throw(!options.m_directories.empty(), std::runtime_error("No directories to watch."));
+    precondition_throw(!options.m_outputDirectory.empty(), std::runtime_error("No output directory specified."));
+
+    std::error_code error;
+    fs::create_directories(options.m_outputDirectory, error);
+    if (!fs::is_directory(options.m_outputDirectory))
+        throw std::runtime_error("Could not create output directory - " + options.m_outputDirectory);
+
+    // Anything that fails from here on leaves the descriptors to the
+    // destructor, which won't run. So clean up on the way out.
+    auto cleanupGuard = makeCallGuard([this]()
+    {
+        if (m_inotifyFd != -1)
+            close(m_inotifyFd);
+        if (m_stopPipe[0] != -1)
+            close(m_stopPipe[0]);
+        if (m_stopPipe[1] != -1)
+            close(m_stopPipe[1]);
+    });
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd == -1)
+        throw std::runtime_error(std::string("Could not start watching directories - ") + strerror(errno));
+
+    if (pipe2(m_stopPipe, O_NONBLOCK | O_CLOEXEC) != 0)
+        throw std::runtime_error(std::string("Could not start watching directories - ") + strerror(errno));
+
+    for (const auto& directory : options.m_directories)
+    {
+        if (fs::equivalent(directory, options.m_outputDirectory, error))
+            throw std::runtime_error("The output directory can't be one that's being watched - " + directory);
+
+        const int watch = inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+        if (watch == -1)
+            throw std::runtime_error("Could not watch directory " + directory + " - " + strerror(errno));
+
+        m_watchedDirectories[watch] = directory;
+    }
+
+    m_spWorkers = std::make_unique<RepairWorkerPool>(options.m_workerCount);
+    cleanupGuard.dismiss();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+WatchDaemon::~WatchDaemon()
+{
+    m_spWorkers.reset();
+    close(m_inotifyFd);
+    close(m_stopPipe[0]);
+    close(m_stopPipe[1]);
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::run()
+{
+    // Big enough for hundreds of events per read, which is what keeps up
+    // with a busy drop folder.
+    alignas(inotify_event) char events[64 * 1024];
+
+    for (;;)
+    {
+        pollfd fds[2] = { { m_inotifyFd, POLLIN, 0 }, { m_stopPipe[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("Error waiting for files - ") + strerror(errno));
+        }
+
+        if (fds[1].revents != 0)
+            break;
+
+        for (;;)
+        {
+            const ssize_t size = read(m_inotifyFd, events, sizeof(events));
+            if (size <= 0)
+                break;
+            handleEvents(events, static_cast<size_t>(size));
+        }
+    }
+
+    // Empty the pipe, so run() can be called again.
+    char discard[16];
+    while (read(m_stopPipe[0], discard, sizeof(discard)) > 0)
+        ;
+
+    m_spWorkers->waitUntilIdle();
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::stop()
+{
+    // write() is one of the few things a signal handler is allowed to do.
+    const char wake = 1;
+    ssize_t written = write(m_stopPipe[1], &wake, 1);
+    (void)written;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::handleEvents(const char* pEvents, size_t size)
+{
+    for (const char* pNext = pEvents; pNext < pEvents + size; )
+    {
+        const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(pNext);
+        pNext += sizeof(inotify_event) + pEvent->len;
+
+        if (pEvent->mask & IN_Q_OVERFLOW)
+        {
+            std::cerr << "Too many files arrived at once. Some weren't seen and won't be repaired.\n";
+            continue;
+        }
+
+        auto watched = m_watchedDirectories.find(pEvent->wd);
+        if (watched == m_watchedDirectories.end())
+            continue;
+
+        if (pEvent->mask & IN_IGNORED)
+        {
+            std::cerr << "No longer watching " << watched->second << "\n";
+            m_watchedDirectories.erase(watched);
+            continue;
+        }
+
+        if ((pEvent->mask & IN_ISDIR) || (pEvent->len == 0))
+            continue;
+
+        const std::string name = pEvent->name;
+        if (!isSTLFileName(name))
+            continue;
+
+        const std::string inputFile = (fs::path(watched->second) / name).string();
+        m_spWorkers->submit([this, inputFile, name](RepairWorkspace& workspace)
+        {
+            repairFile(inputFile, name, workspace);
+        });
+    }
+}
+
+#else
+
+/**
+ * @since 2026 Oct 19
+ */
+WatchDaemon::WatchDaemon(const WatchOptions& options) :
+    m_options(options),
+    m_inotifyFd(-1),
+    m_stopPipe{ -1, -1 },
+    m_repairedFileCount(0),
+    m_failedFileCount(0),
+    m_committer(options.m_durability)
+{
+    throw std::runtime_error("Watching directories isn't supported on this platform.");
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+WatchDaemon::~WatchDaemon()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::run()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::stop()
+{
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::handleEvents(const char* /*pEvents*/, size_t /*size*/)
+{
+}
+
+#endif
+
+/**
+ * Runs on a worker thread.
+ *
+ * @since 2026 Oct 19
+ */
+void WatchDaemon::repairFile(const std::string& inputFile, const std::string& name, RepairWorkspace& workspace)
+{
+    const std::string outputFile = (fs::path(m_options.m_outputDirectory) / name).string();
+    const std::string tempFile = makeTempOutputPath(outputFile);
+    const auto startTime = std::chrono::steady_clock::now();
+    auto getElapsedNs = [&]()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+    };
+
+    try
+    {
+        FileUtils::readWholeFile(inputFile, workspace.m_input);
+        if (looksLikeASCII(workspace.m_input))
+            throw std::runtime_error("Looks like an ASCII STL.");
+
+        const RepairOptions options = planRepairs(workspace.m_input.data(), workspace.m_input.size(),
+            m_options.m_repairOptions);
+
+        workspace.m_output.clear();
+        const RepairResult result = repairSTL(workspace.m_input.data(), workspace.m_input.size(),
+            workspace.m_output, options);
+
+        FILE* pFile = fopen(tempFile.c_str(), "wb");
+        if (!pFile)
+            throw std::runtime_error("Could not create " + tempFile);
+        auto removeGuard = makeCallGuard([&]() { remove(tempFile.c_str()); });
+
+        const bool isWritten = (fwrite(workspace.m_output.data(), 1, workspace.m_output.size(), pFile) == workspace.m_output.size());
+        if ((fclose(pFile) != 0) || !isWritten)
+            throw std::runtime_error("Could not write " + tempFile);
+
+        m_committer.commit(tempFile, outputFile);
+        removeGuard.dismiss();
+        ++m_repairedFileCount;
+        Metrics::recordRepair(MetricsSource::WATCH, workspace.m_input.size(), result, getElapsedNs());
+    }
+    catch (const std::exception& e)
+    {
+        ++m_failedFileCount;
+        Metrics::recordFailure(MetricsSource::WATCH, getElapsedNs());
+
+        // One write, so messages from different workers don't interleave.
+        std::cerr << ("Could not repair " + inputFile + " - " + e.what() + "\n") << std::flush;
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef STLREPAIR_WATCHDAEMON__H_
+#define STLREPAIR_WATCHDAEMON__H_
+
+#include "FilterStages.h"
+#include "RepairWorkerPool.h"
+#include "OutputCommitter.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * How a WatchDaemon should go about its business.
+ */
+struct WatchOptions
+{
+    //! Directories to watch. Subdirectories aren't watched.
+    std::vector<std::string> m_directories;
+
+    //! Where repaired files go, under the same name. Can't be watched itself.
+    std::string m_outputDirectory;
+
+    /**
+     * Repairs made to every file. The triangle count and trailing data are
+     * fixed on top of these as each file needs it (see planRepairs()).
+     */
+    RepairOptions m_repairOptions;
+
+    //! Number of repair workers. 0 means one per core.
+    unsigned m_workerCount = 0;
+
+    //! How repaired files are committed to the output directory.
+    DurabilityPolicy m_durability = DurabilityPolicy::NONE;
+};
+
+/**
+ * Watches directories for STL files and repairs each one as soon as
+ * whoever's writing it closes it (inotify's IN_CLOSE_WRITE, or IN_MOVED_TO
+ * for files renamed into place). Files are repaired in memory on a pool of
+ * workers that stick around between files, so there's no per-file cost
+ * beyond reading and writing it.
+ *
+ * Each repaired file is written to a hidden temp file in the output
+ * directory and committed with an OutputCommitter, so anything watching
+ * that directory only ever sees complete files. Only files ending in .stl are picked up.
+ * Files already in a directory when watching starts are left alone.
+ *
+ * Linux only, for now.
+ */
+class WatchDaemon
+{
+public:
+
+    /**
+     * Constructor. Starts watching, so anything closed after this returns
+     * will be repaired once run() is called.
+     *
+     * @throws std::runtime_error if a directory can't be watched, the
+     *         output directory is one of them, or the platform isn't
+     *         supported.
+     */
+    explicit WatchDaemon(const WatchOptions& options);
+
+    //! Destructor.
+    ~WatchDaemon();
+
+    WatchDaemon(const WatchDaemon&) = delete;
+    WatchDaemon& operator=(const WatchDaemon&) = delete;
+
+    /**
+     * Repairs files as they turn up until stop() is called. Files already
+     * queued are finished before returning.
+     */
+    void run();
+
+    /**
+     * Makes run() return. Safe to call from any thread, and from a signal
+     * handler.
+     */
+    void stop();
+
+    //! Returns the number of files repaired so far.
+    uint64_t getRepairedFileCount() const { return m_repairedFileCount; }
+
+    //! Returns the number of files that couldn't be repaired.
+    uint64_t getFailedFileCount() const { return m_failedFileCount; }
+
+private:
+
+    void handleEvents(const char* pEvents, size_t size);
+    void repairFile(const std::string& inputFile, const std::string& name, RepairWorkspace& workspace);
+
+    WatchOptions m_options;
+    int m_inotifyFd;
+    int m_stopPipe[2];
+    std::map<int, std::string> m_watchedDirectories;
+    std::unique_ptr<RepairWorkerPool> m_spWorkers;
+    std::atomic<uint64_t> m_repairedFileCount;
+    std::atomic<uint64_t> m_failedFileCount;
+    OutputCommitter m_committer;
+};
+
+#endif
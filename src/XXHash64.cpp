@@ -0,0 +1,171 @@
+#include "XXHash64.h"
+#include "ByteStream.h"
+
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+namespace
+{
+    const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+    const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+    const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+    const size_t HASH_FILE_BUFFER_SIZE = 1024 * 1024;
+
+    inline uint64_t rotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // Little endian, like every platform we build for.
+    inline uint64_t read64(const uint8_t* pData)
+    {
+        uint64_t value;
+        memcpy(&value, pData, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t read32(const uint8_t* pData)
+    {
+        uint32_t value;
+        memcpy(&value, pData, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * PRIME64_2;
+        accumulator = rotateLeft(accumulator, 31);
+        return accumulator * PRIME64_1;
+    }
+
+    inline uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+    {
+        accumulator ^= round(0, value);
+        return accumulator * PRIME64_1 + PRIME64_4;
+    }
+
+    inline void consumeStripe(uint64_t (&accumulators)[4], const uint8_t* pStripe)
+    {
+        accumulators[0] = round(accumulators[0], read64(pStripe));
+        accumulators[1] = round(accumulators[1], read64(pStripe + 8));
+        accumulators[2] = round(accumulators[2], read64(pStripe + 16));
+        accumulators[3] = round(accumulators[3], read64(pStripe + 24));
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+XXHash64::XXHash64(uint64_t seed) :
+    m_stripeSize(0),
+    m_totalSize(0),
+    m_seed(seed)
+{
+    m_accumulators[0] = seed + PRIME64_1 + PRIME64_2;
+    m_accumulators[1] = seed + PRIME64_2;
+    m_accumulators[2] = seed;
+    m_accumulators[3] = seed - PRIME64_1;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+void XXHash64::update(const void* pData, size_t size)
+{
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    m_totalSize += size;
+
+    if (m_stripeSize > 0)
+    {
+        const size_t bytesToCopy = std::min(size, sizeof(m_stripe) - m_stripeSize);
+        memcpy(m_stripe + m_stripeSize, pBytes, bytesToCopy);
+        m_stripeSize += bytesToCopy;
+        pBytes += bytesToCopy;
+        size -= bytesToCopy;
+
+        if (m_stripeSize < sizeof(m_stripe))
+            return;
+
+        consumeStripe(m_accumulators, m_stripe);
+        m_stripeSize = 0;
+    }
+
+    for (; size >= sizeof(m_stripe); pBytes += sizeof(m_stripe), size -= sizeof(m_stripe))
+        consumeStripe(m_accumulators, pBytes);
+
+    if (size > 0)
+    {
+        memcpy(m_stripe, pBytes, size);
+        m_stripeSize = size;
+    }
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t XXHash64::digest() const
+{
+    uint64_t hash;
+    if (m_totalSize >= sizeof(m_stripe))
+    {
+        hash = rotateLeft(m_accumulators[0], 1) + rotateLeft(m_accumulators[1], 7) +
+               rotateLeft(m_accumulators[2], 12) + rotateLeft(m_accumulators[3], 18);
+        for (uint64_t accumulator : m_accumulators)
+            hash = mergeRound(hash, accumulator);
+    }
+    else
+    {
+        hash = m_seed + PRIME64_5;
+    }
+
+    hash += m_totalSize;
+
+    const uint8_t* pBytes = m_stripe;
+    size_t size = m_stripeSize;
+    for (; size >= 8; pBytes += 8, size -= 8)
+    {
+        hash ^= round(0, read64(pBytes));
+        hash = rotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+
+    if (size >= 4)
+    {
+        hash ^= static_cast<uint64_t>(read32(pBytes)) * PRIME64_1;
+        hash = rotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+        pBytes += 4;
+        size -= 4;
+    }
+
+    for (; size > 0; ++pBytes, --size)
+    {
+        hash ^= *pBytes * PRIME64_5;
+        hash = rotateLeft(hash, 11) * PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+/**
+ * @since 2026 Oct 19
+ */
+uint64_t hashFile(const std::string& filepath, uint64_t seed)
+{
+    FileByteSource source(filepath);
+    std::vector<uint8_t> buffer(HASH_FILE_BUFFER_SIZE);
+
+    XXHash64 hash(seed);
+    for (size_t bytesRead; (bytesRead = source.read(buffer.data(), buffer.size())) > 0; )
+        hash.update(buffer.data(), bytesRead);
+
+    return hash.digest();
+}
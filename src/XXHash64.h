@@ -0,0 +1,42 @@
+#ifndef STLREPAIR_XXHASH64__H_
+#define STLREPAIR_XXHASH64__H_
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Incremental XXH64. Produces the same value as the reference xxHash
+ * implementation, however the data is split across calls to update().
+ * Fast enough that hashing a file costs little more than reading it.
+ */
+class XXHash64
+{
+public:
+
+    //! Constructor.
+    explicit XXHash64(uint64_t seed = 0);
+
+    //! Adds data to the hash.
+    void update(const void* pData, size_t size);
+
+    //! Returns the hash of everything added so far.
+    uint64_t digest() const;
+
+private:
+
+    uint64_t m_accumulators[4];
+    uint8_t m_stripe[32];
+    size_t m_stripeSize;
+    uint64_t m_totalSize;
+    uint64_t m_seed;
+};
+
+/**
+ * Returns the XXH64 of the contents of the given file.
+ *
+ * @throws std::runtime_error if the file can't be read.
+ */
+uint64_t hashFile(const std::string& filepath, uint64_t seed = 0);
+
+#endif
@@ -0,0 +1,104 @@
+#include "AffineTransform.h"
+#include "BinarySTLFileReader.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    STLBinaryTriangleData makeTriangle(const STLFacet& facet)
+    {
+        STLBinaryTriangleData triangle;
+        encodeFacet(facet, triangle);
+        return triangle;
+    }
+
+    void expectNear(const Vec3& actual, const Vec3& expected)
+    {
+        EXPECT_NEAR(actual.x, expected.x, 1e-5f);
+        EXPECT_NEAR(actual.y, expected.y, 1e-5f);
+        EXPECT_NEAR(actual.z, expected.z, 1e-5f);
+    }
+}
+
+class AffineTransformTests : public testing::Test
+{
+
+};
+
+TEST_F(AffineTransformTests, testIdentity)
+{
+    EXPECT_TRUE(AffineTransform().isIdentity());
+    EXPECT_TRUE(AffineTransform::scale(1.0f).isIdentity());
+    EXPECT_FALSE(AffineTransform::scale(2.0f).isIdentity());
+    EXPECT_FALSE(AffineTransform::translation({ 0.0f, 1.0f, 0.0f }).isIdentity());
+}
+
+TEST_F(AffineTransformTests, testScaleThenTranslate)
+{
+    AffineTransform transform = AffineTransform::scale(25.4f).then(
+        AffineTransform::translation({ 1.0f, 2.0f, 3.0f }));
+
+    STLBinaryTriangleData triangle = makeTriangle({ { 0, 0, 1 },
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } } });
+    transform.apply(triangle);
+
+    STLFacet facet = decodeFacet(triangle);
+    expectNear(facet.normal, { 0, 0, 1 });
+    expectNear(facet.vertices[0], { 1, 2, 3 });
+    expectNear(facet.vertices[1], { 26.4f, 2, 3 });
+    expectNear(facet.vertices[2], { 1, 27.4f, 3 });
+}
+
+TEST_F(AffineTransformTests, testNonUniformScaleKeepsNormalsPerpendicular)
+{
+    // A 45 degree facet. Squashing z should tilt its normal towards z.
+    const float n = 0.70710678f;
+    STLBinaryTriangleData triangle = makeTriangle({ { n, 0, n },
+        { { 1, 0, 0 }, { 0, 1, 1 }, { 0, 0, 1 } } });
+
+    AffineTransform::scale(Vec3{ 1.0f, 1.0f, 0.5f }).apply(triangle);
+
+    STLFacet facet = decodeFacet(triangle);
+    const float expectedLength = std::sqrt(1.0f + 4.0f);
+    expectNear(facet.normal, { 1.0f / expectedLength, 0.0f, 2.0f / expectedLength });
+}
+
+TEST_F(AffineTransformTests, testMirrorFlipsWinding)
+{
+    STLBinaryTriangleData triangle = makeTriangle({ { 0, 0, 1 },
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } } });
+
+    AffineTransform::scale(Vec3{ -1.0f, 1.0f, 1.0f }).apply(triangle);
+
+    STLFacet facet = decodeFacet(triangle);
+    expectNear(facet.normal, { 0, 0, 1 });
+    expectNear(facet.vertices[0], { 0, 0, 0 });
+    expectNear(facet.vertices[1], { 0, 1, 0 });
+    expectNear(facet.vertices[2], { -1, 0, 0 });
+}
+
+TEST_F(AffineTransformTests, testZeroNormalStaysZero)
+{
+    STLBinaryTriangleData triangle = makeTriangle({ { 0, 0, 0 },
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } } });
+
+    AffineTransform::scale(3.0f).apply(triangle);
+
+    expectNear(decodeFacet(triangle).normal, { 0, 0, 0 });
+}
+
+TEST_F(AffineTransformTests, testScanBoundingBox)
+{
+    BoundingBox full = scanBoundingBox(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    EXPECT_NEAR(full.m_max.x - full.m_min.x, 5.0f, 0.01f);
+    EXPECT_NEAR(full.center().x, 0.0f, 0.01f);
+
+    // Sampling a single block still gives a sensible answer for a small file.
+    BoundingBox sampled = scanBoundingBox(TEST_DATA_DIR + "binary_5mm_sphere.stl", 1);
+    EXPECT_EQ(sampled.m_min.x, full.m_min.x);
+    EXPECT_EQ(sampled.m_max.z, full.m_max.z);
+}
@@ -0,0 +1,112 @@
+#include "AsyncFileIO.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    AsyncIOOptions makeOptions(AsyncIOBackend backend)
+    {
+        // Tiny blocks and a shallow queue, so every test exercises lots of
+        // requests and slot reuse.
+        AsyncIOOptions options;
+        options.m_isEnabled = true;
+        options.m_backend = backend;
+        options.m_queueDepth = 3;
+        options.m_blockSize = 1000;
+        return options;
+    }
+
+    std::vector<uint8_t> readAll(ByteSource& source, size_t chunkSize)
+    {
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> chunk(chunkSize);
+        size_t bytesRead = 0;
+        while ((bytesRead = source.read(chunk.data(), chunk.size())) > 0)
+            data.insert(data.end(), chunk.begin(), chunk.begin() + bytesRead);
+        return data;
+    }
+
+    void testReading(AsyncIOBackend backend)
+    {
+        const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+        const std::vector<uint8_t> expected = FileUtils::readWholeFile(INPUT_FILE);
+
+        auto spSource = openAsyncFileByteSource(INPUT_FILE, makeOptions(backend));
+        EXPECT_EQ(readAll(*spSource, 777), expected);
+
+        uint8_t buffer[50];
+        EXPECT_EQ(spSource->read(buffer, sizeof(buffer)), 0u);
+
+        ASSERT_TRUE(spSource->seek(84));
+        ASSERT_EQ(spSource->read(buffer, sizeof(buffer)), sizeof(buffer));
+        EXPECT_EQ(memcmp(buffer, expected.data() + 84, sizeof(buffer)), 0);
+    }
+
+    void testWriting(AsyncIOBackend backend)
+    {
+        std::vector<uint8_t> expected(10050);
+        for (size_t i = 0; i < expected.size(); ++i)
+            expected[i] = static_cast<uint8_t>(i * 31);
+
+        const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "async_write_test.bin");
+        auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+        auto spSink = createAsyncFileByteSink(OUTPUT_FILE, makeOptions(backend));
+        for (size_t offset = 0; offset < expected.size(); offset += 50)
+            spSink->write(expected.data() + offset, 50);
+        spSink->close();
+        spSink.reset();
+
+        EXPECT_EQ(FileUtils::readWholeFile(OUTPUT_FILE), expected);
+    }
+}
+
+class AsyncFileIOTests : public testing::Test
+{
+
+};
+
+TEST_F(AsyncFileIOTests, testThreadPoolReading)
+{
+    testReading(AsyncIOBackend::THREAD_POOL);
+}
+
+TEST_F(AsyncFileIOTests, testThreadPoolWriting)
+{
+    testWriting(AsyncIOBackend::THREAD_POOL);
+}
+
+TEST_F(AsyncFileIOTests, testIOUringReading)
+{
+    if (!isIOUringSupported())
+        GTEST_SKIP() << "io_uring isn't available here.";
+
+    testReading(AsyncIOBackend::IO_URING);
+}
+
+TEST_F(AsyncFileIOTests, testIOUringWriting)
+{
+    if (!isIOUringSupported())
+        GTEST_SKIP() << "io_uring isn't available here.";
+
+    testWriting(AsyncIOBackend::IO_URING);
+}
+
+TEST_F(AsyncFileIOTests, testAutomaticBackendAlwaysWorks)
+{
+    testReading(AsyncIOBackend::AUTOMATIC);
+    testWriting(AsyncIOBackend::AUTOMATIC);
+}
+
+TEST_F(AsyncFileIOTests, testOpeningMissingFileThrows)
+{
+    EXPECT_THROW(openAsyncFileByteSource(TEST_DATA_DIR + "no_such_file.stl",
+        makeOptions(AsyncIOBackend::AUTOMATIC)), std::runtime_error);
+}
@@ -2,6 +2,9 @@
 #include "BinarySTLFileReader.h"
 #include "FileUtils.h"
 #include "CallGuard.h"
+#include "STLMesh.h"
+#include "MortonCode.h"
+#include "PipelinedByteStream.h"
 
 #include "gtest/gtest.h"
 
@@ -126,4 +129,114 @@ TEST_F(BinarySTLFileFilterTests, testZeroAttributeByteCounts)
 
     EXPECT_EQ(FileUtils::getFileSize(INPUT_FILE), FileUtils::getFileSize(OUTPUT_FILE));
     EXPECT_EQ(FileUtils::areFilesEqual(TEST_DATA_DIR + "binary_5mm_sphere.stl", OUTPUT_FILE), true);
-}
\ No newline at end of file
+}
+
+TEST_F(BinarySTLFileFilterTests, testSortByMortonCode)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    BinarySTLFileFilter filter(OUTPUT_FILE);
+    filter.m_sortByMortonCode = true;
+
+    BinarySTLFileReader reader(INPUT_FILE);
+    reader.readFile(filter);
+
+    EXPECT_EQ(FileUtils::getFileSize(INPUT_FILE), FileUtils::getFileSize(OUTPUT_FILE));
+    EXPECT_EQ(FileUtils::areFilesEqual(INPUT_FILE, OUTPUT_FILE, 0,
+        BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES), true);
+
+    // Same triangles, just reordered.
+    STLMesh input = readMesh(INPUT_FILE);
+    STLMesh output = readMesh(OUTPUT_FILE);
+    ASSERT_EQ(input.size(), output.size());
+    EXPECT_FALSE(input.m_triangles == output.m_triangles);
+
+    std::vector<uint64_t> codes;
+    std::vector<uint32_t> order;
+    sortByMortonCode(input.m_triangles, codes, order);
+    for (size_t i = 0; i < order.size(); ++i)
+        EXPECT_EQ(output.m_triangles[i], input.m_triangles[order[i]]);
+}
+
+TEST_F(BinarySTLFileFilterTests, testResynchronizeMidStreamJunk)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_with_mid_stream_junk.stl";
+    const std::string ORIGINAL_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    BinarySTLFileFilter filter(OUTPUT_FILE);
+    filter.m_updateTriangleCount = true;
+
+    BinarySTLFileReader reader(INPUT_FILE);
+    reader.setResynchronizationEnabled(true);
+    reader.readFile(filter);
+
+    // Minus the junk, it's the original sphere.
+    EXPECT_EQ(filter.getSkippedByteCount(), 23u);
+    EXPECT_EQ(FileUtils::areFilesEqual(ORIGINAL_FILE, OUTPUT_FILE), true);
+}
+
+TEST_F(BinarySTLFileFilterTests, testPipelinedOutputMatches)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string SYNCHRONOUS_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto synchronousFileGuard = makeCallGuard([&]() { _unlink(SYNCHRONOUS_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(SYNCHRONOUS_FILE);
+        filter.m_zeroAttributeByteCounts = true;
+        filter.m_updateTriangleCount = true;
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    const std::string PIPELINED_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto pipelinedFileGuard = makeCallGuard([&]() { _unlink(PIPELINED_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(PIPELINED_FILE);
+        filter.m_zeroAttributeByteCounts = true;
+        filter.m_updateTriangleCount = true;
+        filter.m_writeOnBackgroundThread = true;
+        BinarySTLFileReader reader(std::make_unique<PrefetchingByteSource>(
+            std::make_unique<FileByteSource>(INPUT_FILE), 4096, 2));
+        reader.readFile(filter);
+    }
+
+    EXPECT_EQ(FileUtils::areFilesEqual(SYNCHRONOUS_FILE, PIPELINED_FILE), true);
+}
+
+TEST_F(BinarySTLFileFilterTests, testAsyncIOOutputMatches)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string SYNCHRONOUS_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto synchronousFileGuard = makeCallGuard([&]() { _unlink(SYNCHRONOUS_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(SYNCHRONOUS_FILE);
+        filter.m_updateTriangleCount = true;
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    const std::string ASYNC_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto asyncFileGuard = makeCallGuard([&]() { _unlink(ASYNC_FILE.c_str()); });
+
+    {
+        AsyncIOOptions asyncIO;
+        asyncIO.m_isEnabled = true;
+        asyncIO.m_queueDepth = 4;
+        asyncIO.m_blockSize = 4096;
+
+        BinarySTLFileFilter filter(ASYNC_FILE);
+        filter.m_updateTriangleCount = true;
+        filter.m_asyncIO = asyncIO;
+        BinarySTLFileReader reader(openAsyncFileByteSource(INPUT_FILE, asyncIO));
+        reader.readFile(filter);
+    }
+
+    EXPECT_EQ(FileUtils::areFilesEqual(SYNCHRONOUS_FILE, ASYNC_FILE), true);
+}
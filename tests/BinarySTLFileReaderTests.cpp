@@ -14,7 +14,10 @@ public:
         m_readTriangleCountCalledCount(0),
         m_readTriangleCalledCount(0),
         m_readUnknownDataCalledCount(0),
-        m_triangleCount(0)
+        m_readSkippedDataCalledCount(0),
+        m_triangleCount(0),
+        m_skippedDataOffset(0),
+        m_skippedDataSize(0)
     {
     }
 
@@ -67,15 +70,27 @@ public:
          return true;
      }
 
+    //! Called whenever junk is skipped during resynchronization.
+    bool onReadSkippedData(const uint64_t fileOffset, const uint64_t dataSize) override
+    {
+        m_skippedDataOffset = fileOffset;
+        m_skippedDataSize = dataSize;
+        ++m_readSkippedDataCalledCount;
+        return true;
+    }
+
     int m_readBeginCalledCount;
     int m_readEndCalledCount;
     int m_readFileHeaderCalledCount;
     int m_readTriangleCountCalledCount;
     int m_readTriangleCalledCount;
     int m_readUnknownDataCalledCount;
+    int m_readSkippedDataCalledCount;
     std::vector<char> m_headerBuffer;
     uint32_t m_triangleCount;
     std::vector<char> m_weirdDataBuffer;
+    uint64_t m_skippedDataOffset;
+    uint64_t m_skippedDataSize;
 };
 
 class BinarySTLFileReaderTests : public testing::Test
@@ -228,3 +243,62 @@ TEST_F(BinarySTLFileReaderTests, testOpeningSphereWithTruncatedData)
     EXPECT_EQ(listener.m_readUnknownDataCalledCount, 1);
     EXPECT_EQ(listener.m_weirdDataBuffer.size(), 49);
 }
+
+TEST_F(BinarySTLFileReaderTests, testOpeningSphereWithMidStreamJunk)
+{
+    // Without resynchronization, everything after the junk is misaligned and
+    // the tail end of the last triangle shows up as unknown data.
+    BinarySTLFileReader reader(TEST_DATA_DIR + "binary_5mm_sphere_with_mid_stream_junk.stl");
+    TestBinarySTLFileReaderListener listener;
+    reader.readFile(listener);
+
+    EXPECT_EQ(listener.m_triangleCount, 960);
+    EXPECT_EQ(listener.m_readTriangleCalledCount, 960);
+    EXPECT_EQ(listener.m_readUnknownDataCalledCount, 1);
+    EXPECT_EQ(listener.m_weirdDataBuffer.size(), 23);
+    EXPECT_EQ(listener.m_readSkippedDataCalledCount, 0);
+}
+
+TEST_F(BinarySTLFileReaderTests, testResynchronizingSphereWithMidStreamJunk)
+{
+    // 23 bytes of junk were inserted after the 480th triangle.
+    BinarySTLFileReader reader(TEST_DATA_DIR + "binary_5mm_sphere_with_mid_stream_junk.stl");
+    reader.setResynchronizationEnabled(true);
+    TestBinarySTLFileReaderListener listener;
+    reader.readFile(listener);
+
+    EXPECT_EQ(listener.m_readEndCalledCount, 1);
+    EXPECT_EQ(listener.m_triangleCount, 960);
+    EXPECT_EQ(listener.m_readTriangleCalledCount, 960);
+    EXPECT_EQ(listener.m_readUnknownDataCalledCount, 0);
+    EXPECT_EQ(listener.m_readSkippedDataCalledCount, 1);
+    EXPECT_EQ(listener.m_skippedDataOffset, 84u + 480u * 50u);
+    EXPECT_EQ(listener.m_skippedDataSize, 23u);
+}
+
+TEST_F(BinarySTLFileReaderTests, testResynchronizingCleanSphere)
+{
+    // Nothing should be skipped from a healthy file.
+    BinarySTLFileReader reader(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    reader.setResynchronizationEnabled(true);
+    TestBinarySTLFileReaderListener listener;
+    reader.readFile(listener);
+
+    EXPECT_EQ(listener.m_readTriangleCalledCount, 960);
+    EXPECT_EQ(listener.m_readUnknownDataCalledCount, 0);
+    EXPECT_EQ(listener.m_readSkippedDataCalledCount, 0);
+}
+
+TEST_F(BinarySTLFileReaderTests, testResynchronizingSphereWithWeirdDataOnEnd)
+{
+    // Trailing data after the last triangle is still reported as unknown data.
+    BinarySTLFileReader reader(TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl");
+    reader.setResynchronizationEnabled(true);
+    TestBinarySTLFileReaderListener listener;
+    reader.readFile(listener);
+
+    EXPECT_EQ(listener.m_readTriangleCalledCount, 960);
+    EXPECT_EQ(listener.m_readUnknownDataCalledCount, 1);
+    EXPECT_EQ(listener.m_weirdDataBuffer.size(), 5);
+    EXPECT_EQ(listener.m_readSkippedDataCalledCount, 0);
+}
@@ -0,0 +1,248 @@
+#include "CompressedByteStream.h"
+#include "BinarySTLFileReader.h"
+#include "BinarySTLFileFilter.h"
+#include "STLMesh.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+#if defined(STLREPAIR_WITH_ZLIB)
+
+namespace
+{
+    std::vector<uint8_t> readAll(ByteSource& source)
+    {
+        std::vector<uint8_t> data;
+        uint8_t buffer[4096];
+        while (size_t bytesRead = source.read(buffer, sizeof(buffer)))
+            data.insert(data.end(), buffer, buffer + bytesRead);
+        return data;
+    }
+
+    std::vector<uint8_t> readFileData(const std::string& filepath)
+    {
+        std::ifstream file(filepath, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    //! Appends a compressed copy of the input to the output file.
+    void compressFile(const std::string& inputFile, const std::string& outputFile, CompressionFormat format)
+    {
+        std::vector<uint8_t> compressed;
+        std::unique_ptr<ByteSink> spSink = createCompressingByteSink(std::make_unique<VectorByteSink>(compressed), format);
+        const std::vector<uint8_t> data = readFileData(inputFile);
+        spSink->write(data.data(), data.size());
+        spSink->close();
+
+        std::ofstream file(outputFile, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+    }
+
+    std::vector<uint8_t> decompressFile(const std::string& filepath)
+    {
+        std::unique_ptr<ByteSource> spSource = openCompressedFileByteSource(filepath);
+        return readAll(*spSource);
+    }
+}
+
+#endif
+
+class CompressedByteStreamTests : public testing::Test
+{
+
+};
+
+TEST_F(CompressedByteStreamTests, testFormatFromPath)
+{
+    EXPECT_EQ(getCompressionFormatFromPath("part.stl.gz"), CompressionFormat::GZIP);
+    EXPECT_EQ(getCompressionFormatFromPath("part.stl.GZ"), CompressionFormat::GZIP);
+    EXPECT_EQ(getCompressionFormatFromPath("part.stl.zst"), CompressionFormat::ZSTD);
+    EXPECT_EQ(getCompressionFormatFromPath("part.stl"), CompressionFormat::NONE);
+    EXPECT_EQ(getCompressionFormatFromPath("gz"), CompressionFormat::NONE);
+}
+
+TEST_F(CompressedByteStreamTests, testUncompressedInput)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    EXPECT_EQ(detectCompressionFormat(INPUT_FILE), CompressionFormat::NONE);
+    EXPECT_EQ(detectCompressionFormat(TEST_DATA_DIR + "no_such_file.stl"), CompressionFormat::NONE);
+    EXPECT_EQ(getUncompressedSize(INPUT_FILE), FileUtils::getFileSize(INPUT_FILE));
+    EXPECT_THROW(openCompressedFileByteSource(INPUT_FILE), std::runtime_error);
+}
+
+#if defined(STLREPAIR_WITH_ZLIB)
+
+TEST_F(CompressedByteStreamTests, testReadGzip)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_truncated_data.stl";
+    const std::string COMPRESSED_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "compressed.stl.gz");
+    auto fileGuard = makeCallGuard([&]() { _unlink(COMPRESSED_FILE.c_str()); });
+    compressFile(INPUT_FILE, COMPRESSED_FILE, CompressionFormat::GZIP);
+
+    EXPECT_EQ(detectCompressionFormat(COMPRESSED_FILE), CompressionFormat::GZIP);
+    EXPECT_EQ(getUncompressedSize(COMPRESSED_FILE), FileUtils::getFileSize(INPUT_FILE));
+    EXPECT_EQ(decompressFile(COMPRESSED_FILE), readFileData(INPUT_FILE));
+
+    EXPECT_EQ(determineFileType(COMPRESSED_FILE), STLFileType::BINARY);
+    EXPECT_EQ(readTriangleCount(COMPRESSED_FILE), readTriangleCount(INPUT_FILE));
+    EXPECT_EQ(calculateTriangleCount(COMPRESSED_FILE), calculateTriangleCount(INPUT_FILE));
+    EXPECT_EQ(hasExtraData(COMPRESSED_FILE), hasExtraData(INPUT_FILE));
+
+    const BoundingBox expectedBounds = scanBoundingBox(INPUT_FILE);
+    const BoundingBox bounds = scanBoundingBox(COMPRESSED_FILE);
+    EXPECT_EQ(bounds.m_min.x, expectedBounds.m_min.x);
+    EXPECT_EQ(bounds.m_min.y, expectedBounds.m_min.y);
+    EXPECT_EQ(bounds.m_min.z, expectedBounds.m_min.z);
+    EXPECT_EQ(bounds.m_max.x, expectedBounds.m_max.x);
+    EXPECT_EQ(bounds.m_max.y, expectedBounds.m_max.y);
+    EXPECT_EQ(bounds.m_max.z, expectedBounds.m_max.z);
+
+    const STLMesh expected = readMesh(INPUT_FILE);
+    const STLMesh mesh = readMesh(COMPRESSED_FILE);
+    EXPECT_EQ(mesh.m_header, expected.m_header);
+    EXPECT_EQ(mesh.m_triangles, expected.m_triangles);
+    EXPECT_EQ(mesh.m_attributeByteCounts, expected.m_attributeByteCounts);
+}
+
+TEST_F(CompressedByteStreamTests, testSeek)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string COMPRESSED_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "compressed.stl.gz");
+    auto fileGuard = makeCallGuard([&]() { _unlink(COMPRESSED_FILE.c_str()); });
+    compressFile(INPUT_FILE, COMPRESSED_FILE, CompressionFormat::GZIP);
+
+    const std::vector<uint8_t> expected = readFileData(INPUT_FILE);
+    std::unique_ptr<ByteSource> spSource =
+        createDecompressingByteSource(std::make_unique<FileByteSource>(COMPRESSED_FILE), CompressionFormat::GZIP);
+
+    uint8_t buffer[100];
+    ASSERT_TRUE(spSource->seek(30000));
+    ASSERT_EQ(spSource->read(buffer, sizeof(buffer)), sizeof(buffer));
+    EXPECT_TRUE(std::equal(buffer, buffer + sizeof(buffer), expected.begin() + 30000));
+
+    // Backwards means starting over.
+    ASSERT_TRUE(spSource->seek(84));
+    ASSERT_EQ(spSource->read(buffer, sizeof(buffer)), sizeof(buffer));
+    EXPECT_TRUE(std::equal(buffer, buffer + sizeof(buffer), expected.begin() + 84));
+
+    EXPECT_FALSE(spSource->seek(expected.size() + 1));
+}
+
+TEST_F(CompressedByteStreamTests, testConcatenatedMembers)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string COMPRESSED_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "compressed.stl.gz");
+    auto fileGuard = makeCallGuard([&]() { _unlink(COMPRESSED_FILE.c_str()); });
+    compressFile(INPUT_FILE, COMPRESSED_FILE, CompressionFormat::GZIP);
+    compressFile(INPUT_FILE, COMPRESSED_FILE, CompressionFormat::GZIP);
+
+    std::vector<uint8_t> expected = readFileData(INPUT_FILE);
+    expected.insert(expected.end(), expected.begin(), expected.end());
+    EXPECT_EQ(decompressFile(COMPRESSED_FILE), expected);
+}
+
+TEST_F(CompressedByteStreamTests, testTruncatedGzip)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string COMPRESSED_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "compressed.stl.gz");
+    auto fileGuard = makeCallGuard([&]() { _unlink(COMPRESSED_FILE.c_str()); });
+    compressFile(INPUT_FILE, COMPRESSED_FILE, CompressionFormat::GZIP);
+
+    std::vector<uint8_t> compressed = readFileData(COMPRESSED_FILE);
+    compressed.resize(compressed.size() / 2);
+    std::ofstream(COMPRESSED_FILE, std::ios::binary).write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+
+    EXPECT_THROW(decompressFile(COMPRESSED_FILE), std::runtime_error);
+    EXPECT_THROW(getUncompressedSize(COMPRESSED_FILE), std::runtime_error);
+}
+
+TEST_F(CompressedByteStreamTests, testRepairToGzip)
+{
+    // The declared count is far too big, so the repair changes it.
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl";
+    const std::string COMPRESSED_INPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "compressed.stl.gz");
+    const std::string EXPECTED_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "expected.stl");
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "repaired.stl.gz");
+    auto fileGuard = makeCallGuard([&]()
+    {
+        _unlink(COMPRESSED_INPUT_FILE.c_str());
+        _unlink(EXPECTED_FILE.c_str());
+        _unlink(OUTPUT_FILE.c_str());
+    });
+    compressFile(INPUT_FILE, COMPRESSED_INPUT_FILE, CompressionFormat::GZIP);
+
+    auto setUpFilter = [&](BinarySTLFileFilter& filter)
+    {
+        filter.m_updateTriangleCount = true;
+        filter.m_triangleLimit = calculateTriangleCount(COMPRESSED_INPUT_FILE);
+        filter.m_clearExtraFileData = true;
+        filter.m_stampPayloadDigest = true;
+    };
+
+    {
+        BinarySTLFileFilter filter(EXPECTED_FILE);
+        setUpFilter(filter);
+        BinarySTLFileReader(INPUT_FILE).readFile(filter);
+    }
+
+    // Without the start of the file worked out up front, there's no way to
+    // fix it afterwards.
+    {
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        setUpFilter(filter);
+        filter.m_outputCompression = CompressionFormat::GZIP;
+        EXPECT_THROW(BinarySTLFileReader(COMPRESSED_INPUT_FILE).readFile(filter), std::runtime_error);
+    }
+
+    {
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        setUpFilter(filter);
+        filter.m_outputCompression = CompressionFormat::GZIP;
+
+        STLBinaryHeader header;
+        uint32_t triangleCount = 0;
+        predictFileStart(COMPRESSED_INPUT_FILE, filter.getRepairOptions(), header, triangleCount);
+        EXPECT_EQ(triangleCount, 960u);
+
+        filter.setFileStart(header, triangleCount);
+        BinarySTLFileReader(COMPRESSED_INPUT_FILE).readFile(filter);
+    }
+
+    EXPECT_EQ(detectCompressionFormat(OUTPUT_FILE), CompressionFormat::GZIP);
+    EXPECT_EQ(decompressFile(OUTPUT_FILE), readFileData(EXPECTED_FILE));
+}
+
+TEST_F(CompressedByteStreamTests, testWrongFileStart)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "repaired.stl.gz");
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    BinarySTLFileFilter filter(OUTPUT_FILE);
+    filter.m_updateTriangleCount = true;
+    filter.m_triangleLimit = calculateTriangleCount(INPUT_FILE);
+    filter.m_outputCompression = CompressionFormat::GZIP;
+    filter.setFileStart(readMesh(INPUT_FILE).m_header, 959);
+
+    EXPECT_THROW(BinarySTLFileReader(INPUT_FILE).readFile(filter), std::runtime_error);
+}
+
+#else
+
+TEST_F(CompressedByteStreamTests, testGzipUnsupported)
+{
+    std::vector<uint8_t> data;
+    EXPECT_FALSE(isCompressionSupported(CompressionFormat::GZIP));
+    EXPECT_THROW(createCompressingByteSink(std::make_unique<VectorByteSink>(data), CompressionFormat::GZIP),
+        std::runtime_error);
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include "ConnectedComponents.h"
+#include "STLGeometry.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    void addTriangle(STLMesh& mesh, const Vec3& a, const Vec3& b, const Vec3& c)
+    {
+        STLFacet facet = { { 0.0f, 0.0f, 1.0f }, { a, b, c } };
+        STLBinaryTriangleData triangle;
+        encodeFacet(facet, triangle);
+        mesh.m_triangles.push_back(triangle);
+        mesh.m_attributeByteCounts.push_back(0);
+    }
+
+    // Two separate quads, each made of two triangles sharing an edge.
+    STLMesh makeTwoQuads()
+    {
+        STLMesh mesh;
+        memset(mesh.m_header.data(), 0, mesh.m_header.size());
+        addTriangle(mesh, { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 });
+        addTriangle(mesh, { 5, 0, 0 }, { 6, 0, 0 }, { 6, 1, 0 });
+        addTriangle(mesh, { 0, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 });
+        addTriangle(mesh, { 5, 0, 0 }, { 6, 1, 0 }, { 5, 1, -0.0f });
+        addTriangle(mesh, { 5, 1, 0 }, { 4, 1, 0 }, { 4, 0, 0 });
+        return mesh;
+    }
+}
+
+class ConnectedComponentsTests : public testing::Test
+{
+
+};
+
+TEST_F(ConnectedComponentsTests, testUnionFind)
+{
+    ConcurrentUnionFind sets(6);
+    sets.unite(4, 2);
+    sets.unite(5, 4);
+    sets.unite(1, 3);
+
+    EXPECT_EQ(sets.find(5), 2);
+    EXPECT_EQ(sets.find(4), 2);
+    EXPECT_EQ(sets.find(3), 1);
+    EXPECT_EQ(sets.find(0), 0);
+    EXPECT_NE(sets.find(1), sets.find(2));
+}
+
+TEST_F(ConnectedComponentsTests, testSphereIsOneComponent)
+{
+    STLMesh mesh = readMesh(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    ComponentLabels labels = findConnectedComponents(mesh);
+
+    EXPECT_EQ(mesh.size(), 960);
+    EXPECT_EQ(labels.m_componentCount, 1);
+}
+
+TEST_F(ConnectedComponentsTests, testTwoQuads)
+{
+    STLMesh mesh = makeTwoQuads();
+    ComponentLabels labels = findConnectedComponents(mesh);
+
+    // Negative zero must weld with positive zero, pulling in the last triangle.
+    EXPECT_EQ(labels.m_componentCount, 2);
+    EXPECT_EQ(labels.m_triangleComponents, (std::vector<uint32_t>{ 0, 1, 0, 1, 1 }));
+}
+
+TEST_F(ConnectedComponentsTests, testWriteComponents)
+{
+    STLMesh mesh = makeTwoQuads();
+    ComponentLabels labels = findConnectedComponents(mesh);
+
+    auto outputFiles = writeConnectedComponents(mesh, labels,
+        TEST_DATA_DIR + "quads.stl", true, true);
+    auto fileGuard = makeCallGuard([&]()
+    {
+        for (const auto& file : outputFiles)
+            _unlink(file.c_str());
+    });
+
+    ASSERT_EQ(outputFiles.size(), 2);
+    EXPECT_EQ(outputFiles[0], TEST_DATA_DIR + "quads_part1.stl");
+    EXPECT_EQ(outputFiles[1], TEST_DATA_DIR + "quads_part2.stl");
+
+    EXPECT_EQ(readTriangleCount(outputFiles[0]), 2);
+    EXPECT_EQ(calculateTriangleCount(outputFiles[0]), 2);
+    EXPECT_EQ(readTriangleCount(outputFiles[1]), 3);
+    EXPECT_EQ(calculateTriangleCount(outputFiles[1]), 3);
+}
@@ -0,0 +1,120 @@
+#include "DirectFileIO.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    std::vector<uint8_t> readAll(ByteSource& source, size_t chunkSize)
+    {
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> chunk(chunkSize);
+        size_t bytesRead = 0;
+        while ((bytesRead = source.read(chunk.data(), chunk.size())) > 0)
+            data.insert(data.end(), chunk.begin(), chunk.begin() + bytesRead);
+        return data;
+    }
+
+    void testWritingSize(size_t size)
+    {
+        std::vector<uint8_t> expected(size);
+        for (size_t i = 0; i < expected.size(); ++i)
+            expected[i] = static_cast<uint8_t>(i * 31);
+
+        const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "direct_write_test.bin");
+        auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+        auto spSink = createDirectFileByteSink(OUTPUT_FILE, DIRECT_IO_ALIGNMENT);
+        for (size_t offset = 0; offset < expected.size(); offset += 50)
+            spSink->write(expected.data() + offset, std::min<size_t>(50, expected.size() - offset));
+        spSink->close();
+        spSink.reset();
+
+        EXPECT_EQ(FileUtils::readWholeFile(OUTPUT_FILE), expected);
+    }
+}
+
+class DirectFileIOTests : public testing::Test
+{
+
+};
+
+TEST_F(DirectFileIOTests, testReadingMatchesFile)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::vector<uint8_t> expected = FileUtils::readWholeFile(INPUT_FILE);
+
+    // The header and the odd read size mean no read lines up with a block.
+    auto spSource = openDirectFileByteSource(INPUT_FILE, DIRECT_IO_ALIGNMENT);
+    uint8_t header[84];
+    ASSERT_EQ(spSource->read(header, sizeof(header)), sizeof(header));
+    std::vector<uint8_t> actual(header, header + sizeof(header));
+    std::vector<uint8_t> rest = readAll(*spSource, 50);
+    actual.insert(actual.end(), rest.begin(), rest.end());
+
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(DirectFileIOTests, testSeeking)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::vector<uint8_t> expected = FileUtils::readWholeFile(INPUT_FILE);
+
+    auto spSource = openDirectFileByteSource(INPUT_FILE, DIRECT_IO_ALIGNMENT);
+    uint8_t buffer[100];
+
+    ASSERT_TRUE(spSource->seek(expected.size() - 10));
+    ASSERT_EQ(spSource->read(buffer, sizeof(buffer)), 10u);
+    EXPECT_EQ(memcmp(buffer, expected.data() + expected.size() - 10, 10), 0);
+
+    ASSERT_TRUE(spSource->seek(4090));
+    ASSERT_EQ(spSource->read(buffer, sizeof(buffer)), sizeof(buffer));
+    EXPECT_EQ(memcmp(buffer, expected.data() + 4090, sizeof(buffer)), 0);
+
+    ASSERT_TRUE(spSource->seek(expected.size() + 100));
+    EXPECT_EQ(spSource->read(buffer, sizeof(buffer)), 0u);
+}
+
+TEST_F(DirectFileIOTests, testWritingOddSize)
+{
+    testWritingSize(10050);
+}
+
+TEST_F(DirectFileIOTests, testWritingAlignedSize)
+{
+    testWritingSize(2 * DIRECT_IO_ALIGNMENT);
+}
+
+TEST_F(DirectFileIOTests, testFilterOutputMatches)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string CACHED_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto cachedFileGuard = makeCallGuard([&]() { _unlink(CACHED_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(CACHED_FILE);
+        filter.m_updateTriangleCount = true;
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    const std::string DIRECT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto directFileGuard = makeCallGuard([&]() { _unlink(DIRECT_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(DIRECT_FILE);
+        filter.m_updateTriangleCount = true;
+        filter.m_bypassPageCache = true;
+        BinarySTLFileReader reader(openDirectFileByteSource(INPUT_FILE));
+        reader.readFile(filter);
+    }
+
+    EXPECT_EQ(FileUtils::areFilesEqual(CACHED_FILE, DIRECT_FILE), true);
+}
@@ -0,0 +1,107 @@
+#include "FacetDiff.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <cstring>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    const size_t RECORD_SIZE = 50;
+
+    //! Facet records that are all different from each other.
+    std::vector<uint8_t> makeRecords(uint32_t facetCount)
+    {
+        std::vector<uint8_t> records(facetCount * RECORD_SIZE, 0);
+        for (uint32_t facet = 0; facet < facetCount; ++facet)
+            memcpy(&records[facet * RECORD_SIZE + 20], &facet, sizeof(facet));
+        return records;
+    }
+}
+
+class FacetDiffTests : public testing::Test
+{
+
+};
+
+TEST_F(FacetDiffTests, testIdenticalRecords)
+{
+    const std::vector<uint8_t> records = makeRecords(1000);
+
+    FacetDiff diff = diffFacets(records.data(), 1000, records.data(), 1000);
+    EXPECT_EQ(diff.isIdentical(), true);
+}
+
+TEST_F(FacetDiffTests, testChangedFacet)
+{
+    const std::vector<uint8_t> left = makeRecords(1000);
+    std::vector<uint8_t> right = left;
+    right[417 * RECORD_SIZE + 49] ^= 0x80;
+
+    FacetDiff diff = diffFacets(left.data(), 1000, right.data(), 1000);
+    EXPECT_EQ(diff.m_changedFacets, std::vector<uint32_t>{ 417 });
+    EXPECT_EQ(diff.m_removedFacets.empty(), true);
+    EXPECT_EQ(diff.m_addedFacets.empty(), true);
+    EXPECT_EQ(diff.m_movedFacetCount, 0u);
+}
+
+TEST_F(FacetDiffTests, testInsertedFacetShowsAsAddedNotChanged)
+{
+    const std::vector<uint8_t> left = makeRecords(1000);
+    std::vector<uint8_t> right(RECORD_SIZE, 0xEE);
+    right.insert(right.end(), left.begin(), left.end());
+
+    FacetDiff diff = diffFacets(left.data(), 1000, right.data(), 1001);
+    EXPECT_EQ(diff.m_addedFacets, std::vector<uint32_t>{ 0 });
+    EXPECT_EQ(diff.m_changedFacets.empty(), true);
+    EXPECT_EQ(diff.m_removedFacets.empty(), true);
+    EXPECT_EQ(diff.m_movedFacetCount, 1000u);
+}
+
+TEST_F(FacetDiffTests, testRemovedFacet)
+{
+    const std::vector<uint8_t> left = makeRecords(1000);
+
+    FacetDiff diff = diffFacets(left.data(), 1000, left.data(), 999);
+    EXPECT_EQ(diff.m_removedFacets, std::vector<uint32_t>{ 999 });
+    EXPECT_EQ(diff.m_changedFacets.empty(), true);
+    EXPECT_EQ(diff.m_addedFacets.empty(), true);
+}
+
+TEST_F(FacetDiffTests, testReorderedFile)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        filter.m_sortByMortonCode = true;
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    FacetDiff diff = diffSTLFiles(INPUT_FILE, OUTPUT_FILE);
+    EXPECT_EQ(diff.m_isHeaderDifferent, false);
+    EXPECT_EQ(diff.m_changedFacets.empty(), true);
+    EXPECT_EQ(diff.m_removedFacets.empty(), true);
+    EXPECT_EQ(diff.m_addedFacets.empty(), true);
+    EXPECT_GT(diff.m_movedFacetCount, 0u);
+}
+
+TEST_F(FacetDiffTests, testTriangleCountDifference)
+{
+    FacetDiff diff = diffSTLFiles(TEST_DATA_DIR + "binary_5mm_sphere.stl",
+        TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl");
+
+    EXPECT_NE(diff.m_leftTriangleCount, diff.m_rightTriangleCount);
+    EXPECT_EQ(diff.m_leftFacetCount, diff.m_rightFacetCount);
+    EXPECT_EQ(diff.m_changedFacets.empty(), true);
+    EXPECT_EQ(diff.isIdentical(), false);
+}
@@ -0,0 +1,141 @@
+#include "FacetReader.h"
+#include "BinarySTLFileReader.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    struct Record
+    {
+        STLBinaryTriangleData m_triangle;
+        uint16_t m_attributeByteCount;
+
+        bool operator==(const Record& other) const
+        {
+            return (m_triangle == other.m_triangle) && (m_attributeByteCount == other.m_attributeByteCount);
+        }
+    };
+
+    // What the callback reader makes of the file, for comparison.
+    std::vector<Record> readWithListener(const std::string& filepath)
+    {
+        class CollectingListener : public BinarySTLFileReaderListener
+        {
+        public:
+            bool onReadTriangle(const STLBinaryTriangleData& triangle, const uint16_t attributeByteCount) override
+            {
+                m_records.push_back({ triangle, attributeByteCount });
+                return true;
+            }
+            std::vector<Record> m_records;
+        };
+
+        CollectingListener listener;
+        BinarySTLFileReader reader(filepath);
+        reader.readFile(listener);
+        return listener.m_records;
+    }
+
+    std::vector<Record> readWithFacetReader(FacetReader& reader)
+    {
+        std::vector<Record> records;
+        uint64_t expectedIndex = 0;
+        for (const FacetBatch& batch : reader)
+        {
+            EXPECT_EQ(batch.getFirstIndex(), expectedIndex);
+            expectedIndex += batch.size();
+
+            for (FacetView facet : batch)
+            {
+                Record record;
+                facet.copyTriangleData(record.m_triangle);
+                record.m_attributeByteCount = facet.getAttributeByteCount();
+                records.push_back(record);
+            }
+        }
+        return records;
+    }
+}
+
+class FacetReaderTests : public testing::Test
+{
+
+};
+
+TEST_F(FacetReaderTests, testMatchesListenerReader)
+{
+    for (const char* filename : { "binary_5mm_sphere.stl", "binary_5mm_sphere_weird_data_on_end.stl",
+        "binary_5mm_sphere_truncated_data.stl", "binary_5mm_sphere_with_giant_triangle_count.stl" })
+    {
+        const std::string INPUT_FILE = TEST_DATA_DIR + filename;
+        const std::vector<Record> expected = readWithListener(INPUT_FILE);
+
+        FacetReader mappedReader(INPUT_FILE, 100);
+        EXPECT_EQ(readWithFacetReader(mappedReader), expected) << filename;
+
+        FacetReader bufferedReader(std::make_unique<FileByteSource>(INPUT_FILE), 100);
+        EXPECT_EQ(readWithFacetReader(bufferedReader), expected) << filename;
+        EXPECT_EQ(bufferedReader.getTriangleCount(), mappedReader.getTriangleCount()) << filename;
+    }
+}
+
+TEST_F(FacetReaderTests, testHeaderAndDecoding)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    FacetReader reader(INPUT_FILE);
+    EXPECT_EQ(reader.getTriangleCount(), 960u);
+
+    FacetBatch batch;
+    ASSERT_TRUE(reader.next(batch));
+    ASSERT_EQ(batch.size(), 960u);
+
+    STLBinaryTriangleData triangleData;
+    batch[5].copyTriangleData(triangleData);
+    const STLFacet expected = decodeFacet(triangleData);
+    const STLFacet actual = batch[5].getFacet();
+    EXPECT_EQ(memcmp(&expected, &actual, sizeof(expected)), 0);
+
+    const Vec3 vertex = batch[5].getVertex(2);
+    EXPECT_EQ(vertex.x, expected.vertices[2].x);
+    EXPECT_EQ(vertex.y, expected.vertices[2].y);
+    EXPECT_EQ(vertex.z, expected.vertices[2].z);
+
+    EXPECT_FALSE(reader.next(batch));
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(FacetReaderTests, testEarlyExit)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    FacetReader reader(INPUT_FILE, 64);
+
+    size_t batchCount = 0;
+    for (const FacetBatch& batch : reader)
+    {
+        EXPECT_EQ(batch.size(), 64u);
+        if (++batchCount == 2)
+            break;
+    }
+
+    // Picking up again carries on from where we stopped.
+    FacetBatch batch;
+    ASSERT_TRUE(reader.next(batch));
+    EXPECT_EQ(batch.getFirstIndex(), 128u);
+}
+
+TEST_F(FacetReaderTests, testPartialRecordIsIgnored)
+{
+    // A header and count followed by less than one whole record.
+    FacetReader reader(TEST_DATA_DIR + "binarytoosmall.stl");
+    FacetBatch batch;
+    EXPECT_FALSE(reader.next(batch));
+}
+
+TEST_F(FacetReaderTests, testMissingFileThrows)
+{
+    EXPECT_THROW(FacetReader(TEST_DATA_DIR + "no_such_file.stl"), std::runtime_error);
+}
@@ -208,4 +208,27 @@ TEST_F(FileUtilsTests, testGenerateUniqueFilePathWithTwoFilesThatAlreadyExists)
 
     std::string newPath = FileUtils::generateUniqueFilePath(TEST_FILE_1);
     EXPECT_EQ(newPath, EXPECTED_TEST_FILE);
-}
\ No newline at end of file
+}
+
+TEST_F(FileUtilsTests, testReadWholeFile)
+{
+    const std::string TEST_FILE(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+
+    const std::vector<uint8_t> data = FileUtils::readWholeFile(TEST_FILE);
+    EXPECT_EQ(data.size(), FileUtils::getFileSize(TEST_FILE));
+}
+
+TEST_F(FileUtilsTests, testReadWholeFileThatDoesntExist)
+{
+    EXPECT_THROW(FileUtils::readWholeFile(TEST_DATA_DIR + "no_such_file.stl"), std::runtime_error);
+}
+
+TEST_F(FileUtilsTests, testGenerateRandomSuffix)
+{
+    const std::string suffix1 = FileUtils::generateRandomSuffix();
+    const std::string suffix2 = FileUtils::generateRandomSuffix();
+
+    EXPECT_EQ(suffix1.size(), 16u);
+    EXPECT_EQ(suffix1.find_first_not_of("0123456789abcdef"), std::string::npos);
+    EXPECT_NE(suffix1, suffix2);
+}
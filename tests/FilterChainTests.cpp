@@ -0,0 +1,168 @@
+#include "FilterChain.h"
+#include "FilterStages.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    struct StageLog
+    {
+        std::vector<std::string> m_events;
+        size_t m_triangleCount = 0;
+    };
+
+    class LoggingStage : public FilterStage
+    {
+    public:
+
+        LoggingStage(StageLog& log, const std::string& name) : m_log(log), m_name(name) {}
+
+        void processTriangles(TriangleBatch& batch) override
+        {
+            m_log.m_events.push_back(m_name + ":batch");
+            m_log.m_triangleCount += batch.size();
+        }
+
+        void finishTriangles(TriangleBatch& /*batch*/) override
+        {
+            m_log.m_events.push_back(m_name + ":finish");
+        }
+
+    private:
+
+        StageLog& m_log;
+        std::string m_name;
+    };
+
+    //! Drops every other triangle.
+    class DecimateStage : public FilterStage
+    {
+    public:
+
+        void processTriangles(TriangleBatch& batch) override
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < batch.size(); ++i, ++m_seen)
+            {
+                if (m_seen % 2 != 0)
+                    continue;
+                batch.m_triangles[kept] = batch.m_triangles[i];
+                batch.m_attributeByteCounts[kept] = batch.m_attributeByteCounts[i];
+                ++kept;
+            }
+            batch.resize(kept);
+        }
+
+    private:
+
+        size_t m_seen = 0;
+    };
+
+    uint32_t readTriangleCountField(const std::string& filepath)
+    {
+        uint32_t triangleCount = 0;
+        FILE* pFile = fopen(filepath.c_str(), "rb");
+        fseek(pFile, BINARY_STL_HEADER_SIZE_IN_BYTES, SEEK_SET);
+        fread(&triangleCount, 1, sizeof(triangleCount), pFile);
+        fclose(pFile);
+        return triangleCount;
+    }
+}
+
+class FilterChainTests : public testing::Test
+{
+
+};
+
+TEST_F(FilterChainTests, testEmptyChainCopiesFile)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    {
+        FilterChain chain(OUTPUT_FILE, 100);
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(chain);
+    }
+
+    EXPECT_EQ(FileUtils::areFilesEqual(INPUT_FILE, OUTPUT_FILE), true);
+}
+
+TEST_F(FilterChainTests, testStagesShareOnePass)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    StageLog log;
+    {
+        FilterChain chain(OUTPUT_FILE, 400);
+        chain.addStage(std::make_unique<LoggingStage>(log, "a"))
+             .addStage(std::make_unique<LoggingStage>(log, "b"));
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(chain);
+        EXPECT_EQ(chain.getWrittenTriangleCount(), 960u);
+    }
+
+    // 960 triangles make three batches, and each one visits every stage
+    // before the next one is read.
+    std::vector<std::string> expected;
+    for (int batch = 0; batch < 3; ++batch)
+    {
+        expected.push_back("a:batch");
+        expected.push_back("b:batch");
+    }
+    expected.push_back("a:finish");
+    expected.push_back("b:finish");
+    EXPECT_EQ(log.m_events, expected);
+    EXPECT_EQ(log.m_triangleCount, 2u * 960u);
+}
+
+TEST_F(FilterChainTests, testHeldBackTrianglesReachLaterStages)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    StageLog log;
+    {
+        FilterChain chain(OUTPUT_FILE, 64);
+        chain.addStage(std::make_unique<MortonOrderStage>())
+             .addStage(std::make_unique<LoggingStage>(log, "after"));
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(chain);
+    }
+
+    // Nothing gets past the sort until the end, and then everything does.
+    std::vector<std::string> expected = { "after:batch", "after:finish" };
+    EXPECT_EQ(log.m_events, expected);
+    EXPECT_EQ(log.m_triangleCount, 960u);
+}
+
+TEST_F(FilterChainTests, testCustomStageWithCountUpdate)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        filter.m_updateTriangleCount = true;
+        filter.addStage(std::make_unique<DecimateStage>());
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    EXPECT_EQ(readTriangleCountField(OUTPUT_FILE), 480u);
+    EXPECT_EQ(FileUtils::getFileSize(OUTPUT_FILE),
+        static_cast<uint64_t>(BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES + 480 * 50));
+}
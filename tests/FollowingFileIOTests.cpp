@@ -0,0 +1,161 @@
+#include "FollowingFileIO.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+#if defined(__linux__)
+
+namespace
+{
+    std::vector<uint8_t> readAll(ByteSource& source, size_t chunkSize)
+    {
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> chunk(chunkSize);
+        size_t bytesRead = 0;
+        while ((bytesRead = source.read(chunk.data(), chunk.size())) > 0)
+            data.insert(data.end(), chunk.begin(), chunk.begin() + bytesRead);
+        return data;
+    }
+
+    /**
+     * Writes data to a file a bit at a time on another thread, like a slow
+     * download. The first chunk's there before the constructor returns.
+     */
+    class SlowWriter
+    {
+    public:
+
+        SlowWriter(const std::string& filepath, const std::vector<uint8_t>& data, size_t chunkSize) :
+            m_pFile(fopen(filepath.c_str(), "wb"))
+        {
+            if (!m_pFile)
+                throw std::runtime_error("Could not create " + filepath);
+
+            const size_t firstChunkSize = std::min(chunkSize, data.size());
+            fwrite(data.data(), 1, firstChunkSize, m_pFile);
+            fflush(m_pFile);
+
+            m_thread = std::thread([this, &data, chunkSize, firstChunkSize]()
+            {
+                for (size_t offset = firstChunkSize; offset < data.size(); offset += chunkSize)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    fwrite(data.data() + offset, 1, std::min(chunkSize, data.size() - offset), m_pFile);
+                    fflush(m_pFile);
+                }
+                fclose(m_pFile);
+            });
+        }
+
+        ~SlowWriter() { m_thread.join(); }
+
+    private:
+
+        FILE* m_pFile;
+        std::thread m_thread;
+    };
+
+    void repair(std::unique_ptr<ByteSource> spSource, const std::string& outputFile)
+    {
+        BinarySTLFileFilter filter(outputFile);
+        filter.m_updateTriangleCount = true;
+        filter.m_clearExtraFileData = true;
+
+        BinarySTLFileReader reader(std::move(spSource));
+        reader.readFile(filter);
+    }
+}
+
+class FollowingFileIOTests : public testing::Test
+{
+
+};
+
+TEST_F(FollowingFileIOTests, testReadsFinishedFile)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+
+    auto spSource = openFollowingFileByteSource(INPUT_FILE);
+    EXPECT_EQ(readAll(*spSource, 4096), FileUtils::readWholeFile(INPUT_FILE));
+}
+
+TEST_F(FollowingFileIOTests, testReadsUntilWriterCloses)
+{
+    const std::vector<uint8_t> expected = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    const std::string GROWING_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "following.stl");
+    auto fileGuard = makeCallGuard([&]() { _unlink(GROWING_FILE.c_str()); });
+
+    std::vector<uint8_t> data;
+    {
+        SlowWriter writer(GROWING_FILE, expected, 777);
+        auto spSource = openFollowingFileByteSource(GROWING_FILE);
+        data = readAll(*spSource, 4096);
+    }
+
+    EXPECT_EQ(data, expected);
+}
+
+TEST_F(FollowingFileIOTests, testRepairMatchesFinishedFile)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_truncated_data.stl";
+    const std::string GROWING_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "following.stl");
+    const std::string EXPECTED_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "following_expected.stl");
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "following_output.stl");
+    auto fileGuard = makeCallGuard([&]()
+    {
+        _unlink(GROWING_FILE.c_str());
+        _unlink(EXPECTED_FILE.c_str());
+        _unlink(OUTPUT_FILE.c_str());
+    });
+
+    repair(std::make_unique<FileByteSource>(INPUT_FILE), EXPECTED_FILE);
+
+    // Starts with less than a header, and the partial facet on the end
+    // arrives last.
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(INPUT_FILE);
+    {
+        SlowWriter writer(GROWING_FILE, input, 60);
+        repair(openFollowingFileByteSource(GROWING_FILE), OUTPUT_FILE);
+    }
+
+    EXPECT_TRUE(FileUtils::areFilesEqual(EXPECTED_FILE, OUTPUT_FILE));
+}
+
+TEST_F(FollowingFileIOTests, testThrowsIfDeleted)
+{
+    const std::string GROWING_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "following.stl");
+    auto fileGuard = makeCallGuard([&]() { _unlink(GROWING_FILE.c_str()); });
+
+    FILE* pFile = fopen(GROWING_FILE.c_str(), "wb");
+    ASSERT_NE(pFile, nullptr);
+    auto closeGuard = makeCallGuard([&]() { fclose(pFile); });
+
+    auto spSource = openFollowingFileByteSource(GROWING_FILE);
+    std::thread deleter([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        _unlink(GROWING_FILE.c_str());
+    });
+
+    uint8_t buffer[16];
+    EXPECT_THROW(spSource->read(buffer, sizeof(buffer)), std::runtime_error);
+    deleter.join();
+}
+
+TEST_F(FollowingFileIOTests, testMissingFileThrows)
+{
+    EXPECT_THROW(openFollowingFileByteSource(TEST_DATA_DIR + "no_such_file.stl"), std::runtime_error);
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "InMemoryRepair.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+class InMemoryRepairTests : public testing::Test
+{
+
+};
+
+TEST_F(InMemoryRepairTests, testNoOptionsCopiesInput)
+{
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+
+    std::vector<uint8_t> output;
+    RepairResult result = repairSTL(input.data(), input.size(), output, RepairOptions());
+
+    EXPECT_EQ(output, input);
+    EXPECT_EQ(result.m_triangleCount, 960u);
+    EXPECT_EQ(result.m_outputSize, input.size());
+    EXPECT_EQ(result.m_skippedByteCount, 0u);
+}
+
+TEST_F(InMemoryRepairTests, testMatchesFileRepair)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        filter.m_zeroOutHeader = true;
+        filter.m_clearExtraFileData = true;
+        filter.m_updateTriangleCount = true;
+        filter.m_sortByMortonCode = true;
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    RepairOptions options;
+    options.m_zeroOutHeader = true;
+    options.m_clearExtraFileData = true;
+    options.m_updateTriangleCount = true;
+    options.m_sortByMortonCode = true;
+
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(INPUT_FILE);
+    std::vector<uint8_t> output;
+    repairSTL(input.data(), input.size(), output, options);
+
+    EXPECT_EQ(output, FileUtils::readWholeFile(OUTPUT_FILE));
+}
+
+TEST_F(InMemoryRepairTests, testCountPatchedInOutputBuffer)
+{
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl");
+
+    RepairOptions options;
+    options.m_updateTriangleCount = true;
+
+    std::vector<uint8_t> output(input.size());
+    RepairResult result = repairSTL(input.data(), input.size(), output.data(), output.size(), options);
+    output.resize(result.m_outputSize);
+
+    EXPECT_EQ(output, FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl"));
+}
+
+TEST_F(InMemoryRepairTests, testOutputBufferTooSmall)
+{
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+
+    std::vector<uint8_t> output(input.size() / 2);
+    EXPECT_THROW(repairSTL(input.data(), input.size(), output.data(), output.size(), RepairOptions()),
+        std::runtime_error);
+}
+
+TEST_F(InMemoryRepairTests, testInputTooSmall)
+{
+    const std::vector<uint8_t> input(10, 0);
+
+    std::vector<uint8_t> output;
+    EXPECT_THROW(repairSTL(input.data(), input.size(), output, RepairOptions()), std::runtime_error);
+}
+
+TEST_F(InMemoryRepairTests, testConcurrentRepairs)
+{
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_with_mid_stream_junk.stl");
+
+    RepairOptions options;
+    options.m_resynchronize = true;
+    options.m_sortByMortonCode = true;
+
+    std::vector<uint8_t> expected;
+    repairSTL(input.data(), input.size(), expected, options);
+
+    std::vector<std::vector<uint8_t>> outputs(4);
+    std::vector<std::thread> threads;
+    for (auto& output : outputs)
+        threads.emplace_back([&]() { repairSTL(input.data(), input.size(), output, options); });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& output : outputs)
+        EXPECT_EQ(output, expected);
+}
+
+TEST_F(InMemoryRepairTests, testPlanRepairsLeavesGoodFileAlone)
+{
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+
+    RepairOptions baseOptions;
+    baseOptions.m_zeroOutHeader = true;
+    const RepairOptions options = planRepairs(input.data(), input.size(), baseOptions);
+
+    EXPECT_TRUE(options.m_zeroOutHeader);
+    EXPECT_FALSE(options.m_updateTriangleCount);
+    EXPECT_FALSE(options.m_clearExtraFileData);
+    EXPECT_EQ(options.m_triangleLimit, 0u);
+}
+
+TEST_F(InMemoryRepairTests, testPlanRepairsFixesCountAndTail)
+{
+    const std::vector<uint8_t> giantCount = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl");
+    RepairOptions options = planRepairs(giantCount.data(), giantCount.size(), RepairOptions());
+    EXPECT_TRUE(options.m_updateTriangleCount);
+    EXPECT_TRUE(options.m_clearExtraFileData);
+    EXPECT_EQ(options.m_triangleLimit, 960u);
+
+    const std::vector<uint8_t> extraData = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl");
+    options = planRepairs(extraData.data(), extraData.size(), RepairOptions());
+    EXPECT_FALSE(options.m_updateTriangleCount);
+    EXPECT_TRUE(options.m_clearExtraFileData);
+
+    std::vector<uint8_t> output;
+    RepairResult result = repairSTL(extraData.data(), extraData.size(), output, options);
+    EXPECT_EQ(result.m_triangleCount, 960u);
+    EXPECT_EQ(output, FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl"));
+}
+
+TEST_F(InMemoryRepairTests, testResultOnlyReportsRepairsThatChangedSomething)
+{
+    RepairOptions options;
+    options.m_updateTriangleCount = true;
+    options.m_zeroAttributeByteCounts = true;
+    options.m_clearExtraFileData = true;
+
+    // Nothing to fix.
+    const std::vector<uint8_t> clean = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    std::vector<uint8_t> output;
+    RepairResult result = repairSTL(clean.data(), clean.size(), output, options);
+    EXPECT_FALSE(result.m_isHeaderCleared);
+    EXPECT_FALSE(result.m_isTriangleCountChanged);
+    EXPECT_EQ(result.m_zeroedAttributeCount, 0u);
+    EXPECT_EQ(result.m_droppedByteCount, 0u);
+
+    const std::vector<uint8_t> giantCount = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl");
+    output.clear();
+    result = repairSTL(giantCount.data(), giantCount.size(), output, planRepairs(giantCount.data(), giantCount.size(), options));
+    EXPECT_TRUE(result.m_isTriangleCountChanged);
+
+    const std::vector<uint8_t> abcs = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_with_abcs.stl");
+    output.clear();
+    result = repairSTL(abcs.data(), abcs.size(), output, options);
+    EXPECT_EQ(result.m_zeroedAttributeCount, 960u);
+    EXPECT_FALSE(result.m_isTriangleCountChanged);
+
+    const std::vector<uint8_t> extraData = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl");
+    output.clear();
+    options.m_zeroOutHeader = true;
+    result = repairSTL(extraData.data(), extraData.size(), output, options);
+    EXPECT_EQ(result.m_droppedByteCount, extraData.size() - clean.size());
+    EXPECT_TRUE(result.m_isHeaderCleared);
+}
@@ -0,0 +1,169 @@
+#include "Metrics.h"
+#include "MetricsExporter.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+class MetricsTests : public testing::Test
+{
+protected:
+
+    void SetUp() override { Metrics::setEnabled(true); }
+    void TearDown() override { Metrics::setEnabled(false); }
+};
+
+TEST_F(MetricsTests, testNothingRecordedWhenDisabled)
+{
+    Metrics::setEnabled(false);
+    const MetricsSnapshot before = Metrics::getSnapshot();
+    Metrics::recordFailure(MetricsSource::WATCH, 1000);
+    const MetricsSnapshot after = Metrics::getSnapshot();
+
+    EXPECT_EQ(after.get(MetricsSource::WATCH, MetricsCounter::FILES_FAILED),
+              before.get(MetricsSource::WATCH, MetricsCounter::FILES_FAILED));
+}
+
+TEST_F(MetricsTests, testCountersSumOverThreads)
+{
+    const MetricsSnapshot before = Metrics::getSnapshot();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([]()
+        {
+            for (int j = 0; j < 1000; ++j)
+                Metrics::add(MetricsSource::SERVE, MetricsCounter::INPUT_BYTES, 3);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Counts from threads that have finished still have to be there.
+    const MetricsSnapshot after = Metrics::getSnapshot();
+    EXPECT_EQ(after.get(MetricsSource::SERVE, MetricsCounter::INPUT_BYTES) -
+              before.get(MetricsSource::SERVE, MetricsCounter::INPUT_BYTES), 12000u);
+}
+
+TEST_F(MetricsTests, testRecordRepairCountsRepairKinds)
+{
+    const MetricsSnapshot before = Metrics::getSnapshot();
+
+    RepairResult result;
+    result.m_triangleCount = 10;
+    result.m_outputSize = 584;
+    result.m_isTriangleCountChanged = true;
+    result.m_droppedByteCount = 16;
+    Metrics::recordRepair(MetricsSource::WATCH, 600, result, 2000000);
+
+    const MetricsSnapshot after = Metrics::getSnapshot();
+    auto delta = [&](MetricsCounter counter)
+    {
+        return after.get(MetricsSource::WATCH, counter) - before.get(MetricsSource::WATCH, counter);
+    };
+    EXPECT_EQ(delta(MetricsCounter::FILES_REPAIRED), 1u);
+    EXPECT_EQ(delta(MetricsCounter::INPUT_BYTES), 600u);
+    EXPECT_EQ(delta(MetricsCounter::OUTPUT_BYTES), 584u);
+    EXPECT_EQ(delta(MetricsCounter::FACETS), 10u);
+    EXPECT_EQ(delta(MetricsCounter::COUNTS_SYNCED), 1u);
+    EXPECT_EQ(delta(MetricsCounter::EXTRA_DATA_DROPPED), 1u);
+    EXPECT_EQ(delta(MetricsCounter::HEADERS_CLEARED), 0u);
+    EXPECT_EQ(delta(MetricsCounter::ATTRIBUTES_ZEROED), 0u);
+
+    // 2ms lands in the 2.5ms bucket.
+    const size_t source = static_cast<size_t>(MetricsSource::WATCH);
+    EXPECT_EQ(after.m_latencyBuckets[source][2] - before.m_latencyBuckets[source][2], 1u);
+    EXPECT_EQ(after.m_latencySumNs[source] - before.m_latencySumNs[source], 2000000u);
+}
+
+TEST_F(MetricsTests, testPrometheusText)
+{
+    MetricsSnapshot snapshot;
+    snapshot.m_counters[0][static_cast<size_t>(MetricsCounter::FILES_REPAIRED)] = 5;
+    snapshot.m_counters[0][static_cast<size_t>(MetricsCounter::FILES_FAILED)] = 2;
+    snapshot.m_latencyBuckets[0][0] = 3;
+    snapshot.m_latencyBuckets[0][3] = 4;
+    snapshot.m_latencySumNs[0] = 1500000000;
+    snapshot.m_queueDepth = 7;
+
+    const std::string text = formatPrometheusText(snapshot);
+    EXPECT_NE(text.find("# TYPE stlrepair_files_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_files_total{source=\"watch\",result=\"repaired\"} 5\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_files_total{source=\"watch\",result=\"failed\"} 2\n"), std::string::npos);
+    EXPECT_EQ(text.find("stlrepair_errors_total"), std::string::npos);
+
+    // Buckets are cumulative.
+    EXPECT_NE(text.find("stlrepair_repair_duration_seconds_bucket{source=\"watch\",le=\"0.0005\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_repair_duration_seconds_bucket{source=\"watch\",le=\"0.0025\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_repair_duration_seconds_bucket{source=\"watch\",le=\"0.005\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_repair_duration_seconds_bucket{source=\"watch\",le=\"+Inf\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_repair_duration_seconds_sum{source=\"watch\"} 1.5\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_repair_duration_seconds_count{source=\"watch\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("stlrepair_queue_depth 7\n"), std::string::npos);
+}
+
+TEST_F(MetricsTests, testTextfileWriter)
+{
+    const std::string metricsFile = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "metrics.prom");
+    auto fileGuard = makeCallGuard([&]() { _unlink(metricsFile.c_str()); });
+
+    Metrics::add(MetricsSource::WATCH, MetricsCounter::FACETS, 1);
+    {
+        MetricsTextfileWriter writer(metricsFile, std::chrono::seconds(60));
+
+        std::ifstream file(metricsFile);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        EXPECT_NE(contents.str().find("stlrepair_facets_total{source=\"watch\"}"), std::string::npos);
+    }
+
+    EXPECT_FALSE(FileUtils::fileExists(metricsFile + ".tmp"));
+}
+
+#if !defined(_WIN32)
+
+TEST_F(MetricsTests, testHttpEndpoint)
+{
+    MetricsHttpEndpoint endpoint(0);
+    ASSERT_NE(endpoint.getPort(), 0);
+
+    const int client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(client, -1);
+    auto closeGuard = makeCallGuard([&]() { close(client); });
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(endpoint.getPort());
+    ASSERT_EQ(connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+
+    const std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ASSERT_EQ(send(client, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(client, buffer, sizeof(buffer), 0)) > 0)
+        response.append(buffer, static_cast<size_t>(received));
+
+    EXPECT_EQ(response.find("HTTP/1.0 200 OK\r\n"), 0u);
+    EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4\r\n"), std::string::npos);
+    EXPECT_NE(response.find("stlrepair_queue_depth"), std::string::npos);
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "OutputCommitter.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    void writeTextFile(const std::string& filepath, const std::string& text)
+    {
+        std::ofstream file(filepath, std::ios::binary);
+        file << text;
+    }
+
+    std::string readTextFile(const std::string& filepath)
+    {
+        std::ifstream file(filepath, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+}
+
+class OutputCommitterTests : public testing::Test
+{
+
+};
+
+TEST_F(OutputCommitterTests, testTempPathIsHiddenAndNextToOutput)
+{
+    const std::string outputFile = TEST_DATA_DIR + "committed.stl";
+    const std::string tempFile = makeTempOutputPath(outputFile);
+
+    const std::filesystem::path tempPath(tempFile);
+    EXPECT_EQ(tempPath.parent_path(), std::filesystem::path(outputFile).parent_path());
+    EXPECT_EQ(tempPath.filename().string().find(".committed.stl."), 0u);
+    EXPECT_NE(makeTempOutputPath(outputFile), tempFile);
+}
+
+TEST_F(OutputCommitterTests, testCommitReplacesOutput)
+{
+    for (DurabilityPolicy policy : { DurabilityPolicy::NONE, DurabilityPolicy::FDATASYNC, DurabilityPolicy::GROUP_COMMIT })
+    {
+        const std::string outputFile = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "committed.stl");
+        auto fileGuard = makeCallGuard([&]() { _unlink(outputFile.c_str()); });
+        writeTextFile(outputFile, "old");
+
+        const std::string tempFile = makeTempOutputPath(outputFile);
+        writeTextFile(tempFile, "new");
+
+        OutputCommitter committer(policy);
+        committer.commit(tempFile, outputFile);
+
+        EXPECT_EQ(readTextFile(outputFile), "new");
+        EXPECT_FALSE(FileUtils::fileExists(tempFile));
+        EXPECT_EQ(committer.getSyncCount(), (policy == DurabilityPolicy::NONE) ? 0u : 2u);
+    }
+}
+
+TEST_F(OutputCommitterTests, testCommitWithoutTempFile)
+{
+    for (DurabilityPolicy policy : { DurabilityPolicy::NONE, DurabilityPolicy::FDATASYNC, DurabilityPolicy::GROUP_COMMIT })
+    {
+        const std::string outputFile = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "committed.stl");
+
+        OutputCommitter committer(policy);
+        EXPECT_THROW(committer.commit(makeTempOutputPath(outputFile), outputFile), std::runtime_error);
+        EXPECT_FALSE(FileUtils::fileExists(outputFile));
+    }
+}
+
+TEST_F(OutputCommitterTests, testGroupCommitFromManyThreads)
+{
+    const size_t THREAD_COUNT = 8;
+    const size_t FILES_PER_THREAD = 16;
+
+    std::vector<std::string> outputFiles;
+    for (size_t i = 0; i < THREAD_COUNT * FILES_PER_THREAD; ++i)
+        outputFiles.push_back(TEST_DATA_DIR + "group_commit_" + std::to_string(i) + ".stl");
+    auto fileGuard = makeCallGuard([&]()
+    {
+        for (const auto& outputFile : outputFiles)
+            _unlink(outputFile.c_str());
+    });
+
+    OutputCommitter committer(DurabilityPolicy::GROUP_COMMIT);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < THREAD_COUNT; ++thread)
+    {
+        threads.emplace_back([&, thread]()
+        {
+            for (size_t i = thread * FILES_PER_THREAD; i < (thread + 1) * FILES_PER_THREAD; ++i)
+            {
+                const std::string tempFile = makeTempOutputPath(outputFiles[i]);
+                writeTextFile(tempFile, std::to_string(i));
+                committer.commit(tempFile, outputFiles[i]);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < outputFiles.size(); ++i)
+        EXPECT_EQ(readTextFile(outputFiles[i]), std::to_string(i));
+
+    // Never more than a flush of each file and its directory.
+    EXPECT_LE(committer.getSyncCount(), 2 * outputFiles.size());
+}
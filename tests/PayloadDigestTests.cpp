@@ -0,0 +1,101 @@
+#include "PayloadDigest.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+class PayloadDigestTests : public testing::Test
+{
+
+};
+
+TEST_F(PayloadDigestTests, testIncrementalMatchesParallel)
+{
+    // Enough facets for a few chunks, plus a partial one.
+    const size_t FACET_COUNT = PAYLOAD_DIGEST_CHUNK_FACET_COUNT * 3 + 123;
+    std::vector<uint8_t> records(FACET_COUNT * 50);
+    for (size_t i = 0; i < records.size(); ++i)
+        records[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+
+    PayloadDigest digest;
+    for (size_t facet = 0; facet < FACET_COUNT; ++facet)
+    {
+        STLBinaryTriangleData triangle;
+        uint16_t attributeByteCount = 0;
+        memcpy(triangle.data(), &records[facet * 50], triangle.size());
+        memcpy(&attributeByteCount, &records[facet * 50 + 48], sizeof(attributeByteCount));
+        digest.update(triangle, attributeByteCount);
+    }
+
+    EXPECT_EQ(digest.digest(), computePayloadDigest(records.data(), FACET_COUNT));
+    EXPECT_NE(digest.digest(), computePayloadDigest(records.data(), FACET_COUNT - 1));
+}
+
+TEST_F(PayloadDigestTests, testStampRoundTrip)
+{
+    STLBinaryHeader header;
+    memset(header.data(), 'x', header.size());
+
+    uint64_t digest = 0;
+    EXPECT_EQ(readPayloadDigest(header, digest), false);
+
+    stampPayloadDigest(header, 0x0123456789ABCDEFull);
+    EXPECT_EQ(readPayloadDigest(header, digest), true);
+    EXPECT_EQ(digest, 0x0123456789ABCDEFull);
+}
+
+TEST_F(PayloadDigestTests, testStampedFileVerifies)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    {
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        filter.m_sortByMortonCode = true;
+        filter.m_stampPayloadDigest = true;
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    EXPECT_EQ(verifyPayloadDigest(INPUT_FILE), PayloadDigestCheck::NOT_STAMPED);
+    EXPECT_EQ(verifyPayloadDigest(OUTPUT_FILE), PayloadDigestCheck::MATCH);
+
+    // Flip a bit in the last facet.
+    FILE* pFile = fopen(OUTPUT_FILE.c_str(), "rb+");
+    ASSERT_NE(pFile, nullptr);
+    fseek(pFile, BINARY_STL_HEADER_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_COUNT_IN_BYTES + 959 * 50 + 10, SEEK_SET);
+    int value = fgetc(pFile);
+    fseek(pFile, -1, SEEK_CUR);
+    fputc(value ^ 0x01, pFile);
+    fclose(pFile);
+
+    EXPECT_EQ(verifyPayloadDigest(OUTPUT_FILE), PayloadDigestCheck::MISMATCH);
+}
+
+TEST_F(PayloadDigestTests, testDigestFollowsAddedStages)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    {
+        // The added stage changes every triangle, so the digest is only
+        // right if it's taken after it.
+        BinarySTLFileFilter filter(OUTPUT_FILE);
+        filter.m_stampPayloadDigest = true;
+        filter.addStage(std::make_unique<TransformStage>(AffineTransform::translation({ 1.0f, 2.0f, 3.0f })));
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(filter);
+    }
+
+    EXPECT_EQ(verifyPayloadDigest(OUTPUT_FILE), PayloadDigestCheck::MATCH);
+}
@@ -0,0 +1,93 @@
+#include "PipelinedByteStream.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    class MemorySink : public ByteSink
+    {
+    public:
+        MemorySink(std::vector<uint8_t>& data, size_t failAfter) :
+            m_data(data), m_failAfter(failAfter), m_isClosed(false) {}
+
+        void write(const uint8_t* pData, size_t size) override
+        {
+            if (m_data.size() + size > m_failAfter)
+                throw std::runtime_error("Disk full.");
+            m_data.insert(m_data.end(), pData, pData + size);
+        }
+
+        void close() override { m_isClosed = true; }
+
+        std::vector<uint8_t>& m_data;
+        size_t m_failAfter;
+        bool m_isClosed;
+    };
+}
+
+class PipelinedByteStreamTests : public testing::Test
+{
+
+};
+
+TEST_F(PipelinedByteStreamTests, testPrefetchingMatchesFile)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::vector<uint8_t> expected = FileUtils::readWholeFile(INPUT_FILE);
+
+    // Small blocks and odd read sizes, so reads straddle blocks.
+    PrefetchingByteSource source(std::make_unique<FileByteSource>(INPUT_FILE), 1000, 3);
+    std::vector<uint8_t> actual;
+    uint8_t buffer[777];
+    size_t bytesRead = 0;
+    while ((bytesRead = source.read(buffer, sizeof(buffer))) > 0)
+        actual.insert(actual.end(), buffer, buffer + bytesRead);
+
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(source.read(buffer, sizeof(buffer)), 0u);
+
+    // Seeking starts over from the new position.
+    ASSERT_TRUE(source.seek(84));
+    ASSERT_EQ(source.read(buffer, 50), 50u);
+    EXPECT_EQ(memcmp(buffer, expected.data() + 84, 50), 0);
+}
+
+TEST_F(PipelinedByteStreamTests, testAsyncSinkWritesEverything)
+{
+    std::vector<uint8_t> expected(100000);
+    for (size_t i = 0; i < expected.size(); ++i)
+        expected[i] = static_cast<uint8_t>(i * 31);
+
+    std::vector<uint8_t> actual;
+    auto spMemorySink = std::make_unique<MemorySink>(actual, expected.size());
+    MemorySink* pMemorySink = spMemorySink.get();
+
+    AsyncByteSink sink(std::move(spMemorySink), 1000, 3);
+    for (size_t offset = 0; offset < expected.size(); offset += 50)
+        sink.write(expected.data() + offset, 50);
+    sink.close();
+
+    EXPECT_TRUE(pMemorySink->m_isClosed);
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(PipelinedByteStreamTests, testAsyncSinkReportsErrors)
+{
+    std::vector<uint8_t> data(1000);
+    std::vector<uint8_t> written;
+
+    AsyncByteSink sink(std::make_unique<MemorySink>(written, 5000), 1000, 2);
+    EXPECT_THROW(
+        {
+            for (int i = 0; i < 100; ++i)
+                sink.write(data.data(), data.size());
+            sink.close();
+        }, std::runtime_error);
+}
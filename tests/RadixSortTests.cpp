@@ -0,0 +1,45 @@
+#include "RadixSort.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+class RadixSortTests : public testing::Test
+{
+
+};
+
+TEST_F(RadixSortTests, testMismatchedSizes)
+{
+    std::vector<uint64_t> keys(2);
+    std::vector<uint32_t> values(3);
+    EXPECT_THROW(radixSort(keys, values), std::runtime_error);
+}
+
+TEST_F(RadixSortTests, testSortIsStable)
+{
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(100000);
+    std::vector<uint32_t> values(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        // Mix of small keys (lots of ties, skipped passes) and full width keys.
+        keys[i] = (i % 2) ? (random() % 64) : random();
+        values[i] = static_cast<uint32_t>(i);
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> expected;
+    for (size_t i = 0; i < keys.size(); ++i)
+        expected.emplace_back(keys[i], values[i]);
+    std::stable_sort(expected.begin(), expected.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    radixSort(keys, values);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(keys[i], expected[i].first);
+        ASSERT_EQ(values[i], expected[i].second);
+    }
+}
@@ -0,0 +1,102 @@
+#include "RecordPlausibility.h"
+#include "STLFileTypes.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    const size_t RECORD_SIZE = BINARY_STL_TRIANGLE_SIZE_IN_BYTES + BINARY_STL_TRIANGLE_ATTRIBUTE_BYTE_COUNT_IN_BYTES;
+
+    std::vector<uint8_t> makeRecord(const STLFacet& facet)
+    {
+        std::vector<uint8_t> record(RECORD_SIZE, 0);
+        STLBinaryTriangleData triangle;
+        encodeFacet(facet, triangle);
+        memcpy(record.data(), triangle.data(), triangle.size());
+        return record;
+    }
+
+    STLFacet makeFacet(const Vec3& normal)
+    {
+        return { normal, { { 10.0f, 10.0f, 5.0f }, { 12.0f, 10.0f, 5.0f }, { 10.0f, 13.0f, 5.0f } } };
+    }
+}
+
+class RecordPlausibilityTests : public testing::Test
+{
+
+};
+
+TEST_F(RecordPlausibilityTests, testGoodFacets)
+{
+    EXPECT_TRUE(isPlausibleTriangleRecord(makeRecord(makeFacet({ 0.0f, 0.0f, 1.0f })).data()));
+
+    // Backwards, area-weighted and missing normals are all fine.
+    EXPECT_TRUE(isPlausibleTriangleRecord(makeRecord(makeFacet({ 0.0f, 0.0f, -1.0f })).data()));
+    EXPECT_TRUE(isPlausibleTriangleRecord(makeRecord(makeFacet({ 0.0f, 0.0f, 6.0f })).data()));
+    EXPECT_TRUE(isPlausibleTriangleRecord(makeRecord(makeFacet({ 0.0f, 0.0f, 0.0f })).data()));
+}
+
+TEST_F(RecordPlausibilityTests, testBadFacets)
+{
+    // Normal lying in the facet's plane.
+    EXPECT_FALSE(isPlausibleTriangleRecord(makeRecord(makeFacet({ 1.0f, 0.0f, 0.0f })).data()));
+
+    // Not a number.
+    EXPECT_FALSE(isPlausibleTriangleRecord(makeRecord(makeFacet(
+        { 0.0f, 0.0f, std::numeric_limits<float>::quiet_NaN() })).data()));
+
+    // Absurd magnitudes.
+    STLFacet facet = makeFacet({ 0.0f, 0.0f, 1.0f });
+    facet.vertices[2].x = 1.0e20f;
+    EXPECT_FALSE(isPlausibleTriangleRecord(makeRecord(facet).data()));
+    facet.vertices[2].x = 1.0e-35f;
+    EXPECT_FALSE(isPlausibleTriangleRecord(makeRecord(facet).data()));
+
+    // Degenerate, including all zeros.
+    facet = makeFacet({ 0.0f, 0.0f, 1.0f });
+    facet.vertices[2] = facet.vertices[1];
+    EXPECT_FALSE(isPlausibleTriangleRecord(makeRecord(facet).data()));
+    EXPECT_FALSE(isPlausibleTriangleRecord(std::vector<uint8_t>(RECORD_SIZE, 0).data()));
+}
+
+TEST_F(RecordPlausibilityTests, testMisalignedRecordsAreRejected)
+{
+    std::vector<uint8_t> data;
+    for (int i = 0; i < 16; ++i)
+    {
+        STLFacet facet = makeFacet({ 0.0f, 0.0f, 1.0f });
+        for (auto& vertex : facet.vertices)
+            vertex.z += static_cast<float>(i);
+        auto record = makeRecord(facet);
+        data.insert(data.end(), record.begin(), record.end());
+    }
+
+    EXPECT_EQ(countPlausibleTriangleRecords(data.data(), 16), 16u);
+    for (size_t offset = 1; offset < RECORD_SIZE; ++offset)
+        EXPECT_LT(countPlausibleTriangleRecords(data.data() + offset, 8), 8u) << "offset " << offset;
+}
+
+TEST_F(RecordPlausibilityTests, testNearBounds)
+{
+    BoundingBox bounds;
+    EXPECT_TRUE(isRecordNearBounds(makeRecord(makeFacet({ 0.0f, 0.0f, 1.0f })).data(), bounds));
+
+    bounds.extend(Vec3{ 0.0f, 0.0f, 0.0f });
+    bounds.extend(Vec3{ 20.0f, 20.0f, 20.0f });
+    EXPECT_TRUE(isRecordNearBounds(makeRecord(makeFacet({ 0.0f, 0.0f, 1.0f })).data(), bounds));
+
+    STLFacet facet = makeFacet({ 0.0f, 0.0f, 1.0f });
+    facet.vertices[1].x = 5000.0f;
+    EXPECT_FALSE(isRecordNearBounds(makeRecord(facet).data(), bounds));
+    EXPECT_FALSE(hasUsableVertices(makeRecord(facet).data(), bounds));
+
+    // Odd normals don't matter for usable vertices, zeros do.
+    EXPECT_TRUE(hasUsableVertices(makeRecord(makeFacet({ 5.0f, 0.0f, 0.0f })).data(), bounds));
+    EXPECT_FALSE(hasUsableVertices(std::vector<uint8_t>(RECORD_SIZE, 0).data(), bounds));
+}
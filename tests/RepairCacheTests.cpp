@@ -0,0 +1,96 @@
+#include "RepairCache.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <thread>
+#include <chrono>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+class RepairCacheTests : public testing::Test
+{
+
+};
+
+TEST_F(RepairCacheTests, testKeyDependsOnInputAndOptions)
+{
+    RepairOptions options;
+    RepairOptions otherOptions;
+    otherOptions.m_sortByMortonCode = true;
+
+    const std::string key = RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere.stl", options);
+
+    EXPECT_EQ(RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere.stl", options), key);
+    EXPECT_NE(RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere.stl", otherOptions), key);
+    EXPECT_NE(RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere_with_abcs.stl", options), key);
+    EXPECT_NE(RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere.stl", options, CompressionFormat::GZIP), key);
+    EXPECT_NE(RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere.stl", options, CompressionFormat::GZIP),
+        RepairCache::makeKey(TEST_DATA_DIR + "binary_5mm_sphere.stl", options, CompressionFormat::ZSTD));
+}
+
+TEST_F(RepairCacheTests, testStoreThenFetch)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string CACHE_DIR = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "cache");
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]()
+    {
+        _unlink(OUTPUT_FILE.c_str());
+        std::error_code error;
+        std::filesystem::remove_all(CACHE_DIR, error);
+    });
+
+    RepairCache cache(CACHE_DIR);
+    const std::string key = RepairCache::makeKey(INPUT_FILE, RepairOptions());
+
+    EXPECT_EQ(cache.fetch(key, OUTPUT_FILE), false);
+    EXPECT_EQ(FileUtils::fileExists(OUTPUT_FILE), false);
+
+    cache.store(key, INPUT_FILE);
+
+    EXPECT_EQ(cache.fetch(key, OUTPUT_FILE), true);
+    EXPECT_EQ(FileUtils::areFilesEqual(INPUT_FILE, OUTPUT_FILE), true);
+}
+
+TEST_F(RepairCacheTests, testLeastRecentlyUsedIsEvicted)
+{
+    const std::string FIRST_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string SECOND_FILE = TEST_DATA_DIR + "binary_5mm_sphere_with_abcs.stl";
+    const std::string THIRD_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string CACHE_DIR = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "cache");
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(FIRST_FILE);
+    auto fileGuard = makeCallGuard([&]()
+    {
+        _unlink(OUTPUT_FILE.c_str());
+        std::error_code error;
+        std::filesystem::remove_all(CACHE_DIR, error);
+    });
+
+    // Room for two entries, but not three.
+    RepairCache cache(CACHE_DIR, FileUtils::getFileSize(FIRST_FILE) * 5 / 2);
+
+    const std::string firstKey = RepairCache::makeKey(FIRST_FILE, RepairOptions());
+    const std::string secondKey = RepairCache::makeKey(SECOND_FILE, RepairOptions());
+    const std::string thirdKey = RepairCache::makeKey(THIRD_FILE, RepairOptions());
+
+    // Timestamps need to be distinguishable on coarse file systems.
+    cache.store(firstKey, FIRST_FILE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    cache.store(secondKey, SECOND_FILE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Using the first makes the second the least recently used.
+    EXPECT_EQ(cache.fetch(firstKey, OUTPUT_FILE), true);
+    _unlink(OUTPUT_FILE.c_str());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    cache.store(thirdKey, THIRD_FILE);
+
+    EXPECT_EQ(cache.fetch(secondKey, OUTPUT_FILE), false);
+    EXPECT_EQ(cache.fetch(firstKey, OUTPUT_FILE), true);
+    _unlink(OUTPUT_FILE.c_str());
+    EXPECT_EQ(cache.fetch(thirdKey, OUTPUT_FILE), true);
+}
@@ -0,0 +1,178 @@
+#include "RepairCheckpoint.h"
+#include "BinarySTLFileFilter.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    const uint32_t FACET_COUNT = 20000;
+
+    //! Several batches' worth of facets, a count that's too big and some junk on the end.
+    void writeLargeSTL(const std::string& filepath)
+    {
+        std::vector<uint8_t> data(84 + FACET_COUNT * 50 + 30);
+        memset(data.data(), 'h', 80);
+        const uint32_t declaredCount = FACET_COUNT + 5;
+        memcpy(&data[80], &declaredCount, sizeof(declaredCount));
+
+        for (uint32_t facet = 0; facet < FACET_COUNT; ++facet)
+        {
+            float values[12];
+            for (int i = 0; i < 12; ++i)
+                values[i] = static_cast<float>((facet * 12 + i) % 1000) * 0.01f;
+            memcpy(&data[84 + facet * 50], values, sizeof(values));
+        }
+
+        std::ofstream file(filepath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    void setUpFilter(BinarySTLFileFilter& filter)
+    {
+        filter.m_zeroAttributeByteCounts = true;
+        filter.m_updateTriangleCount = true;
+        filter.m_clearExtraFileData = true;
+        filter.m_triangleLimit = FACET_COUNT;
+        filter.m_stampPayloadDigest = true;
+        filter.m_transform = AffineTransform::scale(2.0f);
+    }
+
+    //! Passes everything along until the given number of triangles, then dies.
+    class DyingListener : public BinarySTLFileReaderListener
+    {
+    public:
+        DyingListener(BinarySTLFileReaderListener& listener, uint32_t triangleLimit) :
+            m_listener(listener), m_remaining(triangleLimit) {}
+
+        void onReadEnd() override { m_listener.onReadEnd(); }
+        bool onReadFileHeader(const STLBinaryHeader& header) override { return m_listener.onReadFileHeader(header); }
+        bool onReadTriangleCount(const uint32_t triangleCount) override { return m_listener.onReadTriangleCount(triangleCount); }
+        bool onReadTriangle(const STLBinaryTriangleData& triangleData, const uint16_t attributeByteCount) override
+        {
+            if (m_remaining-- == 0)
+                throw std::runtime_error("Killed.");
+            return m_listener.onReadTriangle(triangleData, attributeByteCount);
+        }
+        bool onReadUnknownData(const uint8_t* const pData, const size_t dataSize) override { return m_listener.onReadUnknownData(pData, dataSize); }
+
+    private:
+        BinarySTLFileReaderListener& m_listener;
+        uint32_t m_remaining;
+    };
+}
+
+class RepairCheckpointTests : public testing::Test
+{
+
+};
+
+TEST_F(RepairCheckpointTests, testRoundTrip)
+{
+    const std::string checkpointPath = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "round_trip.checkpoint");
+    auto fileGuard = makeCallGuard([&]() { _unlink(checkpointPath.c_str()); });
+
+    RepairCheckpoint checkpoint;
+    checkpoint.m_inputSize = 123456;
+    checkpoint.m_optionsHash = 42;
+    checkpoint.m_outputFile = "out.stl";
+    checkpoint.m_tempFile = ".out.stl.partial";
+    checkpoint.m_reader.m_fileOffset = 5084;
+    checkpoint.m_reader.m_triangleIndex = 100;
+    checkpoint.m_reader.m_isResynchronizing = true;
+    checkpoint.m_filter.m_writtenTriangleCount = 99;
+    checkpoint.m_filter.m_stageStates = { {}, { 1, 2, 3 } };
+    writeRepairCheckpoint(checkpointPath, checkpoint);
+
+    RepairCheckpoint loaded;
+    ASSERT_TRUE(readRepairCheckpoint(checkpointPath, loaded));
+    EXPECT_EQ(loaded.m_inputSize, 123456u);
+    EXPECT_EQ(loaded.m_optionsHash, 42u);
+    EXPECT_EQ(loaded.m_outputFile, "out.stl");
+    EXPECT_EQ(loaded.m_tempFile, ".out.stl.partial");
+    EXPECT_EQ(loaded.m_reader.m_fileOffset, 5084u);
+    EXPECT_EQ(loaded.m_reader.m_triangleIndex, 100u);
+    EXPECT_TRUE(loaded.m_reader.m_isResynchronizing);
+    EXPECT_EQ(loaded.m_filter.m_writtenTriangleCount, 99u);
+    EXPECT_EQ(loaded.m_filter.m_stageStates, checkpoint.m_filter.m_stageStates);
+    EXPECT_EQ(loaded.m_filter.getOutputSize(), 84u + 99 * 50);
+}
+
+TEST_F(RepairCheckpointTests, testDamagedCheckpointIgnored)
+{
+    const std::string checkpointPath = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "damaged.checkpoint");
+    auto fileGuard = makeCallGuard([&]() { _unlink(checkpointPath.c_str()); });
+
+    RepairCheckpoint checkpoint;
+    EXPECT_FALSE(readRepairCheckpoint(checkpointPath, checkpoint));
+
+    writeRepairCheckpoint(checkpointPath, checkpoint);
+    {
+        std::fstream file(checkpointPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(20);
+        file.put('x');
+    }
+    EXPECT_FALSE(readRepairCheckpoint(checkpointPath, checkpoint));
+}
+
+TEST_F(RepairCheckpointTests, testResumedOutputMatchesUninterrupted)
+{
+    const std::string inputFile = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "checkpoint_input.stl");
+    writeLargeSTL(inputFile);
+    const std::string expectedFile = FileUtils::generateUniqueFilePath(inputFile);
+    const std::string resumedFile = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "checkpoint_resumed.stl");
+    const std::string checkpointPath = getCheckpointPath(inputFile);
+    auto fileGuard = makeCallGuard([&]()
+    {
+        _unlink(inputFile.c_str());
+        _unlink(expectedFile.c_str());
+        _unlink(resumedFile.c_str());
+        _unlink(checkpointPath.c_str());
+    });
+
+    {
+        BinarySTLFileFilter filter(expectedFile);
+        setUpFilter(filter);
+        BinarySTLFileReader reader(inputFile);
+        reader.readFile(filter);
+    }
+
+    // Checkpoint at every batch, and die part way through the third.
+    {
+        BinarySTLFileFilter filter(resumedFile);
+        setUpFilter(filter);
+        BinarySTLFileReader reader(inputFile);
+        RepairCheckpointer checkpointer(reader, filter, checkpointPath,
+            makeInitialCheckpoint(inputFile, filter.getRepairOptions(), "unused", resumedFile), 1);
+        DyingListener dyingListener(checkpointer, DEFAULT_FILTER_BATCH_SIZE * 2 + 100);
+        EXPECT_THROW(reader.readFile(dyingListener), std::runtime_error);
+        EXPECT_EQ(checkpointer.getCheckpointCount(), 2u);
+    }
+
+    RepairCheckpoint checkpoint;
+    ASSERT_TRUE(readRepairCheckpoint(checkpointPath, checkpoint));
+    EXPECT_EQ(checkpoint.m_reader.m_triangleIndex, DEFAULT_FILTER_BATCH_SIZE * 2);
+    EXPECT_EQ(checkpoint.m_filter.m_writtenTriangleCount, DEFAULT_FILTER_BATCH_SIZE * 2);
+
+    {
+        BinarySTLFileFilter filter(resumedFile);
+        setUpFilter(filter);
+        EXPECT_TRUE(isCheckpointFor(checkpoint, inputFile, filter.getRepairOptions()));
+
+        BinarySTLFileReader reader(inputFile);
+        RepairCheckpointer checkpointer(reader, filter, checkpointPath, checkpoint, 1);
+        filter.resumeFrom(checkpoint.m_filter);
+        reader.resumeFile(checkpointer, checkpoint.m_reader);
+    }
+
+    EXPECT_TRUE(FileUtils::areFilesEqual(expectedFile, resumedFile));
+}
@@ -0,0 +1,149 @@
+#include "RepairServer.h"
+#include "RepairClient.h"
+#include "InMemoryRepair.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+#if !defined(_WIN32)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+class RepairServerTests : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        m_socketPath = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "repair.sock");
+    }
+
+    //! Starts a server on its own thread. TearDown() stops it.
+    void startServer(uint64_t maximumRequestSize = DEFAULT_MAXIMUM_REPAIR_REQUEST_SIZE)
+    {
+        m_spServer = std::make_unique<RepairServer>(m_socketPath, 4, maximumRequestSize);
+        m_serverThread = std::thread([this]() { m_spServer->run(); });
+    }
+
+    void TearDown() override
+    {
+        if (m_spServer)
+        {
+            m_spServer->stop();
+            m_serverThread.join();
+            m_spServer.reset();
+        }
+    }
+
+    std::string m_socketPath;
+    std::unique_ptr<RepairServer> m_spServer;
+    std::thread m_serverThread;
+};
+
+TEST_F(RepairServerTests, testRepairsSentBytes)
+{
+    startServer();
+
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl");
+    RepairOptions options;
+    options.m_zeroAttributeByteCounts = true;
+
+    std::vector<uint8_t> expected;
+    repairSTL(input.data(), input.size(), expected, planRepairs(input.data(), input.size(), options));
+
+    RepairClient client(m_socketPath);
+    std::vector<uint8_t> output;
+    RepairResult result = client.repair(input.data(), input.size(), output, options);
+
+    EXPECT_EQ(output, expected);
+    EXPECT_EQ(result.m_triangleCount, 960u);
+    EXPECT_EQ(result.m_outputSize, expected.size());
+}
+
+TEST_F(RepairServerTests, testRepairsPassedDescriptors)
+{
+    startServer();
+
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    const int inputFd = open(INPUT_FILE.c_str(), O_RDONLY);
+    const int outputFd = open(OUTPUT_FILE.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT_NE(inputFd, -1);
+    ASSERT_NE(outputFd, -1);
+    auto closeGuard = makeCallGuard([&]() { close(inputFd); close(outputFd); });
+
+    RepairClient client(m_socketPath);
+    RepairResult result = client.repair(inputFd, outputFd, RepairOptions());
+
+    EXPECT_EQ(result.m_triangleCount, 960u);
+    EXPECT_TRUE(FileUtils::areFilesEqual(OUTPUT_FILE, TEST_DATA_DIR + "binary_5mm_sphere.stl"));
+}
+
+TEST_F(RepairServerTests, testFailedRepairKeepsConnection)
+{
+    startServer();
+
+    RepairClient client(m_socketPath);
+    const uint8_t tooSmall[10] = {};
+    std::vector<uint8_t> output;
+    EXPECT_THROW(client.repair(tooSmall, sizeof(tooSmall), output, RepairOptions()), std::runtime_error);
+
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    client.repair(input.data(), input.size(), output, RepairOptions());
+    EXPECT_EQ(output, input);
+    EXPECT_EQ(m_spServer->getFailedRequestCount(), 1u);
+}
+
+TEST_F(RepairServerTests, testRequestTooLarge)
+{
+    startServer(1024);
+
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    RepairClient client(m_socketPath);
+    std::vector<uint8_t> output;
+    EXPECT_THROW(client.repair(input.data(), input.size(), output, RepairOptions()), std::runtime_error);
+}
+
+TEST_F(RepairServerTests, testConcurrentClients)
+{
+    startServer();
+
+    const std::vector<uint8_t> input = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl");
+    const std::vector<uint8_t> expected = FileUtils::readWholeFile(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+
+    std::atomic<int> matchCount(0);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 8; ++i)
+    {
+        clients.emplace_back([&]()
+        {
+            RepairClient client(m_socketPath);
+            std::vector<uint8_t> output;
+            for (int j = 0; j < 50; ++j)
+            {
+                client.repair(input.data(), input.size(), output, RepairOptions());
+                if (output == expected)
+                    ++matchCount;
+            }
+        });
+    }
+
+    for (auto& client : clients)
+        client.join();
+
+    EXPECT_EQ(matchCount, 400);
+    EXPECT_EQ(m_spServer->getRepairedRequestCount(), 400u);
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "RepairWorkerPool.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+
+class RepairWorkerPoolTests : public testing::Test
+{
+
+};
+
+TEST_F(RepairWorkerPoolTests, testRunsEveryJob)
+{
+    std::atomic<int> jobCount(0);
+    {
+        RepairWorkerPool pool(4);
+        EXPECT_EQ(pool.getThreadCount(), 4u);
+
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&](RepairWorkspace&) { ++jobCount; });
+
+        pool.waitUntilIdle();
+        EXPECT_EQ(jobCount, 1000);
+        EXPECT_EQ(pool.getQueueDepth(), 0u);
+    }
+}
+
+TEST_F(RepairWorkerPoolTests, testQueuedJobsFinishBeforeDestruction)
+{
+    std::atomic<int> jobCount(0);
+    {
+        RepairWorkerPool pool(1);
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&](RepairWorkspace&) { ++jobCount; });
+    }
+
+    EXPECT_EQ(jobCount, 100);
+}
+
+TEST_F(RepairWorkerPoolTests, testThrowingJobDoesNotStopWorker)
+{
+    std::atomic<int> jobCount(0);
+    RepairWorkerPool pool(1);
+
+    pool.submit([](RepairWorkspace&) { throw std::runtime_error("Bad file."); });
+    pool.submit([&](RepairWorkspace&) { ++jobCount; });
+    pool.waitUntilIdle();
+
+    EXPECT_EQ(jobCount, 1);
+}
+
+TEST_F(RepairWorkerPoolTests, testWorkspaceIsReused)
+{
+    RepairWorkerPool pool(1);
+
+    const uint8_t* pFirstBuffer = nullptr;
+    const uint8_t* pSecondBuffer = nullptr;
+    pool.submit([&](RepairWorkspace& workspace)
+    {
+        workspace.m_input.resize(4096);
+        pFirstBuffer = workspace.m_input.data();
+    });
+    pool.submit([&](RepairWorkspace& workspace)
+    {
+        workspace.m_input.resize(1024);
+        pSecondBuffer = workspace.m_input.data();
+    });
+    pool.waitUntilIdle();
+
+    EXPECT_EQ(pFirstBuffer, pSecondBuffer);
+}
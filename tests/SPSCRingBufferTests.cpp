@@ -0,0 +1,69 @@
+#include "SPSCRingBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+class SPSCRingBufferTests : public testing::Test
+{
+
+};
+
+TEST_F(SPSCRingBufferTests, testCapacityRoundsUp)
+{
+    SPSCRingBuffer<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+}
+
+TEST_F(SPSCRingBufferTests, testFullAndEmpty)
+{
+    SPSCRingBuffer<int> ring(4);
+
+    int value = 0;
+    EXPECT_FALSE(ring.tryPop(value));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        value = i;
+        EXPECT_TRUE(ring.tryPush(value));
+    }
+
+    value = 99;
+    EXPECT_FALSE(ring.tryPush(value));
+    EXPECT_EQ(value, 99);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+TEST_F(SPSCRingBufferTests, testOrderAcrossThreads)
+{
+    const int ITEM_COUNT = 100000;
+    SPSCRingBuffer<int> ring(16);
+
+    std::thread producer([&]()
+    {
+        for (int i = 0; i < ITEM_COUNT; ++i)
+        {
+            int value = i;
+            waitUntil([&]() { return ring.tryPush(value); });
+        }
+    });
+
+    int expected = 0;
+    bool isInOrder = true;
+    while (expected < ITEM_COUNT)
+    {
+        int value = -1;
+        waitUntil([&]() { return ring.tryPop(value); });
+        isInOrder = isInOrder && (value == expected);
+        ++expected;
+    }
+
+    producer.join();
+    EXPECT_TRUE(isInOrder);
+}
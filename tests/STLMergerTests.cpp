@@ -0,0 +1,118 @@
+#include "STLMerger.h"
+#include "STLMesh.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    std::vector<std::string> getInputFiles()
+    {
+        return { TEST_DATA_DIR + "binary_5mm_sphere.stl",
+                 TEST_DATA_DIR + "binary_5mm_sphere_truncated_data.stl",
+                 TEST_DATA_DIR + "binary_5mm_sphere.stl" };
+    }
+
+    //! The facets of every input, in order, as the merge should have them.
+    STLMesh readInputs(const std::vector<std::string>& inputFiles)
+    {
+        STLMesh combined;
+        for (const std::string& inputFile : inputFiles)
+        {
+            const STLMesh mesh = readMesh(inputFile);
+            const size_t facetCount = std::min<size_t>(mesh.size(), readTriangleCount(inputFile));
+            combined.m_triangles.insert(combined.m_triangles.end(), mesh.m_triangles.begin(), mesh.m_triangles.begin() + facetCount);
+            combined.m_attributeByteCounts.insert(combined.m_attributeByteCounts.end(),
+                mesh.m_attributeByteCounts.begin(), mesh.m_attributeByteCounts.begin() + facetCount);
+        }
+        return combined;
+    }
+}
+
+class STLMergerTests : public testing::Test
+{
+
+};
+
+TEST_F(STLMergerTests, testPlan)
+{
+    const std::vector<std::string> inputFiles = getInputFiles();
+    const std::vector<MergeInput> inputs = planMerge(inputFiles);
+    ASSERT_EQ(inputs.size(), 3u);
+
+    uint64_t outputOffset = 84;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        EXPECT_EQ(inputs[i].m_filepath, inputFiles[i]);
+        EXPECT_EQ(inputs[i].m_declaredCount, readTriangleCount(inputFiles[i]));
+        EXPECT_EQ(inputs[i].m_calculatedCount, calculateTriangleCount(inputFiles[i]));
+        EXPECT_EQ(inputs[i].m_facetCount, std::min(inputs[i].m_declaredCount, inputs[i].m_calculatedCount));
+        EXPECT_EQ(inputs[i].m_outputOffset, outputOffset);
+        outputOffset += inputs[i].m_facetCount * 50ull;
+    }
+
+    // The truncated file is missing most of its last facet.
+    EXPECT_LT(inputs[1].m_facetCount, inputs[1].m_declaredCount);
+}
+
+TEST_F(STLMergerTests, testMerge)
+{
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "merged.stl");
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    const std::vector<std::string> inputFiles = getInputFiles();
+    const STLMesh expected = readInputs(inputFiles);
+    EXPECT_EQ(mergeFiles(inputFiles, OUTPUT_FILE), expected.size());
+
+    EXPECT_EQ(readTriangleCount(OUTPUT_FILE), expected.size());
+    EXPECT_EQ(calculateTriangleCount(OUTPUT_FILE), expected.size());
+    EXPECT_EQ(hasExtraData(OUTPUT_FILE), 0u);
+
+    const STLMesh merged = readMesh(OUTPUT_FILE);
+    EXPECT_EQ(merged.m_header, readMesh(inputFiles.front()).m_header);
+    EXPECT_EQ(merged.m_triangles, expected.m_triangles);
+    EXPECT_EQ(merged.m_attributeByteCounts, expected.m_attributeByteCounts);
+}
+
+TEST_F(STLMergerTests, testMergeWithRepairs)
+{
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "merged.stl");
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    MergeOptions options;
+    options.m_zeroOutHeader = true;
+    options.m_zeroAttributeByteCounts = true;
+    options.m_transform = AffineTransform::scale(2.0f).then(AffineTransform::translation({ 1.0f, 2.0f, 3.0f }));
+
+    const std::vector<std::string> inputFiles = getInputFiles();
+    STLMesh expected = readInputs(inputFiles);
+    for (auto& triangle : expected.m_triangles)
+        options.m_transform.apply(triangle);
+
+    mergeFiles(inputFiles, OUTPUT_FILE, options);
+
+    const STLMesh merged = readMesh(OUTPUT_FILE);
+    for (uint8_t byte : merged.m_header)
+        EXPECT_EQ(byte, 0);
+    for (uint16_t attributeByteCount : merged.m_attributeByteCounts)
+        EXPECT_EQ(attributeByteCount, 0);
+    EXPECT_EQ(merged.m_triangles, expected.m_triangles);
+}
+
+TEST_F(STLMergerTests, testBadInputs)
+{
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "merged.stl");
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    EXPECT_THROW(mergeFiles({}, OUTPUT_FILE), std::runtime_error);
+    EXPECT_THROW(mergeFiles({ TEST_DATA_DIR + "binary_5mm_sphere.stl", TEST_DATA_DIR + "no_such_file.stl" }, OUTPUT_FILE),
+        std::runtime_error);
+    EXPECT_FALSE(FileUtils::fileExists(OUTPUT_FILE));
+}
@@ -0,0 +1,115 @@
+#include "SelfIntersection.h"
+#include "FacetBVH.h"
+#include "STLGeometry.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    STLFacet makeFacet(const Vec3& a, const Vec3& b, const Vec3& c)
+    {
+        return { { 0.0f, 0.0f, 0.0f }, { a, b, c } };
+    }
+
+    void addFacet(STLMesh& mesh, const STLFacet& facet)
+    {
+        STLBinaryTriangleData triangle;
+        encodeFacet(facet, triangle);
+        mesh.m_triangles.push_back(triangle);
+        mesh.m_attributeByteCounts.push_back(0);
+    }
+}
+
+class SelfIntersectionTests : public testing::Test
+{
+
+};
+
+TEST_F(SelfIntersectionTests, testCrossingTriangles)
+{
+    STLFacet flat = makeFacet({ 0, 0, 0 }, { 4, 0, 0 }, { 0, 4, 0 });
+    STLFacet upright = makeFacet({ 1, 1, -1 }, { 1, 1, 1 }, { 2, -1, 0 });
+    EXPECT_TRUE(doTrianglesIntersect(flat, upright));
+    EXPECT_TRUE(doTrianglesIntersect(upright, flat));
+}
+
+TEST_F(SelfIntersectionTests, testSeparatedTriangles)
+{
+    STLFacet flat = makeFacet({ 0, 0, 0 }, { 4, 0, 0 }, { 0, 4, 0 });
+    STLFacet above = makeFacet({ 1, 1, 1 }, { 1, 1, 2 }, { 2, -1, 1.5f });
+    EXPECT_FALSE(doTrianglesIntersect(flat, above));
+}
+
+TEST_F(SelfIntersectionTests, testNeighboursDontIntersect)
+{
+    STLFacet facet1 = makeFacet({ 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 });
+    STLFacet facet2 = makeFacet({ 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 1 });
+    STLFacet facet3 = makeFacet({ 0, 0, 0 }, { -1, 0, 1 }, { 0, -1, -1 });
+    EXPECT_FALSE(doTrianglesIntersect(facet1, facet2));
+    EXPECT_FALSE(doTrianglesIntersect(facet1, facet3));
+}
+
+TEST_F(SelfIntersectionTests, testBVHVisitsEveryOverlapOnce)
+{
+    STLMesh mesh;
+    for (int i = 0; i < 100; ++i)
+    {
+        const float x = static_cast<float>((i * 37) % 10);
+        const float y = static_cast<float>(i / 10);
+        addFacet(mesh, makeFacet({ x, y, 0 }, { x + 1.5f, y, 0 }, { x, y + 0.5f, 0 }));
+    }
+
+    FacetBVH bvh(mesh);
+    ASSERT_EQ(bvh.leafCount(), 100);
+
+    int bvhPairs = 0;
+    for (uint32_t leaf = 0; leaf < bvh.leafCount(); ++leaf)
+        bvh.forEachOverlappingLeaf(leaf, [&](uint32_t) { ++bvhPairs; });
+
+    // Compare against brute force.
+    int expectedPairs = 0;
+    for (uint32_t i = 0; i < bvh.leafCount(); ++i)
+    {
+        for (uint32_t j = i + 1; j < bvh.leafCount(); ++j)
+        {
+            const auto& box1 = bvh.leafBox(i);
+            const auto& box2 = bvh.leafBox(j);
+            bool overlap = true;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                overlap = overlap && (box1.m_min[axis] <= box2.m_max[axis]) &&
+                    (box2.m_min[axis] <= box1.m_max[axis]);
+            }
+            if (overlap)
+                ++expectedPairs;
+        }
+    }
+
+    // Neighbours within a row overlap. The rows themselves are too far apart to touch.
+    EXPECT_EQ(expectedPairs, 90);
+    EXPECT_EQ(bvhPairs, expectedPairs);
+}
+
+TEST_F(SelfIntersectionTests, testSphereHasNoIntersections)
+{
+    STLMesh mesh = readMesh(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    EXPECT_TRUE(findSelfIntersections(mesh).empty());
+}
+
+TEST_F(SelfIntersectionTests, testFindsInjectedIntersection)
+{
+    STLMesh mesh = readMesh(TEST_DATA_DIR + "binary_5mm_sphere.stl");
+    const size_t originalSize = mesh.size();
+
+    // A large triangle slicing straight through the middle of the sphere.
+    addFacet(mesh, makeFacet({ -10, -10, 0.1f }, { 10, -10, 0.1f }, { 0, 20, 0.1f }));
+
+    auto intersections = findSelfIntersections(mesh);
+    ASSERT_FALSE(intersections.empty());
+    for (const auto& intersection : intersections)
+        EXPECT_EQ(intersection.second, originalSize);
+}
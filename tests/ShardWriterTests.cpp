@@ -0,0 +1,198 @@
+#include "ShardWriter.h"
+#include "STLMesh.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    //! Enough facets that every shard's buffer fills several times, plus a partial facet on the end.
+    void writeLargeSTL(const std::string& filepath, uint32_t facetCount)
+    {
+        std::vector<uint8_t> data(84 + facetCount * 50 + 20);
+        memset(data.data(), 'h', 80);
+        memcpy(&data[80], &facetCount, sizeof(facetCount));
+
+        for (uint32_t facet = 0; facet < facetCount; ++facet)
+        {
+            float values[12];
+            for (int i = 0; i < 12; ++i)
+                values[i] = static_cast<float>((facet * 7 + i * 13) % 1000) * 0.1f;
+            memcpy(&data[84 + facet * 50], values, sizeof(values));
+            const uint16_t attributeByteCount = static_cast<uint16_t>(facet);
+            memcpy(&data[84 + facet * 50 + 48], &attributeByteCount, sizeof(attributeByteCount));
+        }
+
+        std::ofstream file(filepath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    void removeAll(const std::vector<std::string>& filepaths)
+    {
+        for (const std::string& filepath : filepaths)
+            _unlink(filepath.c_str());
+    }
+
+    //! Checks each shard is a valid STL, and that together they hold the input's facets in order.
+    void expectShardsMatch(const std::string& inputFile, const std::vector<std::string>& shards)
+    {
+        const STLMesh input = readMesh(inputFile);
+        STLMesh combined;
+        for (const std::string& shard : shards)
+        {
+            EXPECT_EQ(readTriangleCount(shard), calculateTriangleCount(shard));
+            EXPECT_EQ(hasExtraData(shard), 0u);
+
+            const STLMesh mesh = readMesh(shard);
+            EXPECT_EQ(mesh.m_header, input.m_header);
+            combined.m_triangles.insert(combined.m_triangles.end(), mesh.m_triangles.begin(), mesh.m_triangles.end());
+            combined.m_attributeByteCounts.insert(combined.m_attributeByteCounts.end(),
+                mesh.m_attributeByteCounts.begin(), mesh.m_attributeByteCounts.end());
+        }
+
+        EXPECT_EQ(combined.m_triangles, input.m_triangles);
+        EXPECT_EQ(combined.m_attributeByteCounts, input.m_attributeByteCounts);
+    }
+}
+
+class ShardWriterTests : public testing::Test
+{
+
+};
+
+TEST_F(ShardWriterTests, testFacetRanges)
+{
+    const std::string INPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "shard_input.stl");
+    writeLargeSTL(INPUT_FILE, 100000);
+    std::vector<std::string> shards;
+    auto fileGuard = makeCallGuard([&]() { _unlink(INPUT_FILE.c_str()); removeAll(shards); });
+
+    ShardOptions options;
+    options.m_shardCount = 3;
+    shards = shardFile(INPUT_FILE, options, 2);
+
+    ASSERT_EQ(shards.size(), 3u);
+    EXPECT_EQ(readTriangleCount(shards[0]), 33334u);
+    EXPECT_EQ(readTriangleCount(shards[1]), 33333u);
+    EXPECT_EQ(readTriangleCount(shards[2]), 33333u);
+    expectShardsMatch(INPUT_FILE, shards);
+}
+
+TEST_F(ShardWriterTests, testMaxBytes)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    std::vector<std::string> shards;
+    auto fileGuard = makeCallGuard([&]() { removeAll(shards); });
+
+    ShardOptions options;
+    options.m_mode = ShardMode::MAX_BYTES;
+    options.m_maxShardBytes = 84 + 100 * 50 + 49;
+    shards = shardFile(INPUT_FILE, options);
+
+    const uint32_t facetCount = readTriangleCount(INPUT_FILE);
+    ASSERT_EQ(shards.size(), (facetCount + 99) / 100);
+    for (const std::string& shard : shards)
+        EXPECT_LE(FileUtils::getFileSize(shard), options.m_maxShardBytes);
+    expectShardsMatch(INPUT_FILE, shards);
+}
+
+TEST_F(ShardWriterTests, testMaxBytesTooSmall)
+{
+    ShardOptions options;
+    options.m_mode = ShardMode::MAX_BYTES;
+    options.m_maxShardBytes = 84 + 49;
+    EXPECT_THROW(ShardPlan(options, 10), std::runtime_error);
+}
+
+TEST_F(ShardWriterTests, testJunkDropped)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere_truncated_data.stl";
+    std::vector<std::string> shards;
+    auto fileGuard = makeCallGuard([&]() { removeAll(shards); });
+
+    ShardOptions options;
+    options.m_zeroOutHeader = true;
+    options.m_zeroAttributeByteCounts = true;
+    shards = shardFile(INPUT_FILE, options);
+
+    ASSERT_EQ(shards.size(), 2u);
+    uint32_t facetCount = 0;
+    for (const std::string& shard : shards)
+    {
+        EXPECT_EQ(hasExtraData(shard), 0u);
+        const STLMesh mesh = readMesh(shard);
+        for (uint8_t byte : mesh.m_header)
+            EXPECT_EQ(byte, 0);
+        for (uint16_t attributeByteCount : mesh.m_attributeByteCounts)
+            EXPECT_EQ(attributeByteCount, 0);
+        facetCount += static_cast<uint32_t>(mesh.size());
+    }
+    EXPECT_EQ(facetCount, calculateTriangleCount(INPUT_FILE));
+}
+
+TEST_F(ShardWriterTests, testSlabs)
+{
+    const std::string INPUT_FILE = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "shard_input.stl");
+    writeLargeSTL(INPUT_FILE, 50000);
+    std::vector<std::string> shards;
+    auto fileGuard = makeCallGuard([&]() { _unlink(INPUT_FILE.c_str()); removeAll(shards); });
+
+    ShardOptions options;
+    options.m_mode = ShardMode::SLABS;
+    options.m_shardCount = 4;
+    shards = shardFile(INPUT_FILE, options);
+    ASSERT_EQ(shards.size(), 4u);
+
+    // Each facet is in the slab its centroid falls in.
+    const BoundingBox bounds = scanBoundingBox(INPUT_FILE);
+    const ShardPlan plan(options, 50000, bounds);
+    uint32_t facetCount = 0;
+    for (uint32_t shard = 0; shard < shards.size(); ++shard)
+    {
+        const STLMesh mesh = readMesh(shards[shard]);
+        EXPECT_GT(mesh.size(), 0u);
+        for (const auto& triangle : mesh.m_triangles)
+            EXPECT_EQ(plan.getShard(0, decodeFacet(triangle)), shard);
+        facetCount += static_cast<uint32_t>(mesh.size());
+    }
+    EXPECT_EQ(facetCount, 50000u);
+}
+
+TEST_F(ShardWriterTests, testOctants)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    std::vector<std::string> shards;
+    auto fileGuard = makeCallGuard([&]() { removeAll(shards); });
+
+    ShardOptions options;
+    options.m_mode = ShardMode::OCTANTS;
+    shards = shardFile(INPUT_FILE, options);
+    ASSERT_EQ(shards.size(), 8u);
+
+    // A sphere about its center has something in every octant.
+    const Vec3 center = scanBoundingBox(INPUT_FILE).center();
+    uint32_t facetCount = 0;
+    for (uint32_t shard = 0; shard < shards.size(); ++shard)
+    {
+        const STLMesh mesh = readMesh(shards[shard]);
+        EXPECT_GT(mesh.size(), 0u);
+        for (const auto& triangle : mesh.m_triangles)
+        {
+            const Vec3 centroid = computeCentroid(decodeFacet(triangle));
+            EXPECT_EQ(centroid.x >= center.x, (shard & 1) != 0);
+            EXPECT_EQ(centroid.y >= center.y, (shard & 2) != 0);
+            EXPECT_EQ(centroid.z >= center.z, (shard & 4) != 0);
+        }
+        facetCount += static_cast<uint32_t>(mesh.size());
+    }
+    EXPECT_EQ(facetCount, readTriangleCount(INPUT_FILE));
+}
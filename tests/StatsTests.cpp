@@ -0,0 +1,114 @@
+#include "Stats.h"
+#include "FilterChain.h"
+#include "BinarySTLFileReader.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <chrono>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    const PhaseStats& getPhase(const StatsReport& report, StatsPhase phase)
+    {
+        return report.m_phases[static_cast<size_t>(phase)];
+    }
+}
+
+class StatsTests : public testing::Test
+{
+
+};
+
+TEST_F(StatsTests, testNothingRecordedWhenDisabled)
+{
+    Stats::setEnabled(true);
+    Stats::setEnabled(false);
+
+    {
+        STLREPAIR_STATS_PHASE(READ);
+        STLREPAIR_STATS_COUNT_BYTES(READ, 100);
+    }
+
+    const StatsReport report = Stats::getReport();
+    EXPECT_EQ(getPhase(report, StatsPhase::READ).m_scopeCount, 0u);
+    EXPECT_EQ(getPhase(report, StatsPhase::READ).m_byteCount, 0u);
+}
+
+#if !defined(STLREPAIR_DISABLE_STATS)
+
+TEST_F(StatsTests, testNestedPhasesAreExclusive)
+{
+    Stats::setEnabled(true);
+    auto statsGuard = makeCallGuard([]() { Stats::setEnabled(false); });
+
+    {
+        STLREPAIR_STATS_PHASE(FILTER);
+        {
+            STLREPAIR_STATS_PHASE(WRITE);
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        }
+    }
+
+    const StatsReport report = Stats::getReport();
+    EXPECT_EQ(getPhase(report, StatsPhase::FILTER).m_scopeCount, 1u);
+    EXPECT_EQ(getPhase(report, StatsPhase::WRITE).m_scopeCount, 1u);
+    EXPECT_GE(getPhase(report, StatsPhase::WRITE).m_wallTimeNs, 30000000u);
+    EXPECT_LT(getPhase(report, StatsPhase::FILTER).m_wallTimeNs, 15000000u);
+}
+
+TEST_F(StatsTests, testRepairIsInstrumented)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    Stats::setEnabled(true);
+    auto statsGuard = makeCallGuard([]() { Stats::setEnabled(false); });
+
+    {
+        FilterChain chain(OUTPUT_FILE);
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(chain);
+    }
+
+    const StatsReport report = Stats::getReport();
+    EXPECT_EQ(getPhase(report, StatsPhase::READ).m_byteCount, FileUtils::getFileSize(INPUT_FILE));
+    EXPECT_EQ(getPhase(report, StatsPhase::FILTER).m_facetCount, 960u);
+    EXPECT_EQ(getPhase(report, StatsPhase::WRITE).m_facetCount, 960u);
+    EXPECT_EQ(getPhase(report, StatsPhase::WRITE).m_byteCount, FileUtils::getFileSize(INPUT_FILE));
+    EXPECT_EQ(getPhase(report, StatsPhase::PATCH).m_scopeCount, 0u);
+
+    const std::string json = formatStatsJson(report);
+    EXPECT_NE(json.find("\"filter\":{\"wall_ns\":"), std::string::npos);
+    EXPECT_EQ(json.find("\"patch\""), std::string::npos);
+}
+
+#else
+
+TEST_F(StatsTests, testHooksCompileAway)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    Stats::setEnabled(true);
+    auto statsGuard = makeCallGuard([]() { Stats::setEnabled(false); });
+
+    {
+        FilterChain chain(OUTPUT_FILE);
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(chain);
+    }
+
+    const StatsReport report = Stats::getReport();
+    EXPECT_EQ(getPhase(report, StatsPhase::READ).m_scopeCount, 0u);
+    EXPECT_EQ(getPhase(report, StatsPhase::READ).m_byteCount, 0u);
+    EXPECT_EQ(getPhase(report, StatsPhase::WRITE).m_facetCount, 0u);
+}
+
+#endif
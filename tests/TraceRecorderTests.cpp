@@ -0,0 +1,136 @@
+#include "TraceRecorder.h"
+#include "FilterChain.h"
+#include "FilterStages.h"
+#include "BinarySTLFileReader.h"
+#include "Parallel.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <thread>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+namespace
+{
+    std::string getTraceJson()
+    {
+        std::ostringstream stream;
+        TraceRecorder::writeJson(stream);
+        return stream.str();
+    }
+}
+
+class TraceRecorderTests : public testing::Test
+{
+
+};
+
+TEST_F(TraceRecorderTests, testNothingRecordedWhenStopped)
+{
+    TraceRecorder::start();
+    TraceRecorder::stop();
+
+    {
+        STLREPAIR_TRACE_SCOPE("not recorded", "test");
+    }
+
+    EXPECT_EQ(getTraceJson().find("not recorded"), std::string::npos);
+}
+
+#if !defined(STLREPAIR_DISABLE_STATS)
+
+TEST_F(TraceRecorderTests, testStartDiscardsEarlierEvents)
+{
+    TraceRecorder::start();
+    {
+        STLREPAIR_TRACE_SCOPE("first run", "test");
+    }
+    TraceRecorder::start();
+    auto traceGuard = makeCallGuard([]() { TraceRecorder::stop(); });
+    {
+        STLREPAIR_TRACE_SCOPE("second run", "test");
+    }
+
+    const std::string json = getTraceJson();
+    EXPECT_EQ(json.find("first run"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"second run\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":"), std::string::npos);
+}
+
+TEST_F(TraceRecorderTests, testThreadsAreNamedAndSeparate)
+{
+    TraceRecorder::start();
+    auto traceGuard = makeCallGuard([]() { TraceRecorder::stop(); });
+
+    std::thread thread([]()
+    {
+        TraceRecorder::setThreadName("other \"thread\"");
+        STLREPAIR_TRACE_SCOPE("on other thread", "test");
+    });
+    thread.join();
+
+    {
+        STLREPAIR_TRACE_SCOPE("on this thread", "test");
+    }
+
+    const std::string json = getTraceJson();
+    EXPECT_NE(json.find("\"args\":{\"name\":\"other \\\"thread\\\"\"}"), std::string::npos);
+
+    const size_t otherEvent = json.find("on other thread");
+    const size_t thisEvent = json.find("on this thread");
+    ASSERT_NE(otherEvent, std::string::npos);
+    ASSERT_NE(thisEvent, std::string::npos);
+
+    const std::string otherThreadId = json.substr(json.find("\"tid\":", otherEvent), 9);
+    const std::string thisThreadId = json.substr(json.find("\"tid\":", thisEvent), 9);
+    EXPECT_NE(otherThreadId, thisThreadId);
+}
+
+TEST_F(TraceRecorderTests, testRepairIsTraced)
+{
+    const std::string INPUT_FILE = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    const std::string OUTPUT_FILE = FileUtils::generateUniqueFilePath(INPUT_FILE);
+    auto fileGuard = makeCallGuard([&]() { _unlink(OUTPUT_FILE.c_str()); });
+
+    TraceRecorder::start();
+    auto traceGuard = makeCallGuard([]() { TraceRecorder::stop(); });
+
+    {
+        FilterChain chain(OUTPUT_FILE);
+        chain.addStage(std::make_unique<ZeroAttributeByteCountsStage>());
+        BinarySTLFileReader reader(INPUT_FILE);
+        reader.readFile(chain);
+    }
+
+    parallelFor(100000, [](size_t, size_t) {});
+
+    const std::string json = getTraceJson();
+    EXPECT_NE(json.find("\"name\":\"read file\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"read\",\"cat\":\"phase\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"write\",\"cat\":\"phase\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"zero attribute byte counts\",\"cat\":\"stage\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"close\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"parallel chunk\""), std::string::npos);
+    EXPECT_EQ(TraceRecorder::getDroppedEventCount(), 0u);
+}
+
+#else
+
+TEST_F(TraceRecorderTests, testHooksCompileAway)
+{
+    TraceRecorder::start();
+    auto traceGuard = makeCallGuard([]() { TraceRecorder::stop(); });
+
+    {
+        STLREPAIR_TRACE_SCOPE("compiled out", "test");
+    }
+    parallelFor(100000, [](size_t, size_t) {});
+
+    const std::string json = getTraceJson();
+    EXPECT_EQ(json.find("compiled out"), std::string::npos);
+    EXPECT_EQ(json.find("parallel chunk"), std::string::npos);
+}
+
+#endif
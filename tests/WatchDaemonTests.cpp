@@ -0,0 +1,105 @@
+#include "WatchDaemon.h"
+#include "FileUtils.h"
+#include "CallGuard.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+extern std::string TEST_DATA_DIR; // Yeah, I don't feel great about it. But it is what it is for now.
+
+#if defined(__linux__)
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    //! Waits up to a few seconds for the file to show up.
+    bool waitForFile(const fs::path& filepath)
+    {
+        for (int i = 0; (i < 500) && !fs::exists(filepath); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        return fs::exists(filepath);
+    }
+}
+
+class WatchDaemonTests : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        m_rootDirectory = FileUtils::generateUniqueFilePath(TEST_DATA_DIR + "watch");
+        m_inputDirectory = fs::path(m_rootDirectory) / "in";
+        m_outputDirectory = fs::path(m_rootDirectory) / "out";
+        fs::create_directories(m_inputDirectory);
+    }
+
+    void TearDown() override
+    {
+        std::error_code error;
+        fs::remove_all(m_rootDirectory, error);
+    }
+
+    std::string m_rootDirectory;
+    fs::path m_inputDirectory;
+    fs::path m_outputDirectory;
+};
+
+TEST_F(WatchDaemonTests, testRepairsFilesAsTheyArrive)
+{
+    WatchOptions options;
+    options.m_directories.push_back(m_inputDirectory.string());
+    options.m_outputDirectory = m_outputDirectory.string();
+    options.m_workerCount = 2;
+
+    WatchDaemon daemon(options);
+    std::thread thread([&]() { daemon.run(); });
+    auto stopGuard = makeCallGuard([&]()
+    {
+        daemon.stop();
+        thread.join();
+    });
+
+    fs::copy_file(TEST_DATA_DIR + "binary_5mm_sphere_weird_data_on_end.stl", m_inputDirectory / "weird.stl");
+    fs::copy_file(TEST_DATA_DIR + "binary_5mm_sphere_with_giant_triangle_count.stl", m_inputDirectory / "giant.STL");
+    fs::copy_file(TEST_DATA_DIR + "binary_5mm_sphere.stl", m_inputDirectory / "ignored.txt");
+
+    ASSERT_TRUE(waitForFile(m_outputDirectory / "weird.stl"));
+    ASSERT_TRUE(waitForFile(m_outputDirectory / "giant.STL"));
+
+    const std::string expectedFile = TEST_DATA_DIR + "binary_5mm_sphere.stl";
+    EXPECT_TRUE(FileUtils::areFilesEqual((m_outputDirectory / "weird.stl").string(), expectedFile));
+    EXPECT_EQ(fs::file_size(m_outputDirectory / "giant.STL"), fs::file_size(expectedFile));
+
+    stopGuard.dismiss();
+    daemon.stop();
+    thread.join();
+
+    EXPECT_EQ(daemon.getRepairedFileCount(), 2u);
+    EXPECT_EQ(daemon.getFailedFileCount(), 0u);
+    EXPECT_FALSE(fs::exists(m_outputDirectory / "ignored.txt"));
+}
+
+TEST_F(WatchDaemonTests, testOutputDirectoryCannotBeWatched)
+{
+    WatchOptions options;
+    options.m_directories.push_back(m_inputDirectory.string());
+    options.m_outputDirectory = m_inputDirectory.string();
+
+    EXPECT_THROW(WatchDaemon daemon(options), std::runtime_error);
+}
+
+TEST_F(WatchDaemonTests, testMissingDirectoryThrows)
+{
+    WatchOptions options;
+    options.m_directories.push_back((m_inputDirectory / "missing").string());
+    options.m_outputDirectory = m_outputDirectory.string();
+
+    EXPECT_THROW(WatchDaemon daemon(options), std::runtime_error);
+}
+
+#endif
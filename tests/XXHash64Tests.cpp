@@ -0,0 +1,44 @@
+#include "XXHash64.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+
+class XXHash64Tests : public testing::Test
+{
+
+};
+
+TEST_F(XXHash64Tests, testReferenceValues)
+{
+    // Published values from the reference implementation.
+    const std::string text = "Nobody inspects the spammish repetition";
+
+    XXHash64 empty;
+    EXPECT_EQ(empty.digest(), 0xEF46DB3751D8E999ull);
+
+    XXHash64 shortHash;
+    shortHash.update("abc", 3);
+    EXPECT_EQ(shortHash.digest(), 0x44BC2CF5AD770999ull);
+
+    XXHash64 longHash;
+    longHash.update(text.data(), text.size());
+    EXPECT_EQ(longHash.digest(), 0xFBCEA83C8A378BF1ull);
+}
+
+TEST_F(XXHash64Tests, testSplitUpdatesMatch)
+{
+    std::string text;
+    for (int i = 0; i < 100; ++i)
+        text += std::to_string(i * 7919);
+
+    XXHash64 whole;
+    whole.update(text.data(), text.size());
+
+    XXHash64 pieces;
+    for (size_t offset = 0, step = 1; offset < text.size(); offset += step, step = (step % 37) + 3)
+        pieces.update(text.data() + offset, std::min(step, text.size() - offset));
+
+    EXPECT_EQ(pieces.digest(), whole.digest());
+}